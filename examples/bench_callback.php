@@ -0,0 +1,43 @@
+<?php
+// per event cost of calling back into PHP: idle callbacks fire once per loop iteration,
+// so the time per event is mostly libuv's loop plus the callback dispatch.
+// no reference numbers are recorded here, they depend on the build and the machine:
+// run it against two builds on the same machine to compare a dispatch change.
+// usage: php -d extension=uv.so examples/bench_callback.php [events]
+$events = isset($argv[1]) ? (int) $argv[1] : 1000000;
+
+class Handler {
+    public $i = 0;
+    public $events;
+
+    public function onIdle($idle) {
+        if (++$this->i >= $this->events) {
+            uv_idle_stop($idle);
+        }
+    }
+}
+
+function bench($name, $callback, $events) {
+    $idle = uv_idle_init();
+    uv_idle_start($idle, $callback);
+
+    $start = uv_hrtime();
+    uv_run();
+    $elapsed = uv_hrtime() - $start;
+
+    uv_close($idle);
+    uv_run();
+
+    printf("%-10s %8.1f ns/event\n", $name, $elapsed / $events);
+}
+
+$i = 0;
+bench("closure", function($idle) use (&$i, $events) {
+    if (++$i >= $events) {
+        uv_idle_stop($idle);
+    }
+}, $events);
+
+$handler = new Handler;
+$handler->events = $events;
+bench("method", [$handler, 'onIdle'], $events);
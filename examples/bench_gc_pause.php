@@ -0,0 +1,50 @@
+<?php
+// cycle collector pause against the number of active handles. every started
+// timer is a child of its loop for the collector; a collection reaching the
+// loop only rechecks the handles started, stopped or fired since the last one.
+// "first" includes starting all timers, "steady" restarts 10 of them before.
+// usage: php -d extension=uv.so examples/bench_gc_pause.php [rounds]
+$rounds = isset($argv[1]) ? (int) $argv[1] : 20;
+
+function garbage($loop) {
+    // a cycle holding the loop, so the collection traverses it
+    $o = new stdClass;
+    $o->self = $o;
+    $o->loop = $loop;
+}
+
+function pause($loop) {
+    garbage($loop);
+    $start = uv_hrtime();
+    gc_collect_cycles();
+    return (uv_hrtime() - $start) / 1e6;
+}
+
+foreach ([1000, 10000, 100000] as $count) {
+    $loop = uv_loop_new();
+    $timers = [];
+    for ($i = 0; $i < $count; $i++) {
+        $timer = uv_timer_init($loop);
+        uv_timer_start($timer, 3600 * 1000, 0, function() {});
+        $timers[] = $timer;
+    }
+
+    $first = pause($loop);
+    $steady = 0;
+    for ($round = 0; $round < $rounds; $round++) {
+        for ($i = 0; $i < 10; $i++) {
+            $timer = $timers[mt_rand(0, $count - 1)];
+            uv_timer_stop($timer);
+            uv_timer_start($timer, 3600 * 1000, 0, function() {});
+        }
+        $steady += pause($loop);
+    }
+
+    printf("%6d timers: first %8.3f ms, steady %8.3f ms\n", $count, $first, $steady / $rounds);
+
+    foreach ($timers as $timer) {
+        uv_close($timer);
+    }
+    unset($timers);
+    uv_run($loop);
+}
@@ -0,0 +1,36 @@
+<?php
+// memory held by idle handles: creates handles that are never started and
+// reports the Zend heap growth per object. a timer with its callback stored
+// is measured too, as started handles also keep their callback slots.
+// run it against builds before and after a layout change to compare.
+// usage: php -d extension=uv.so examples/bench_handle_size.php [handles]
+$count = isset($argv[1]) ? (int) $argv[1] : 100000;
+
+function bench($name, $count, $create) {
+    $handles = [];
+    gc_collect_cycles();
+    $before = memory_get_usage();
+    for ($i = 0; $i < $count; $i++) {
+        $handles[] = $create();
+    }
+    $after = memory_get_usage();
+
+    // the array itself is included: PHP stores 16 bytes per element
+    printf("%-14s %6.0f bytes/handle\n", $name, ($after - $before) / $count - 16);
+
+    foreach ($handles as $handle) {
+        uv_close($handle);
+    }
+    unset($handles);
+    uv_run();
+}
+
+bench("UVTcp", $count, function() { return uv_tcp_init(); });
+bench("UVTimer", $count, function() { return uv_timer_init(); });
+bench("UVUdp", $count, function() { return uv_udp_init(); });
+bench("UVTimer+cb", $count, function() {
+    $timer = uv_timer_init();
+    uv_timer_start($timer, 3600 * 1000, 0, 'strlen');
+    uv_timer_stop($timer);
+    return $timer;
+});
@@ -79,6 +79,9 @@ ZEND_DECLARE_MODULE_GLOBALS(uv);
 			break; \
 		} \
 		dest = zv == NULL ? NULL : (type *) Z_OBJ_P(zv); \
+		if (zv != NULL && Z_OBJ_P(zv)->handlers == &uv_handlers) { \
+			php_uv_gc_touch((php_uv_t *) Z_OBJ_P(zv)); \
+		} \
 	}
 
 #define UV_PARAM_OBJ(dest, type, ...) UV_PARAM_OBJ_EX(dest, type, 0, ##__VA_ARGS__)
@@ -139,7 +142,7 @@ static int uv_parse_arg_object(zval *arg, zval **dest, int check_null, zend_clas
 
 #define PHP_UV_DEINIT_UV(uv) \
 	clean_uv_handle(uv); \
-	OBJ_RELEASE(&uv->std);
+	php_uv_release(uv);
 
 #define PHP_UV_INIT_GENERIC(dest, type, ce) \
 	do { \
@@ -172,10 +175,11 @@ static int uv_parse_arg_object(zval *arg, zval **dest, int check_null, zend_clas
 	w->buf = uv_buf_init(estrndup(str, strlen), strlen); \
 	w->cb = cb; \
 
-#define PHP_UV_INIT_SEND_REQ(w, uv, str, strlen) \
-	w = (send_req_t *) emalloc(sizeof(send_req_t)); \
-	w->req.data = uv; \
+#define PHP_UV_INIT_SEND_REQ(w, uv, str, strlen, parts) \
+	w = (send_req_t *) emalloc(sizeof(send_req_t) + ((parts) - 1) * sizeof(uv_udp_send_t)); \
 	w->buf = uv_buf_init(estrndup(str, strlen), strlen); \
+	w->pending = 0; \
+	w->status = 0; \
 
 #define PHP_UV_FETCH_UV_DEFAULT_LOOP(loop) \
 	if (loop == NULL) { \
@@ -208,9 +212,14 @@ static int uv_parse_arg_object(zval *arg, zval **dest, int check_null, zend_clas
 	PHP_UV_CHECK_VALID_FD(fd, zstream) \
 }
 
+/* without php_uv_fs_cb libuv runs the request inline and returns its result */
 #define PHP_UV_FS_ASYNC(loop, func,  ...) \
-	error = uv_fs_##func(&loop->loop, (uv_fs_t*)&uv->uv.fs, __VA_ARGS__, php_uv_fs_cb); \
-	if (error) { \
+	error = uv_fs_##func(&loop->loop, (uv_fs_t*)&uv->uv.fs, __VA_ARGS__, sync ? NULL : php_uv_fs_cb); \
+	if (error < 0 && !sync) { \
+		php_uv_fs_bufs_free(uv); \
+		if (uv->buffer) { \
+			efree(uv->buffer); \
+		} \
 		PHP_UV_DEINIT_UV(uv); \
 		php_error_docref(NULL, E_WARNING, "uv_" #func " failed"); \
 		return; \
@@ -218,14 +227,26 @@ static int uv_parse_arg_object(zval *arg, zval **dest, int check_null, zend_clas
 
 #define PHP_UV_INIT_ZVALS(uv) \
 	{ \
-		int ix = 0;\
-		for (ix = 0; ix < PHP_UV_CB_MAX; ix++) {\
+		uint32_t ix = 0;\
+		for (ix = 0; ix < uv->layout->cb_count; ix++) {\
 			uv->callback[ix] = NULL;\
 		} \
 		ZVAL_UNDEF(&uv->fs_fd); \
 		ZVAL_UNDEF(&uv->fs_fd_alt); \
+		ZVAL_UNDEF(&uv->awaiter); \
 	}
 
+#define PHP_UV_INTERNAL_INIT(internal, fn) \
+	do { \
+		GC_REFCOUNT(internal) = 1; \
+		GC_TYPE_INFO(internal) = IS_NULL; \
+		(internal)->dispose = fn; \
+	} while (0)
+
+#define PHP_UV_IS_INTERNAL(handle) (GC_TYPE((zend_refcounted *) (handle)->data) != IS_OBJECT)
+
+#define PHP_UV_CONTAINER_OF(ptr, type, member) ((type *) ((char *) (ptr) - XtOffsetOf(type, member)))
+
 #define PHP_UV_SKIP_DTOR(uv) do { GC_FLAGS(&uv->std) |= IS_OBJ_DESTRUCTOR_CALLED; } while (0)
 #define PHP_UV_IS_DTORED(uv) (GC_FLAGS(&uv->std) & IS_OBJ_DESTRUCTOR_CALLED)
 
@@ -322,6 +343,26 @@ static zend_object_handlers uv_lock_handlers;
 static zend_class_entry *uv_stdio_ce;
 static zend_object_handlers uv_stdio_handlers;
 
+static zend_class_entry *uv_promise_ce;
+static zend_object_handlers uv_promise_handlers;
+
+static zend_class_entry *uv_runtime_ce;
+static zend_object_handlers uv_runtime_handlers;
+
+#ifdef ZTS
+/* runtimes destroyed before their workers were joined, joined by php_uv_runtime_reap() */
+static php_uv_runtime_shared_t *php_uv_runtime_orphans = NULL;
+static uv_mutex_t php_uv_runtime_orphans_lock;
+
+static void php_uv_runtime_reap(zend_bool wait);
+#endif
+
+static zend_class_entry *uv_timer_wheel_ce;
+static zend_object_handlers uv_timer_wheel_handlers;
+
+static zend_class_entry *uv_stat_ce;
+static zend_object_handlers uv_stat_handlers;
+
 
 typedef struct {
 	uv_write_t req;
@@ -330,10 +371,45 @@ typedef struct {
 } write_req_t;
 
 typedef struct {
-	uv_udp_send_t req;
 	uv_buf_t buf;
+	int pending; /* segmented sends still in flight, the callback fires with the last one */
+	int status;
+	uv_udp_send_t req[1];
 } send_req_t;
 
+/* UDP_SEGMENT limits: segments per send (UDP_MAX_SEGMENTS in linux) and the IPv4 payload maximum */
+#define PHP_UV_UDP_MAX_SEGMENTS 64
+#define PHP_UV_UDP_MAX_PAYLOAD  65507
+
+typedef struct {
+	php_uv_internal_t internal;
+	uv_udp_t udp; /* upstream side, replies arrive here */
+	php_uv_udp_relay_t *relay;
+	struct sockaddr_storage client;
+	zend_string *key;
+	uint64_t last_seen;
+	int upstream;
+} php_uv_udp_relay_session_t;
+
+struct php_uv_udp_relay_s {
+	php_uv_internal_t internal;
+	uv_timer_t timer; /* idle session sweep */
+	php_uv_t *listener;
+	HashTable sessions; /* client address => php_uv_udp_relay_session_t */
+	struct sockaddr_storage *upstreams;
+	int upstream_count;
+	int mode;
+	uint32_t next;
+	uint64_t idle_timeout;
+	uint32_t max_sessions; /* 0 for no limit */
+	int handles; /* timer and session sockets not yet closed, the relay is freed with the last one */
+	zend_bool stopped;
+	zend_long forwarded;
+	zend_long replied;
+	zend_long dropped;
+	char buf[65536];
+};
+
 enum php_uv_socket_type {
 	PHP_UV_TCP_IPV4 = 1,
 	PHP_UV_TCP_IPV6 = 2,
@@ -346,6 +422,7 @@ enum php_uv_socket_type {
 /* declarations */
 
 static void php_uv_fs_cb(uv_fs_t* req);
+static int php_uv_fs_result(php_uv_t *uv, zval *params);
 /**
  * execute callback
  *
@@ -356,9 +433,21 @@ static void php_uv_fs_cb(uv_fs_t* req);
  * @return int (maybe..)
  */
 static int php_uv_do_callback(zval *retval_ptr, php_uv_cb_t *callback, zval *params, int param_count TSRMLS_DC);
+static int php_uv_dispatch(php_uv_loop_t *loop, zend_object *current, php_uv_cb_t *cb, zval *retval_ptr, zval *params, int param_count);
 
 void static destruct_uv(zend_object *obj);
 void static clean_uv_handle(php_uv_t *uv);
+static void php_uv_release(php_uv_t *uv);
+
+static void php_uv_gc_touch(php_uv_t *uv);
+static void php_uv_gc_forget(php_uv_t *uv);
+static void php_uv_loop_clear_events(php_uv_loop_t *loop);
+static void php_uv_loop_clear_deferred(php_uv_loop_t *loop);
+static void php_uv_loop_clear_microtasks(php_uv_loop_t *loop);
+static void php_uv_microtask_start(php_uv_loop_t *loop);
+static void php_uv_watchdog_stop(php_uv_loop_t *loop);
+static void php_uv_promise_attach(php_uv_t *uv, zval *promise);
+static int php_uv_await_result(php_uv_t *uv, enum php_uv_callback_type type, zval *params, int param_count, zval *result);
 
 static void php_uv_tcp_connect_cb(uv_connect_t *conn_req, int status);
 
@@ -376,6 +465,12 @@ static void php_uv_read_alloc(uv_handle_t* handle, size_t suggested_size, uv_buf
 
 static void php_uv_close(php_uv_t *uv);
 
+static void php_uv_stream_timeouts_stop(php_uv_t *uv);
+
+typedef struct php_uv_udp_relay_s php_uv_udp_relay_t;
+
+static void php_uv_udp_relay_stop(php_uv_udp_relay_t *relay, zend_bool listener_closing);
+
 static void php_uv_timer_cb(uv_timer_t *handle);
 
 static void php_uv_idle_cb(uv_timer_t *handle);
@@ -489,11 +584,115 @@ static const char* php_uv_strerror(long error_code)
 	return uv_strerror(error_code);
 }
 
+/* Callbacks run from within uv_run() and friends, always on a fresh top level frame with by-value
+ * arguments. For plain user functions that is little more than pushing a frame and entering the VM,
+ * so resolve once here what zend_call_function() would check again on every event. */
+static zend_function *php_uv_cb_fast_function(zend_fcall_info *fci, zend_fcall_info_cache *fcc)
+{
+#if PHP_VERSION_ID >= 70100 && PHP_VERSION_ID < 70300
+	zend_function *func = fcc->function_handler;
+	uint32_t i, num_args;
+
+	if (!ZEND_FCI_INITIALIZED(*fci) || !fcc->initialized || func == NULL || func->type != ZEND_USER_FUNCTION) {
+		return NULL;
+	}
+	if (func->common.fn_flags & (ZEND_ACC_CALL_VIA_TRAMPOLINE | ZEND_ACC_ABSTRACT | ZEND_ACC_DEPRECATED)) {
+		return NULL;
+	}
+
+	num_args = func->common.num_args + ((func->common.fn_flags & ZEND_ACC_VARIADIC) ? 1 : 0);
+	for (i = 0; i < num_args; i++) {
+		if (func->common.arg_info[i].pass_by_reference) {
+			return NULL;
+		}
+	}
+
+	return func;
+#else
+	return NULL;
+#endif
+}
+
+static zend_always_inline int php_uv_cb_call(php_uv_cb_t *cb, zval *retval_ptr, zval *params, int param_count)
+{
+#if PHP_VERSION_ID >= 70100 && PHP_VERSION_ID < 70300
+	zend_function *func = cb->fast;
+	zend_execute_data *caller = EG(current_execute_data);
+
+	/* zend_call_function() inserts a dummy frame when called outside of an internal function (e.g. on shutdown) */
+	if (EXPECTED(func != NULL && caller != NULL && caller->func != NULL && !ZEND_USER_CODE(caller->func->type))) {
+		zend_execute_data *call;
+		const zend_op *opline_before_exception;
+		int i;
+
+		if (UNEXPECTED(!EG(active) || EG(exception))) {
+			return FAILURE;
+		}
+
+		ZVAL_UNDEF(retval_ptr);
+		call = zend_vm_stack_push_call_frame(ZEND_CALL_TOP_FUNCTION | ZEND_CALL_DYNAMIC, func, param_count,
+			cb->fcc.called_scope, (func->common.fn_flags & ZEND_ACC_STATIC) ? NULL : cb->fcc.object);
+
+		for (i = 0; i < param_count; i++) {
+			zval *arg = &params[i];
+
+			ZVAL_DEREF(arg);
+			ZVAL_COPY(ZEND_CALL_ARG(call, i + 1), arg);
+		}
+
+		if (UNEXPECTED(func->op_array.fn_flags & ZEND_ACC_CLOSURE)) {
+			uint32_t call_info = ZEND_CALL_CLOSURE;
+
+			GC_REFCOUNT((zend_object *) func->op_array.prototype)++;
+#if defined(ZEND_ACC_FAKE_CLOSURE) && defined(ZEND_CALL_FAKE_CLOSURE)
+			if (func->common.fn_flags & ZEND_ACC_FAKE_CLOSURE) {
+				call_info |= ZEND_CALL_FAKE_CLOSURE;
+			}
+#endif
+			ZEND_ADD_CALL_FLAG(call, call_info);
+		}
+
+		/* the frame is released by the VM when the function returns */
+		opline_before_exception = EG(opline_before_exception);
+		zend_init_execute_data(call, &func->op_array, retval_ptr);
+		zend_execute_ex(call);
+		EG(opline_before_exception) = opline_before_exception;
+
+		return SUCCESS;
+	}
+#endif
+
+	cb->fci.params        = params;
+	cb->fci.retval        = retval_ptr;
+	cb->fci.param_count   = param_count;
+	cb->fci.no_separation = 1;
+
+	return zend_call_function(&cb->fci, &cb->fcc);
+}
+
+/* only switch the interpreter context when the callback belongs to another one */
+#ifdef ZTS
+#define PHP_UV_CTX_ENTER() \
+	void *old_ctx = NULL; \
+	zend_bool swap_ctx = tsrm_get_ls_cache() != (void *) tsrm_ls; \
+	if (swap_ctx) { \
+		old_ctx = tsrm_set_interpreter_context(tsrm_ls); \
+	}
+#define PHP_UV_CTX_LEAVE() \
+	if (swap_ctx) { \
+		tsrm_set_interpreter_context(old_ctx); \
+	}
+#else
+#define PHP_UV_CTX_ENTER()
+#define PHP_UV_CTX_LEAVE()
+#endif
+
 static php_uv_cb_t* php_uv_cb_init_dynamic(php_uv_t *uv, zend_fcall_info *fci, zend_fcall_info_cache *fcc) {
 	php_uv_cb_t *cb = emalloc(sizeof(php_uv_cb_t));
 
 	memcpy(&cb->fci, fci, sizeof(zend_fcall_info));
 	memcpy(&cb->fcc, fcc, sizeof(zend_fcall_info_cache));
+	cb->fast = php_uv_cb_fast_function(fci, fcc);
 
 	if (ZEND_FCI_INITIALIZED(*fci)) {
 		Z_TRY_ADDREF(cb->fci.function_name);
@@ -505,14 +704,28 @@ static php_uv_cb_t* php_uv_cb_init_dynamic(php_uv_t *uv, zend_fcall_info *fci, z
 	return cb;
 }
 
+static zend_always_inline php_uv_cb_t *php_uv_cb_get(php_uv_t *uv, enum php_uv_callback_type type)
+{
+	int slot = uv->layout->cb_slot[type];
+
+	return slot < 0 ? NULL : uv->callback[slot];
+}
+
 static void php_uv_cb_init(php_uv_cb_t **result, php_uv_t *uv, zend_fcall_info *fci, zend_fcall_info_cache *fcc, enum php_uv_callback_type type)
 {
 	php_uv_cb_t *cb;
+	int slot = uv->layout->cb_slot[type];
+
+	if (slot < 0) {
+		/* the class never fires this callback */
+		*result = NULL;
+		return;
+	}
 
-	if (uv->callback[type] == NULL) {
+	if (uv->callback[slot] == NULL) {
 		cb = emalloc(sizeof(php_uv_cb_t));
 	} else {
-		cb = uv->callback[type];
+		cb = uv->callback[slot];
 
 		if (Z_TYPE(cb->fci.function_name) != IS_UNDEF) {
 			zval_dtor(&cb->fci.function_name);
@@ -524,6 +737,7 @@ static void php_uv_cb_init(php_uv_cb_t **result, php_uv_t *uv, zend_fcall_info *
 
 	memcpy(&cb->fci, fci, sizeof(zend_fcall_info));
 	memcpy(&cb->fcc, fcc, sizeof(zend_fcall_info_cache));
+	cb->fast = php_uv_cb_fast_function(fci, fcc);
 
 	if (ZEND_FCI_INITIALIZED(*fci)) {
 		Z_TRY_ADDREF(cb->fci.function_name);
@@ -532,7 +746,8 @@ static void php_uv_cb_init(php_uv_cb_t **result, php_uv_t *uv, zend_fcall_info *
 		}
 	}
 
-	uv->callback[type] = cb;
+	uv->callback[slot] = cb;
+	*result = cb;
 }
 
 static void php_uv_lock_init(enum php_uv_lock_type lock_type, INTERNAL_FUNCTION_PARAMETERS)
@@ -748,17 +963,390 @@ static void php_uv_lock_trylock(enum php_uv_lock_type lock_type, INTERNAL_FUNCTI
 }
 
 
-static void php_uv_fs_common(uv_fs_type fs_type, INTERNAL_FUNCTION_PARAMETERS)
+/* the array of uv_fs_readv() (lengths) or uv_fs_writev() (strings). NULL with a warning when it cannot be used */
+static php_uv_fs_bufs_t *php_uv_fs_bufs_new(HashTable *ht, zend_bool read)
+{
+	php_uv_fs_bufs_t *bufs;
+	uint32_t n = zend_hash_num_elements(ht), i = 0;
+	size_t total = 0;
+	zval *entry;
+
+	if (n == 0) {
+		php_error_docref(NULL, E_WARNING, "at least one buffer is required");
+		return NULL;
+	}
+
+	bufs = safe_emalloc(n - 1, sizeof(uv_buf_t), sizeof(php_uv_fs_bufs_t));
+	bufs->nbufs = n;
+	bufs->data = NULL;
+	bufs->strings = NULL;
+
+	if (read) {
+		ZEND_HASH_FOREACH_VAL(ht, entry) {
+			zend_long length = zval_get_long(entry);
+
+			if (length < 0 || (zend_ulong) length > (zend_ulong) ZEND_LONG_MAX - total) {
+				php_error_docref(NULL, E_WARNING, "buffer lengths must be 0 or greater and fit in a string");
+				efree(bufs);
+				return NULL;
+			}
+			bufs->bufs[i++].len = (size_t) length;
+			total += (size_t) length;
+		} ZEND_HASH_FOREACH_END();
+
+		/* the segments are consecutive, so a short read fills them in order */
+		bufs->data = emalloc(total);
+		for (i = 0, total = 0; i < n; i++) {
+			bufs->bufs[i].base = bufs->data + total;
+			total += bufs->bufs[i].len;
+		}
+	} else {
+		/* the strings are referenced, not copied */
+		bufs->strings = safe_emalloc(n, sizeof(zend_string *), 0);
+		ZEND_HASH_FOREACH_VAL(ht, entry) {
+			bufs->strings[i] = zval_get_string(entry);
+			bufs->bufs[i] = uv_buf_init(ZSTR_VAL(bufs->strings[i]), ZSTR_LEN(bufs->strings[i]));
+			i++;
+		} ZEND_HASH_FOREACH_END();
+	}
+
+	return bufs;
+}
+
+static void php_uv_fs_bufs_free(php_uv_t *uv)
+{
+	php_uv_fs_bufs_t *bufs = uv->fs_bufs;
+	unsigned int i;
+
+	if (bufs == NULL) {
+		return;
+	}
+
+	if (bufs->strings) {
+		for (i = 0; i < bufs->nbufs; i++) {
+			zend_string_release(bufs->strings[i]);
+		}
+		efree(bufs->strings);
+	}
+	if (bufs->data) {
+		efree(bufs->data);
+	}
+	efree(bufs);
+	uv->fs_bufs = NULL;
+}
+
+static void php_uv_stat_cache_entry_dtor(zval *zv)
+{
+	efree(Z_PTR_P(zv));
+}
+
+static zend_string *php_uv_stat_cache_key(uv_fs_type fs_type, const char *path, size_t len)
+{
+	zend_string *key = zend_string_alloc(len + 1, 0);
+
+	ZSTR_VAL(key)[0] = fs_type == UV_FS_LSTAT ? 'l' : 's';
+	memcpy(ZSTR_VAL(key) + 1, path, len);
+	ZSTR_VAL(key)[len + 1] = '\0';
+
+	return key;
+}
+
+/* drops the entries of the paths starting with prefix, only those without another separator after it unless recursive */
+static void php_uv_stat_cache_flush(php_uv_stat_cache_t *cache, const char *prefix, size_t len, zend_bool recursive)
+{
+	zend_string *key;
+
+	ZEND_HASH_FOREACH_STR_KEY(&cache->entries, key) {
+		const char *path = ZSTR_VAL(key) + 1;
+		size_t path_len = ZSTR_LEN(key) - 1, i;
+
+		if (path_len < len || memcmp(path, prefix, len) != 0) {
+			continue;
+		}
+		if (!recursive) {
+			for (i = len; i < path_len && !IS_SLASH(path[i]); i++);
+			if (i < path_len) {
+				continue;
+			}
+		}
+		zend_hash_del(&cache->entries, key);
+		cache->invalidations++;
+	} ZEND_HASH_FOREACH_END();
+}
+
+static void php_uv_stat_cache_forget(php_uv_stat_cache_t *cache, const char *path, size_t len)
+{
+	zend_string *key = php_uv_stat_cache_key(UV_FS_STAT, path, len);
+
+	if (zend_hash_del(&cache->entries, key) == SUCCESS) {
+		cache->invalidations++;
+	}
+	ZSTR_VAL(key)[0] = 'l';
+	zend_string_forget_hash_val(key);
+	if (zend_hash_del(&cache->entries, key) == SUCCESS) {
+		cache->invalidations++;
+	}
+	zend_string_release(key);
+}
+
+static void php_uv_stat_watch_close_cb(uv_handle_t *handle)
+{
+	php_uv_stat_watch_t *watch = PHP_UV_CONTAINER_OF(handle, php_uv_stat_watch_t, handle);
+
+	zend_string_release(watch->dir);
+	efree(watch);
+}
+
+static void php_uv_stat_watch_close(php_uv_stat_watch_t *watch)
+{
+	zend_hash_del(&watch->cache->watches, watch->dir);
+	uv_close((uv_handle_t *) &watch->handle, php_uv_stat_watch_close_cb);
+}
+
+static void php_uv_stat_watch_dispose(php_uv_internal_t *internal)
+{
+	php_uv_stat_watch_close(PHP_UV_CONTAINER_OF(internal, php_uv_stat_watch_t, internal));
+}
+
+static void php_uv_stat_watch_cb(uv_fs_event_t *handle, const char *filename, int events, int status)
+{
+	php_uv_stat_watch_t *watch = PHP_UV_CONTAINER_OF(handle, php_uv_stat_watch_t, handle);
+	php_uv_stat_cache_t *cache = watch->cache;
+	size_t len = ZSTR_LEN(watch->dir), filename_len;
+	char *path;
+
+	cache->epoch++;
+
+	/* whatever happened inside changed the directory's own mtime */
+	if (len > 1) {
+		php_uv_stat_cache_forget(cache, ZSTR_VAL(watch->dir), len - 1);
+	}
+
+	if (status < 0 || filename == NULL) {
+		php_uv_stat_cache_flush(cache, ZSTR_VAL(watch->dir), len, 0);
+		if (status < 0) {
+			php_uv_stat_watch_close(watch);
+		}
+		return;
+	}
+
+	filename_len = strlen(filename);
+	path = emalloc(len + filename_len + 2);
+	memcpy(path, ZSTR_VAL(watch->dir), len);
+	memcpy(path + len, filename, filename_len);
+	php_uv_stat_cache_forget(cache, path, len + filename_len);
+	if (events & UV_RENAME) {
+		/* a directory which was renamed or removed takes everything cached below it */
+		path[len + filename_len] = DEFAULT_SLASH;
+		php_uv_stat_cache_flush(cache, path, len + filename_len + 1, 1);
+	}
+	efree(path);
+}
+
+/* watches the directory of a new entry, dir is absolute and keeps its trailing separator */
+static void php_uv_stat_cache_watch(php_uv_loop_t *loop, php_uv_stat_cache_t *cache, const char *dir, size_t len)
+{
+	php_uv_stat_watch_t *watch;
+
+	if (zend_hash_str_exists(&cache->watches, dir, len) || zend_hash_num_elements(&cache->watches) >= cache->max_watches) {
+		return;
+	}
+
+	watch = emalloc(sizeof(php_uv_stat_watch_t));
+	PHP_UV_INTERNAL_INIT(&watch->internal, php_uv_stat_watch_dispose);
+	watch->cache = cache;
+	watch->dir = zend_string_init(dir, len, 0);
+	uv_fs_event_init(&loop->loop, &watch->handle);
+	watch->handle.data = &watch->internal;
+
+	if (uv_fs_event_start(&watch->handle, php_uv_stat_watch_cb, ZSTR_VAL(watch->dir), 0) < 0) {
+		/* e.g. out of inotify watches: the entries of this directory only expire */
+		zend_hash_str_add_ptr(&cache->watches, dir, len, NULL);
+		uv_close((uv_handle_t *) &watch->handle, php_uv_stat_watch_close_cb);
+		return;
+	}
+	/* the cache never keeps the loop alive */
+	uv_unref((uv_handle_t *) &watch->handle);
+	zend_hash_add_ptr(&cache->watches, watch->dir, watch);
+}
+
+/* entries are kept in the order they were stored, the internal pointer stays on the oldest: deleting it moves it on to the next */
+static void php_uv_stat_cache_evict(php_uv_stat_cache_t *cache)
+{
+	zend_string *key;
+	zend_ulong index;
+
+	if (zend_hash_get_current_key(&cache->entries, &key, &index) != HASH_KEY_IS_STRING) {
+		zend_hash_internal_pointer_reset(&cache->entries);
+		if (zend_hash_get_current_key(&cache->entries, &key, &index) != HASH_KEY_IS_STRING) {
+			return;
+		}
+	}
+	zend_hash_del(&cache->entries, key);
+}
+
+static void php_uv_stat_cache_store(php_uv_loop_t *loop, uv_fs_type fs_type, const char *path, const uv_stat_t *stat)
+{
+	php_uv_stat_cache_t *cache = loop->stat_cache;
+	php_uv_stat_entry_t *entry;
+	zend_string *key;
+	size_t len = strlen(path), dir_len = len;
+	uint64_t now = uv_hrtime();
+
+	if (zend_hash_num_elements(&cache->entries) >= cache->max_entries) {
+		/* a bounded step per store: the oldest entry makes room, expired or not */
+		php_uv_stat_cache_evict(cache);
+	}
+
+	while (dir_len > 0 && !IS_SLASH(path[dir_len - 1])) {
+		dir_len--;
+	}
+	php_uv_stat_cache_watch(loop, cache, path, dir_len);
+
+	entry = emalloc(sizeof(php_uv_stat_entry_t));
+	memcpy(&entry->stat, stat, sizeof(uv_stat_t));
+	entry->expires = now + cache->ttl;
+
+	key = php_uv_stat_cache_key(fs_type, path, len);
+	zend_hash_update_ptr(&cache->entries, key, entry);
+	zend_string_release(key);
+}
+
+/* empties the cache and closes its watchers */
+static void php_uv_stat_cache_clear(php_uv_stat_cache_t *cache)
+{
+	php_uv_stat_watch_t *watch;
+
+	ZEND_HASH_FOREACH_PTR(&cache->watches, watch) {
+		if (watch) {
+			uv_close((uv_handle_t *) &watch->handle, php_uv_stat_watch_close_cb);
+		}
+	} ZEND_HASH_FOREACH_END();
+	zend_hash_clean(&cache->watches);
+	zend_hash_clean(&cache->entries);
+	cache->epoch++;
+}
+
+static void php_uv_stat_hits_cb(uv_idle_t *handle)
+{
+	php_uv_loop_t *loop = PHP_UV_CONTAINER_OF(handle, php_uv_loop_t, stat_hits_idle);
+	php_uv_t **hits = loop->stat_hits;
+	uint32_t count = loop->stat_hits_count, i;
+
+	/* hits of the callbacks run in the next iteration */
+	loop->stat_hits = NULL;
+	loop->stat_hits_count = 0;
+	loop->stat_hits_size = 0;
+	uv_idle_stop(handle);
+
+	for (i = 0; i < count; i++) {
+		php_uv_fs_cb(&hits[i]->uv.fs);
+	}
+	efree(hits);
+}
+
+static void php_uv_stat_hits_dispose(php_uv_internal_t *internal)
+{
+	php_uv_loop_t *loop = PHP_UV_CONTAINER_OF(internal, php_uv_loop_t, stat_hits_internal);
+	uint32_t i;
+
+	/* dropped like requests the loop never completed */
+	for (i = 0; i < loop->stat_hits_count; i++) {
+		php_uv_t *uv = loop->stat_hits[i];
+
+		uv_fs_req_cleanup(&uv->uv.fs);
+		if (uv->buffer) {
+			efree(uv->buffer);
+			uv->buffer = NULL;
+		}
+		OBJ_RELEASE(&uv->std);
+	}
+	loop->stat_hits_count = 0;
+	uv_close((uv_handle_t *) &loop->stat_hits_idle, NULL);
+}
+
+/* a hit fills in the request as libuv would have, it completes through php_uv_fs_cb() in the next iteration, or right away if sync.
+ * On a miss *stat_path is what to stat: with the cache on, the absolute path it is keyed by, kept in uv->buffer until the result is in;
+ * a relative one would name another file after a chdir() */
+static int php_uv_stat_cache_complete(php_uv_loop_t *loop, php_uv_t *uv, uv_fs_type fs_type, zend_string *path, zend_bool sync, const char **stat_path)
+{
+	php_uv_stat_cache_t *cache = loop->stat_cache;
+	php_uv_stat_entry_t *entry;
+	zend_string *key;
+	uv_fs_t *req = &uv->uv.fs;
+
+	*stat_path = ZSTR_VAL(path);
+	if (cache == NULL || cache->ttl == 0) {
+		return 0;
+	}
+
+	if (!IS_ABSOLUTE_PATH(ZSTR_VAL(path), ZSTR_LEN(path))) {
+		uv->buffer = expand_filepath(ZSTR_VAL(path), NULL);
+		if (uv->buffer == NULL) {
+			/* not cached at all */
+			return 0;
+		}
+		*stat_path = uv->buffer;
+	}
+
+	key = php_uv_stat_cache_key(fs_type, *stat_path, strlen(*stat_path));
+	entry = zend_hash_find_ptr(&cache->entries, key);
+	if (entry && entry->expires <= uv_hrtime()) {
+		zend_hash_del(&cache->entries, key);
+		entry = NULL;
+	}
+	zend_string_release(key);
+
+	if (entry == NULL) {
+		cache->misses++;
+		/* tells php_uv_fs_result() whether the result may still be stored */
+		uv->stat_epoch = cache->epoch;
+		return 0;
+	}
+	cache->hits++;
+
+	/* no path, nothing for uv_fs_req_cleanup() to free */
+	memset(req, 0, sizeof(uv_fs_t));
+	req->data = uv;
+	req->type = UV_FS;
+	req->loop = &loop->loop;
+	req->fs_type = fs_type;
+	memcpy(&req->statbuf, &entry->stat, sizeof(uv_stat_t));
+	req->ptr = &req->statbuf;
+
+	if (sync) {
+		return 1;
+	}
+
+	if (!loop->stat_hits_init) {
+		uv_idle_init(&loop->loop, &loop->stat_hits_idle);
+		PHP_UV_INTERNAL_INIT(&loop->stat_hits_internal, php_uv_stat_hits_dispose);
+		loop->stat_hits_idle.data = &loop->stat_hits_internal;
+		loop->stat_hits_init = 1;
+	}
+	if (loop->stat_hits_count == loop->stat_hits_size) {
+		loop->stat_hits_size = loop->stat_hits_size ? loop->stat_hits_size * 2 : 8;
+		loop->stat_hits = safe_erealloc(loop->stat_hits, loop->stat_hits_size, sizeof(php_uv_t *), 0);
+	}
+	/* holds the reference libuv would have held */
+	loop->stat_hits[loop->stat_hits_count++] = uv;
+	uv_idle_start(&loop->stat_hits_idle, php_uv_stat_hits_cb);
+
+	return 1;
+}
+
+static void php_uv_fs_common(uv_fs_type fs_type, int mode, INTERNAL_FUNCTION_PARAMETERS)
 {
+	zend_bool sync = (mode & PHP_UV_FS_SYNC) != 0;
 	int error = 0;
 	php_uv_loop_t *loop;
-	php_uv_t *uv;
+	php_uv_t *uv = NULL;
 	zend_fcall_info fci       = empty_fcall_info;
 	zend_fcall_info_cache fcc = empty_fcall_info_cache;
 	php_uv_cb_t *cb;
 
 #define PHP_UV_FS_PARSE_PARAMETERS(num, params) \
-	ZEND_PARSE_PARAMETERS_START(1 + num, 2 + num) \
+	ZEND_PARSE_PARAMETERS_START(1 + num, (sync ? 1 : 2) + num) \
 		UV_PARAM_OBJ(loop, php_uv_loop_t, uv_loop_ce) \
 		params \
 		Z_PARAM_OPTIONAL \
@@ -769,7 +1357,10 @@ static void php_uv_fs_common(uv_fs_type fs_type, INTERNAL_FUNCTION_PARAMETERS)
 #define PHP_UV_FS_SETUP() \
 	PHP_UV_INIT_UV(uv, uv_fs_ce); \
 	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop); \
-	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_FS_CB);
+	if (!sync) { \
+		php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_FS_CB); \
+		uv->await_type = PHP_UV_FS_CB; \
+	}
 
 #define PHP_UV_FS_SETUP_AND_EXECUTE(command, ...) \
 	PHP_UV_FS_SETUP(); \
@@ -946,9 +1537,14 @@ static void php_uv_fs_common(uv_fs_type fs_type, INTERNAL_FUNCTION_PARAMETERS)
 		case UV_FS_LSTAT:
 		{
 			zend_string *path;
+			const char *stat_path;
 
 			PHP_UV_FS_PARSE_PARAMETERS(1, Z_PARAM_STR(path));
-			PHP_UV_FS_SETUP_AND_EXECUTE(lstat, path->val);
+			PHP_UV_FS_SETUP();
+			if (php_uv_stat_cache_complete(loop, uv, fs_type, path, sync, &stat_path)) {
+				break;
+			}
+			PHP_UV_FS_ASYNC(loop, lstat, stat_path);
 			break;
 		}
 		case UV_FS_FSTAT:
@@ -967,9 +1563,14 @@ static void php_uv_fs_common(uv_fs_type fs_type, INTERNAL_FUNCTION_PARAMETERS)
 		case UV_FS_STAT:
 		{
 			zend_string *path;
+			const char *stat_path;
 
 			PHP_UV_FS_PARSE_PARAMETERS(1, Z_PARAM_STR(path));
-			PHP_UV_FS_SETUP_AND_EXECUTE(stat, path->val);
+			PHP_UV_FS_SETUP();
+			if (php_uv_stat_cache_complete(loop, uv, fs_type, path, sync, &stat_path)) {
+				break;
+			}
+			PHP_UV_FS_ASYNC(loop, stat, stat_path);
 			break;
 		}
 		case UV_FS_UTIME:
@@ -1011,6 +1612,28 @@ static void php_uv_fs_common(uv_fs_type fs_type, INTERNAL_FUNCTION_PARAMETERS)
 			zend_long offset;
 			uv_buf_t buf;
 
+			if (mode & PHP_UV_FS_VECTORED) {
+				HashTable *lengths;
+				php_uv_fs_bufs_t *bufs;
+
+				PHP_UV_FS_PARSE_PARAMETERS(3, Z_PARAM_RESOURCE(zstream) Z_PARAM_LONG(offset) Z_PARAM_ARRAY_HT(lengths));
+				if (offset < 0) {
+					offset = 0;
+				}
+				PHP_UV_FS_SETUP()
+				PHP_UV_ZVAL_TO_FD(fd, zstream);
+				uv->fs_fd = *zstream;
+				Z_ADDREF(uv->fs_fd);
+				if ((bufs = php_uv_fs_bufs_new(lengths, 1)) == NULL) {
+					PHP_UV_DEINIT_UV(uv);
+					RETURN_FALSE;
+				}
+				uv->fs_bufs = bufs;
+
+				PHP_UV_FS_ASYNC(loop, read, fd, bufs->bufs, bufs->nbufs, offset);
+				break;
+			}
+
 			PHP_UV_FS_PARSE_PARAMETERS(3, Z_PARAM_RESOURCE(zstream) Z_PARAM_LONG(offset) Z_PARAM_LONG(length));
 			if (length <= 0) {
 				length = 0;
@@ -1054,6 +1677,25 @@ static void php_uv_fs_common(uv_fs_type fs_type, INTERNAL_FUNCTION_PARAMETERS)
 			zend_long fd, offset = -1;
 			uv_buf_t uv_fs_write_buf_t;
 
+			if (mode & PHP_UV_FS_VECTORED) {
+				HashTable *buffers;
+				php_uv_fs_bufs_t *bufs;
+
+				PHP_UV_FS_PARSE_PARAMETERS(3, Z_PARAM_RESOURCE(zstream) Z_PARAM_ARRAY_HT(buffers) Z_PARAM_LONG(offset));
+				PHP_UV_FS_SETUP();
+				PHP_UV_ZVAL_TO_FD(fd, zstream);
+				uv->fs_fd = *zstream;
+				Z_ADDREF(uv->fs_fd);
+				if ((bufs = php_uv_fs_bufs_new(buffers, 0)) == NULL) {
+					PHP_UV_DEINIT_UV(uv);
+					RETURN_FALSE;
+				}
+				uv->fs_bufs = bufs;
+
+				PHP_UV_FS_ASYNC(loop, write, fd, bufs->bufs, bufs->nbufs, offset);
+				break;
+			}
+
 			PHP_UV_FS_PARSE_PARAMETERS(3, Z_PARAM_RESOURCE(zstream) Z_PARAM_STR(buffer) Z_PARAM_LONG(offset));
 			PHP_UV_FS_SETUP();
 			PHP_UV_ZVAL_TO_FD(fd, zstream);
@@ -1074,6 +1716,31 @@ static void php_uv_fs_common(uv_fs_type fs_type, INTERNAL_FUNCTION_PARAMETERS)
 		}
 	}
 
+	if (uv && sync) {
+		zval params[3] = {{{0}}};
+		int argc = php_uv_fs_result(uv, params), i;
+
+		/* what awaiting the request would have given: the result, or the negative error code */
+		php_uv_await_result(uv, PHP_UV_FS_CB, params, argc, return_value);
+		for (i = 0; i < argc; i++) {
+			zval_ptr_dtor(&params[i]);
+		}
+		if (!Z_ISUNDEF(uv->fs_fd_alt)) {
+			zval_ptr_dtor(&uv->fs_fd_alt);
+			ZVAL_UNDEF(&uv->fs_fd_alt);
+		}
+		uv_fs_req_cleanup(&uv->uv.fs);
+		PHP_UV_DEINIT_UV(uv);
+	} else if (uv) {
+		if (!ZEND_FCI_INITIALIZED(fci)) {
+			php_uv_promise_attach(uv, return_value);
+		} else {
+			/* the request stays owned by libuv until php_uv_fs_cb, hand out another reference to await it */
+			GC_REFCOUNT(&uv->std)++;
+			RETVAL_OBJ(&uv->std);
+		}
+	}
+
 #undef PHP_UV_FS_PARSE_PARAMETERS
 #undef PHP_UV_FS_SETUP
 #undef PHP_UV_FS_SETUP_AND_EXECUTE
@@ -1121,34 +1788,204 @@ static zval php_uv_address_to_zval(const struct sockaddr *addr)
 	return tmp;
 }
 
-static zval php_uv_make_stat(const uv_stat_t *s)
-{
-	zval tmp = {{0}};
-	array_init(&tmp);
+/* the names UVStat answers to, in the order var_dump() and foreach show them */
+static const char *php_uv_stat_fields[] = {
+	"dev", "ino", "mode", "nlink", "uid", "gid", "rdev", "size", "blksize", "blocks", "flags", "gen",
+	"atime", "mtime", "ctime", "birthtime", "atime_ns", "mtime_ns", "ctime_ns", "birthtime_ns"
+};
 
-	add_assoc_long_ex(&tmp, ZEND_STRL("dev"), s->st_dev);
-	add_assoc_long_ex(&tmp, ZEND_STRL("ino"), s->st_ino);
-	add_assoc_long_ex(&tmp, ZEND_STRL("mode"), s->st_mode);
-	add_assoc_long_ex(&tmp, ZEND_STRL("link"), s->st_nlink);
-	add_assoc_long_ex(&tmp, ZEND_STRL("uid"), s->st_uid);
-	add_assoc_long_ex(&tmp, ZEND_STRL("gid"), s->st_gid);
-	add_assoc_long_ex(&tmp, ZEND_STRL("rdev"), s->st_rdev);
-	add_assoc_long_ex(&tmp, ZEND_STRL("size"), s->st_size);
+#define PHP_UV_STAT_FIELD_NLINK 3
+#define PHP_UV_STAT_FIELD_COUNT (sizeof(php_uv_stat_fields) / sizeof(php_uv_stat_fields[0]))
 
-#ifndef PHP_WIN32
-	add_assoc_long_ex(&tmp, ZEND_STRL("blksize"), s->st_blksize);
-	add_assoc_long_ex(&tmp, ZEND_STRL("blocks"), s->st_blocks);
-#endif
+static int php_uv_stat_field_index(zval *name)
+{
+	int i;
 
-	add_assoc_long_ex(&tmp, ZEND_STRL("atime"), s->st_atim.tv_sec);
-	add_assoc_long_ex(&tmp, ZEND_STRL("mtime"), s->st_mtim.tv_sec);
-	add_assoc_long_ex(&tmp, ZEND_STRL("ctime"), s->st_ctim.tv_sec);
+	if (Z_TYPE_P(name) != IS_STRING) {
+		return -1;
+	}
+	for (i = 0; i < PHP_UV_STAT_FIELD_COUNT; i++) {
+		if (Z_STRLEN_P(name) == strlen(php_uv_stat_fields[i]) && memcmp(Z_STRVAL_P(name), php_uv_stat_fields[i], Z_STRLEN_P(name)) == 0) {
+			return i;
+		}
+	}
+	/* uv_fs_stat() used to call it link */
+	if (zend_string_equals_literal(Z_STR_P(name), "link")) {
+		return PHP_UV_STAT_FIELD_NLINK;
+	}
 
-	return tmp;
+	return -1;
 }
 
-static inline zend_bool php_uv_closeable_type(php_uv_t *uv) {
-	zend_class_entry *ce = uv->std.ce;
+static void php_uv_stat_timespec(zval *rv, const uv_timespec_t *ts)
+{
+#if SIZEOF_ZEND_LONG >= 8
+	ZVAL_LONG(rv, (zend_long) ts->tv_sec * 1000000000 + ts->tv_nsec);
+#else
+	ZVAL_DOUBLE(rv, (double) ts->tv_sec * 1000000000 + ts->tv_nsec);
+#endif
+}
+
+static void php_uv_stat_field(const uv_stat_t *s, int field, zval *rv)
+{
+	switch (field) {
+		case 0: ZVAL_LONG(rv, s->st_dev); break;
+		case 1: ZVAL_LONG(rv, s->st_ino); break;
+		case 2: ZVAL_LONG(rv, s->st_mode); break;
+		case 3: ZVAL_LONG(rv, s->st_nlink); break;
+		case 4: ZVAL_LONG(rv, s->st_uid); break;
+		case 5: ZVAL_LONG(rv, s->st_gid); break;
+		case 6: ZVAL_LONG(rv, s->st_rdev); break;
+		case 7: ZVAL_LONG(rv, s->st_size); break;
+		case 8: ZVAL_LONG(rv, s->st_blksize); break;
+		case 9: ZVAL_LONG(rv, s->st_blocks); break;
+		case 10: ZVAL_LONG(rv, s->st_flags); break;
+		case 11: ZVAL_LONG(rv, s->st_gen); break;
+		case 12: ZVAL_LONG(rv, s->st_atim.tv_sec); break;
+		case 13: ZVAL_LONG(rv, s->st_mtim.tv_sec); break;
+		case 14: ZVAL_LONG(rv, s->st_ctim.tv_sec); break;
+		case 15: ZVAL_LONG(rv, s->st_birthtim.tv_sec); break;
+		case 16: php_uv_stat_timespec(rv, &s->st_atim); break;
+		case 17: php_uv_stat_timespec(rv, &s->st_mtim); break;
+		case 18: php_uv_stat_timespec(rv, &s->st_ctim); break;
+		case 19: php_uv_stat_timespec(rv, &s->st_birthtim); break;
+		default: ZVAL_NULL(rv); break;
+	}
+}
+
+static zval php_uv_make_stat(const uv_stat_t *s)
+{
+	zval tmp = {{0}};
+
+	object_init_ex(&tmp, uv_stat_ce);
+	memcpy(&((php_uv_stat_t *) Z_OBJ(tmp))->stat, s, sizeof(uv_stat_t));
+
+	return tmp;
+}
+
+static zval *php_uv_stat_read(zval *object, zval *name, int type, zval *rv, const char *undefined)
+{
+	int field = php_uv_stat_field_index(name);
+
+	if (field < 0) {
+		if (type != BP_VAR_IS) {
+			zend_string *str = zval_get_string(name);
+			php_error_docref(NULL, E_NOTICE, undefined, ZSTR_VAL(str));
+			zend_string_release(str);
+		}
+		return &EG(uninitialized_zval);
+	}
+
+	php_uv_stat_field(&((php_uv_stat_t *) Z_OBJ_P(object))->stat, field, rv);
+	return rv;
+}
+
+static int php_uv_stat_has(zval *object, zval *name, int check_empty)
+{
+	int field = php_uv_stat_field_index(name);
+	zval tmp;
+
+	if (field < 0) {
+		return 0;
+	}
+	if (check_empty == 1) {
+		php_uv_stat_field(&((php_uv_stat_t *) Z_OBJ_P(object))->stat, field, &tmp);
+		return zend_is_true(&tmp);
+	}
+	return 1;
+}
+
+static zval *php_uv_stat_read_property(zval *object, zval *member, int type, void **cache_slot, zval *rv)
+{
+	return php_uv_stat_read(object, member, type, rv, "Undefined property: UVStat::$%s");
+}
+
+static zval *php_uv_stat_read_dimension(zval *object, zval *offset, int type, zval *rv)
+{
+	if (offset == NULL) {
+		zend_throw_error(NULL, "Cannot append to UVStat");
+		return NULL;
+	}
+	return php_uv_stat_read(object, offset, type, rv, "Undefined index: %s");
+}
+
+static int php_uv_stat_has_property(zval *object, zval *member, int has_set_exists, void **cache_slot)
+{
+	return php_uv_stat_has(object, member, has_set_exists);
+}
+
+static int php_uv_stat_has_dimension(zval *object, zval *offset, int check_empty)
+{
+	return php_uv_stat_has(object, offset, check_empty);
+}
+
+static void php_uv_stat_write_property(zval *object, zval *member, zval *value, void **cache_slot)
+{
+	zend_throw_error(NULL, "UVStat is read-only");
+}
+
+static void php_uv_stat_write_dimension(zval *object, zval *offset, zval *value)
+{
+	zend_throw_error(NULL, "UVStat is read-only");
+}
+
+static void php_uv_stat_unset_property(zval *object, zval *member, void **cache_slot)
+{
+	zend_throw_error(NULL, "UVStat is read-only");
+}
+
+static void php_uv_stat_unset_dimension(zval *object, zval *offset)
+{
+	zend_throw_error(NULL, "UVStat is read-only");
+}
+
+static zval *php_uv_stat_get_property_ptr_ptr(zval *object, zval *member, int type, void **cache_slot)
+{
+	/* no storage to point into, the engine falls back to read_property and write_property */
+	return NULL;
+}
+
+/* the array the stat used to be, only built for var_dump(), foreach and (array) casts */
+static HashTable *php_uv_stat_get_properties(zval *object)
+{
+	php_uv_stat_t *stat = (php_uv_stat_t *) Z_OBJ_P(object);
+	zval tmp;
+	int i;
+
+	if (stat->std.properties == NULL) {
+		ALLOC_HASHTABLE(stat->std.properties);
+		zend_hash_init(stat->std.properties, PHP_UV_STAT_FIELD_COUNT + 1, NULL, ZVAL_PTR_DTOR, 0);
+		for (i = 0; i < PHP_UV_STAT_FIELD_COUNT; i++) {
+			php_uv_stat_field(&stat->stat, i, &tmp);
+			zend_hash_str_add_new(stat->std.properties, php_uv_stat_fields[i], strlen(php_uv_stat_fields[i]), &tmp);
+			if (i == PHP_UV_STAT_FIELD_NLINK) {
+				/* uv_fs_stat() arrays had it as link, uv_fs_poll_start() ones as nlink */
+				ZVAL_LONG(&tmp, stat->stat.st_nlink);
+				zend_hash_str_add_new(stat->std.properties, ZEND_STRL("link"), &tmp);
+			}
+		}
+	}
+
+	return stat->std.properties;
+}
+
+static int php_uv_stat_count_elements(zval *object, zend_long *count)
+{
+	/* the fields and the link alias, as the (array) cast has them */
+	*count = PHP_UV_STAT_FIELD_COUNT + 1;
+	return SUCCESS;
+}
+
+static HashTable *php_uv_stat_get_gc(zval *object, zval **table, int *n)
+{
+	/* holds no zvals, std_get_gc() would build the properties through get_properties for every scan */
+	*table = NULL;
+	*n = 0;
+	return Z_OBJ_P(object)->properties;
+}
+
+static inline zend_bool php_uv_closeable_type(php_uv_t *uv) {
+	zend_class_entry *ce = uv->std.ce;
 	return ce == uv_pipe_ce || ce == uv_tty_ce || ce == uv_tcp_ce || ce == uv_udp_ce || ce == uv_prepare_ce || ce == uv_check_ce || ce == uv_idle_ce || ce == uv_async_ce || ce == uv_timer_ce || ce == uv_process_ce || ce == uv_fs_event_ce || ce == uv_poll_ce || ce == uv_fs_poll_ce || ce == uv_signal_ce;
 }
 
@@ -1187,6 +2024,12 @@ void static destruct_uv_lock(zend_object *obj)
 static void destruct_uv_loop_walk_cb(uv_handle_t* handle, void* arg) 
 {
 	php_uv_t *uv = (php_uv_t *) handle->data;
+	if (PHP_UV_IS_INTERNAL(handle)) {
+		if (!uv_is_closing(handle)) {
+			((php_uv_internal_t *) handle->data)->dispose(handle->data);
+		}
+		return;
+	}
 	if (!PHP_UV_IS_DTORED(uv)) { // otherwise we're already closing
 		php_uv_close(uv);
 	}
@@ -1196,6 +2039,10 @@ void static destruct_uv_loop(zend_object *obj)
 {
 	php_uv_loop_t *loop_obj = (php_uv_loop_t *) obj;
 	uv_loop_t *loop = &loop_obj->loop;
+	php_uv_watchdog_stop(loop_obj);
+	php_uv_loop_clear_events(loop_obj);
+	php_uv_loop_clear_deferred(loop_obj);
+	php_uv_loop_clear_microtasks(loop_obj);
 	if (loop_obj != UV_G(default_loop)) {
 		uv_stop(loop); /* in case we haven't stopped the loop yet otherwise ... */
 		uv_run(loop, UV_RUN_DEFAULT); /* invalidate the stop ;-) */
@@ -1205,16 +2052,57 @@ void static destruct_uv_loop(zend_object *obj)
 		uv_run(loop, UV_RUN_DEFAULT);
 		uv_loop_close(loop);
 	}
+	php_uv_loop_clear_events(loop_obj);
+	if (loop_obj->events) {
+		efree(loop_obj->events);
+	}
+	if (loop_obj->microtasks) {
+		efree(loop_obj->microtasks);
+		loop_obj->microtasks = NULL;
+	}
+	if (loop_obj->stat_cache) {
+		/* its watchers were closed with the loop */
+		zend_hash_destroy(&loop_obj->stat_cache->watches);
+		zend_hash_destroy(&loop_obj->stat_cache->entries);
+		efree(loop_obj->stat_cache);
+		loop_obj->stat_cache = NULL;
+	}
+	if (loop_obj->stat_hits) {
+		efree(loop_obj->stat_hits);
+		loop_obj->stat_hits = NULL;
+	}
 	if (loop_obj->gc_buffer) {
 		efree(loop_obj->gc_buffer);
 	}
 }
 
+void static free_uv_loop(zend_object *obj)
+{
+	php_uv_loop_t *loop = (php_uv_loop_t *) obj;
+	uint32_t i;
+
+	/* handles outliving their loop (e.g. after a fatal error) must not touch it anymore */
+	for (i = 0; i < loop->gc_registry_count; i++) {
+		((php_uv_t *) Z_OBJ(loop->gc_registry[i]))->gc_slot = 0;
+	}
+	for (i = 0; i < loop->gc_dirty_count; i++) {
+		loop->gc_dirty[i]->gc_dirty = 0;
+	}
+	if (loop->gc_registry) {
+		efree(loop->gc_registry);
+	}
+	if (loop->gc_dirty) {
+		efree(loop->gc_dirty);
+	}
+
+	zend_object_std_dtor(obj);
+}
+
 void static clean_uv_handle(php_uv_t *uv) {
-	int i;
+	uint32_t i;
 
 	/* for now */
-	for (i = 0; i < PHP_UV_CB_MAX; i++) {
+	for (i = 0; i < uv->layout->cb_count; i++) {
 		php_uv_cb_t *cb = uv->callback[i];
 		if (cb != NULL) {
 			if (ZEND_FCI_INITIALIZED(cb->fci)) {
@@ -1226,7 +2114,7 @@ void static clean_uv_handle(php_uv_t *uv) {
 			}
 
 			efree(cb);
-			cb = NULL;
+			uv->callback[i] = NULL;
 		}
 	}
 
@@ -1240,6 +2128,11 @@ void static clean_uv_handle(php_uv_t *uv) {
 			ZVAL_UNDEF(&uv->fs_fd_alt);
 		}
 	}
+
+	if (!Z_ISUNDEF(uv->awaiter)) {
+		zval_ptr_dtor(&uv->awaiter);
+		ZVAL_UNDEF(&uv->awaiter);
+	}
 }
 
 void static destruct_uv(zend_object *obj)
@@ -1259,6 +2152,40 @@ void static destruct_uv(zend_object *obj)
 	}
 }
 
+/* drops a reference php-uv holds on a cleaned handle or request. When it is the last one, the object
+ * goes to the free list of its class and create_object hands it out again instead of allocating. */
+static void php_uv_release(php_uv_t *uv)
+{
+	uint32_t pool = uv->layout->index;
+
+	if (GC_REFCOUNT(&uv->std) == 1 && uv->std.properties == NULL
+	 && UV_G(pool_enabled) && UV_G(pool_count)[pool] < PHP_UV_POOL_MAX) {
+		/* the destructor flag stays set, so the engine never destructs a pooled object */
+		PHP_UV_SKIP_DTOR(uv);
+		uv->pool_next = UV_G(pool)[pool];
+		UV_G(pool)[pool] = uv;
+		UV_G(pool_count)[pool]++;
+		return;
+	}
+
+	OBJ_RELEASE(&uv->std);
+}
+
+static void php_uv_pool_clear(void)
+{
+	uint32_t i;
+
+	UV_G(pool_enabled) = 0;
+	for (i = 0; i < PHP_UV_LAYOUT_MAX; i++) {
+		while (UV_G(pool)[i]) {
+			php_uv_t *uv = UV_G(pool)[i];
+			UV_G(pool)[i] = uv->pool_next;
+			OBJ_RELEASE(&uv->std);
+		}
+		UV_G(pool_count)[i] = 0;
+	}
+}
+
 void static php_uv_free_write_req(write_req_t *wr) {
 	if (wr->cb) {
 		if (ZEND_FCI_INITIALIZED(wr->cb->fci)) {
@@ -1276,2192 +2203,6471 @@ void static php_uv_free_write_req(write_req_t *wr) {
 	efree(wr);
 }
 
-/* callback */
-static int php_uv_do_callback(zval *retval_ptr, php_uv_cb_t *callback, zval *params, int param_count TSRMLS_DC)
+static void php_uv_event_push(php_uv_t *uv, int type, zval *params, int param_count)
 {
-	int error;
+	php_uv_loop_t *loop = PHP_UV_CONTAINER_OF(uv->uv.handle.loop, php_uv_loop_t, loop);
+	php_uv_event_t *event;
+	int i;
 
-#ifdef ZTS
-	void *old = tsrm_set_interpreter_context(tsrm_ls);
-#endif
+	ZEND_ASSERT(param_count <= 4);
 
-	if (ZEND_FCI_INITIALIZED(callback->fci)) {
-		callback->fci.params = params;
-		callback->fci.retval = retval_ptr;
-		callback->fci.param_count = param_count;
-		callback->fci.no_separation = 1;
+	if (loop->events_count == loop->events_size) {
+		uint32_t size = loop->events_size ? loop->events_size * 2 : 16;
+		php_uv_event_t *events = safe_emalloc(size, sizeof(php_uv_event_t), 0);
 
-		error = zend_call_function(&callback->fci, &callback->fcc);
-	} else {
-		error = -1;
+		for (i = 0; i < (int) loop->events_count; i++) {
+			events[i] = loop->events[(loop->events_head + i) % loop->events_size];
+		}
+		if (loop->events) {
+			efree(loop->events);
+		}
+		loop->events = events;
+		loop->events_size = size;
+		loop->events_head = 0;
 	}
 
-#ifdef ZTS
-	tsrm_set_interpreter_context(old);
-#endif
+	event = &loop->events[(loop->events_head + loop->events_count++) % loop->events_size];
+	event->type = type;
+	event->argc = param_count;
+	for (i = 0; i < param_count; i++) {
+		ZVAL_COPY(&event->args[i], &params[i]);
+	}
+}
 
-	return error;
+static void php_uv_event_shift(php_uv_loop_t *loop, zval *record)
+{
+	php_uv_event_t *event = &loop->events[loop->events_head];
+	int i;
+
+	loop->events_head = (loop->events_head + 1) % loop->events_size;
+	loop->events_count--;
+
+	array_init_size(record, event->argc + 1);
+	add_next_index_long(record, event->type);
+	for (i = 0; i < event->argc; i++) {
+		add_next_index_zval(record, &event->args[i]);
+	}
 }
 
-static int php_uv_do_callback2(zval *retval_ptr, php_uv_t *uv, zval *params, int param_count, enum php_uv_callback_type type TSRMLS_DC)
+static void php_uv_loop_clear_events(php_uv_loop_t *loop)
 {
-	int error = 0;
+	while (loop->events_count > 0) {
+		php_uv_event_t *event = &loop->events[loop->events_head];
+		int i;
 
-#ifdef ZTS
-	void *old = tsrm_set_interpreter_context(tsrm_ls);
-#endif
-	if (ZEND_FCI_INITIALIZED(uv->callback[type]->fci)) {
-		uv->callback[type]->fci.params        = params;
-		uv->callback[type]->fci.retval        = retval_ptr;
-		uv->callback[type]->fci.param_count   = param_count;
-		uv->callback[type]->fci.no_separation = 1;
+		loop->events_head = (loop->events_head + 1) % loop->events_size;
+		loop->events_count--;
 
-		if (zend_call_function(&uv->callback[type]->fci, &uv->callback[type]->fcc) != SUCCESS) {
-			error = -1;
+		for (i = 0; i < event->argc; i++) {
+			zval_ptr_dtor(&event->args[i]);
 		}
-	} else {
-		error = -2;
 	}
+}
+
+/* coroutines and promises */
+enum php_uv_promise_reaction_kind {
+	PHP_UV_REACTION_THEN,      /* call a handler, settle target with what it returns */
+	PHP_UV_REACTION_FORWARD,   /* settle target the same way */
+	PHP_UV_REACTION_ALL,       /* store the value at key of target, see uv_promise_all() */
+	PHP_UV_REACTION_COROUTINE  /* resume the Generator in target */
+};
 
+struct php_uv_promise_reaction_s {
+	int kind;
+	zval target;
+	zval key;
+	php_uv_cb_t *on_fulfilled;
+	php_uv_cb_t *on_rejected;
+	php_uv_promise_reaction_t *next;
+};
+
+struct php_uv_promise_timeout_s {
+	php_uv_internal_t internal;
+	uv_timer_t timer;
+	php_uv_promise_t *promise; /* holds a reference while the timer is armed */
 #ifdef ZTS
-	tsrm_set_interpreter_context(old);
+	void ***thread_ctx;
 #endif
-	//zend_fcall_info_args_clear(&uv->callback[type]->fci, 0);
+};
 
-	return error;
+static void php_uv_coroutine_step(zval *coroutine, zval *value);
+
+static zend_always_inline int php_uv_coroutine_finished(zval *coroutine)
+{
+	return ((zend_generator *) Z_OBJ_P(coroutine))->execute_data == NULL;
 }
 
-#ifdef ZTS
+static void php_uv_cb_free(php_uv_cb_t *cb)
+{
+	if (ZEND_FCI_INITIALIZED(cb->fci)) {
+		zval_ptr_dtor(&cb->fci.function_name);
+		if (cb->fci.object != NULL) {
+			OBJ_RELEASE(cb->fci.object);
+		}
+	}
 
-static int php_uv_do_callback3(zval *retval_ptr, php_uv_t *uv, zval *params, int param_count, enum php_uv_callback_type type)
+	efree(cb);
+}
+
+static php_uv_promise_reaction_t *php_uv_promise_reaction_new(int kind, zval *target)
 {
-	int error = 0;
-	void *tsrm_ls, *old;
-	zend_op_array *ops;
-	zend_function fn, *old_fn;
+	php_uv_promise_reaction_t *reaction = emalloc(sizeof(php_uv_promise_reaction_t));
 
-	if (ZEND_FCI_INITIALIZED(uv->callback[type]->fci)) {
-		tsrm_ls = tsrm_new_interpreter_context();
-		old = tsrm_set_interpreter_context(tsrm_ls);
+	reaction->kind = kind;
+	ZVAL_COPY(&reaction->target, target);
+	ZVAL_UNDEF(&reaction->key);
+	reaction->on_fulfilled = NULL;
+	reaction->on_rejected = NULL;
+	reaction->next = NULL;
 
-		PG(expose_php) = 0;
-		PG(auto_globals_jit) = 0;
+	return reaction;
+}
 
-		php_request_startup();
-		EG(current_execute_data) = NULL;
-		EG(current_module) = phpext_uv_ptr;
+static void php_uv_promise_reaction_free(php_uv_promise_reaction_t *reaction)
+{
+	zval_ptr_dtor(&reaction->target);
+	zval_ptr_dtor(&reaction->key);
+	if (reaction->on_fulfilled) {
+		php_uv_cb_free(reaction->on_fulfilled);
+	}
+	if (reaction->on_rejected) {
+		php_uv_cb_free(reaction->on_rejected);
+	}
+	efree(reaction);
+}
+
+static void php_uv_promise_timeout_close_cb(uv_handle_t *handle)
+{
+	efree(PHP_UV_CONTAINER_OF(handle, php_uv_promise_timeout_t, timer));
+}
 
-		uv->callback[type]->fci.params        = params;
-		uv->callback[type]->fci.retval        = retval_ptr;
-		uv->callback[type]->fci.param_count   = param_count;
-		uv->callback[type]->fci.no_separation = 1;
-		uv->callback[type]->fci.object = NULL;
-		uv->callback[type]->fcc.initialized = 1;
+/* stop the timer and drop its reference on the promise */
+static void php_uv_promise_timeout_cancel(php_uv_promise_timeout_t *timeout)
+{
+	php_uv_promise_t *promise = timeout->promise;
 
-		uv->callback[type]->fcc.calling_scope = NULL;
-		uv->callback[type]->fcc.called_scope = NULL;
-		uv->callback[type]->fcc.object = NULL;
+	timeout->promise = NULL;
+	promise->timeout = NULL;
+	uv_close((uv_handle_t *) &timeout->timer, php_uv_promise_timeout_close_cb);
+	OBJ_RELEASE(&promise->std);
+}
 
-		if (!ZEND_USER_CODE(uv->callback[type]->fcc.function_handler->type)) {
-			return error = -2;
-		}
+static void php_uv_promise_settle(php_uv_promise_t *promise, int state, zval *result);
 
-		fn = *(old_fn = uv->callback[type]->fcc.function_handler);
-		uv->callback[type]->fcc.function_handler = &fn;
+static void php_uv_promise_react(php_uv_promise_reaction_t *reaction, int state, zval *result)
+{
+	php_uv_promise_t *target = NULL;
 
-		ops = &fn.op_array;
-		ops->run_time_cache = NULL;
-		if (ops->fn_flags) {
-			ops->fn_flags &= ~ZEND_ACC_CLOSURE;
-			ops->prototype = NULL;
-		}
+	if (reaction->kind != PHP_UV_REACTION_COROUTINE) {
+		target = (php_uv_promise_t *) Z_OBJ(reaction->target);
+	}
 
-		zend_try {
-			if (zend_call_function(&uv->callback[type]->fci, &uv->callback[type]->fcc) != SUCCESS) {
-				error = -1;
+	switch (reaction->kind) {
+		case PHP_UV_REACTION_THEN:
+		{
+			php_uv_cb_t *handler = state == PHP_UV_PROMISE_FULFILLED ? reaction->on_fulfilled : reaction->on_rejected;
+			zval retval = {{0}};
+
+			if (handler == NULL) {
+				php_uv_promise_settle(target, state, result);
+				break;
+			}
+			if (UNEXPECTED(EG(exception) != NULL)) {
+				/* thrown by an earlier callback, it is left for uv_run()'s caller and the handler does not run */
+				break;
 			}
-		} zend_catch {
-			error = -1;
-		} zend_end_try();
 
-		if (ops->run_time_cache && !ops->function_name) {
-			efree(ops->run_time_cache);
+			if (php_uv_cb_call(handler, &retval, result, 1) != SUCCESS) {
+				ZVAL_NULL(&retval);
+			}
+			if (EG(exception)) {
+				zval exception;
+
+				/* the handler threw: the derived promise is rejected with the exception */
+				ZVAL_OBJ(&exception, EG(exception));
+				Z_ADDREF(exception);
+				zend_clear_exception();
+				php_uv_promise_settle(target, PHP_UV_PROMISE_REJECTED, &exception);
+				zval_ptr_dtor(&exception);
+			} else if (Z_TYPE(retval) == IS_OBJECT && Z_OBJCE(retval) == uv_promise_ce) {
+				php_uv_promise_t *inner = (php_uv_promise_t *) Z_OBJ(retval);
+
+				if (inner->state == PHP_UV_PROMISE_PENDING) {
+					*inner->reactions_tail = php_uv_promise_reaction_new(PHP_UV_REACTION_FORWARD, &reaction->target);
+					inner->reactions_tail = &(*inner->reactions_tail)->next;
+				} else {
+					php_uv_promise_settle(target, inner->state, &inner->result);
+				}
+			} else {
+				php_uv_promise_settle(target, PHP_UV_PROMISE_FULFILLED, &retval);
+			}
+			zval_ptr_dtor(&retval);
+			break;
 		}
+		case PHP_UV_REACTION_FORWARD:
+			php_uv_promise_settle(target, state, result);
+			break;
+		case PHP_UV_REACTION_ALL:
+			if (target->state != PHP_UV_PROMISE_PENDING) {
+				break;
+			}
+			if (state == PHP_UV_PROMISE_REJECTED) {
+				php_uv_promise_settle(target, state, result);
+				break;
+			}
+			SEPARATE_ARRAY(&target->result);
+			Z_TRY_ADDREF_P(result);
+			if (Z_TYPE(reaction->key) == IS_LONG) {
+				zend_hash_index_update(Z_ARRVAL(target->result), Z_LVAL(reaction->key), result);
+			} else {
+				zend_hash_update(Z_ARRVAL(target->result), Z_STR(reaction->key), result);
+			}
+			if (--target->pending == 0) {
+				php_uv_promise_settle(target, PHP_UV_PROMISE_FULFILLED, &target->result);
+			}
+			break;
+		case PHP_UV_REACTION_COROUTINE:
+			php_uv_coroutine_step(&reaction->target, result);
+			break;
+	}
+}
 
-		uv->callback[type]->fcc.function_handler = old_fn;
-
-		php_request_shutdown(NULL);
-		tsrm_set_interpreter_context(old);
-		tsrm_free_interpreter_context(tsrm_ls);
+/* run reaction now if the promise is settled, otherwise once it is */
+static void php_uv_promise_add_reaction(php_uv_promise_t *promise, php_uv_promise_reaction_t *reaction)
+{
+	if (promise->state == PHP_UV_PROMISE_PENDING) {
+		*promise->reactions_tail = reaction;
+		promise->reactions_tail = &reaction->next;
 	} else {
-		error = -2;
+		php_uv_promise_react(reaction, promise->state, &promise->result);
+		php_uv_promise_reaction_free(reaction);
 	}
-
-	//zend_fcall_info_args_clear(&uv->callback[type]->fci, 0);
-
-	return error;
 }
-#endif
 
-static void php_uv_tcp_connect_cb(uv_connect_t *req, int status)
+static void php_uv_promise_settle(php_uv_promise_t *promise, int state, zval *result)
 {
-	zval retval = {{0}};
-	zval params[2] = {{{0}}};
-	php_uv_t *uv = (php_uv_t *) req->data;
-	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
+	php_uv_promise_reaction_t *reaction, *next;
 
-	ZVAL_OBJ(&params[0], &uv->std);
-	ZVAL_LONG(&params[1], status);
+	if (promise->state != PHP_UV_PROMISE_PENDING) {
+		return;
+	}
 
-	php_uv_do_callback2(&retval, uv, params, 2, PHP_UV_CONNECT_CB TSRMLS_CC);
+	GC_REFCOUNT(&promise->std)++;
 
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_udp_tcp_cb, uv);
-	zval_ptr_dtor(&params[0]);
-	zval_ptr_dtor(&params[1]);
+	promise->state = state;
+	if (result != &promise->result) {
+		zval_ptr_dtor(&promise->result);
+		ZVAL_COPY(&promise->result, result);
+	}
 
-	zval_ptr_dtor(&retval);
-	efree(req);
+	if (promise->timeout) {
+		php_uv_promise_timeout_cancel(promise->timeout);
+	}
+
+	reaction = promise->reactions;
+	promise->reactions = NULL;
+	promise->reactions_tail = &promise->reactions;
+
+	while (reaction) {
+		next = reaction->next;
+		php_uv_promise_react(reaction, state, &promise->result);
+		php_uv_promise_reaction_free(reaction);
+		reaction = next;
+	}
+
+	OBJ_RELEASE(&promise->std);
 }
 
-/* TODO: Not sure how PHP will deal with int64_t */
-static void php_uv_process_close_cb(uv_process_t* process, int64_t exit_status, int term_signal)
+static void php_uv_promise_timeout_cb(uv_timer_t *handle)
 {
-	zval retval = {{0}};
-	zval params[3] = {{{0}}};
-	php_uv_t *uv = (php_uv_t*)process->data;
-	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
+	php_uv_promise_timeout_t *timeout = PHP_UV_CONTAINER_OF(handle, php_uv_promise_timeout_t, timer);
+	php_uv_promise_t *promise = timeout->promise;
+	zval result;
+	TSRMLS_FETCH_FROM_CTX(timeout->thread_ctx);
+	PHP_UV_CTX_ENTER();
 
-	ZVAL_OBJ(&params[0], &uv->std);
-	ZVAL_LONG(&params[1], exit_status);
-	ZVAL_LONG(&params[2], term_signal);
+	/* keep the timer's reference until the promise is settled */
+	timeout->promise = NULL;
+	promise->timeout = NULL;
+	uv_close((uv_handle_t *) handle, php_uv_promise_timeout_close_cb);
 
-	php_uv_do_callback2(&retval, uv, params, 3, PHP_UV_PROC_CLOSE_CB TSRMLS_CC);
+	ZVAL_LONG(&result, UV_ETIMEDOUT);
+	php_uv_promise_settle(promise, PHP_UV_PROMISE_REJECTED, &result);
+	OBJ_RELEASE(&promise->std);
 
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_process_close_cb, uv);
-	zval_ptr_dtor(&params[0]);
-	zval_ptr_dtor(&params[1]);
-	zval_ptr_dtor(&params[2]);
-
-	zval_ptr_dtor(&retval);
+	PHP_UV_CTX_LEAVE();
 }
 
+static void php_uv_promise_timeout_dispose(php_uv_internal_t *internal)
+{
+	/* the loop goes away: the promise stays pending */
+	php_uv_promise_timeout_cancel(PHP_UV_CONTAINER_OF(internal, php_uv_promise_timeout_t, internal));
+}
 
-static void php_uv_pipe_connect_cb(uv_connect_t *req, int status)
+/* a request or handle started without a callback settles the returned promise */
+static void php_uv_promise_attach(php_uv_t *uv, zval *promise)
 {
-	zval retval = {{0}};
-	zval params[2] = {{{0}}};
-	php_uv_t *uv = (php_uv_t*)req->data;
-	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
+	object_init_ex(promise, uv_promise_ce);
+	ZVAL_COPY(&uv->awaiter, promise);
+}
 
-	ZVAL_LONG(&params[0], status);
-	ZVAL_OBJ(&params[1], &uv->std);
+/* what the awaiter of an operation gets: the callback's payload, or the negative error code. returns whether it failed */
+static int php_uv_await_result(php_uv_t *uv, enum php_uv_callback_type type, zval *params, int param_count, zval *result)
+{
+	zval *status = NULL, *value = param_count > 0 ? &params[param_count - 1] : NULL;
 
-	php_uv_do_callback2(&retval, uv, params, 2, PHP_UV_PIPE_CONNECT_CB TSRMLS_CC);
+	switch (type) {
+		case PHP_UV_FS_CB:
+			if (uv->uv.fs.result < 0) {
+				ZVAL_LONG(result, uv->uv.fs.result);
+				return 1;
+			}
+			switch (uv->uv.fs.fs_type) {
+				case UV_FS_FCHMOD:
+				case UV_FS_FCHOWN:
+				case UV_FS_FTRUNCATE:
+				case UV_FS_FDATASYNC:
+				case UV_FS_FSYNC:
+					ZVAL_TRUE(result);
+					return 0;
+				default:
+					break;
+			}
+			break;
+		case PHP_UV_GETADDR_CB:
+			status = &params[0];
+			break;
+		case PHP_UV_CONNECT_CB:
+			value = &params[0];
+			status = &params[1];
+			break;
+		case PHP_UV_PIPE_CONNECT_CB:
+			status = &params[0];
+			value = &params[1];
+			break;
+		default:
+			break;
+	}
 
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_pipe_connect_cb, uv);
-	zval_ptr_dtor(&params[0]);
-	zval_ptr_dtor(&params[1]);
+	if (status && Z_LVAL_P(status) != 0) {
+		ZVAL_COPY(result, status);
+		return 1;
+	}
 
-	zval_ptr_dtor(&retval);
-	efree(req);
+	if (value) {
+		ZVAL_COPY(result, value);
+	} else {
+		ZVAL_NULL(result);
+	}
+	return 0;
 }
 
-
-static void php_uv_walk_cb(uv_handle_t* handle, void* arg)
+/* suspend the coroutine on what it yielded. returns 0 and sets resume if it can go on right away */
+static int php_uv_coroutine_await(zval *coroutine, zval *yielded, zval *resume)
 {
-/*
-	zval retval = {{0}};
-	zval params[2] = {{{0}}};
-	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
+	php_uv_promise_t *promise;
+	php_uv_t *uv;
 
-	ZVAL_LONG(&params[0], status);
-	ZVAL_OBJ(&params[1], &uv->std);
+	if (Z_TYPE_P(yielded) == IS_OBJECT && Z_OBJCE_P(yielded) == uv_promise_ce) {
+		promise = (php_uv_promise_t *) Z_OBJ_P(yielded);
+	} else if (Z_TYPE_P(yielded) == IS_OBJECT && instanceof_function(Z_OBJCE_P(yielded), uv_ce)) {
+		uv = (php_uv_t *) Z_OBJ_P(yielded);
+		if (uv->await_type < 0 || PHP_UV_IS_DTORED(uv)) {
+			php_error_docref(NULL, E_WARNING, "%s has no pending operation to await, resuming with null", ZSTR_VAL(uv->std.ce->name));
+			return 0;
+		}
+		if (Z_ISUNDEF(uv->awaiter)) {
+			ZVAL_COPY(&uv->awaiter, coroutine);
+			return 1;
+		}
+		if (Z_OBJCE(uv->awaiter) != uv_promise_ce) {
+			php_error_docref(NULL, E_WARNING, "%s is already awaited by another coroutine, resuming with null", ZSTR_VAL(uv->std.ce->name));
+			return 0;
+		}
+		/* started without a callback: wait for its promise */
+		promise = (php_uv_promise_t *) Z_OBJ(uv->awaiter);
+	} else {
+		php_error_docref(NULL, E_WARNING, "coroutine yielded a value which can not be awaited, resuming with null");
+		return 0;
+	}
 
-	php_uv_do_callback2(&retval, uv, params, 2, PHP_UV_PIPE_CONNECT_CB TSRMLS_CC);
+	if (promise->state != PHP_UV_PROMISE_PENDING) {
+		ZVAL_COPY(resume, &promise->result);
+		return 0;
+	}
 
-	zval_ptr_dtor(&params[0]);
-	zval_ptr_dtor(&params[1]);
-	zval_ptr_dtor(&retval);
-	efree(req);
-*/
+	php_uv_promise_add_reaction(promise, php_uv_promise_reaction_new(PHP_UV_REACTION_COROUTINE, coroutine));
+	return 1;
 }
 
-static void php_uv_write_cb(uv_write_t* req, int status)
+/* run the coroutine until it waits for something or returns; value == NULL starts it */
+static void php_uv_coroutine_step(zval *coroutine, zval *value)
 {
-	write_req_t* wr = (write_req_t*) req;
-	zval retval = {{0}};
-	zval params[2] = {{{0}}};
-	php_uv_t *uv = (php_uv_t *) req->handle->data;
-	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
-
-	PHP_UV_DEBUG_PRINT("uv_write_cb: status: %d\n", status);
-
-	ZVAL_OBJ(&params[0], &uv->std);
-	ZVAL_LONG(&params[1], status);
+	zval yielded, resume;
 
-	php_uv_do_callback(&retval, wr->cb, params, 2 TSRMLS_CC);
+	if (value) {
+		zend_call_method_with_1_params(coroutine, zend_ce_generator, NULL, "send", &yielded, value);
+	} else {
+		zend_call_method_with_0_params(coroutine, zend_ce_generator, NULL, "current", &yielded);
+	}
 
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_write_cb, uv);
-	zval_ptr_dtor(&params[0]);
-	zval_ptr_dtor(&params[1]);
+	while (!EG(exception) && !php_uv_coroutine_finished(coroutine)) {
+		ZVAL_NULL(&resume);
+		if (php_uv_coroutine_await(coroutine, &yielded, &resume)) {
+			break;
+		}
 
-	zval_ptr_dtor(&retval);
+		zval_ptr_dtor(&yielded);
+		zend_call_method_with_1_params(coroutine, zend_ce_generator, NULL, "send", &yielded, &resume);
+		zval_ptr_dtor(&resume);
+	}
 
-	php_uv_free_write_req(wr);
+	zval_ptr_dtor(&yielded);
 }
 
-static void php_uv_udp_send_cb(uv_udp_send_t* req, int status)
+/* hand the outcome of the operation to whoever awaits it: a promise or a coroutine */
+static void php_uv_await_settle(php_uv_t *uv, enum php_uv_callback_type type, zval *params, int param_count)
 {
-	send_req_t* wr = (send_req_t*) req;
-	zval retval = {{0}};
-	zval params[2] = {{{0}}};
-	php_uv_t *uv = (php_uv_t *) req->data;
-	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
-
-	ZVAL_OBJ(&params[0], &uv->std);
-	ZVAL_LONG(&params[1], status);
+	zval awaiter, result;
+	int failed = php_uv_await_result(uv, type, params, param_count, &result);
 
-	php_uv_do_callback2(&retval, uv, params, 2, PHP_UV_SEND_CB TSRMLS_CC);
+	/* detach first: a coroutine may await this handle again right away */
+	ZVAL_COPY_VALUE(&awaiter, &uv->awaiter);
+	ZVAL_UNDEF(&uv->awaiter);
 
-	if (!uv_is_closing(&uv->uv.handle)) { /* send_cb is invoked *before* the handle is marked as inactive - uv_close() will thus *not* increment the refcount and we must then not delete the refcount here */
-		PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_udp_send_cb, uv);
-		zval_ptr_dtor(&params[0]);
+	if (Z_OBJCE(awaiter) == uv_promise_ce) {
+		php_uv_promise_settle((php_uv_promise_t *) Z_OBJ(awaiter), failed ? PHP_UV_PROMISE_REJECTED : PHP_UV_PROMISE_FULFILLED, &result);
+	} else {
+		php_uv_coroutine_step(&awaiter, &result);
 	}
-	zval_ptr_dtor(&params[1]);
 
-	zval_ptr_dtor(&retval);
+	zval_ptr_dtor(&result);
+	zval_ptr_dtor(&awaiter);
+}
 
-	if (wr->buf.base) {
-		efree(wr->buf.base);
+#if PHP_VERSION_ID >= 70300
+/* the root buffer grows while automatic collection is off, holding it back loses nothing.
+ * older collectors drop the roots they have no room for then, and their cycles leak:
+ * there uv_loop_gc_idle() only adds the idle collection */
+# define PHP_UV_GC_HOLD 1
+#endif
+
+static zend_always_inline php_uv_loop_t *php_uv_loop_of(php_uv_t *uv)
+{
+	zend_class_entry *ce = uv->std.ce;
+	uv_loop_t *loop;
+
+	/* requests keep their loop in different places, handles all in uv_handle_t */
+	if (ce == uv_fs_ce) {
+		loop = uv->uv.fs.loop;
+	} else if (ce == uv_addrinfo_ce) {
+		loop = uv->uv.addrinfo.loop;
+	} else if (ce == uv_work_ce) {
+		loop = uv->uv.work.loop;
+	} else {
+		loop = uv->uv.handle.loop;
 	}
-	efree(wr);
+
+	return PHP_UV_CONTAINER_OF(loop, php_uv_loop_t, loop);
 }
 
-static void php_uv_listen_cb(uv_stream_t* server, int status)
+/* bounded runs */
+static void php_uv_budget_charge(php_uv_budget_t *budget)
 {
-	zval retval = {{0}};
-	zval params[2] = {{{0}}};
-	php_uv_t *uv = (php_uv_t *) server->data;
-
-	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
+	if ((budget->callbacks > 0 && --budget->callbacks == 0) || (budget->deadline && uv_hrtime() >= budget->deadline)) {
+		budget->spent = 1;
+		if (budget->running) {
+			uv_stop(&budget->loop->loop);
+		}
+	}
+}
 
-	ZVAL_OBJ(&params[0], &uv->std);
-	++GC_REFCOUNT(&uv->std);
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_listen_cb, uv);
-	ZVAL_LONG(&params[1], status);
+static void php_uv_deferred_push(php_uv_loop_t *loop, php_uv_cb_t *cb, zval *params, int param_count)
+{
+	php_uv_deferred_t *deferred = emalloc(sizeof(php_uv_deferred_t));
+	int i;
 
-	php_uv_do_callback2(&retval, uv, params, 2, PHP_UV_LISTEN_CB TSRMLS_CC);
+	ZEND_ASSERT(param_count <= 4);
 
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_listen_cb, uv);
-	zval_ptr_dtor(&params[0]);
-	zval_ptr_dtor(&params[1]);
+	/* the handle may drop or replace its callback before the replay */
+	deferred->cb = php_uv_cb_init_dynamic(NULL, &cb->fci, &cb->fcc);
+	deferred->argc = param_count;
+	for (i = 0; i < param_count; i++) {
+		ZVAL_COPY(&deferred->args[i], &params[i]);
+	}
+	deferred->next = NULL;
 
-	zval_ptr_dtor(&retval);
+	*loop->deferred_tail = deferred;
+	loop->deferred_tail = &deferred->next;
 }
 
-static void php_uv_shutdown_cb(uv_shutdown_t* handle, int status)
+static void php_uv_deferred_free(php_uv_deferred_t *deferred)
 {
-	zval retval = {{0}};
-	zval params[2] = {{{0}}};
-	php_uv_t *uv = (php_uv_t *) handle->data;
-	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
+	int i;
 
-	ZVAL_OBJ(&params[0], &uv->std);
-	ZVAL_LONG(&params[1], status);
+	for (i = 0; i < deferred->argc; i++) {
+		zval_ptr_dtor(&deferred->args[i]);
+	}
+	php_uv_cb_free(deferred->cb);
+	efree(deferred);
+}
 
-	php_uv_do_callback2(&retval, uv, params, 2, PHP_UV_SHUTDOWN_CB TSRMLS_CC);
+static php_uv_deferred_t *php_uv_deferred_shift(php_uv_loop_t *loop)
+{
+	php_uv_deferred_t *deferred = loop->deferred;
 
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_shutdown_cb, uv);
-	zval_ptr_dtor(&params[0]);
-	zval_ptr_dtor(&params[1]);
+	loop->deferred = deferred->next;
+	if (loop->deferred == NULL) {
+		loop->deferred_tail = &loop->deferred;
+	}
 
-	zval_ptr_dtor(&retval);
+	return deferred;
 }
 
-static void php_uv_read_cb(uv_stream_t* handle, ssize_t nread, const uv_buf_t* buf)
+/* oldest first, until the budget (if any) is spent again */
+static void php_uv_deferred_replay(php_uv_loop_t *loop, php_uv_budget_t *budget)
 {
-	zval retval = {{0}};
-	zval params[3] = {{{0}}};
-	php_uv_t *uv = (php_uv_t *) handle->data;
-	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
+	while (loop->deferred && !EG(exception) && !(budget && budget->spent)) {
+		php_uv_deferred_t *deferred = php_uv_deferred_shift(loop);
+		zval retval = {{0}};
 
-	PHP_UV_DEBUG_PRINT("uv_read_cb\n");
+		php_uv_cb_call(deferred->cb, &retval, deferred->args, deferred->argc);
+		zval_ptr_dtor(&retval);
+		php_uv_deferred_free(deferred);
 
-	ZVAL_OBJ(&params[0], &uv->std);
-	if (nread > 0) { // uv disables itself when it reaches EOF/error
-		GC_REFCOUNT(&uv->std)++;
-		PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_read_cb, uv);
+		if (budget) {
+			php_uv_budget_charge(budget);
+		}
 	}
+}
 
-	ZVAL_LONG(&params[1], nread);
-	if (nread > 0) {
-		ZVAL_STRINGL(&params[2], buf->base, nread);
-	} else {
-		ZVAL_NULL(&params[2]);
+static void php_uv_loop_clear_deferred(php_uv_loop_t *loop)
+{
+	while (loop->deferred) {
+		php_uv_deferred_free(php_uv_deferred_shift(loop));
 	}
+}
 
-	php_uv_do_callback2(&retval, uv, params, 3, PHP_UV_READ_CB TSRMLS_CC);
-
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_read_cb, uv);
-	zval_ptr_dtor(&params[0]);
-	zval_ptr_dtor(&params[1]);
-	zval_ptr_dtor(&params[2]);
-
-	zval_ptr_dtor(&retval);
+/* watchdog */
+static void php_uv_watchdog_thread(void *arg)
+{
+	php_uv_watchdog_t *watchdog = (php_uv_watchdog_t *) arg;
 
-	if (buf->base) {
-		efree(buf->base);
+	uv_mutex_lock(&watchdog->lock);
+	while (!watchdog->stop) {
+		if (watchdog->entered && !watchdog->capture && uv_hrtime() - watchdog->entered >= watchdog->threshold) {
+			watchdog->capture = 1;
+#if PHP_VERSION_ID >= 70100
+			/* the loop's thread takes the backtrace from php_uv_interrupt_function() */
+			*watchdog->vm_interrupt = 1;
+#endif
+		}
+		uv_cond_timedwait(&watchdog->cond, &watchdog->lock, MAX(watchdog->threshold / 4, 1000000));
 	}
+	uv_mutex_unlock(&watchdog->lock);
 }
 
-/* unused
-static void php_uv_read2_cb(uv_pipe_t* handle, ssize_t nread, uv_buf_t buf, uv_handle_type pending)
+static void php_uv_watchdog_record(php_uv_watchdog_t *watchdog, uint64_t took, zval *trace)
 {
-	zval retval = {{0}};
-	zval params[4] = {{{0}}};
-	php_uv_t *uv = (php_uv_t*)handle->data;
-	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
+	zend_object *current = watchdog->current;
+	zval entry;
 
-	PHP_UV_DEBUG_PRINT("uv_read2_cb\n");
+	if (zend_hash_num_elements(Z_ARRVAL(watchdog->slow)) == PHP_UV_WATCHDOG_SLOW_MAX) {
+		zend_ulong oldest = 0;
 
-	ZVAL_OBJ(&params[0], &uv->std);
-	if (nread > 0) { // uv disables itself when it reaches EOF/error
-		GC_REFCOUNT(&uv->std)++;
-		PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_read2_cb, uv);
+		ZEND_HASH_FOREACH_NUM_KEY(Z_ARRVAL(watchdog->slow), oldest) {
+			break;
+		} ZEND_HASH_FOREACH_END();
+		zend_hash_index_del(Z_ARRVAL(watchdog->slow), oldest);
 	}
-	ZVAL_LONG(&params[1], nread);
-	if (nread > 0) {
-		ZVAL_STRINGL(&params[2], buf.base,nread);
+
+	array_init_size(&entry, 3);
+	if (current) {
+		add_assoc_str(&entry, "handle", zend_string_copy(current->ce->name));
 	} else {
-		ZVAL_NULL(&params[2]);
+		add_assoc_null(&entry, "handle");
 	}
-	ZVAL_LONG(&params[3], pending);
-
-	php_uv_do_callback2(&retval, uv, params, 4, PHP_UV_READ2_CB TSRMLS_CC);
-
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_read2_cb, uv);
-	zval_ptr_dtor(&params[0]);
-	zval_ptr_dtor(&params[1]);
-	zval_ptr_dtor(&params[2]);
-	zval_ptr_dtor(&params[3]);
-
-	zval_ptr_dtor(&retval);
-
-	if (buf.base) {
-		efree(buf.base);
+	add_assoc_double(&entry, "duration", took / 1000000.0);
+	if (trace) {
+		add_assoc_zval(&entry, "trace", trace);
+	} else {
+		add_assoc_null(&entry, "trace");
 	}
+	add_next_index_zval(&watchdog->slow, &entry);
 }
-*/
 
-static void php_uv_prepare_cb(uv_prepare_t* handle)
+#if PHP_VERSION_ID >= 70100
+static void (*php_uv_prev_interrupt_function)(zend_execute_data *execute_data);
+
+static void php_uv_interrupt_function(zend_execute_data *execute_data)
 {
-	zval retval = {{0}};
-	zval params[1];
-	php_uv_t *uv = (php_uv_t*)handle->data;
-	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
+	php_uv_watchdog_t *watchdog = UV_G(watchdog);
 
-	PHP_UV_DEBUG_PRINT("prepare_cb\n");
+	if (watchdog && !watchdog->captured) {
+		uint64_t entered;
+		zend_bool capture;
 
-	ZVAL_OBJ(&params[0], &uv->std);
-	GC_REFCOUNT(&uv->std)++;
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_prepare_cb, uv);
+		uv_mutex_lock(&watchdog->lock);
+		capture = watchdog->capture;
+		entered = watchdog->entered;
+		uv_mutex_unlock(&watchdog->lock);
 
-	php_uv_do_callback2(&retval, uv, params, 1, PHP_UV_PREPARE_CB TSRMLS_CC);
+		if (capture) {
+			zval trace;
 
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_prepare_cb, uv);
-	zval_ptr_dtor(&params[0]);
+			watchdog->captured = 1;
+			zend_fetch_debug_backtrace(&trace, 0, DEBUG_BACKTRACE_IGNORE_ARGS, 0);
+			php_uv_watchdog_record(watchdog, uv_hrtime() - entered, &trace);
+		}
+	}
 
-	zval_ptr_dtor(&retval);
+	if (php_uv_prev_interrupt_function) {
+		php_uv_prev_interrupt_function(execute_data);
+	}
 }
+#endif
 
-static void php_uv_check_cb(uv_check_t* handle)
+static void php_uv_watchdog_enter(php_uv_watchdog_t *watchdog, zend_object *current)
 {
-	zval retval = {{0}};
-	zval params[1];
-	php_uv_t *uv = (php_uv_t*)handle->data;
-	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
+	uint64_t now = uv_hrtime();
 
-	PHP_UV_DEBUG_PRINT("check_cb\n");
+	uv_mutex_lock(&watchdog->lock);
+	watchdog->entered = now;
+	watchdog->capture = 0;
+	uv_mutex_unlock(&watchdog->lock);
 
-	ZVAL_OBJ(&params[0], &uv->std);
-	GC_REFCOUNT(&uv->std)++;
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_check_cb, uv);
+	watchdog->current = current;
+	watchdog->captured = 0;
+	UV_G(watchdog) = watchdog;
+}
 
-	php_uv_do_callback2(&retval, uv, params, 1, PHP_UV_CHECK_CB TSRMLS_CC);
+static void php_uv_watchdog_leave(php_uv_watchdog_t *watchdog)
+{
+	uint64_t now = uv_hrtime(), took, ms;
+	int bucket = 0;
 
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_check_cb, uv);
-	zval_ptr_dtor(&params[0]);
+	uv_mutex_lock(&watchdog->lock);
+	took = now - watchdog->entered;
+	watchdog->entered = 0;
+	uv_mutex_unlock(&watchdog->lock);
+	UV_G(watchdog) = NULL;
 
-	zval_ptr_dtor(&retval);
-}
+	for (ms = took / 1000000; ms && bucket < PHP_UV_WATCHDOG_BUCKETS - 1; ms >>= 1) {
+		bucket++;
+	}
+	watchdog->histogram[bucket]++;
+	if (took > watchdog->max) {
+		watchdog->max = took;
+	}
 
+	if (took >= watchdog->threshold) {
+		watchdog->slow_count++;
+		if (watchdog->captured) {
+			/* the entry was added mid-callback, complete its duration */
+			zval *entry = zend_hash_index_find(Z_ARRVAL(watchdog->slow), Z_ARRVAL(watchdog->slow)->nNextFreeElement - 1);
+			if (entry) {
+				add_assoc_double(entry, "duration", took / 1000000.0);
+			}
+		} else {
+			php_uv_watchdog_record(watchdog, took, NULL);
+		}
+	}
+	watchdog->current = NULL;
+}
 
-static void php_uv_async_cb(uv_async_t* handle)
+static void php_uv_watchdog_stop(php_uv_loop_t *loop)
 {
-	zval retval = {{0}};
-	zval params[1];
-	php_uv_t *uv = (php_uv_t*)handle->data;
-	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
-
-	PHP_UV_DEBUG_PRINT("async_cb\n");
-
-	ZVAL_OBJ(&params[0], &uv->std);
-	GC_REFCOUNT(&uv->std)++;
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_async_cb, uv);
+	php_uv_watchdog_t *watchdog = loop->watchdog;
 
-	php_uv_do_callback2(&retval, uv, params, 1, PHP_UV_ASYNC_CB TSRMLS_CC);
+	if (!watchdog) {
+		return;
+	}
+	loop->watchdog = NULL;
 
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_async_cb, uv);
-	zval_ptr_dtor(&params[0]);
+	uv_mutex_lock(&watchdog->lock);
+	watchdog->stop = 1;
+	uv_cond_signal(&watchdog->cond);
+	uv_mutex_unlock(&watchdog->lock);
+	uv_thread_join(&watchdog->thread);
 
-	zval_ptr_dtor(&retval);
+	if (UV_G(watchdog) == watchdog) {
+		UV_G(watchdog) = NULL;
+	}
+	uv_cond_destroy(&watchdog->cond);
+	uv_mutex_destroy(&watchdog->lock);
+	zval_ptr_dtor(&watchdog->slow);
+	efree(watchdog);
 }
 
-#ifdef ZTS
-static void php_uv_work_cb(uv_work_t* req)
+/* callback */
+static int php_uv_do_callback(zval *retval_ptr, php_uv_cb_t *callback, zval *params, int param_count TSRMLS_DC)
 {
-	zval retval = {{0}};
-	php_uv_t *uv = (php_uv_t*)req->data;
+	int error;
+	PHP_UV_CTX_ENTER();
 
-	uv = (php_uv_t*)req->data;
+	if (ZEND_FCI_INITIALIZED(callback->fci)) {
+		error = php_uv_cb_call(callback, retval_ptr, params, param_count);
+	} else {
+		error = -1;
+	}
 
-	PHP_UV_DEBUG_PRINT("work_cb\n");
+	PHP_UV_CTX_LEAVE();
 
-	php_uv_do_callback3(&retval, uv, NULL, 0, PHP_UV_WORK_CB);
+	return error;
 }
 
-static void php_uv_after_work_cb(uv_work_t* req, int status)
+/* under the budget and watchdog of the loop; 1 when the budget is spent and the call was deferred */
+static int php_uv_dispatch(php_uv_loop_t *loop, zend_object *current, php_uv_cb_t *cb, zval *retval_ptr, zval *params, int param_count)
 {
-	zval retval = {{0}};
-	php_uv_t *uv = (php_uv_t*)req->data;
-	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
-
-	uv = (php_uv_t*)req->data;
-
-	PHP_UV_DEBUG_PRINT("after_work_cb\n");
+	php_uv_budget_t *budget = loop->budget;
+#ifdef PHP_UV_GC_HOLD
+	zend_bool gc_held = loop->gc_idle, gc_enabled = 0;
+#endif
+	int error = 0;
 
-	php_uv_do_callback2(&retval, uv, NULL, 0, PHP_UV_AFTER_WORK_CB TSRMLS_CC);
+	if (UNEXPECTED(budget != NULL) && budget->spent) {
+		php_uv_deferred_push(loop, cb, params, param_count);
+		return 1;
+	}
+#ifdef PHP_UV_GC_HOLD
+	if (UNEXPECTED(gc_held)) {
+		/* collected by php_uv_gc_idle_cb() once the loop has nothing to do */
+		gc_enabled = gc_enable(0);
+	}
+#endif
+	if (EXPECTED(loop->watchdog == NULL)) {
+		if (php_uv_cb_call(cb, retval_ptr, params, param_count) != SUCCESS) {
+			error = -1;
+		}
+	} else {
+		php_uv_watchdog_t *watchdog = loop->watchdog;
 
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_after_work_cb, uv);
+		php_uv_watchdog_enter(watchdog, current);
+		if (php_uv_cb_call(cb, retval_ptr, params, param_count) != SUCCESS) {
+			error = -1;
+		}
+		/* the callback may have stopped the watchdog */
+		if (loop->watchdog == watchdog) {
+			php_uv_watchdog_leave(watchdog);
+		}
+	}
+#ifdef PHP_UV_GC_HOLD
+	if (UNEXPECTED(gc_held)) {
+		gc_enable(gc_enabled);
+	}
+#endif
+	if (UNEXPECTED(budget != NULL)) {
+		php_uv_budget_charge(budget);
+	}
 
-	/* as uv_cancel inside destruct_uv will return EBUSY here as were still in the work callback, but freeing is safe here */
-	clean_uv_handle(uv); /* this avoids a cancel */
-	OBJ_RELEASE(&uv->std);
+	return error;
 }
-#endif
 
-static void php_uv_fs_cb(uv_fs_t* req)
+static int php_uv_do_callback2(zval *retval_ptr, php_uv_t *uv, zval *params, int param_count, enum php_uv_callback_type type TSRMLS_DC)
 {
-	zval params[3] = {{{0}}};
-	zval retval = {{0}};
-	php_uv_t *uv = (php_uv_t*)req->data;
-	int argc, i = 0;
-	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
+	int error = 0;
+	php_uv_cb_t *cb;
+	php_uv_loop_t *loop = php_uv_loop_of(uv);
+	PHP_UV_CTX_ENTER();
 
-	PHP_UV_DEBUG_PRINT("# php_uv_fs_cb %p\n", uv);
+	loop->callbacks[uv->layout->index]++;
+	php_uv_gc_touch(uv);
 
-	if (PHP_UV_IS_DTORED(uv)) {
-		uv_fs_req_cleanup(req);
+	if (UNEXPECTED(!Z_ISUNDEF(uv->awaiter)) && type == uv->await_type) {
+		php_uv_await_settle(uv, type, params, param_count);
+		PHP_UV_CTX_LEAVE();
+		return 0;
+	}
 
-		OBJ_RELEASE(&uv->std);
-		return;
+	if (UNEXPECTED(uv->sink == PHP_UV_SINK_QUEUE)) {
+		php_uv_event_push(uv, type, params, param_count);
+		PHP_UV_CTX_LEAVE();
+		return 0;
 	}
 
-	if (!Z_ISUNDEF(uv->fs_fd)) {
-		if (uv->uv.fs.result < 0) {
-			ZVAL_FALSE(&params[0]);
-			zval_ptr_dtor(&uv->fs_fd);
-		} else {
-			ZVAL_COPY_VALUE(&params[0], &uv->fs_fd);
+	cb = php_uv_cb_get(uv, type);
+	if (cb && ZEND_FCI_INITIALIZED(cb->fci)) {
+		if (php_uv_dispatch(loop, &uv->std, cb, retval_ptr, params, param_count) < 0) {
+			error = -1;
 		}
-		ZVAL_UNDEF(&uv->fs_fd);
+	} else {
+		error = -2;
 	}
 
-	switch (uv->uv.fs.fs_type) {
-		case UV_FS_SYMLINK:
-		case UV_FS_LINK:
-		case UV_FS_CHMOD:
-		case UV_FS_RENAME:
-		case UV_FS_UNLINK:
-		case UV_FS_RMDIR:
-		case UV_FS_MKDIR:
-		case UV_FS_CLOSE:
-		case UV_FS_CHOWN:
-		case UV_FS_UTIME:
-		case UV_FS_FUTIME:
-			argc = 1;
-			ZVAL_BOOL(&params[0], uv->uv.fs.result == 0);
-			break;
+	PHP_UV_CTX_LEAVE();
 
-		case UV_FS_FCHMOD:
-		case UV_FS_FCHOWN:
-		case UV_FS_FTRUNCATE:
-		case UV_FS_FDATASYNC:
-		case UV_FS_FSYNC:
-			argc = 1;
-			if (uv->uv.fs.result < 0) {
-				zval_ptr_dtor(&params[0]);
-				ZVAL_FALSE(&params[0]);
-			}
-			break;
+	return error;
+}
 
-		case UV_FS_OPEN:
-			argc = 1;
-			if (uv->uv.fs.result < 0) {
-				ZVAL_FALSE(&params[0]);
-			} else {
-				PHP_UV_FD_TO_ZVAL(&params[0], uv->uv.fs.result)
-				PHP_UV_DEBUG_PRINT("Creating fs handle %p\n", Z_RES(params[0]));
-			}
-			break;
+#ifdef ZTS
 
-		case UV_FS_SCANDIR:
-			argc = 2;
-			if (uv->uv.fs.result < 0 || req->ptr == NULL) {
-				ZVAL_LONG(&params[1], uv->uv.fs.result);
-			} else {
-				uv_dirent_t dent;
+static int php_uv_do_callback3(zval *retval_ptr, php_uv_t *uv, zval *params, int param_count, enum php_uv_callback_type type)
+{
+	int error = 0;
+	void *tsrm_ls, *old;
+	zend_op_array *ops;
+	zend_function fn, *old_fn;
+	php_uv_cb_t *cb = php_uv_cb_get(uv, type);
 
-				ZVAL_TRUE(&params[0]); // wtf, but do not break BC
+	if (cb && ZEND_FCI_INITIALIZED(cb->fci)) {
+		tsrm_ls = tsrm_new_interpreter_context();
+		old = tsrm_set_interpreter_context(tsrm_ls);
 
-				array_init(&params[1]);
-				while (UV_EOF != uv_fs_scandir_next(req, &dent)) {
-					add_next_index_string(&params[1], dent.name);
-				}
-			}
-			break;
+		PG(expose_php) = 0;
+		PG(auto_globals_jit) = 0;
 
-		case UV_FS_LSTAT:
-		case UV_FS_STAT:
-			ZVAL_BOOL(&params[0], req->ptr != NULL);
-		case UV_FS_FSTAT:
-			argc = 2;
-			if (req->ptr != NULL) {
-				params[1] = php_uv_make_stat((const uv_stat_t *) req->ptr);
-			} else {
-				ZVAL_NULL(&params[1]);
-			}
-			break;
+		php_request_startup();
+		EG(current_execute_data) = NULL;
+		EG(current_module) = phpext_uv_ptr;
 
-		case UV_FS_READLINK:
-			argc = 2;
-			ZVAL_BOOL(&params[0], uv->uv.fs.result == 0);
-			ZVAL_STRING(&params[1], req->ptr);
-			break;
+		cb->fci.params        = params;
+		cb->fci.retval        = retval_ptr;
+		cb->fci.param_count   = param_count;
+		cb->fci.no_separation = 1;
+		cb->fci.object = NULL;
+		cb->fcc.initialized = 1;
 
-		case UV_FS_READ:
-			argc = 3;
-			if (uv->uv.fs.result >= 0) {
-				ZVAL_STRINGL(&params[2], uv->buffer, uv->uv.fs.result);
-			} else {
-				ZVAL_NULL(&params[2]);
-			}
-			ZVAL_LONG(&params[1], uv->uv.fs.result);
-			efree(uv->buffer);
-			break;
+		cb->fcc.calling_scope = NULL;
+		cb->fcc.called_scope = NULL;
+		cb->fcc.object = NULL;
 
-		case UV_FS_SENDFILE:
-			argc = 2;
-			ZVAL_LONG(&params[1], uv->uv.fs.result);
-			break;
+		if (!ZEND_USER_CODE(cb->fcc.function_handler->type)) {
+			return error = -2;
+		}
 
-		case UV_FS_WRITE:
-			argc = 2;
-			ZVAL_LONG(&params[1], uv->uv.fs.result);
-			efree(uv->buffer);
-			break;
+		fn = *(old_fn = cb->fcc.function_handler);
+		cb->fcc.function_handler = &fn;
 
-		case UV_FS_UNKNOWN:
-		case UV_FS_CUSTOM:
-		default:
-			argc = 0;
-			php_error_docref(NULL, E_ERROR, "type; %d does not support yet.", uv->uv.fs.fs_type);
-			break;
-	}
+		ops = &fn.op_array;
+		ops->run_time_cache = NULL;
+		if (ops->fn_flags) {
+			ops->fn_flags &= ~ZEND_ACC_CLOSURE;
+			ops->prototype = NULL;
+		}
 
-	php_uv_do_callback2(&retval, uv, params, argc, PHP_UV_FS_CB TSRMLS_CC);
+		zend_try {
+			if (zend_call_function(&cb->fci, &cb->fcc) != SUCCESS) {
+				error = -1;
+			}
+		} zend_catch {
+			error = -1;
+		} zend_end_try();
 
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_fs_cb, uv);
-	for (i = 0; i < argc; i++) {
-		zval_ptr_dtor(&params[i]);
-	}
+		if (ops->run_time_cache && !ops->function_name) {
+			efree(ops->run_time_cache);
+		}
 
-	zval_ptr_dtor(&retval);
+		cb->fcc.function_handler = old_fn;
 
-	if (!Z_ISUNDEF(uv->fs_fd_alt)) {
-		zval_ptr_dtor(&uv->fs_fd_alt);
-		ZVAL_UNDEF(&uv->fs_fd_alt);
+		php_request_shutdown(NULL);
+		tsrm_set_interpreter_context(old);
+		tsrm_free_interpreter_context(tsrm_ls);
+	} else {
+		error = -2;
 	}
 
-	uv_fs_req_cleanup(req);
+	//zend_fcall_info_args_clear(&cb->fci, 0);
 
-	clean_uv_handle(uv);
-	OBJ_RELEASE(&uv->std);
+	return error;
 }
+#endif
 
-static void php_uv_fs_event_cb(uv_fs_event_t* req, const char* filename, int events, int status)
+static void php_uv_tcp_connect_cb(uv_connect_t *req, int status)
 {
-	zval params[4] = {{{0}}};
 	zval retval = {{0}};
-	php_uv_t *uv = (php_uv_t*)req->data;
+	zval params[2] = {{{0}}};
+	php_uv_t *uv = (php_uv_t *) req->data;
 	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
 
-	PHP_UV_DEBUG_PRINT("fs_event_cb: %s, %d\n", filename, status);
-
 	ZVAL_OBJ(&params[0], &uv->std);
-	GC_REFCOUNT(&uv->std)++;
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_fs_event_cb, uv);
-	if (filename) {
-		ZVAL_STRING(&params[1], filename);
-	} else {
-		ZVAL_NULL(&params[1]);
-	}
-	ZVAL_LONG(&params[2], events);
-	ZVAL_LONG(&params[3], status);
+	ZVAL_LONG(&params[1], status);
 
-	php_uv_do_callback2(&retval, uv, params, 4, PHP_UV_FS_EVENT_CB TSRMLS_CC);
+	php_uv_do_callback2(&retval, uv, params, 2, PHP_UV_CONNECT_CB TSRMLS_CC);
 
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_fs_event_cb, uv);
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_udp_tcp_cb, uv);
 	zval_ptr_dtor(&params[0]);
 	zval_ptr_dtor(&params[1]);
-	zval_ptr_dtor(&params[2]);
-	zval_ptr_dtor(&params[3]);
 
 	zval_ptr_dtor(&retval);
+	efree(req);
 }
 
-static zval php_uv_stat_to_zval(const uv_stat_t *stat)
+/* TODO: Not sure how PHP will deal with int64_t */
+static void php_uv_process_close_cb(uv_process_t* process, int64_t exit_status, int term_signal)
 {
-	zval result = {{0}};
-	array_init(&result);
-
-	add_assoc_long_ex(&result, ZEND_STRL("dev"), stat->st_dev);
-	add_assoc_long_ex(&result, ZEND_STRL("ino"), stat->st_ino);
-	add_assoc_long_ex(&result, ZEND_STRL("mode"), stat->st_mode);
-	add_assoc_long_ex(&result, ZEND_STRL("nlink"), stat->st_nlink);
-	add_assoc_long_ex(&result, ZEND_STRL("uid"), stat->st_uid);
-	add_assoc_long_ex(&result, ZEND_STRL("gid"), stat->st_gid);
-	add_assoc_long_ex(&result, ZEND_STRL("rdev"), stat->st_rdev);
-	add_assoc_long_ex(&result, ZEND_STRL("size"), stat->st_size);
-
-#ifndef PHP_WIN32
-	add_assoc_long_ex(&result, ZEND_STRL("blksize"), stat->st_blksize);
-	add_assoc_long_ex(&result, ZEND_STRL("blocks"), stat->st_blocks);
-#endif
-
-	add_assoc_long_ex(&result, ZEND_STRL("atime"), stat->st_atim.tv_sec);
-	add_assoc_long_ex(&result, ZEND_STRL("mtime"), stat->st_mtim.tv_sec);
-	add_assoc_long_ex(&result, ZEND_STRL("ctime"), stat->st_ctim.tv_sec);
-
-	return result;
-}
-
-static void php_uv_fs_poll_cb(uv_fs_poll_t* handle, int status, const uv_stat_t* prev, const uv_stat_t* curr)
-{
-	zval params[4] = {{{0}}};
 	zval retval = {{0}};
-	php_uv_t *uv = (php_uv_t*)handle->data;
+	zval params[3] = {{{0}}};
+	php_uv_t *uv = (php_uv_t*)process->data;
 	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
 
 	ZVAL_OBJ(&params[0], &uv->std);
-	GC_REFCOUNT(&uv->std)++;
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_fs_poll_cb, uv);
-	ZVAL_LONG(&params[1], status);
-	params[2] = php_uv_stat_to_zval(prev);
-	params[3] = php_uv_stat_to_zval(curr);
+	ZVAL_LONG(&params[1], exit_status);
+	ZVAL_LONG(&params[2], term_signal);
 
-	php_uv_do_callback2(&retval, uv, params, 4, PHP_UV_FS_POLL_CB TSRMLS_CC);
+	php_uv_do_callback2(&retval, uv, params, 3, PHP_UV_PROC_CLOSE_CB TSRMLS_CC);
 
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_fs_poll_cb, uv);
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_process_close_cb, uv);
 	zval_ptr_dtor(&params[0]);
 	zval_ptr_dtor(&params[1]);
 	zval_ptr_dtor(&params[2]);
-	zval_ptr_dtor(&params[3]);
 
 	zval_ptr_dtor(&retval);
 }
 
-static void php_uv_poll_cb(uv_poll_t* handle, int status, int events)
+
+static void php_uv_pipe_connect_cb(uv_connect_t *req, int status)
 {
-	zval params[4] = {{{0}}};
 	zval retval = {{0}};
-	php_uv_t *uv = (php_uv_t*)handle->data;
+	zval params[2] = {{{0}}};
+	php_uv_t *uv = (php_uv_t*)req->data;
 	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
 
-	ZVAL_OBJ(&params[0], &uv->std);
-	if (status == 0) {
-		GC_REFCOUNT(&uv->std)++;
-	}
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_poll_cb, uv);
-	ZVAL_LONG(&params[1], status);
-	ZVAL_LONG(&params[2], events);
-	if (!Z_ISUNDEF(uv->fs_fd)) {
-		ZVAL_COPY(&params[3], &uv->fs_fd);
-	} else {
-		PHP_UV_FD_TO_ZVAL(&params[3], uv->sock);
-	}
+	ZVAL_LONG(&params[0], status);
+	ZVAL_OBJ(&params[1], &uv->std);
 
-	php_uv_do_callback2(&retval, uv, params, 4, PHP_UV_POLL_CB TSRMLS_CC);
+	php_uv_do_callback2(&retval, uv, params, 2, PHP_UV_PIPE_CONNECT_CB TSRMLS_CC);
 
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_poll_cb, uv);
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_pipe_connect_cb, uv);
 	zval_ptr_dtor(&params[0]);
 	zval_ptr_dtor(&params[1]);
-	zval_ptr_dtor(&params[2]);
-	zval_ptr_dtor(&params[3]);
 
 	zval_ptr_dtor(&retval);
+	efree(req);
 }
 
 
-static void php_uv_udp_recv_cb(uv_udp_t* handle, ssize_t nread, const uv_buf_t* buf, const struct sockaddr* addr, unsigned flags)
+static void php_uv_walk_cb(uv_handle_t* handle, void* arg)
 {
-	/* TODO: is this correctly implmented? */
+/*
 	zval retval = {{0}};
-	zval params[3] = {{{0}}};
-	php_uv_t *uv = (php_uv_t*)handle->data;
+	zval params[2] = {{{0}}};
 	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
 
-	ZVAL_OBJ(&params[0], &uv->std);
-	GC_REFCOUNT(&uv->std)++;
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_udp_recv_cb, uv);
-	ZVAL_LONG(&params[1], nread);
-	ZVAL_STRINGL(&params[2], buf->base, nread);
+	ZVAL_LONG(&params[0], status);
+	ZVAL_OBJ(&params[1], &uv->std);
 
-	php_uv_do_callback2(&retval, uv, params, 3, PHP_UV_RECV_CB TSRMLS_CC);
+	php_uv_do_callback2(&retval, uv, params, 2, PHP_UV_PIPE_CONNECT_CB TSRMLS_CC);
 
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_udp_recv_cb, uv);
 	zval_ptr_dtor(&params[0]);
 	zval_ptr_dtor(&params[1]);
-	zval_ptr_dtor(&params[2]);
-
 	zval_ptr_dtor(&retval);
+	efree(req);
+*/
+}
 
-	if (buf->base) {
-		efree(buf->base);
+static void php_uv_stream_timeouts_cb(uv_timer_t *handle);
+
+static void php_uv_stream_timeouts_close_cb(uv_handle_t *handle)
+{
+	php_uv_stream_timeouts_t *timeouts = PHP_UV_CONTAINER_OF(handle, php_uv_stream_timeouts_t, timer);
+
+	if (timeouts->callback) {
+		php_uv_cb_free(timeouts->callback);
 	}
+	efree(timeouts);
 }
 
-static void php_uv_read_alloc(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf)
+/* (re)starts the timer for the earliest deadline */
+static void php_uv_stream_timeouts_arm(php_uv_stream_timeouts_t *timeouts)
 {
-	buf->base = emalloc(suggested_size);
-	buf->len = suggested_size;
-	//return uv_buf_init(emalloc(suggested_size), suggested_size);
+	uint64_t now = uv_now(timeouts->timer.loop), next = 0;
+
+	if (timeouts->idle) {
+		next = timeouts->activity + timeouts->idle;
+	}
+	if (timeouts->read_deadline && (!next || timeouts->read_deadline < next)) {
+		next = timeouts->read_deadline;
+	}
+	if (timeouts->writes && timeouts->write_deadline && (!next || timeouts->write_deadline < next)) {
+		next = timeouts->write_deadline;
+	}
+
+	timeouts->due = next;
+	if (next) {
+		uv_timer_start(&timeouts->timer, php_uv_stream_timeouts_cb, next > now ? next - now : 0, 0);
+	} else {
+		uv_timer_stop(&timeouts->timer);
+	}
 }
 
-static void php_uv_close_cb(uv_handle_t *handle)
+static void php_uv_stream_timeouts_cb(uv_timer_t *handle)
 {
-	zval retval = {{0}};
-	zval params[1] = {{{0}}};
+	php_uv_stream_timeouts_t *timeouts = PHP_UV_CONTAINER_OF(handle, php_uv_stream_timeouts_t, timer);
+	php_uv_t *uv = timeouts->stream;
+	uint64_t now = uv_now(handle->loop);
+	zval params[2], retval;
+	int expired;
+	TSRMLS_FETCH_FROM_CTX(timeouts->thread_ctx);
 
-	php_uv_t *uv = (php_uv_t *) handle->data;
-	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
+	timeouts->due = 0;
+	if (timeouts->read_deadline && timeouts->read_deadline <= now) {
+		expired = PHP_UV_TIMEOUT_READ;
+	} else if (timeouts->writes && timeouts->write_deadline && timeouts->write_deadline <= now) {
+		expired = PHP_UV_TIMEOUT_WRITE;
+	} else if (timeouts->idle && timeouts->activity + timeouts->idle <= now) {
+		expired = PHP_UV_TIMEOUT_IDLE;
+	} else {
+		/* there was I/O since the timer was started */
+		php_uv_stream_timeouts_arm(timeouts);
+		return;
+	}
 
-	if (uv->callback[PHP_UV_CLOSE_CB]) {
-		ZVAL_OBJ(&params[0], (zend_object *) uv);
+	/* expires once, uv_stream_set_timeouts() starts over */
+	timeouts->idle = 0;
+	timeouts->write = 0;
+	timeouts->read_deadline = 0;
+	timeouts->write_deadline = 0;
 
-		php_uv_do_callback2(&retval, uv, params, 1, PHP_UV_CLOSE_CB TSRMLS_CC);
-		zval_ptr_dtor(&retval);
+	if (timeouts->callback == NULL) {
+		php_uv_close(uv);
+		return;
 	}
 
-	/* manually clean the uv handle as dtor will not be called anymore here */
-	clean_uv_handle(uv);
+	{
+		PHP_UV_CTX_ENTER();
 
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_close_cb, uv);
-	OBJ_RELEASE(&uv->std);
+		ZVAL_OBJ(&params[0], &uv->std);
+		Z_ADDREF(params[0]);
+		ZVAL_LONG(&params[1], expired);
+		if (php_uv_dispatch(php_uv_loop_of(uv), &uv->std, timeouts->callback, &retval, params, 2) == SUCCESS) {
+			zval_ptr_dtor(&retval);
+		}
+		zval_ptr_dtor(&params[0]);
+
+		PHP_UV_CTX_LEAVE();
+	}
 }
 
-static inline zend_bool php_uv_is_handle_referenced(php_uv_t *uv) {
-	zend_class_entry *ce = uv->std.ce;
+static void php_uv_stream_timeouts_dispose(php_uv_internal_t *internal)
+{
+	php_uv_stream_timeouts_t *timeouts = PHP_UV_CONTAINER_OF(internal, php_uv_stream_timeouts_t, internal);
 
-	return (ce == uv_signal_ce || ce == uv_timer_ce || ce == uv_idle_ce || ce == uv_udp_ce || ce == uv_tcp_ce || ce == uv_tty_ce || ce == uv_pipe_ce || ce == uv_prepare_ce || ce == uv_check_ce || ce == uv_poll_ce || ce == uv_fs_poll_ce) && uv_is_active(&uv->uv.handle);
+	if (timeouts->stream) {
+		timeouts->stream->timeouts = NULL;
+		timeouts->stream = NULL;
+	}
+	uv_close((uv_handle_t *) &timeouts->timer, php_uv_stream_timeouts_close_cb);
 }
 
-/* uv handle must not be cleaned or closed before called */
-static void php_uv_close(php_uv_t *uv) {
-	ZEND_ASSERT(!uv_is_closing(&uv->uv.handle));
+/* the stream is closing or its deadlines were removed */
+static void php_uv_stream_timeouts_stop(php_uv_t *uv)
+{
+	php_uv_stream_timeouts_t *timeouts = uv->timeouts;
 
-	if (!php_uv_is_handle_referenced(uv)) {
-		++GC_REFCOUNT(&uv->std);
-		PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(php_uv_close, uv);
-	}
+	uv->timeouts = NULL;
+	timeouts->stream = NULL;
+	uv_close((uv_handle_t *) &timeouts->timer, php_uv_stream_timeouts_close_cb);
+}
 
-	uv_close(&uv->uv.handle, php_uv_close_cb);
+static void php_uv_stream_timeouts_write_start(php_uv_stream_timeouts_t *timeouts)
+{
+	if (timeouts->writes++ == 0 && timeouts->write) {
+		timeouts->write_deadline = uv_now(timeouts->timer.loop) + timeouts->write;
+		if (!timeouts->due || timeouts->write_deadline < timeouts->due) {
+			php_uv_stream_timeouts_arm(timeouts);
+		}
+	}
+}
 
-	PHP_UV_SKIP_DTOR(uv);
+static void php_uv_stream_timeouts_write_done(php_uv_stream_timeouts_t *timeouts)
+{
+	/* writes started before the deadlines were set are not counted */
+	if (timeouts->writes > 0) {
+		timeouts->writes--;
+	}
+	timeouts->activity = uv_now(timeouts->timer.loop);
+	/* a completed write is progress: the next pending one gets the full time */
+	timeouts->write_deadline = timeouts->writes && timeouts->write ? timeouts->activity + timeouts->write : 0;
 }
 
-static void php_uv_idle_cb(uv_timer_t *handle)
+static void php_uv_write_cb(uv_write_t* req, int status)
 {
+	write_req_t* wr = (write_req_t*) req;
 	zval retval = {{0}};
-	zval params[1] = {{{0}}};
-
-	php_uv_t *uv = (php_uv_t*)handle->data;
+	zval params[2] = {{{0}}};
+	php_uv_t *uv = (php_uv_t *) req->handle->data;
 	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
 
+	PHP_UV_DEBUG_PRINT("uv_write_cb: status: %d\n", status);
+
+	if (uv->timeouts) {
+		php_uv_stream_timeouts_write_done(uv->timeouts);
+	}
+
 	ZVAL_OBJ(&params[0], &uv->std);
-	GC_REFCOUNT(&uv->std)++;
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(php_uv_idle_cb, uv);
+	ZVAL_LONG(&params[1], status);
 
-	php_uv_do_callback2(&retval, uv, params, 1, PHP_UV_IDLE_CB TSRMLS_CC);
+	if (uv->sink == PHP_UV_SINK_QUEUE) {
+		php_uv_event_push(uv, PHP_UV_WRITE_CB, params, 2);
+	} else {
+		php_uv_do_callback(&retval, wr->cb, params, 2 TSRMLS_CC);
+	}
 
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(php_uv_idle_cb, uv);
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_write_cb, uv);
 	zval_ptr_dtor(&params[0]);
+	zval_ptr_dtor(&params[1]);
 
 	zval_ptr_dtor(&retval);
+
+	php_uv_free_write_req(wr);
 }
 
-static void php_uv_getaddrinfo_cb(uv_getaddrinfo_t* handle, int status, struct addrinfo* res)
+static void php_uv_udp_send_cb(uv_udp_send_t* req, int status)
 {
+	send_req_t* wr = (send_req_t*) req->data;
 	zval retval = {{0}};
 	zval params[2] = {{{0}}};
-	struct addrinfo *address;
-	char ip[INET6_ADDRSTRLEN];
-	const char *addr;
-
-	php_uv_t *uv = (php_uv_t*)handle->data;
+	php_uv_t *uv = (php_uv_t *) req->handle->data;
 	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
 
-	ZVAL_LONG(&params[0], status);
-	array_init(&params[1]);
-
-	address = res;
-	while (address) {
-		if (address->ai_family == AF_INET) {
-			addr = (char*) &((struct sockaddr_in*) address->ai_addr)->sin_addr;
-			uv_inet_ntop(address->ai_family, addr, ip, INET6_ADDRSTRLEN);
-			add_next_index_string(&params[1], ip);
-		}
-
-		address = address->ai_next;
+	if (status && !wr->status) {
+		wr->status = status;
+	}
+	if (--wr->pending > 0) {
+		return;
 	}
 
-	address = res;
-	while (address) {
-		if (address->ai_family == AF_INET6) {
-			addr = (char*) &((struct sockaddr_in6*) address->ai_addr)->sin6_addr;
-			uv_inet_ntop(address->ai_family, addr, ip, INET6_ADDRSTRLEN);
-			add_next_index_string(&params[1], ip);
-		}
+	ZVAL_OBJ(&params[0], &uv->std);
+	ZVAL_LONG(&params[1], wr->status);
 
-		address = address->ai_next;
-	}
+	php_uv_do_callback2(&retval, uv, params, 2, PHP_UV_SEND_CB TSRMLS_CC);
 
-	php_uv_do_callback2(&retval, uv, params, 2, PHP_UV_GETADDR_CB TSRMLS_CC);
+	if (!uv_is_closing(&uv->uv.handle)) { /* send_cb is invoked *before* the handle is marked as inactive - uv_close() will thus *not* increment the refcount and we must then not delete the refcount here */
+		PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_udp_send_cb, uv);
+		zval_ptr_dtor(&params[0]);
+	}
+	zval_ptr_dtor(&params[1]);
 
 	zval_ptr_dtor(&retval);
-	zval_ptr_dtor(&params[0]);
-	zval_ptr_dtor(&params[1]);
 
-	uv_freeaddrinfo(res);
-	clean_uv_handle(uv);
-	OBJ_RELEASE(&uv->std);
+	if (wr->buf.base) {
+		efree(wr->buf.base);
+	}
+	efree(wr);
 }
 
-static void php_uv_timer_cb(uv_timer_t *handle)
+static void php_uv_listen_cb(uv_stream_t* server, int status)
 {
 	zval retval = {{0}};
-	zval params[1] = {{{0}}};
-	php_uv_t *uv = (php_uv_t*)handle->data;
+	zval params[2] = {{{0}}};
+	php_uv_t *uv = (php_uv_t *) server->data;
+
 	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
 
 	ZVAL_OBJ(&params[0], &uv->std);
+	++GC_REFCOUNT(&uv->std);
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_listen_cb, uv);
+	ZVAL_LONG(&params[1], status);
 
-	if (handle->repeat) {
-		GC_REFCOUNT(&uv->std)++;
-		PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(php_uv_timer_cb, uv);
-	}
-
-	php_uv_do_callback2(&retval, uv, params, 1, PHP_UV_TIMER_CB TSRMLS_CC);
+	php_uv_do_callback2(&retval, uv, params, 2, PHP_UV_LISTEN_CB TSRMLS_CC);
 
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(php_uv_timer_cb, uv);
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_listen_cb, uv);
 	zval_ptr_dtor(&params[0]);
+	zval_ptr_dtor(&params[1]);
 
 	zval_ptr_dtor(&retval);
 }
 
-static void php_uv_signal_cb(uv_signal_t *handle, int sig_num)
+static void php_uv_shutdown_cb(uv_shutdown_t* handle, int status)
 {
 	zval retval = {{0}};
 	zval params[2] = {{{0}}};
-	php_uv_t *uv = (php_uv_t*)handle->data;
+	php_uv_t *uv = (php_uv_t *) handle->data;
 	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
 
 	ZVAL_OBJ(&params[0], &uv->std);
-	GC_REFCOUNT(&uv->std)++;
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(php_uv_signal_cb, uv);
-	ZVAL_LONG(&params[1], sig_num);
+	ZVAL_LONG(&params[1], status);
 
-	php_uv_do_callback2(&retval, uv, params, 2, PHP_UV_SIGNAL_CB TSRMLS_CC);
+	php_uv_do_callback2(&retval, uv, params, 2, PHP_UV_SHUTDOWN_CB TSRMLS_CC);
 
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(php_uv_signal_cb, uv);
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_shutdown_cb, uv);
 	zval_ptr_dtor(&params[0]);
 	zval_ptr_dtor(&params[1]);
 
 	zval_ptr_dtor(&retval);
 }
 
-void static destruct_uv_stdio(zend_object *obj)
+static void php_uv_read_cb(uv_stream_t* handle, ssize_t nread, const uv_buf_t* buf)
 {
-	php_uv_stdio_t *stdio = (php_uv_stdio_t *) obj;
-
-	zval_ptr_dtor(&stdio->stream);
-}
+	zval retval = {{0}};
+	zval params[3] = {{{0}}};
+	php_uv_t *uv = (php_uv_t *) handle->data;
+	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
 
+	PHP_UV_DEBUG_PRINT("uv_read_cb\n");
 
-/* common functions */
+	if (nread > 0 && uv->timeouts) {
+		uv->timeouts->activity = uv_now(handle->loop);
+	}
 
-static void php_uv_ip_common(int ip_type, INTERNAL_FUNCTION_PARAMETERS)
-{
-	php_uv_sockaddr_t *addr;
-	char ip[INET6_ADDRSTRLEN];
+	ZVAL_OBJ(&params[0], &uv->std);
+	if (nread > 0) { // uv disables itself when it reaches EOF/error
+		GC_REFCOUNT(&uv->std)++;
+		PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_read_cb, uv);
+	}
 
-	ZEND_PARSE_PARAMETERS_START(1, 1)
-		UV_PARAM_OBJ(addr, php_uv_sockaddr_t, (ip_type == 1) ? uv_sockaddr_ipv4_ce : uv_sockaddr_ipv6_ce)
-	ZEND_PARSE_PARAMETERS_END();
-
-	if (ip_type == 1) {
-		uv_ip4_name(PHP_UV_SOCKADDR_IPV4_P(addr), ip, INET6_ADDRSTRLEN);
+	ZVAL_LONG(&params[1], nread);
+	if (nread > 0) {
+		ZVAL_STRINGL(&params[2], buf->base, nread);
 	} else {
-		uv_ip6_name(PHP_UV_SOCKADDR_IPV6_P(addr), ip, INET6_ADDRSTRLEN);
+		ZVAL_NULL(&params[2]);
 	}
-	RETVAL_STRING(ip);
-}
 
-static void php_uv_socket_bind(enum php_uv_socket_type ip_type, INTERNAL_FUNCTION_PARAMETERS)
-{
-	php_uv_sockaddr_t *addr;
-	php_uv_t *uv;
-	zend_long flags = 0;
-	int r;
+	php_uv_do_callback2(&retval, uv, params, 3, PHP_UV_READ_CB TSRMLS_CC);
 
-	if (ip_type & PHP_UV_UDP) {
-		ZEND_PARSE_PARAMETERS_START(2, 3)
-			UV_PARAM_OBJ(uv, php_uv_t, uv_udp_ce)
-			UV_PARAM_OBJ(addr, php_uv_sockaddr_t, (ip_type == PHP_UV_UDP_IPV4) ? uv_sockaddr_ipv4_ce : uv_sockaddr_ipv6_ce)
-			Z_PARAM_OPTIONAL
-			Z_PARAM_LONG(flags)
-		ZEND_PARSE_PARAMETERS_END();
-	} else {
-		ZEND_PARSE_PARAMETERS_START(2, 2)
-			UV_PARAM_OBJ(uv, php_uv_t, uv_tcp_ce)
-			UV_PARAM_OBJ(addr, php_uv_sockaddr_t, (ip_type == PHP_UV_TCP_IPV4) ? uv_sockaddr_ipv4_ce : uv_sockaddr_ipv6_ce)
-		ZEND_PARSE_PARAMETERS_END();
-	}
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_read_cb, uv);
+	zval_ptr_dtor(&params[0]);
+	zval_ptr_dtor(&params[1]);
+	zval_ptr_dtor(&params[2]);
 
-	switch (ip_type) {
-		case PHP_UV_TCP_IPV4:
-			r = uv_tcp_bind((uv_tcp_t*)&uv->uv.tcp, (const struct sockaddr*)&PHP_UV_SOCKADDR_IPV4(addr), 0);
-			break;
-		case PHP_UV_TCP_IPV6:
-			r = uv_tcp_bind((uv_tcp_t*)&uv->uv.tcp, (const struct sockaddr*)&PHP_UV_SOCKADDR_IPV6(addr), 0);
-			break;
-		case PHP_UV_UDP_IPV4:
-			r = uv_udp_bind((uv_udp_t*)&uv->uv.udp, (const struct sockaddr*)&PHP_UV_SOCKADDR_IPV4(addr), flags);
-			break;
-		case PHP_UV_UDP_IPV6:
-			r = uv_udp_bind((uv_udp_t*)&uv->uv.udp, (const struct sockaddr*)&PHP_UV_SOCKADDR_IPV6(addr), flags);
-			break;
-		default:
-			php_error_docref(NULL, E_ERROR, "unhandled type");
-			return;
-	}
+	zval_ptr_dtor(&retval);
 
-	if (r) {
-		php_error_docref(NULL, E_WARNING, "bind failed");
-		RETURN_FALSE;
-	} else {
-		RETURN_TRUE;
+	if (buf->base) {
+		efree(buf->base);
 	}
 }
 
-static void php_uv_socket_getname(int type, INTERNAL_FUNCTION_PARAMETERS)
+/* unused
+static void php_uv_read2_cb(uv_pipe_t* handle, ssize_t nread, uv_buf_t buf, uv_handle_type pending)
 {
-	php_uv_t *uv;
-	zval result;
-	int addr_len;
-	struct sockaddr_storage addr;
-	addr_len = sizeof(struct sockaddr_storage);
+	zval retval = {{0}};
+	zval params[4] = {{{0}}};
+	php_uv_t *uv = (php_uv_t*)handle->data;
+	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
 
-	ZEND_PARSE_PARAMETERS_START(1, 1)
-		UV_PARAM_OBJ(uv, php_uv_t, type == 3 ? uv_udp_ce : uv_tcp_ce)
-	ZEND_PARSE_PARAMETERS_END();
+	PHP_UV_DEBUG_PRINT("uv_read2_cb\n");
 
-	switch (type) {
-		case 1:
-			uv_tcp_getsockname(&uv->uv.tcp, (struct sockaddr*)&addr, &addr_len);
-			break;
-		case 2:
-			uv_tcp_getpeername(&uv->uv.tcp, (struct sockaddr*)&addr, &addr_len);
-			break;
-		case 3:
-			uv_udp_getsockname(&uv->uv.udp, (struct sockaddr*)&addr, &addr_len);
-			break;
-		default:
-			php_error_docref(NULL, E_ERROR, "unexpected type");
-		break;
+	ZVAL_OBJ(&params[0], &uv->std);
+	if (nread > 0) { // uv disables itself when it reaches EOF/error
+		GC_REFCOUNT(&uv->std)++;
+		PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_read2_cb, uv);
 	}
+	ZVAL_LONG(&params[1], nread);
+	if (nread > 0) {
+		ZVAL_STRINGL(&params[2], buf.base,nread);
+	} else {
+		ZVAL_NULL(&params[2]);
+	}
+	ZVAL_LONG(&params[3], pending);
 
-	result = php_uv_address_to_zval((struct sockaddr*)&addr);
-	RETURN_ZVAL(&result, 0, 1);
-}
-
-static void php_uv_handle_open(int (*open_cb)(uv_handle_t *, long), zend_class_entry *ce, INTERNAL_FUNCTION_PARAMETERS) {
-	php_uv_t *uv;
-	zend_long fd; // file handle
-	int error;
-
-	ZEND_PARSE_PARAMETERS_START(2, 2)
-		UV_PARAM_OBJ(uv, php_uv_t, ce)
-		Z_PARAM_LONG(fd)
-	ZEND_PARSE_PARAMETERS_END();
+	php_uv_do_callback2(&retval, uv, params, 4, PHP_UV_READ2_CB TSRMLS_CC);
 
-	if (fd < 0) {
-		php_error_docref(NULL, E_WARNING, "file descriptor must be unsigned value");
-		RETURN_FALSE;
-	}
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_read2_cb, uv);
+	zval_ptr_dtor(&params[0]);
+	zval_ptr_dtor(&params[1]);
+	zval_ptr_dtor(&params[2]);
+	zval_ptr_dtor(&params[3]);
 
-	error = open_cb(&uv->uv.handle, fd);
+	zval_ptr_dtor(&retval);
 
-	if (error) {
-		php_error_docref(NULL, E_WARNING, "%s", php_uv_strerror(error));
+	if (buf.base) {
+		efree(buf.base);
 	}
-
-	RETURN_LONG(error);
 }
+*/
 
-static void php_uv_udp_send(int type, INTERNAL_FUNCTION_PARAMETERS)
+static void php_uv_prepare_cb(uv_prepare_t* handle)
 {
-	zend_string *data;
-	php_uv_t *uv;
-	send_req_t *w;
-	php_uv_sockaddr_t *addr;
-	zend_fcall_info fci       = empty_fcall_info;
-	zend_fcall_info_cache fcc = empty_fcall_info_cache;
-	php_uv_cb_t *cb;
+	zval retval = {{0}};
+	zval params[1];
+	php_uv_t *uv = (php_uv_t*)handle->data;
+	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
 
-	ZEND_PARSE_PARAMETERS_START(3, 4)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_udp_ce)
-		Z_PARAM_STR(data)
-		UV_PARAM_OBJ(addr, php_uv_sockaddr_t, (type == 1) ? uv_sockaddr_ipv4_ce : uv_sockaddr_ipv6_ce)
-		Z_PARAM_OPTIONAL
-		Z_PARAM_FUNC_EX(fci, fcc, 1, 0)
-	ZEND_PARSE_PARAMETERS_END();
+	PHP_UV_DEBUG_PRINT("prepare_cb\n");
 
+	ZVAL_OBJ(&params[0], &uv->std);
 	GC_REFCOUNT(&uv->std)++;
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_udp_send, uv);
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_prepare_cb, uv);
 
-	PHP_UV_INIT_SEND_REQ(w, uv, data->val, data->len);
-	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_SEND_CB);
+	php_uv_do_callback2(&retval, uv, params, 1, PHP_UV_PREPARE_CB TSRMLS_CC);
 
-	if (type == 1) {
-		uv_udp_send(&w->req, &uv->uv.udp, &w->buf, 1, (const struct sockaddr*)&PHP_UV_SOCKADDR_IPV4(addr), php_uv_udp_send_cb);
-	} else {
-		uv_udp_send(&w->req, &uv->uv.udp, &w->buf, 1, (const struct sockaddr*)&PHP_UV_SOCKADDR_IPV6(addr), php_uv_udp_send_cb);
-	}
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_prepare_cb, uv);
+	zval_ptr_dtor(&params[0]);
+
+	zval_ptr_dtor(&retval);
 }
 
-static void php_uv_tcp_connect(enum php_uv_socket_type type, INTERNAL_FUNCTION_PARAMETERS)
+static void php_uv_check_cb(uv_check_t* handle)
 {
-	php_uv_t *uv;
-	php_uv_sockaddr_t *addr;
-	uv_connect_t *req;
-	zend_fcall_info fci       = empty_fcall_info;
-	zend_fcall_info_cache fcc = empty_fcall_info_cache;
-	php_uv_cb_t *cb;
+	zval retval = {{0}};
+	zval params[1];
+	php_uv_t *uv = (php_uv_t*)handle->data;
+	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
 
-	ZEND_PARSE_PARAMETERS_START(2, 3)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_tcp_ce)
-		UV_PARAM_OBJ(addr, php_uv_sockaddr_t, (type == PHP_UV_TCP_IPV4) ? uv_sockaddr_ipv4_ce : uv_sockaddr_ipv6_ce)
-		Z_PARAM_OPTIONAL
-		Z_PARAM_FUNC_EX(fci, fcc, 1, 0)
-	ZEND_PARSE_PARAMETERS_END();
+	PHP_UV_DEBUG_PRINT("check_cb\n");
 
+	ZVAL_OBJ(&params[0], &uv->std);
 	GC_REFCOUNT(&uv->std)++;
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_tcp_connect, uv);
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_check_cb, uv);
 
-	PHP_UV_INIT_CONNECT(req, uv)
-	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_CONNECT_CB);
+	php_uv_do_callback2(&retval, uv, params, 1, PHP_UV_CHECK_CB TSRMLS_CC);
 
-	if (type == PHP_UV_TCP_IPV4) {
-		uv_tcp_connect(req, &uv->uv.tcp, (const struct sockaddr*)&PHP_UV_SOCKADDR_IPV4(addr), php_uv_tcp_connect_cb);
-	} else {
-		uv_tcp_connect(req, &uv->uv.tcp,  (const struct sockaddr*)&PHP_UV_SOCKADDR_IPV6(addr), php_uv_tcp_connect_cb);
-	}
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_check_cb, uv);
+	zval_ptr_dtor(&params[0]);
+
+	zval_ptr_dtor(&retval);
 }
 
-/* zend */
 
-static zend_function_entry php_uv_empty_methods[] = {
-	{NULL, NULL, NULL}
-};
+static void php_uv_async_cb(uv_async_t* handle)
+{
+	zval retval = {{0}};
+	zval params[1];
+	php_uv_t *uv = (php_uv_t*)handle->data;
+	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
 
-int php_uv_cast_object(zval *readobj, zval *writeobj, int type) {
-	if (type == IS_LONG) {
-		ZVAL_LONG(writeobj, Z_OBJ_P(readobj)->handle);
-		return SUCCESS;
-	} else {
-		return zend_std_cast_object_tostring(readobj, writeobj, type);
-	}
-}
+	PHP_UV_DEBUG_PRINT("async_cb\n");
 
-static HashTable *php_uv_get_gc(zval *object, zval **table, int *n) {
-	php_uv_t *uv = (php_uv_t *) Z_OBJ_P(object);
-	int i;
+	ZVAL_OBJ(&params[0], &uv->std);
+	GC_REFCOUNT(&uv->std)++;
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_async_cb, uv);
 
-	if (PHP_UV_IS_DTORED(uv)) {
-		*n = 0;
-		return NULL;
-	}
+	php_uv_do_callback2(&retval, uv, params, 1, PHP_UV_ASYNC_CB TSRMLS_CC);
 
-	// include trailing zvals like fs_fd/_alt
-	*n = (sizeof(php_uv_t) -  XtOffsetOf(php_uv_t, gc_data)) / sizeof(zval);
-	for (i = 0; i < PHP_UV_CB_MAX; i++) {
-		php_uv_cb_t *cb = uv->callback[i];
-		if (cb) {
-			ZVAL_COPY_VALUE(&uv->gc_data[i * 2], &cb->fci.function_name);
-			if (cb->fci.object) {
-				ZVAL_OBJ(&uv->gc_data[i * 2 + 1], cb->fci.object);
-			}
-		} else {
-			ZVAL_UNDEF(&uv->gc_data[i * 2]);
-			ZVAL_UNDEF(&uv->gc_data[i * 2 + 1]);
-		}
-	}
-	*table = uv->gc_data;
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_async_cb, uv);
+	zval_ptr_dtor(&params[0]);
 
-	return uv->std.properties;
+	zval_ptr_dtor(&retval);
 }
 
-static void php_uv_loop_get_gc_walk_cb(uv_handle_t* handle, void *arg) {
-	struct { int *n; php_uv_loop_t *loop; } *data = arg;
-	php_uv_t *uv = (php_uv_t *) handle->data;
+#ifdef ZTS
+static void php_uv_work_cb(uv_work_t* req)
+{
+	zval retval = {{0}};
+	php_uv_t *uv = (php_uv_t*)req->data;
 
-	if (php_uv_is_handle_referenced(uv)) {
-		php_uv_loop_t *loop = data->loop;
+	uv = (php_uv_t*)req->data;
 
-		if (*data->n == loop->gc_buffer_size) {
-			if (loop->gc_buffer_size == 0) {
-				loop->gc_buffer_size = 16;
-			} else {
-				loop->gc_buffer_size *= 2;
-			}
-			loop->gc_buffer = erealloc(loop->gc_buffer, loop->gc_buffer_size * sizeof(zval));
-		}
+	PHP_UV_DEBUG_PRINT("work_cb\n");
 
-		ZVAL_OBJ(loop->gc_buffer + (*data->n)++, &uv->std);
-	}
+	php_uv_do_callback3(&retval, uv, NULL, 0, PHP_UV_WORK_CB);
 }
 
-static HashTable *php_uv_loop_get_gc(zval *object, zval **table, int *n) {
-	php_uv_loop_t *loop = (php_uv_loop_t *) Z_OBJ_P(object);
-	struct { int *n; php_uv_loop_t *loop; } data;
-	data.n = n;
-	data.loop = loop;
+static void php_uv_after_work_cb(uv_work_t* req, int status)
+{
+	zval retval = {{0}};
+	php_uv_t *uv = (php_uv_t*)req->data;
+	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
 
-	*n = 0;
-	if (!PHP_UV_IS_DTORED(loop)) {
-		uv_walk(&loop->loop, php_uv_loop_get_gc_walk_cb, &data);
-		*table = loop->gc_buffer;
-	}
+	uv = (php_uv_t*)req->data;
 
-	return loop->std.properties;
-}
+	PHP_UV_DEBUG_PRINT("after_work_cb\n");
 
-static HashTable *php_uv_stdio_get_gc(zval *object, zval **table, int *n) {
-	php_uv_stdio_t *stdio = (php_uv_stdio_t *) Z_OBJ_P(object);
+	php_uv_do_callback2(&retval, uv, NULL, 0, PHP_UV_AFTER_WORK_CB TSRMLS_CC);
 
-	*n = 1;
-	*table = &stdio->stream;
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_after_work_cb, uv);
 
-	return stdio->std.properties;
+	/* as uv_cancel inside destruct_uv will return EBUSY here as were still in the work callback, but freeing is safe here */
+	clean_uv_handle(uv); /* this avoids a cancel */
+	php_uv_release(uv);
 }
+#endif
 
-static zend_object *php_uv_create_uv(zend_class_entry *ce) {
-	php_uv_t *uv = emalloc(sizeof(php_uv_t));
-	zend_object_std_init(&uv->std, ce);
-	uv->std.handlers = &uv_handlers;
-
-	PHP_UV_INIT_ZVALS(uv);
-	TSRMLS_SET_CTX(uv->thread_ctx);
+/* the arguments of the fs callback for a completed request, also what the _sync variants return from */
+static int php_uv_fs_result(php_uv_t *uv, zval *params)
+{
+	uv_fs_t *req = &uv->uv.fs;
+	int argc;
 
-	uv->uv.handle.data = uv;
+	if (!Z_ISUNDEF(uv->fs_fd)) {
+		if (uv->uv.fs.result < 0) {
+			ZVAL_FALSE(&params[0]);
+			zval_ptr_dtor(&uv->fs_fd);
+		} else {
+			ZVAL_COPY_VALUE(&params[0], &uv->fs_fd);
+		}
+		ZVAL_UNDEF(&uv->fs_fd);
+	}
 
-	return &uv->std;
-}
+	switch (uv->uv.fs.fs_type) {
+		case UV_FS_SYMLINK:
+		case UV_FS_LINK:
+		case UV_FS_CHMOD:
+		case UV_FS_RENAME:
+		case UV_FS_UNLINK:
+		case UV_FS_RMDIR:
+		case UV_FS_MKDIR:
+		case UV_FS_CLOSE:
+		case UV_FS_CHOWN:
+		case UV_FS_UTIME:
+		case UV_FS_FUTIME:
+			argc = 1;
+			ZVAL_BOOL(&params[0], uv->uv.fs.result == 0);
+			break;
 
-static zend_object *php_uv_create_uv_loop(zend_class_entry *ce) {
-	php_uv_loop_t *loop = emalloc(sizeof(php_uv_loop_t));
-	zend_object_std_init(&loop->std, ce);
-	loop->std.handlers = &uv_loop_handlers;
-	
-	uv_loop_init(&loop->loop);
+		case UV_FS_FCHMOD:
+		case UV_FS_FCHOWN:
+		case UV_FS_FTRUNCATE:
+		case UV_FS_FDATASYNC:
+		case UV_FS_FSYNC:
+			argc = 1;
+			if (uv->uv.fs.result < 0) {
+				zval_ptr_dtor(&params[0]);
+				ZVAL_FALSE(&params[0]);
+			}
+			break;
 
-	loop->gc_buffer_size = 0;
-	loop->gc_buffer = NULL;
+		case UV_FS_OPEN:
+			argc = 1;
+			if (uv->uv.fs.result < 0) {
+				ZVAL_FALSE(&params[0]);
+			} else {
+				PHP_UV_FD_TO_ZVAL(&params[0], uv->uv.fs.result)
+				PHP_UV_DEBUG_PRINT("Creating fs handle %p\n", Z_RES(params[0]));
+			}
+			break;
 
-	return &loop->std;
-}
+		case UV_FS_SCANDIR:
+			argc = 2;
+			if (uv->uv.fs.result < 0 || req->ptr == NULL) {
+				ZVAL_LONG(&params[1], uv->uv.fs.result);
+			} else {
+				uv_dirent_t dent;
 
-static zend_object *php_uv_create_uv_sockaddr(zend_class_entry *ce) {
-	php_uv_sockaddr_t *sockaddr = emalloc(sizeof(php_uv_sockaddr_t));
-	zend_object_std_init(&sockaddr->std, ce);
-	sockaddr->std.handlers = &uv_default_handlers;
+				ZVAL_TRUE(&params[0]); // wtf, but do not break BC
 
-	return &sockaddr->std;
-}
+				array_init(&params[1]);
+				while (UV_EOF != uv_fs_scandir_next(req, &dent)) {
+					add_next_index_string(&params[1], dent.name);
+				}
+			}
+			break;
 
-static zend_object *php_uv_create_uv_lock(zend_class_entry *ce) {
-	php_uv_lock_t *lock = emalloc(sizeof(php_uv_lock_t));
-	zend_object_std_init(&lock->std, ce);
-	lock->std.handlers = &uv_lock_handlers;
+		case UV_FS_LSTAT:
+		case UV_FS_STAT:
+			ZVAL_BOOL(&params[0], req->ptr != NULL);
+			if (req->ptr != NULL && req->path != NULL && uv->stat_epoch) {
+				php_uv_loop_t *loop = PHP_UV_CONTAINER_OF(req->loop, php_uv_loop_t, loop);
 
-	lock->locked = 0;
+				/* nothing was invalidated while the request ran */
+				if (loop->stat_cache->ttl > 0 && uv->stat_epoch == loop->stat_cache->epoch) {
+					php_uv_stat_cache_store(loop, req->fs_type, req->path, (const uv_stat_t *) req->ptr);
+				}
+			}
+			if (uv->buffer) {
+				/* the expanded path, see php_uv_stat_cache_complete() */
+				efree(uv->buffer);
+				uv->buffer = NULL;
+			}
+		case UV_FS_FSTAT:
+			argc = 2;
+			if (req->ptr != NULL) {
+				params[1] = php_uv_make_stat((const uv_stat_t *) req->ptr);
+			} else {
+				ZVAL_NULL(&params[1]);
+			}
+			break;
 
-	return &lock->std;
-}
+		case UV_FS_READLINK:
+			argc = 2;
+			ZVAL_BOOL(&params[0], uv->uv.fs.result == 0);
+			if (uv->uv.fs.result == 0) {
+				ZVAL_STRING(&params[1], req->ptr);
+			} else {
+				ZVAL_NULL(&params[1]);
+			}
+			break;
 
-static zend_object *php_uv_create_uv_stdio(zend_class_entry *ce) {
-	php_uv_stdio_t *stdio = emalloc(sizeof(php_uv_stdio_t));
-	zend_object_std_init(&stdio->std, ce);
-	stdio->std.handlers = &uv_stdio_handlers;
+		case UV_FS_READ:
+			argc = 3;
+			if (uv->fs_bufs) {
+				/* readv: the segments which were filled, the last one may be short */
+				php_uv_fs_bufs_t *bufs = uv->fs_bufs;
 
-	stdio->flags = 0;
-	ZVAL_UNDEF(&stdio->stream);
+				if (uv->uv.fs.result >= 0) {
+					size_t left = (size_t) uv->uv.fs.result;
+					unsigned int j;
 
-	return &stdio->std;
-}
+					array_init_size(&params[2], bufs->nbufs);
+					for (j = 0; j < bufs->nbufs && left > 0; j++) {
+						size_t len = MIN(left, bufs->bufs[j].len);
 
-static zend_class_entry *php_uv_register_internal_class_ex(const char *name, zend_class_entry *parent) {
-	zend_class_entry ce = {0}, *new;
+						add_next_index_stringl(&params[2], bufs->bufs[j].base, len);
+						left -= len;
+					}
+				} else {
+					ZVAL_NULL(&params[2]);
+				}
+				ZVAL_LONG(&params[1], uv->uv.fs.result);
+				php_uv_fs_bufs_free(uv);
+				break;
+			}
+			if (uv->uv.fs.result >= 0) {
+				ZVAL_STRINGL(&params[2], uv->buffer, uv->uv.fs.result);
+			} else {
+				ZVAL_NULL(&params[2]);
+			}
+			ZVAL_LONG(&params[1], uv->uv.fs.result);
+			efree(uv->buffer);
+			break;
 
-	ce.name = zend_new_interned_string(zend_string_init(name, strlen(name), 1));
-	ce.info.internal.builtin_functions = php_uv_empty_methods;
-	new = zend_register_internal_class_ex(&ce, parent);
-	new->serialize = zend_class_serialize_deny;
-	new->unserialize = zend_class_unserialize_deny;
-	new->ce_flags |= ZEND_ACC_FINAL;
-	new->create_object = php_uv_create_uv;
+		case UV_FS_SENDFILE:
+			argc = 2;
+			ZVAL_LONG(&params[1], uv->uv.fs.result);
+			break;
 
-	return new;
-}
+		case UV_FS_WRITE:
+			argc = 2;
+			ZVAL_LONG(&params[1], uv->uv.fs.result);
+			if (uv->fs_bufs) {
+				php_uv_fs_bufs_free(uv);
+			} else {
+				efree(uv->buffer);
+			}
+			break;
 
-static zend_class_entry *php_uv_register_internal_class(const char *name) {
-	return php_uv_register_internal_class_ex(name, NULL);
-}
+		case UV_FS_UNKNOWN:
+		case UV_FS_CUSTOM:
+		default:
+			argc = 0;
+			php_error_docref(NULL, E_ERROR, "type; %d does not support yet.", uv->uv.fs.fs_type);
+			break;
+	}
 
-static zend_function *php_uv_get_ctor(zend_object *object) {
-	zend_throw_error(NULL, "The UV classes cannot be instantiated manually");
-	return NULL;
+	return argc;
 }
 
-PHP_MINIT_FUNCTION(uv)
+static void php_uv_fs_cb(uv_fs_t* req)
 {
-	PHP_UV_PROBE(MINIT);
+	zval params[3] = {{{0}}};
+	zval retval = {{0}};
+	php_uv_t *uv = (php_uv_t*)req->data;
+	int argc, i = 0;
+	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
 
-	memcpy(&uv_default_handlers, zend_get_std_object_handlers(), sizeof(zend_object_handlers));
-	uv_default_handlers.clone_obj = NULL;
-	uv_default_handlers.get_constructor = php_uv_get_ctor;
-	uv_default_handlers.cast_object = php_uv_cast_object;
+	PHP_UV_DEBUG_PRINT("# php_uv_fs_cb %p\n", uv);
 
-	uv_ce = php_uv_register_internal_class("UV");
-	uv_ce->ce_flags |= ZEND_ACC_ABSTRACT;
-	uv_ce->ce_flags &= ~ZEND_ACC_FINAL;
-	memcpy(&uv_handlers, &uv_default_handlers, sizeof(zend_object_handlers));
-	uv_handlers.get_gc = php_uv_get_gc;
-	uv_handlers.dtor_obj = destruct_uv;
+	if (PHP_UV_IS_DTORED(uv)) {
+		/* the object was destroyed while libuv still used the buffers, nobody else frees them */
+		php_uv_fs_bufs_free(uv);
+		if (uv->buffer) {
+			efree(uv->buffer);
+			uv->buffer = NULL;
+		}
+		uv_fs_req_cleanup(req);
 
-	php_uv_init(uv_ce);
+		OBJ_RELEASE(&uv->std);
+		return;
+	}
 
-	uv_tcp_ce = php_uv_register_internal_class_ex("UVTcp", uv_ce);
-	uv_udp_ce = php_uv_register_internal_class_ex("UVUdp", uv_ce);
-	uv_pipe_ce = php_uv_register_internal_class_ex("UVPipe", uv_ce);
-	uv_idle_ce = php_uv_register_internal_class_ex("UVIdle", uv_ce);
-	uv_timer_ce = php_uv_register_internal_class_ex("UVTimer", uv_ce);
-	uv_async_ce = php_uv_register_internal_class_ex("UVAsync", uv_ce);
-	uv_stream_ce = php_uv_register_internal_class_ex("UVStream", uv_ce);
-	uv_addrinfo_ce = php_uv_register_internal_class_ex("UVAddrinfo", uv_ce);
-	uv_process_ce = php_uv_register_internal_class_ex("UVProcess", uv_ce);
-	uv_prepare_ce = php_uv_register_internal_class_ex("UVPrepare", uv_ce);
-	uv_check_ce = php_uv_register_internal_class_ex("UVCheck", uv_ce);
-	uv_work_ce = php_uv_register_internal_class_ex("UVWork", uv_ce);
-	uv_fs_ce = php_uv_register_internal_class_ex("UVFs", uv_ce);
-	uv_fs_event_ce = php_uv_register_internal_class_ex("UVFsEvent", uv_ce);
-	uv_tty_ce = php_uv_register_internal_class_ex("UVTty", uv_ce);
-	uv_fs_poll_ce = php_uv_register_internal_class_ex("UVFSPoll", uv_ce);
-	uv_poll_ce = php_uv_register_internal_class_ex("UVPoll", uv_ce);
-	uv_signal_ce = php_uv_register_internal_class_ex("UVSignal", uv_ce);
+	argc = php_uv_fs_result(uv, params);
 
-	uv_loop_ce = php_uv_register_internal_class("UVLoop");
-	uv_loop_ce->create_object = php_uv_create_uv_loop;
-	memcpy(&uv_loop_handlers, &uv_default_handlers, sizeof(zend_object_handlers));
-	uv_loop_handlers.get_gc = php_uv_loop_get_gc;
-	uv_loop_handlers.dtor_obj = destruct_uv_loop;
+	php_uv_do_callback2(&retval, uv, params, argc, PHP_UV_FS_CB TSRMLS_CC);
 
-	uv_sockaddr_ce = php_uv_register_internal_class("UVSockAddr");
-	uv_sockaddr_ce->ce_flags |= ZEND_ACC_ABSTRACT;
-	uv_sockaddr_ce->ce_flags &= ~ZEND_ACC_FINAL;
-	uv_sockaddr_ce->create_object = php_uv_create_uv_sockaddr;
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_fs_cb, uv);
+	for (i = 0; i < argc; i++) {
+		zval_ptr_dtor(&params[i]);
+	}
 
-	uv_sockaddr_ipv4_ce = php_uv_register_internal_class_ex("UVSockAddrIPv4", uv_sockaddr_ce);
-	uv_sockaddr_ipv4_ce->create_object = php_uv_create_uv_sockaddr;
+	zval_ptr_dtor(&retval);
 
-	uv_sockaddr_ipv6_ce = php_uv_register_internal_class_ex("UVSockAddrIPv6", uv_sockaddr_ce);
-	uv_sockaddr_ipv6_ce->create_object = php_uv_create_uv_sockaddr;
+	if (!Z_ISUNDEF(uv->fs_fd_alt)) {
+		zval_ptr_dtor(&uv->fs_fd_alt);
+		ZVAL_UNDEF(&uv->fs_fd_alt);
+	}
 
-	uv_lock_ce = php_uv_register_internal_class("UVLock");
-	uv_lock_ce->create_object = php_uv_create_uv_lock;
-	memcpy(&uv_lock_handlers, &uv_default_handlers, sizeof(zend_object_handlers));
-	uv_lock_handlers.dtor_obj = destruct_uv_lock;
+	uv_fs_req_cleanup(req);
 
-	uv_stdio_ce = php_uv_register_internal_class("UVStdio");
-	uv_stdio_ce->create_object = php_uv_create_uv_stdio;
-	memcpy(&uv_stdio_handlers, &uv_default_handlers, sizeof(zend_object_handlers));
-	uv_stdio_handlers.dtor_obj = destruct_uv_stdio;
-	uv_stdio_handlers.get_gc = php_uv_stdio_get_gc;
+	clean_uv_handle(uv);
+	php_uv_release(uv);
+}
 
-#if !defined(PHP_WIN32) && !(defined(HAVE_SOCKETS) && !defined(COMPILE_DL_SOCKETS))
-	{
-		zend_module_entry *sockets;
-		if ((sockets = zend_hash_str_find_ptr(&module_registry, ZEND_STRL("sockets")))) {
-			if (sockets->handle) { // shared
-				php_sockets_le_socket = (int (*)(void)) DL_FETCH_SYMBOL(sockets->handle, "php_sockets_le_socket");
-				if (php_sockets_le_socket == NULL) {
-					php_sockets_le_socket = (int (*)(void)) DL_FETCH_SYMBOL(sockets->handle, "_php_sockets_le_socket");
-				}
-			}
-		}
+static void php_uv_fs_event_cb(uv_fs_event_t* req, const char* filename, int events, int status)
+{
+	zval params[4] = {{{0}}};
+	zval retval = {{0}};
+	php_uv_t *uv = (php_uv_t*)req->data;
+	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
+
+	PHP_UV_DEBUG_PRINT("fs_event_cb: %s, %d\n", filename, status);
+
+	ZVAL_OBJ(&params[0], &uv->std);
+	GC_REFCOUNT(&uv->std)++;
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_fs_event_cb, uv);
+	if (filename) {
+		ZVAL_STRING(&params[1], filename);
+	} else {
+		ZVAL_NULL(&params[1]);
 	}
-#endif
+	ZVAL_LONG(&params[2], events);
+	ZVAL_LONG(&params[3], status);
 
-	return SUCCESS;
+	php_uv_do_callback2(&retval, uv, params, 4, PHP_UV_FS_EVENT_CB TSRMLS_CC);
+
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_fs_event_cb, uv);
+	zval_ptr_dtor(&params[0]);
+	zval_ptr_dtor(&params[1]);
+	zval_ptr_dtor(&params[2]);
+	zval_ptr_dtor(&params[3]);
+
+	zval_ptr_dtor(&retval);
 }
 
-PHP_RSHUTDOWN_FUNCTION(uv)
+static void php_uv_fs_poll_cb(uv_fs_poll_t* handle, int status, const uv_stat_t* prev, const uv_stat_t* curr)
 {
-	if (UV_G(default_loop)) {
-		uv_loop_t *loop = &UV_G(default_loop)->loop;
+	zval params[4] = {{{0}}};
+	zval retval = {{0}};
+	php_uv_t *uv = (php_uv_t*)handle->data;
+	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
 
-		/* for proper destruction: close all handles, let libuv call close callback and then close and free the loop */
-		uv_stop(loop); /* in case we longjmp()'ed ... */
-		uv_run(loop, UV_RUN_DEFAULT); /* invalidate the stop ;-) */
+	ZVAL_OBJ(&params[0], &uv->std);
+	GC_REFCOUNT(&uv->std)++;
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_fs_poll_cb, uv);
+	ZVAL_LONG(&params[1], status);
+	params[2] = php_uv_make_stat(prev);
+	params[3] = php_uv_make_stat(curr);
 
-		uv_walk(loop, destruct_uv_loop_walk_cb, NULL);
-		uv_run(loop, UV_RUN_DEFAULT);
-		uv_loop_close(loop);
-		OBJ_RELEASE(&UV_G(default_loop)->std);
-	}
+	php_uv_do_callback2(&retval, uv, params, 4, PHP_UV_FS_POLL_CB TSRMLS_CC);
 
-	return SUCCESS;
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_fs_poll_cb, uv);
+	zval_ptr_dtor(&params[0]);
+	zval_ptr_dtor(&params[1]);
+	zval_ptr_dtor(&params[2]);
+	zval_ptr_dtor(&params[3]);
+
+	zval_ptr_dtor(&retval);
 }
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_run, 0, 0, 1)
-	ZEND_ARG_INFO(0, loop)
-ZEND_END_ARG_INFO()
+static void php_uv_poll_cb(uv_poll_t* handle, int status, int events)
+{
+	zval params[4] = {{{0}}};
+	zval retval = {{0}};
+	php_uv_t *uv = (php_uv_t*)handle->data;
+	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_stop, 0, 0, 1)
-	ZEND_ARG_INFO(0, loop)
-ZEND_END_ARG_INFO()
+	ZVAL_OBJ(&params[0], &uv->std);
+	if (status == 0) {
+		GC_REFCOUNT(&uv->std)++;
+	}
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_poll_cb, uv);
+	ZVAL_LONG(&params[1], status);
+	ZVAL_LONG(&params[2], events);
+	if (!Z_ISUNDEF(uv->fs_fd)) {
+		ZVAL_COPY(&params[3], &uv->fs_fd);
+	} else {
+		PHP_UV_FD_TO_ZVAL(&params[3], uv->sock);
+	}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_loop_delete, 0, 0, 1)
-	ZEND_ARG_INFO(0, loop)
-ZEND_END_ARG_INFO()
+	php_uv_do_callback2(&retval, uv, params, 4, PHP_UV_POLL_CB TSRMLS_CC);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_now, 0, 0, 1)
-	ZEND_ARG_INFO(0, loop)
-ZEND_END_ARG_INFO()
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_poll_cb, uv);
+	zval_ptr_dtor(&params[0]);
+	zval_ptr_dtor(&params[1]);
+	zval_ptr_dtor(&params[2]);
+	zval_ptr_dtor(&params[3]);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_tcp_connect, 0, 0, 2)
-	ZEND_ARG_INFO(0, resource)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	zval_ptr_dtor(&retval);
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_tcp_connect6, 0, 0, 2)
-	ZEND_ARG_INFO(0, resource)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_tcp_init, 0, 0, 1)
-	ZEND_ARG_INFO(0, loop)
-ZEND_END_ARG_INFO()
+static void php_uv_udp_recv_cb(uv_udp_t* handle, ssize_t nread, const uv_buf_t* buf, const struct sockaddr* addr, unsigned flags)
+{
+	/* TODO: is this correctly implmented? */
+	zval retval = {{0}};
+	zval params[3] = {{{0}}};
+	php_uv_t *uv = (php_uv_t*)handle->data;
+	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_listen, 0, 0, 3)
-	ZEND_ARG_INFO(0, resource)
-	ZEND_ARG_INFO(0, backlog)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	ZVAL_OBJ(&params[0], &uv->std);
+	GC_REFCOUNT(&uv->std)++;
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_udp_recv_cb, uv);
+	ZVAL_LONG(&params[1], nread);
+	ZVAL_STRINGL(&params[2], buf->base, nread);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_accept, 0, 0, 2)
-	ZEND_ARG_INFO(0, server)
-	ZEND_ARG_INFO(0, client)
-ZEND_END_ARG_INFO()
+	php_uv_do_callback2(&retval, uv, params, 3, PHP_UV_RECV_CB TSRMLS_CC);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_read_start, 0, 0, 2)
-	ZEND_ARG_INFO(0, server)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_udp_recv_cb, uv);
+	zval_ptr_dtor(&params[0]);
+	zval_ptr_dtor(&params[1]);
+	zval_ptr_dtor(&params[2]);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_read2_start, 0, 0, 2)
-	ZEND_ARG_INFO(0, server)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	zval_ptr_dtor(&retval);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_read_stop, 0, 0, 1)
-	ZEND_ARG_INFO(0, server)
-ZEND_END_ARG_INFO()
+	if (buf->base) {
+		efree(buf->base);
+	}
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_write, 0, 0, 3)
-	ZEND_ARG_INFO(0, client)
-	ZEND_ARG_INFO(0, data)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+static void php_uv_read_alloc(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf)
+{
+	buf->base = emalloc(suggested_size);
+	buf->len = suggested_size;
+	//return uv_buf_init(emalloc(suggested_size), suggested_size);
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_write2, 0, 0, 4)
-	ZEND_ARG_INFO(0, client)
-	ZEND_ARG_INFO(0, data)
-	ZEND_ARG_INFO(0, send)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+static void php_uv_close_cb(uv_handle_t *handle)
+{
+	zval retval = {{0}};
+	zval params[1] = {{{0}}};
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_strerror, 0, 0, 1)
-	ZEND_ARG_INFO(0, error)
-ZEND_END_ARG_INFO()
+	php_uv_t *uv = (php_uv_t *) handle->data;
+	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_err_name, 0, 0, 1)
-	ZEND_ARG_INFO(0, error)
-ZEND_END_ARG_INFO()
+	if (php_uv_cb_get(uv, PHP_UV_CLOSE_CB)) {
+		ZVAL_OBJ(&params[0], (zend_object *) uv);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_timer_init, 0, 0, 1)
-	ZEND_ARG_INFO(0, loop)
-ZEND_END_ARG_INFO()
+		php_uv_do_callback2(&retval, uv, params, 1, PHP_UV_CLOSE_CB TSRMLS_CC);
+		zval_ptr_dtor(&retval);
+	}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_idle_stop, 0, 0, 1)
-	ZEND_ARG_INFO(0, idle)
-ZEND_END_ARG_INFO()
+	php_uv_gc_forget(uv);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_timer_start, 0, 0, 4)
-	ZEND_ARG_INFO(0, timer)
-	ZEND_ARG_INFO(0, timeout)
-	ZEND_ARG_INFO(0, repeat)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	/* manually clean the uv handle as dtor will not be called anymore here */
+	clean_uv_handle(uv);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_timer_stop, 0, 0, 1)
-	ZEND_ARG_INFO(0, timer)
-ZEND_END_ARG_INFO()
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_close_cb, uv);
+	php_uv_release(uv);
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_timer_again, 0, 0, 1)
-	ZEND_ARG_INFO(0, timer)
-ZEND_END_ARG_INFO()
+static inline zend_bool php_uv_is_handle_referenced(php_uv_t *uv) {
+	return uv->layout->loop_ref && uv_is_active(&uv->uv.handle);
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_timer_set_repeat, 0, 0, 2)
-	ZEND_ARG_INFO(0, timer)
-	ZEND_ARG_INFO(0, timeout)
-ZEND_END_ARG_INFO()
+static void php_uv_gc_register(php_uv_loop_t *loop, php_uv_t *uv) {
+	if (loop->gc_registry_count == loop->gc_registry_size) {
+		loop->gc_registry_size = loop->gc_registry_size ? loop->gc_registry_size * 2 : 16;
+		loop->gc_registry = erealloc(loop->gc_registry, loop->gc_registry_size * sizeof(zval));
+	}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_timer_get_repeat, 0, 0, 1)
-	ZEND_ARG_INFO(0, timer)
-ZEND_END_ARG_INFO()
+	ZVAL_OBJ(&loop->gc_registry[loop->gc_registry_count++], &uv->std);
+	uv->gc_slot = loop->gc_registry_count;
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_idle_start, 0, 0, 2)
-	ZEND_ARG_INFO(0, timer)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+static void php_uv_gc_unregister(php_uv_loop_t *loop, php_uv_t *uv) {
+	zval *last = &loop->gc_registry[--loop->gc_registry_count];
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_tcp_open, 0, 0, 2)
-	ZEND_ARG_INFO(0, resource)
-	ZEND_ARG_INFO(0, tcpfd)
-ZEND_END_ARG_INFO()
+	((php_uv_t *) Z_OBJ_P(last))->gc_slot = uv->gc_slot;
+	ZVAL_COPY_VALUE(&loop->gc_registry[uv->gc_slot - 1], last);
+	uv->gc_slot = 0;
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_tcp_bind, 0, 0, 2)
-	ZEND_ARG_INFO(0, resource)
-	ZEND_ARG_INFO(0, address)
-ZEND_END_ARG_INFO()
+/* the handle may have been started, stopped or fired: recheck it at the next collection of its loop */
+static void php_uv_gc_touch(php_uv_t *uv) {
+	php_uv_loop_t *loop;
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_tcp_bind6, 0, 0, 2)
-	ZEND_ARG_INFO(0, resource)
-	ZEND_ARG_INFO(0, address)
-ZEND_END_ARG_INFO()
+	if (uv->gc_dirty || !uv->layout->loop_ref) {
+		return;
+	}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_shutdown, 0, 0, 2)
-	ZEND_ARG_INFO(0, stream)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	loop = PHP_UV_CONTAINER_OF(uv->uv.handle.loop, php_uv_loop_t, loop);
+	if (PHP_UV_IS_DTORED(loop)) {
+		return;
+	}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_close, 0, 0, 2)
-	ZEND_ARG_INFO(0, stream)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	if (loop->gc_dirty_count == loop->gc_dirty_size) {
+		loop->gc_dirty_size = loop->gc_dirty_size ? loop->gc_dirty_size * 2 : 16;
+		loop->gc_dirty = erealloc(loop->gc_dirty, loop->gc_dirty_size * sizeof(php_uv_t *));
+	}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_idle_init, 0, 0, 1)
-	ZEND_ARG_INFO(0, loop)
-ZEND_END_ARG_INFO()
+	loop->gc_dirty[loop->gc_dirty_count++] = uv;
+	uv->gc_dirty = loop->gc_dirty_count;
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_update_time, 0, 0, 1)
-	ZEND_ARG_INFO(0, loop)
-ZEND_END_ARG_INFO()
+/* the handle is closed or freed, its loop must not report it anymore */
+static void php_uv_gc_forget(php_uv_t *uv) {
+	php_uv_loop_t *loop;
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_is_active, 0, 0, 1)
-	ZEND_ARG_INFO(0, handle)
-ZEND_END_ARG_INFO()
+	if (!uv->gc_slot && !uv->gc_dirty) {
+		return;
+	}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_is_closing, 0, 0, 1)
-	ZEND_ARG_INFO(0, handle)
-ZEND_END_ARG_INFO()
+	loop = PHP_UV_CONTAINER_OF(uv->uv.handle.loop, php_uv_loop_t, loop);
+	if (uv->gc_slot) {
+		php_uv_gc_unregister(loop, uv);
+	}
+	if (uv->gc_dirty) {
+		php_uv_t *last = loop->gc_dirty[--loop->gc_dirty_count];
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_is_readable, 0, 0, 1)
-	ZEND_ARG_INFO(0, handle)
-ZEND_END_ARG_INFO()
+		last->gc_dirty = uv->gc_dirty;
+		loop->gc_dirty[uv->gc_dirty - 1] = last;
+		uv->gc_dirty = 0;
+	}
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_is_writable, 0, 0, 1)
-	ZEND_ARG_INFO(0, handle)
-ZEND_END_ARG_INFO()
+/* brings the registry up to date, only looking at the handles touched since the last collection */
+static void php_uv_gc_sync(php_uv_loop_t *loop) {
+	while (loop->gc_dirty_count > 0) {
+		php_uv_t *uv = loop->gc_dirty[--loop->gc_dirty_count];
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_walk, 0, 0, 3)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, callback)
-	ZEND_ARG_INFO(0, opaque)
-ZEND_END_ARG_INFO()
+		uv->gc_dirty = 0;
+		if (php_uv_is_handle_referenced(uv)) {
+			if (!uv->gc_slot) {
+				php_uv_gc_register(loop, uv);
+			}
+		} else if (uv->gc_slot) {
+			php_uv_gc_unregister(loop, uv);
+		}
+	}
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_guess_handle, 0, 0, 1)
-	ZEND_ARG_INFO(0, fd)
-ZEND_END_ARG_INFO()
+/* uv handle must not be cleaned or closed before called */
+static void php_uv_close(php_uv_t *uv) {
+	ZEND_ASSERT(!uv_is_closing(&uv->uv.handle));
 
+	if (uv->ext && uv->std.ce == uv_udp_ce) {
+		/* the relay's reference on the listener is handed over to the close */
+		php_uv_udp_relay_stop(uv->ext, 1);
+	}
+	if (uv->timeouts) {
+		php_uv_stream_timeouts_stop(uv);
+	}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_ref, 0, 0, 1)
-	ZEND_ARG_INFO(0, loop)
-ZEND_END_ARG_INFO()
+	if (!php_uv_is_handle_referenced(uv)) {
+		++GC_REFCOUNT(&uv->std);
+		PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(php_uv_close, uv);
+	}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_unref, 0, 0, 1)
-	ZEND_ARG_INFO(0, loop)
-ZEND_END_ARG_INFO()
+	uv_close(&uv->uv.handle, php_uv_close_cb);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_tcp_nodelay, 0, 0, 2)
-	ZEND_ARG_INFO(0, tcp)
-	ZEND_ARG_INFO(0, enabled)
-ZEND_END_ARG_INFO()
+	PHP_UV_SKIP_DTOR(uv);
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_ip4_addr, 0, 0, 2)
-	ZEND_ARG_INFO(0, address)
-	ZEND_ARG_INFO(0, port)
-ZEND_END_ARG_INFO()
+static void php_uv_idle_cb(uv_timer_t *handle)
+{
+	zval retval = {{0}};
+	zval params[1] = {{{0}}};
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_ip6_addr, 0, 0, 2)
-	ZEND_ARG_INFO(0, address)
-	ZEND_ARG_INFO(0, port)
-ZEND_END_ARG_INFO()
+	php_uv_t *uv = (php_uv_t*)handle->data;
+	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_init, 0, 0, 1)
-	ZEND_ARG_INFO(0, loop)
-ZEND_END_ARG_INFO()
+	ZVAL_OBJ(&params[0], &uv->std);
+	GC_REFCOUNT(&uv->std)++;
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(php_uv_idle_cb, uv);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_open, 0, 0, 2)
-	ZEND_ARG_INFO(0, resource)
-	ZEND_ARG_INFO(0, udpfd)
-ZEND_END_ARG_INFO()
+	php_uv_do_callback2(&retval, uv, params, 1, PHP_UV_IDLE_CB TSRMLS_CC);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_bind, 0, 0, 3)
-	ZEND_ARG_INFO(0, resource)
-	ZEND_ARG_INFO(0, address)
-	ZEND_ARG_INFO(0, flags)
-ZEND_END_ARG_INFO()
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(php_uv_idle_cb, uv);
+	zval_ptr_dtor(&params[0]);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_bind6, 0, 0, 3)
-	ZEND_ARG_INFO(0, resource)
-	ZEND_ARG_INFO(0, address)
-	ZEND_ARG_INFO(0, flags)
-ZEND_END_ARG_INFO()
+	zval_ptr_dtor(&retval);
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_recv_start, 0, 0, 2)
-	ZEND_ARG_INFO(0, server)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+static void php_uv_getaddrinfo_cb(uv_getaddrinfo_t* handle, int status, struct addrinfo* res)
+{
+	zval retval = {{0}};
+	zval params[2] = {{{0}}};
+	struct addrinfo *address;
+	char ip[INET6_ADDRSTRLEN];
+	const char *addr;
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_recv_stop, 0, 0, 1)
-	ZEND_ARG_INFO(0, server)
-ZEND_END_ARG_INFO()
+	php_uv_t *uv = (php_uv_t*)handle->data;
+	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_set_multicast_loop, 0, 0, 2)
-	ZEND_ARG_INFO(0, server)
-	ZEND_ARG_INFO(0, enabled)
-ZEND_END_ARG_INFO()
+	ZVAL_LONG(&params[0], status);
+	array_init(&params[1]);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_set_multicast_ttl, 0, 0, 2)
-	ZEND_ARG_INFO(0, server)
-	ZEND_ARG_INFO(0, ttl)
-ZEND_END_ARG_INFO()
+	address = res;
+	while (address) {
+		if (address->ai_family == AF_INET) {
+			addr = (char*) &((struct sockaddr_in*) address->ai_addr)->sin_addr;
+			uv_inet_ntop(address->ai_family, addr, ip, INET6_ADDRSTRLEN);
+			add_next_index_string(&params[1], ip);
+		}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_set_broadcast, 0, 0, 2)
-	ZEND_ARG_INFO(0, server)
-	ZEND_ARG_INFO(0, enabled)
-ZEND_END_ARG_INFO()
+		address = address->ai_next;
+	}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_send, 0, 0, 4)
-	ZEND_ARG_INFO(0, server)
-	ZEND_ARG_INFO(0, buffer)
-	ZEND_ARG_INFO(0, address)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	address = res;
+	while (address) {
+		if (address->ai_family == AF_INET6) {
+			addr = (char*) &((struct sockaddr_in6*) address->ai_addr)->sin6_addr;
+			uv_inet_ntop(address->ai_family, addr, ip, INET6_ADDRSTRLEN);
+			add_next_index_string(&params[1], ip);
+		}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_send6, 0, 0, 4)
-	ZEND_ARG_INFO(0, server)
-	ZEND_ARG_INFO(0, buffer)
-	ZEND_ARG_INFO(0, address)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+		address = address->ai_next;
+	}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_pipe_open, 0, 0, 2)
-	ZEND_ARG_INFO(0, file)
-	ZEND_ARG_INFO(0, pipe)
-ZEND_END_ARG_INFO()
+	php_uv_do_callback2(&retval, uv, params, 2, PHP_UV_GETADDR_CB TSRMLS_CC);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_pipe_init, 0, 0, 1)
-	ZEND_ARG_INFO(0, file)
-ZEND_END_ARG_INFO()
+	zval_ptr_dtor(&retval);
+	zval_ptr_dtor(&params[0]);
+	zval_ptr_dtor(&params[1]);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_pipe_bind, 0, 0, 2)
-	ZEND_ARG_INFO(0, handle)
-	ZEND_ARG_INFO(0, name)
-ZEND_END_ARG_INFO()
+	uv_freeaddrinfo(res);
+	clean_uv_handle(uv);
+	php_uv_release(uv);
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_pipe_connect, 0, 0, 3)
-	ZEND_ARG_INFO(0, handle)
-	ZEND_ARG_INFO(0, name)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+static void php_uv_timer_cb(uv_timer_t *handle)
+{
+	zval retval = {{0}};
+	zval params[1] = {{{0}}};
+	php_uv_t *uv = (php_uv_t*)handle->data;
+	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_pipe_pending_count, 0, 0, 1)
-    ZEND_ARG_INFO(0, handle)
-ZEND_END_ARG_INFO()
+	ZVAL_OBJ(&params[0], &uv->std);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_pipe_pending_type, 0, 0, 1)
-    ZEND_ARG_INFO(0, handle)
-ZEND_END_ARG_INFO()
+	if (handle->repeat) {
+		GC_REFCOUNT(&uv->std)++;
+		PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(php_uv_timer_cb, uv);
+	}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_pipe_pending_instances, 0, 0, 2)
-	ZEND_ARG_INFO(0, handle)
-	ZEND_ARG_INFO(0, count)
-ZEND_END_ARG_INFO()
+	php_uv_do_callback2(&retval, uv, params, 1, PHP_UV_TIMER_CB TSRMLS_CC);
 
-/*
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_spawn, 0, 0, 5)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, command)
-	ZEND_ARG_INFO(0, args)
-	ZEND_ARG_INFO(0, options)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
-*/
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(php_uv_timer_cb, uv);
+	zval_ptr_dtor(&params[0]);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_kill, 0, 0, 2)
-	ZEND_ARG_INFO(0, pid)
-	ZEND_ARG_INFO(0, signal)
-ZEND_END_ARG_INFO()
+	zval_ptr_dtor(&retval);
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_process_kill, 0, 0, 2)
-	ZEND_ARG_INFO(0, process)
-	ZEND_ARG_INFO(0, signal)
-ZEND_END_ARG_INFO()
+static void php_uv_signal_cb(uv_signal_t *handle, int sig_num)
+{
+	zval retval = {{0}};
+	zval params[2] = {{{0}}};
+	php_uv_t *uv = (php_uv_t*)handle->data;
+	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_chdir, 0, 0, 1)
-	ZEND_ARG_INFO(0, dir)
-ZEND_END_ARG_INFO()
+	ZVAL_OBJ(&params[0], &uv->std);
+	GC_REFCOUNT(&uv->std)++;
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(php_uv_signal_cb, uv);
+	ZVAL_LONG(&params[1], sig_num);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_tty_get_winsize, 0, 0, 3)
+	php_uv_do_callback2(&retval, uv, params, 2, PHP_UV_SIGNAL_CB TSRMLS_CC);
+
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(php_uv_signal_cb, uv);
+	zval_ptr_dtor(&params[0]);
+	zval_ptr_dtor(&params[1]);
+
+	zval_ptr_dtor(&retval);
+}
+
+void static destruct_uv_stdio(zend_object *obj)
+{
+	php_uv_stdio_t *stdio = (php_uv_stdio_t *) obj;
+
+	zval_ptr_dtor(&stdio->stream);
+}
+
+void static destruct_uv_promise(zend_object *obj)
+{
+	php_uv_promise_t *promise = (php_uv_promise_t *) obj;
+	php_uv_promise_reaction_t *reaction = promise->reactions, *next;
+
+	promise->reactions = NULL;
+	promise->reactions_tail = &promise->reactions;
+	while (reaction) {
+		next = reaction->next;
+		php_uv_promise_reaction_free(reaction);
+		reaction = next;
+	}
+
+	zval_ptr_dtor(&promise->result);
+	ZVAL_UNDEF(&promise->result);
+
+	if (promise->gc_buffer) {
+		efree(promise->gc_buffer);
+		promise->gc_buffer = NULL;
+		promise->gc_buffer_size = 0;
+	}
+}
+
+
+/* common functions */
+
+static void php_uv_ip_common(int ip_type, INTERNAL_FUNCTION_PARAMETERS)
+{
+	php_uv_sockaddr_t *addr;
+	char ip[INET6_ADDRSTRLEN];
+
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		UV_PARAM_OBJ(addr, php_uv_sockaddr_t, (ip_type == 1) ? uv_sockaddr_ipv4_ce : uv_sockaddr_ipv6_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (ip_type == 1) {
+		uv_ip4_name(PHP_UV_SOCKADDR_IPV4_P(addr), ip, INET6_ADDRSTRLEN);
+	} else {
+		uv_ip6_name(PHP_UV_SOCKADDR_IPV6_P(addr), ip, INET6_ADDRSTRLEN);
+	}
+	RETVAL_STRING(ip);
+}
+
+/* libuv (before 1.49) only sets SO_REUSEADDR for UV_UDP_REUSEADDR on linux, which does not spread
+ * datagrams across sockets. SO_REUSEPORT has to be set before bind(), so create the socket here if
+ * libuv did not yet. */
+static int php_uv_udp_set_reuseport(php_uv_t *uv, int family)
+{
+#if !defined(PHP_WIN32) && defined(SO_REUSEPORT)
+	uv_os_fd_t fd;
+	int yes = 1;
+
+	if (uv_fileno(&uv->uv.handle, &fd) != 0) {
+		int r;
+
+		fd = socket(family, SOCK_DGRAM, 0);
+		if (fd < 0) {
+			return -errno;
+		}
+
+		r = uv_udp_open(&uv->uv.udp, fd);
+		if (r) {
+			close(fd);
+			return r;
+		}
+	}
+
+	if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(yes)) != 0) {
+		return -errno;
+	}
+
+	return 0;
+#else
+	return UV_ENOTSUP;
+#endif
+}
+
+static void php_uv_socket_bind(enum php_uv_socket_type ip_type, INTERNAL_FUNCTION_PARAMETERS)
+{
+	php_uv_sockaddr_t *addr;
+	php_uv_t *uv;
+	zend_long flags = 0;
+	int r;
+
+	if (ip_type & PHP_UV_UDP) {
+		ZEND_PARSE_PARAMETERS_START(2, 3)
+			UV_PARAM_OBJ(uv, php_uv_t, uv_udp_ce)
+			UV_PARAM_OBJ(addr, php_uv_sockaddr_t, (ip_type == PHP_UV_UDP_IPV4) ? uv_sockaddr_ipv4_ce : uv_sockaddr_ipv6_ce)
+			Z_PARAM_OPTIONAL
+			Z_PARAM_LONG(flags)
+		ZEND_PARSE_PARAMETERS_END();
+
+		if (flags & PHP_UV_UDP_REUSEPORT) {
+			/* not a libuv flag, uv_udp_bind() would reject it */
+			flags &= ~PHP_UV_UDP_REUSEPORT;
+
+			r = php_uv_udp_set_reuseport(uv, ip_type == PHP_UV_UDP_IPV4 ? AF_INET : AF_INET6);
+			if (r) {
+				php_error_docref(NULL, E_WARNING, "bind failed: %s", php_uv_strerror(r));
+				RETURN_FALSE;
+			}
+		}
+	} else {
+		ZEND_PARSE_PARAMETERS_START(2, 2)
+			UV_PARAM_OBJ(uv, php_uv_t, uv_tcp_ce)
+			UV_PARAM_OBJ(addr, php_uv_sockaddr_t, (ip_type == PHP_UV_TCP_IPV4) ? uv_sockaddr_ipv4_ce : uv_sockaddr_ipv6_ce)
+		ZEND_PARSE_PARAMETERS_END();
+	}
+
+	switch (ip_type) {
+		case PHP_UV_TCP_IPV4:
+			r = uv_tcp_bind((uv_tcp_t*)&uv->uv.tcp, (const struct sockaddr*)&PHP_UV_SOCKADDR_IPV4(addr), 0);
+			break;
+		case PHP_UV_TCP_IPV6:
+			r = uv_tcp_bind((uv_tcp_t*)&uv->uv.tcp, (const struct sockaddr*)&PHP_UV_SOCKADDR_IPV6(addr), 0);
+			break;
+		case PHP_UV_UDP_IPV4:
+			r = uv_udp_bind((uv_udp_t*)&uv->uv.udp, (const struct sockaddr*)&PHP_UV_SOCKADDR_IPV4(addr), flags);
+			break;
+		case PHP_UV_UDP_IPV6:
+			r = uv_udp_bind((uv_udp_t*)&uv->uv.udp, (const struct sockaddr*)&PHP_UV_SOCKADDR_IPV6(addr), flags);
+			break;
+		default:
+			php_error_docref(NULL, E_ERROR, "unhandled type");
+			return;
+	}
+
+	if (r) {
+		php_error_docref(NULL, E_WARNING, "bind failed: %s", php_uv_strerror(r));
+		RETURN_FALSE;
+	} else {
+		RETURN_TRUE;
+	}
+}
+
+static void php_uv_socket_getname(int type, INTERNAL_FUNCTION_PARAMETERS)
+{
+	php_uv_t *uv;
+	zval result;
+	int addr_len;
+	struct sockaddr_storage addr;
+	addr_len = sizeof(struct sockaddr_storage);
+
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		UV_PARAM_OBJ(uv, php_uv_t, type == 3 ? uv_udp_ce : uv_tcp_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+	switch (type) {
+		case 1:
+			uv_tcp_getsockname(&uv->uv.tcp, (struct sockaddr*)&addr, &addr_len);
+			break;
+		case 2:
+			uv_tcp_getpeername(&uv->uv.tcp, (struct sockaddr*)&addr, &addr_len);
+			break;
+		case 3:
+			uv_udp_getsockname(&uv->uv.udp, (struct sockaddr*)&addr, &addr_len);
+			break;
+		default:
+			php_error_docref(NULL, E_ERROR, "unexpected type");
+		break;
+	}
+
+	result = php_uv_address_to_zval((struct sockaddr*)&addr);
+	RETURN_ZVAL(&result, 0, 1);
+}
+
+static void php_uv_handle_open(int (*open_cb)(uv_handle_t *, long), zend_class_entry *ce, INTERNAL_FUNCTION_PARAMETERS) {
+	php_uv_t *uv;
+	zend_long fd; // file handle
+	int error;
+
+	ZEND_PARSE_PARAMETERS_START(2, 2)
+		UV_PARAM_OBJ(uv, php_uv_t, ce)
+		Z_PARAM_LONG(fd)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (fd < 0) {
+		php_error_docref(NULL, E_WARNING, "file descriptor must be unsigned value");
+		RETURN_FALSE;
+	}
+
+	error = open_cb(&uv->uv.handle, fd);
+
+	if (error) {
+		php_error_docref(NULL, E_WARNING, "%s", php_uv_strerror(error));
+	}
+
+	RETURN_LONG(error);
+}
+
+static void php_uv_udp_send(int type, INTERNAL_FUNCTION_PARAMETERS)
+{
+	zend_string *data;
+	php_uv_t *uv;
+	send_req_t *w;
+	php_uv_sockaddr_t *addr;
+	zend_fcall_info fci       = empty_fcall_info;
+	zend_fcall_info_cache fcc = empty_fcall_info_cache;
+	php_uv_cb_t *cb;
+	const struct sockaddr *sa;
+	size_t chunk, offset;
+	int i, parts, r = 0;
+
+	ZEND_PARSE_PARAMETERS_START(3, 4)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_udp_ce)
+		Z_PARAM_STR(data)
+		UV_PARAM_OBJ(addr, php_uv_sockaddr_t, (type == 1) ? uv_sockaddr_ipv4_ce : uv_sockaddr_ipv6_ce)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_FUNC_EX(fci, fcc, 1, 0)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (type == 1) {
+		sa = (const struct sockaddr*)&PHP_UV_SOCKADDR_IPV4(addr);
+	} else {
+		sa = (const struct sockaddr*)&PHP_UV_SOCKADDR_IPV6(addr);
+	}
+
+	/* one uv_udp_send() per kernel-segmented super datagram, or per datagram when php-uv splits */
+	if (uv->gso_size > 0) {
+		chunk = (size_t) uv->gso_size * MIN(PHP_UV_UDP_MAX_SEGMENTS, PHP_UV_UDP_MAX_PAYLOAD / uv->gso_size);
+	} else if (uv->gso_size < 0) {
+		chunk = (size_t) -uv->gso_size;
+	} else {
+		chunk = data->len;
+	}
+	parts = data->len > chunk ? (int) ((data->len + chunk - 1) / chunk) : 1;
+
+	GC_REFCOUNT(&uv->std)++;
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_udp_send, uv);
+
+	PHP_UV_INIT_SEND_REQ(w, uv, data->val, data->len, parts);
+	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_SEND_CB);
+
+	for (i = 0, offset = 0; i < parts; i++, offset += chunk) {
+		uv_buf_t buf = uv_buf_init(w->buf.base + offset, MIN(chunk, w->buf.len - offset));
+
+		w->req[i].data = w;
+		r = uv_udp_send(&w->req[i], &uv->uv.udp, &buf, 1, sa, php_uv_udp_send_cb);
+		if (r) {
+			break;
+		}
+		w->pending++;
+	}
+
+	if (r) {
+		php_error_docref(NULL, E_WARNING, "uv_udp_send failed: %s", php_uv_strerror(r));
+		if (w->pending == 0) {
+			PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_udp_send, uv);
+			OBJ_RELEASE(&uv->std);
+			efree(w->buf.base);
+			efree(w);
+		} else {
+			w->status = r;
+		}
+	}
+}
+
+static void php_uv_udp_relay_release(php_uv_udp_relay_t *relay)
+{
+	if (--relay->handles > 0) {
+		return;
+	}
+
+	zend_hash_destroy(&relay->sessions);
+	efree(relay->upstreams);
+	efree(relay);
+}
+
+static void php_uv_udp_relay_session_close_cb(uv_handle_t *handle)
+{
+	php_uv_udp_relay_session_t *session = PHP_UV_CONTAINER_OF(handle, php_uv_udp_relay_session_t, udp);
+	php_uv_udp_relay_t *relay = session->relay;
+
+	if (session->key) {
+		zend_string_release(session->key);
+	}
+	efree(session);
+
+	php_uv_udp_relay_release(relay);
+}
+
+static void php_uv_udp_relay_timer_close_cb(uv_handle_t *handle)
+{
+	php_uv_udp_relay_release(PHP_UV_CONTAINER_OF(handle, php_uv_udp_relay_t, timer));
+}
+
+static void php_uv_udp_relay_stop(php_uv_udp_relay_t *relay, zend_bool listener_closing)
+{
+	php_uv_t *listener = relay->listener;
+	php_uv_udp_relay_session_t *session;
+
+	if (relay->stopped) {
+		return;
+	}
+	relay->stopped = 1;
+
+	ZEND_HASH_FOREACH_PTR(&relay->sessions, session) {
+		uv_close((uv_handle_t *) &session->udp, php_uv_udp_relay_session_close_cb);
+	} ZEND_HASH_FOREACH_END();
+	zend_hash_clean(&relay->sessions);
+
+	uv_close((uv_handle_t *) &relay->timer, php_uv_udp_relay_timer_close_cb);
+
+	listener->ext = NULL;
+	if (!listener_closing) {
+		php_uv_gc_touch(listener);
+		uv_udp_recv_stop(&listener->uv.udp);
+		PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(php_uv_udp_relay_stop, listener);
+		OBJ_RELEASE(&listener->std);
+	}
+}
+
+static void php_uv_udp_relay_dispose(php_uv_internal_t *internal)
+{
+	php_uv_udp_relay_t *relay = PHP_UV_CONTAINER_OF(internal, php_uv_udp_relay_t, internal);
+
+	php_uv_udp_relay_stop(relay, uv_is_closing(&relay->listener->uv.handle));
+}
+
+static void php_uv_udp_relay_session_dispose(php_uv_internal_t *internal)
+{
+	php_uv_udp_relay_session_t *session = PHP_UV_CONTAINER_OF(internal, php_uv_udp_relay_session_t, internal);
+
+	php_uv_udp_relay_dispose(&session->relay->internal);
+}
+
+/* control plane: callback(UVUdp $listener, long $event, UVSockAddr $client, long $upstream) */
+static void php_uv_udp_relay_event(php_uv_udp_relay_t *relay, php_uv_udp_relay_session_t *session, int event)
+{
+	zval retval = {{0}};
+	zval params[4] = {{{0}}};
+	php_uv_t *uv = relay->listener;
+	php_uv_sockaddr_t *addr;
+	php_uv_cb_t *cb = php_uv_cb_get(uv, PHP_UV_RECV_CB);
+	TSRMLS_FETCH_FROM_CTX(uv->thread_ctx);
+
+	if (cb == NULL || !ZEND_FCI_INITIALIZED(cb->fci)) {
+		return;
+	}
+
+	if (session->client.ss_family == AF_INET) {
+		PHP_UV_SOCKADDR_IPV4_INIT(addr);
+		memcpy(PHP_UV_SOCKADDR_IPV4_P(addr), &session->client, sizeof(struct sockaddr_in));
+	} else {
+		PHP_UV_SOCKADDR_IPV6_INIT(addr);
+		memcpy(PHP_UV_SOCKADDR_IPV6_P(addr), &session->client, sizeof(struct sockaddr_in6));
+	}
+
+	ZVAL_OBJ(&params[0], &uv->std);
+	GC_REFCOUNT(&uv->std)++;
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(php_uv_udp_relay_event, uv);
+	ZVAL_LONG(&params[1], event);
+	ZVAL_OBJ(&params[2], &addr->std);
+	ZVAL_LONG(&params[3], session->upstream);
+
+	php_uv_do_callback2(&retval, uv, params, 4, PHP_UV_RECV_CB TSRMLS_CC);
+
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(php_uv_udp_relay_event, uv);
+	zval_ptr_dtor(&params[0]);
+	zval_ptr_dtor(&params[1]);
+	zval_ptr_dtor(&params[2]);
+	zval_ptr_dtor(&params[3]);
+
+	zval_ptr_dtor(&retval);
+}
+
+/* one receive buffer per relay is enough: datagrams are forwarded before the next read */
+static void php_uv_udp_relay_alloc(uv_handle_t *handle, size_t suggested_size, uv_buf_t *buf)
+{
+	php_uv_udp_relay_t *relay;
+
+	if (PHP_UV_IS_INTERNAL(handle)) {
+		relay = PHP_UV_CONTAINER_OF(handle, php_uv_udp_relay_session_t, udp)->relay;
+	} else {
+		relay = ((php_uv_t *) handle->data)->ext;
+	}
+
+	if (relay) {
+		*buf = uv_buf_init(relay->buf, sizeof(relay->buf));
+	} else {
+		*buf = uv_buf_init(NULL, 0);
+	}
+}
+
+/* client key: port and address; the address alone picks the upstream in source hash mode */
+static size_t php_uv_udp_relay_key(const struct sockaddr *addr, char *key, size_t *addr_offset)
+{
+	if (addr->sa_family == AF_INET) {
+		const struct sockaddr_in *in = (const struct sockaddr_in *) addr;
+		memcpy(key, &in->sin_port, sizeof(in->sin_port));
+		memcpy(key + sizeof(in->sin_port), &in->sin_addr, sizeof(in->sin_addr));
+		*addr_offset = sizeof(in->sin_port);
+		return sizeof(in->sin_port) + sizeof(in->sin_addr);
+	} else {
+		const struct sockaddr_in6 *in6 = (const struct sockaddr_in6 *) addr;
+		memcpy(key, &in6->sin6_port, sizeof(in6->sin6_port));
+		memcpy(key + sizeof(in6->sin6_port), &in6->sin6_addr, sizeof(in6->sin6_addr));
+		*addr_offset = sizeof(in6->sin6_port);
+		return sizeof(in6->sin6_port) + sizeof(in6->sin6_addr);
+	}
+}
+
+static void php_uv_udp_relay_session_recv_cb(uv_udp_t *handle, ssize_t nread, const uv_buf_t *buf, const struct sockaddr *addr, unsigned flags)
+{
+	php_uv_udp_relay_session_t *session = PHP_UV_CONTAINER_OF(handle, php_uv_udp_relay_session_t, udp);
+	php_uv_udp_relay_t *relay = session->relay;
+	uv_buf_t reply;
+
+	if (nread <= 0 || relay->stopped) {
+		return;
+	}
+	if (flags & UV_UDP_PARTIAL) {
+		relay->dropped++;
+		return;
+	}
+
+	session->last_seen = uv_now(handle->loop);
+
+	reply = uv_buf_init(buf->base, nread);
+	if (uv_udp_try_send(&relay->listener->uv.udp, &reply, 1, (const struct sockaddr *) &session->client) < 0) {
+		relay->dropped++;
+	} else {
+		relay->replied++;
+	}
+}
+
+static php_uv_udp_relay_session_t *php_uv_udp_relay_session_open(php_uv_udp_relay_t *relay, const struct sockaddr *addr, const char *key, size_t key_len, size_t addr_offset)
+{
+	php_uv_udp_relay_session_t *session;
+	struct sockaddr_storage any = {0};
+	const struct sockaddr *upstream;
+
+	session = emalloc(sizeof(php_uv_udp_relay_session_t));
+	PHP_UV_INTERNAL_INIT(&session->internal, php_uv_udp_relay_session_dispose);
+	session->relay = relay;
+	session->key = NULL;
+	memcpy(&session->client, addr, addr->sa_family == AF_INET ? sizeof(struct sockaddr_in) : sizeof(struct sockaddr_in6));
+
+	if (relay->mode == PHP_UV_RELAY_SOURCE_HASH) {
+		session->upstream = zend_inline_hash_func(key + addr_offset, key_len - addr_offset) % relay->upstream_count;
+	} else {
+		session->upstream = relay->next++ % relay->upstream_count;
+	}
+	upstream = (const struct sockaddr *) &relay->upstreams[session->upstream];
+
+	if (uv_udp_init(relay->listener->uv.udp.loop, &session->udp)) {
+		efree(session);
+		return NULL;
+	}
+	session->udp.data = &session->internal;
+	relay->handles++;
+
+	any.ss_family = upstream->sa_family;
+	if (uv_udp_bind(&session->udp, (const struct sockaddr *) &any, 0)
+		|| uv_udp_recv_start(&session->udp, php_uv_udp_relay_alloc, php_uv_udp_relay_session_recv_cb)) {
+		uv_close((uv_handle_t *) &session->udp, php_uv_udp_relay_session_close_cb);
+		return NULL;
+	}
+
+	session->key = zend_string_init(key, key_len, 0);
+	zend_hash_add_new_ptr(&relay->sessions, session->key, session);
+
+	php_uv_udp_relay_event(relay, session, PHP_UV_RELAY_SESSION_OPEN);
+
+	return relay->stopped ? NULL : session;
+}
+
+static void php_uv_udp_relay_recv_cb(uv_udp_t *handle, ssize_t nread, const uv_buf_t *buf, const struct sockaddr *addr, unsigned flags)
+{
+	php_uv_t *uv = (php_uv_t *) handle->data;
+	php_uv_udp_relay_t *relay = uv->ext;
+	php_uv_udp_relay_session_t *session;
+	char key[sizeof(uint16_t) + sizeof(struct in6_addr)];
+	size_t key_len, addr_offset;
+	uv_buf_t forward;
+
+	if (nread <= 0 || addr == NULL || relay == NULL) {
+		return;
+	}
+	if (flags & UV_UDP_PARTIAL) {
+		relay->dropped++;
+		return;
+	}
+
+	key_len = php_uv_udp_relay_key(addr, key, &addr_offset);
+	session = zend_hash_str_find_ptr(&relay->sessions, key, key_len);
+	if (session == NULL) {
+		/* every session costs a socket: a flood of new source addresses must not run the process out of descriptors */
+		if (relay->max_sessions && zend_hash_num_elements(&relay->sessions) >= relay->max_sessions) {
+			relay->dropped++;
+			return;
+		}
+		session = php_uv_udp_relay_session_open(relay, addr, key, key_len, addr_offset);
+		if (session == NULL) {
+			if (!relay->stopped) {
+				relay->dropped++;
+			}
+			return;
+		}
+	}
+
+	session->last_seen = uv_now(handle->loop);
+
+	forward = uv_buf_init(buf->base, nread);
+	if (uv_udp_try_send(&session->udp, &forward, 1, (const struct sockaddr *) &relay->upstreams[session->upstream]) < 0) {
+		relay->dropped++;
+	} else {
+		relay->forwarded++;
+	}
+}
+
+static void php_uv_udp_relay_timer_cb(uv_timer_t *handle)
+{
+	php_uv_udp_relay_t *relay = PHP_UV_CONTAINER_OF(handle, php_uv_udp_relay_t, timer);
+	uint64_t now = uv_now(handle->loop);
+	Bucket *p;
+
+	ZEND_HASH_FOREACH_BUCKET(&relay->sessions, p) {
+		php_uv_udp_relay_session_t *session = Z_PTR(p->val);
+
+		if (now - session->last_seen < relay->idle_timeout) {
+			continue;
+		}
+
+		zend_hash_del_bucket(&relay->sessions, p);
+		uv_close((uv_handle_t *) &session->udp, php_uv_udp_relay_session_close_cb);
+
+		php_uv_udp_relay_event(relay, session, PHP_UV_RELAY_SESSION_CLOSE);
+		if (relay->stopped) {
+			break;
+		}
+	} ZEND_HASH_FOREACH_END();
+}
+
+static void php_uv_tcp_connect(enum php_uv_socket_type type, INTERNAL_FUNCTION_PARAMETERS)
+{
+	php_uv_t *uv;
+	php_uv_sockaddr_t *addr;
+	uv_connect_t *req;
+	zend_fcall_info fci       = empty_fcall_info;
+	zend_fcall_info_cache fcc = empty_fcall_info_cache;
+	php_uv_cb_t *cb;
+
+	ZEND_PARSE_PARAMETERS_START(2, 3)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_tcp_ce)
+		UV_PARAM_OBJ(addr, php_uv_sockaddr_t, (type == PHP_UV_TCP_IPV4) ? uv_sockaddr_ipv4_ce : uv_sockaddr_ipv6_ce)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_FUNC_EX(fci, fcc, 1, 0)
+	ZEND_PARSE_PARAMETERS_END();
+
+	GC_REFCOUNT(&uv->std)++;
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_tcp_connect, uv);
+
+	PHP_UV_INIT_CONNECT(req, uv)
+	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_CONNECT_CB);
+	uv->await_type = PHP_UV_CONNECT_CB;
+	if (!ZEND_FCI_INITIALIZED(fci)) {
+		php_uv_promise_attach(uv, return_value);
+	}
+
+	if (type == PHP_UV_TCP_IPV4) {
+		uv_tcp_connect(req, &uv->uv.tcp, (const struct sockaddr*)&PHP_UV_SOCKADDR_IPV4(addr), php_uv_tcp_connect_cb);
+	} else {
+		uv_tcp_connect(req, &uv->uv.tcp,  (const struct sockaddr*)&PHP_UV_SOCKADDR_IPV6(addr), php_uv_tcp_connect_cb);
+	}
+}
+
+/* zend */
+
+static zend_function_entry php_uv_empty_methods[] = {
+	{NULL, NULL, NULL}
+};
+
+int php_uv_cast_object(zval *readobj, zval *writeobj, int type) {
+	if (type == IS_LONG) {
+		ZVAL_LONG(writeobj, Z_OBJ_P(readobj)->handle);
+		return SUCCESS;
+	} else {
+		return zend_std_cast_object_tostring(readobj, writeobj, type);
+	}
+}
+
+static HashTable *php_uv_get_gc(zval *object, zval **table, int *n) {
+	php_uv_t *uv = (php_uv_t *) Z_OBJ_P(object);
+	uint32_t i, count = uv->layout->cb_count * 2;
+
+	if (PHP_UV_IS_DTORED(uv)) {
+		*n = 0;
+		return NULL;
+	}
+
+	/* only objects the GC actually visits pay for the table */
+	if (uv->gc_data == NULL) {
+		uv->gc_data = emalloc((count + 3) * sizeof(zval));
+	}
+
+	for (i = 0; i < uv->layout->cb_count; i++) {
+		php_uv_cb_t *cb = uv->callback[i];
+		if (cb) {
+			ZVAL_COPY_VALUE(&uv->gc_data[i * 2], &cb->fci.function_name);
+			if (cb->fci.object) {
+				ZVAL_OBJ(&uv->gc_data[i * 2 + 1], cb->fci.object);
+			} else {
+				ZVAL_UNDEF(&uv->gc_data[i * 2 + 1]);
+			}
+		} else {
+			ZVAL_UNDEF(&uv->gc_data[i * 2]);
+			ZVAL_UNDEF(&uv->gc_data[i * 2 + 1]);
+		}
+	}
+	ZVAL_COPY_VALUE(&uv->gc_data[count], &uv->fs_fd);
+	ZVAL_COPY_VALUE(&uv->gc_data[count + 1], &uv->fs_fd_alt);
+	ZVAL_COPY_VALUE(&uv->gc_data[count + 2], &uv->awaiter);
+
+	*n = count + 3;
+	*table = uv->gc_data;
+
+	return uv->std.properties;
+}
+
+static void php_uv_loop_gc_append(php_uv_loop_t *loop, int *n, zval *zv) {
+	if (*n == loop->gc_buffer_size) {
+		if (loop->gc_buffer_size == 0) {
+			loop->gc_buffer_size = 16;
+		} else {
+			loop->gc_buffer_size *= 2;
+		}
+		loop->gc_buffer = erealloc(loop->gc_buffer, loop->gc_buffer_size * sizeof(zval));
+	}
+
+	ZVAL_COPY_VALUE(loop->gc_buffer + (*n)++, zv);
+}
+
+static HashTable *php_uv_loop_get_gc(zval *object, zval **table, int *n) {
+	php_uv_loop_t *loop = (php_uv_loop_t *) Z_OBJ_P(object);
+	php_uv_deferred_t *deferred;
+	uint32_t i;
+	int j;
+
+	*n = 0;
+	if (!PHP_UV_IS_DTORED(loop)) {
+		php_uv_gc_sync(loop);
+
+		if (loop->events_count == 0 && loop->deferred == NULL && loop->microtasks_count == 0) {
+			*table = loop->gc_registry;
+			*n = loop->gc_registry_count;
+			return loop->std.properties;
+		}
+
+		for (i = 0; i < loop->gc_registry_count; i++) {
+			php_uv_loop_gc_append(loop, n, &loop->gc_registry[i]);
+		}
+
+		/* queued events hold their arguments until uv_run_collect() hands them out */
+		for (i = 0; i < loop->events_count; i++) {
+			php_uv_event_t *event = &loop->events[(loop->events_head + i) % loop->events_size];
+			for (j = 0; j < event->argc; j++) {
+				php_uv_loop_gc_append(loop, n, &event->args[j]);
+			}
+		}
+
+		for (deferred = loop->deferred; deferred; deferred = deferred->next) {
+			php_uv_loop_gc_append(loop, n, &deferred->cb->fci.function_name);
+			for (j = 0; j < deferred->argc; j++) {
+				php_uv_loop_gc_append(loop, n, &deferred->args[j]);
+			}
+		}
+
+		for (i = 0; i < loop->microtasks_count; i++) {
+			php_uv_loop_gc_append(loop, n, &loop->microtasks[(loop->microtasks_head + i) % loop->microtasks_size].fci.function_name);
+		}
+
+		*table = loop->gc_buffer;
+	}
+
+	return loop->std.properties;
+}
+
+static HashTable *php_uv_stdio_get_gc(zval *object, zval **table, int *n) {
+	php_uv_stdio_t *stdio = (php_uv_stdio_t *) Z_OBJ_P(object);
+
+	*n = 1;
+	*table = &stdio->stream;
+
+	return stdio->std.properties;
+}
+
+static void php_uv_promise_gc_append(php_uv_promise_t *promise, int *n, zval *zv) {
+	if (*n == promise->gc_buffer_size) {
+		if (promise->gc_buffer_size == 0) {
+			promise->gc_buffer_size = 4;
+		} else {
+			promise->gc_buffer_size *= 2;
+		}
+		promise->gc_buffer = erealloc(promise->gc_buffer, promise->gc_buffer_size * sizeof(zval));
+	}
+
+	ZVAL_COPY_VALUE(promise->gc_buffer + (*n)++, zv);
+}
+
+static void php_uv_promise_gc_append_cb(php_uv_promise_t *promise, int *n, php_uv_cb_t *cb) {
+	zval zv;
+
+	if (cb && ZEND_FCI_INITIALIZED(cb->fci)) {
+		php_uv_promise_gc_append(promise, n, &cb->fci.function_name);
+		if (cb->fci.object) {
+			ZVAL_OBJ(&zv, cb->fci.object);
+			php_uv_promise_gc_append(promise, n, &zv);
+		}
+	}
+}
+
+static HashTable *php_uv_promise_get_gc(zval *object, zval **table, int *n) {
+	php_uv_promise_t *promise = (php_uv_promise_t *) Z_OBJ_P(object);
+	php_uv_promise_reaction_t *reaction;
+
+	*n = 0;
+	php_uv_promise_gc_append(promise, n, &promise->result);
+	for (reaction = promise->reactions; reaction; reaction = reaction->next) {
+		php_uv_promise_gc_append(promise, n, &reaction->target);
+		php_uv_promise_gc_append_cb(promise, n, reaction->on_fulfilled);
+		php_uv_promise_gc_append_cb(promise, n, reaction->on_rejected);
+	}
+	*table = promise->gc_buffer;
+
+	return promise->std.properties;
+}
+
+/* object layouts: every class allocates its own libuv struct and the callback slots it can fire */
+#define PHP_UV_CB_BIT(type) (1U << PHP_UV_##type##_CB)
+#define PHP_UV_STREAM_CBS (PHP_UV_CB_BIT(READ) | PHP_UV_CB_BIT(READ2) | PHP_UV_CB_BIT(SHUTDOWN) | PHP_UV_CB_BIT(CLOSE))
+
+#define PHP_UV_LAYOUT(name) \
+	static php_uv_layout_t php_uv_layout_##name; \
+	static zend_object *php_uv_create_uv_##name(zend_class_entry *ce) { \
+		return php_uv_create_uv_ex(ce, &php_uv_layout_##name); \
+	}
+
+#define PHP_UV_REGISTER_LAYOUT(ce, name, handle_type, callbacks) \
+	php_uv_layout_init(&php_uv_layout_##name, ce, sizeof(handle_type), callbacks); \
+	(ce)->create_object = php_uv_create_uv_##name;
+
+static php_uv_layout_t php_uv_layout_any;
+static uint32_t php_uv_layout_count = 0;
+static const php_uv_layout_t *php_uv_layouts[PHP_UV_LAYOUT_MAX];
+
+static void php_uv_layout_init(php_uv_layout_t *layout, zend_class_entry *ce, size_t handle_size, uint32_t callbacks) {
+	int i;
+
+	layout->ce = ce;
+	ZEND_ASSERT(php_uv_layout_count < PHP_UV_LAYOUT_MAX);
+	layout->index = php_uv_layout_count;
+	php_uv_layouts[php_uv_layout_count++] = layout;
+	layout->cb_count = 0;
+	for (i = 0; i < PHP_UV_CB_MAX; i++) {
+		layout->cb_slot[i] = (callbacks & (1U << i)) ? (int8_t) layout->cb_count++ : -1;
+	}
+	layout->size = XtOffsetOf(php_uv_t, uv) + ZEND_MM_ALIGNED_SIZE(handle_size) + layout->cb_count * sizeof(php_uv_cb_t *);
+	layout->loop_ref = ce == uv_signal_ce || ce == uv_timer_ce || ce == uv_idle_ce || ce == uv_udp_ce || ce == uv_tcp_ce || ce == uv_tty_ce || ce == uv_pipe_ce || ce == uv_prepare_ce || ce == uv_check_ce || ce == uv_poll_ce || ce == uv_fs_poll_ce;
+}
+
+static zend_object *php_uv_create_uv_ex(zend_class_entry *ce, const php_uv_layout_t *layout) {
+	php_uv_t *uv = UV_G(pool)[layout->index];
+
+	if (uv) {
+		/* still registered in the object store with the single reference the pool held */
+		UV_G(pool)[layout->index] = uv->pool_next;
+		UV_G(pool_count)[layout->index]--;
+		GC_FLAGS(&uv->std) &= ~IS_OBJ_DESTRUCTOR_CALLED;
+	} else {
+		uv = emalloc(layout->size);
+		zend_object_std_init(&uv->std, ce);
+		uv->std.handlers = &uv_handlers;
+
+		uv->layout = layout;
+		uv->callback = (php_uv_cb_t **) ((char *) uv + layout->size - layout->cb_count * sizeof(php_uv_cb_t *));
+		uv->gc_data = NULL;
+	}
+	PHP_UV_INIT_ZVALS(uv);
+	TSRMLS_SET_CTX(uv->thread_ctx);
+
+	/* a recycled object starts out like a fresh one: nothing of its previous life is kept */
+	uv->pool_next = NULL;
+	uv->sock = (uv_os_sock_t) -1;
+	uv->buffer = NULL;
+	uv->gso_size = 0;
+	uv->ext = NULL;
+	uv->timeouts = NULL;
+	uv->fs_bufs = NULL;
+	uv->stat_epoch = 0;
+	uv->gc_slot = 0;
+	uv->gc_dirty = 0;
+	uv->sink = PHP_UV_SINK_CALLBACK;
+	uv->await_type = -1;
+	uv->uv.handle.data = uv;
+
+	return &uv->std;
+}
+
+static zend_object *php_uv_create_uv(zend_class_entry *ce) {
+	return php_uv_create_uv_ex(ce, &php_uv_layout_any);
+}
+
+PHP_UV_LAYOUT(tcp)
+PHP_UV_LAYOUT(udp)
+PHP_UV_LAYOUT(pipe)
+PHP_UV_LAYOUT(idle)
+PHP_UV_LAYOUT(timer)
+PHP_UV_LAYOUT(async)
+PHP_UV_LAYOUT(stream)
+PHP_UV_LAYOUT(addrinfo)
+PHP_UV_LAYOUT(process)
+PHP_UV_LAYOUT(prepare)
+PHP_UV_LAYOUT(check)
+PHP_UV_LAYOUT(work)
+PHP_UV_LAYOUT(fs)
+PHP_UV_LAYOUT(fs_event)
+PHP_UV_LAYOUT(tty)
+PHP_UV_LAYOUT(fs_poll)
+PHP_UV_LAYOUT(poll)
+PHP_UV_LAYOUT(signal)
+
+void static free_uv(zend_object *obj)
+{
+	php_uv_t *uv = (php_uv_t *) obj;
+
+	php_uv_gc_forget(uv);
+	if (uv->gc_data) {
+		efree(uv->gc_data);
+	}
+
+	zend_object_std_dtor(obj);
+}
+
+#if UV_VERSION_HEX < 0x012D00
+static void php_uv_metrics_prepare_cb(uv_prepare_t *handle)
+{
+	PHP_UV_CONTAINER_OF(handle, php_uv_loop_t, metrics_prepare)->iterations++;
+}
+
+static void php_uv_metrics_prepare_dispose(php_uv_internal_t *internal)
+{
+	php_uv_loop_t *loop = PHP_UV_CONTAINER_OF(internal, php_uv_loop_t, metrics_internal);
+
+	uv_close((uv_handle_t *) &loop->metrics_prepare, NULL);
+}
+#endif
+
+static zend_object *php_uv_create_uv_loop(zend_class_entry *ce) {
+	php_uv_loop_t *loop = emalloc(sizeof(php_uv_loop_t));
+	zend_object_std_init(&loop->std, ce);
+	loop->std.handlers = &uv_loop_handlers;
+	
+	uv_loop_init(&loop->loop);
+#if UV_VERSION_HEX >= 0x012700
+	uv_loop_configure(&loop->loop, UV_METRICS_IDLE_TIME);
+#endif
+#if UV_VERSION_HEX < 0x012D00
+	uv_prepare_init(&loop->loop, &loop->metrics_prepare);
+	PHP_UV_INTERNAL_INIT(&loop->metrics_internal, php_uv_metrics_prepare_dispose);
+	loop->metrics_prepare.data = &loop->metrics_internal;
+	uv_prepare_start(&loop->metrics_prepare, php_uv_metrics_prepare_cb);
+	uv_unref((uv_handle_t *) &loop->metrics_prepare);
+	loop->iterations = 0;
+#endif
+	memset(loop->callbacks, 0, sizeof(loop->callbacks));
+	loop->watchdog = NULL;
+	loop->gc_idle = 0;
+	loop->gc_idle_init = 0;
+	loop->gc_idle_slice = 0;
+	loop->gc_idle_last = 0;
+	loop->timeouts_pool = NULL;
+	loop->timeouts_pool_count = 0;
+	loop->microtasks = NULL;
+	loop->microtasks_head = 0;
+	loop->microtasks_count = 0;
+	loop->microtasks_size = 0;
+	loop->microtask_init = 0;
+	loop->stat_cache = NULL;
+	loop->stat_hits = NULL;
+	loop->stat_hits_count = 0;
+	loop->stat_hits_size = 0;
+	loop->stat_hits_init = 0;
+
+	loop->gc_buffer_size = 0;
+	loop->gc_buffer = NULL;
+
+	loop->gc_registry = NULL;
+	loop->gc_registry_count = 0;
+	loop->gc_registry_size = 0;
+	loop->gc_dirty = NULL;
+	loop->gc_dirty_count = 0;
+	loop->gc_dirty_size = 0;
+
+	loop->events = NULL;
+	loop->events_head = 0;
+	loop->events_count = 0;
+	loop->events_size = 0;
+	loop->collect_timer_init = 0;
+
+	loop->budget = NULL;
+	loop->deferred = NULL;
+	loop->deferred_tail = &loop->deferred;
+
+	return &loop->std;
+}
+
+static zend_object *php_uv_create_uv_sockaddr(zend_class_entry *ce) {
+	php_uv_sockaddr_t *sockaddr = emalloc(sizeof(php_uv_sockaddr_t));
+	zend_object_std_init(&sockaddr->std, ce);
+	sockaddr->std.handlers = &uv_default_handlers;
+
+	return &sockaddr->std;
+}
+
+static zend_object *php_uv_create_uv_lock(zend_class_entry *ce) {
+	php_uv_lock_t *lock = emalloc(sizeof(php_uv_lock_t));
+	zend_object_std_init(&lock->std, ce);
+	lock->std.handlers = &uv_lock_handlers;
+
+	lock->locked = 0;
+
+	return &lock->std;
+}
+
+static zend_object *php_uv_create_uv_stdio(zend_class_entry *ce) {
+	php_uv_stdio_t *stdio = emalloc(sizeof(php_uv_stdio_t));
+	zend_object_std_init(&stdio->std, ce);
+	stdio->std.handlers = &uv_stdio_handlers;
+
+	stdio->flags = 0;
+	ZVAL_UNDEF(&stdio->stream);
+
+	return &stdio->std;
+}
+
+static zend_object *php_uv_create_uv_promise(zend_class_entry *ce) {
+	php_uv_promise_t *promise = emalloc(sizeof(php_uv_promise_t));
+	zend_object_std_init(&promise->std, ce);
+	promise->std.handlers = &uv_promise_handlers;
+
+	promise->state = PHP_UV_PROMISE_PENDING;
+	ZVAL_UNDEF(&promise->result);
+	promise->reactions = NULL;
+	promise->reactions_tail = &promise->reactions;
+	promise->pending = 0;
+	promise->timeout = NULL;
+	promise->gc_buffer_size = 0;
+	promise->gc_buffer = NULL;
+
+	return &promise->std;
+}
+
+static zend_object *php_uv_create_uv_runtime(zend_class_entry *ce) {
+	php_uv_runtime_t *runtime = emalloc(sizeof(php_uv_runtime_t));
+	zend_object_std_init(&runtime->std, ce);
+	runtime->std.handlers = &uv_runtime_handlers;
+
+	runtime->shared = NULL;
+
+	return &runtime->std;
+}
+
+static zend_object *php_uv_create_uv_stat(zend_class_entry *ce) {
+	php_uv_stat_t *stat = emalloc(sizeof(php_uv_stat_t));
+	zend_object_std_init(&stat->std, ce);
+	stat->std.handlers = &uv_stat_handlers;
+
+	memset(&stat->stat, 0, sizeof(uv_stat_t));
+
+	return &stat->std;
+}
+
+static zend_object *php_uv_create_uv_timer_wheel(zend_class_entry *ce) {
+	php_uv_timer_wheel_t *wheel = emalloc(sizeof(php_uv_timer_wheel_t));
+	zend_object_std_init(&wheel->std, ce);
+	wheel->std.handlers = &uv_timer_wheel_handlers;
+
+	wheel->driver = NULL;
+	wheel->armed = 0;
+	wheel->callback = NULL;
+	wheel->tick = 1;
+	wheel->epoch = 0;
+	wheel->current = 0;
+	wheel->mask = 0;
+	wheel->slots = NULL;
+	wheel->entries = NULL;
+	wheel->entries_size = 0;
+	wheel->free = -1;
+	wheel->count = 0;
+
+	return &wheel->std;
+}
+
+static void php_uv_timer_wheel_driver_close_cb(uv_handle_t *handle)
+{
+	efree(PHP_UV_CONTAINER_OF(handle, php_uv_timer_wheel_driver_t, timer));
+}
+
+void static free_uv_timer_wheel(zend_object *obj)
+{
+	php_uv_timer_wheel_t *wheel = (php_uv_timer_wheel_t *) obj;
+
+	/* an armed wheel is referenced by its timer, so it is stopped here */
+	if (wheel->driver) {
+		wheel->driver->wheel = NULL;
+		uv_close((uv_handle_t *) &wheel->driver->timer, php_uv_timer_wheel_driver_close_cb);
+	}
+	if (wheel->callback) {
+		php_uv_cb_free(wheel->callback);
+	}
+	if (wheel->slots) {
+		efree(wheel->slots);
+	}
+	if (wheel->entries) {
+		efree(wheel->entries);
+	}
+
+	zend_object_std_dtor(obj);
+}
+
+static HashTable *php_uv_timer_wheel_get_gc(zval *object, zval **table, int *n) {
+	php_uv_timer_wheel_t *wheel = (php_uv_timer_wheel_t *) Z_OBJ_P(object);
+
+	*n = 0;
+	if (wheel->callback && ZEND_FCI_INITIALIZED(wheel->callback->fci)) {
+		ZVAL_COPY_VALUE(&wheel->gc_table[(*n)++], &wheel->callback->fci.function_name);
+		if (wheel->callback->fci.object) {
+			ZVAL_OBJ(&wheel->gc_table[(*n)++], wheel->callback->fci.object);
+		}
+	}
+	*table = wheel->gc_table;
+
+	return wheel->std.properties;
+}
+
+static zend_class_entry *php_uv_register_internal_class_ex(const char *name, zend_class_entry *parent) {
+	zend_class_entry ce = {0}, *new;
+
+	ce.name = zend_new_interned_string(zend_string_init(name, strlen(name), 1));
+	ce.info.internal.builtin_functions = php_uv_empty_methods;
+	new = zend_register_internal_class_ex(&ce, parent);
+	new->serialize = zend_class_serialize_deny;
+	new->unserialize = zend_class_unserialize_deny;
+	new->ce_flags |= ZEND_ACC_FINAL;
+	new->create_object = php_uv_create_uv;
+
+	return new;
+}
+
+static zend_class_entry *php_uv_register_internal_class(const char *name) {
+	return php_uv_register_internal_class_ex(name, NULL);
+}
+
+static zend_function *php_uv_get_ctor(zend_object *object) {
+	zend_throw_error(NULL, "The UV classes cannot be instantiated manually");
+	return NULL;
+}
+
+PHP_MINIT_FUNCTION(uv)
+{
+	PHP_UV_PROBE(MINIT);
+
+#ifdef ZTS
+	uv_mutex_init(&php_uv_runtime_orphans_lock);
+#endif
+
+	memcpy(&uv_default_handlers, zend_get_std_object_handlers(), sizeof(zend_object_handlers));
+	uv_default_handlers.clone_obj = NULL;
+	uv_default_handlers.get_constructor = php_uv_get_ctor;
+	uv_default_handlers.cast_object = php_uv_cast_object;
+
+	uv_ce = php_uv_register_internal_class("UV");
+	uv_ce->ce_flags |= ZEND_ACC_ABSTRACT;
+	uv_ce->ce_flags &= ~ZEND_ACC_FINAL;
+	memcpy(&uv_handlers, &uv_default_handlers, sizeof(zend_object_handlers));
+	uv_handlers.get_gc = php_uv_get_gc;
+	uv_handlers.dtor_obj = destruct_uv;
+	uv_handlers.free_obj = free_uv;
+
+	php_uv_init(uv_ce);
+
+	uv_tcp_ce = php_uv_register_internal_class_ex("UVTcp", uv_ce);
+	uv_udp_ce = php_uv_register_internal_class_ex("UVUdp", uv_ce);
+	uv_pipe_ce = php_uv_register_internal_class_ex("UVPipe", uv_ce);
+	uv_idle_ce = php_uv_register_internal_class_ex("UVIdle", uv_ce);
+	uv_timer_ce = php_uv_register_internal_class_ex("UVTimer", uv_ce);
+	uv_async_ce = php_uv_register_internal_class_ex("UVAsync", uv_ce);
+	uv_stream_ce = php_uv_register_internal_class_ex("UVStream", uv_ce);
+	uv_addrinfo_ce = php_uv_register_internal_class_ex("UVAddrinfo", uv_ce);
+	uv_process_ce = php_uv_register_internal_class_ex("UVProcess", uv_ce);
+	uv_prepare_ce = php_uv_register_internal_class_ex("UVPrepare", uv_ce);
+	uv_check_ce = php_uv_register_internal_class_ex("UVCheck", uv_ce);
+	uv_work_ce = php_uv_register_internal_class_ex("UVWork", uv_ce);
+	uv_fs_ce = php_uv_register_internal_class_ex("UVFs", uv_ce);
+	uv_fs_event_ce = php_uv_register_internal_class_ex("UVFsEvent", uv_ce);
+	uv_tty_ce = php_uv_register_internal_class_ex("UVTty", uv_ce);
+	uv_fs_poll_ce = php_uv_register_internal_class_ex("UVFSPoll", uv_ce);
+	uv_poll_ce = php_uv_register_internal_class_ex("UVPoll", uv_ce);
+	uv_signal_ce = php_uv_register_internal_class_ex("UVSignal", uv_ce);
+
+	php_uv_layout_init(&php_uv_layout_any, uv_ce, sizeof(((php_uv_t *) NULL)->uv), ~0U >> (32 - PHP_UV_CB_MAX));
+	PHP_UV_REGISTER_LAYOUT(uv_tcp_ce, tcp, uv_tcp_t, PHP_UV_STREAM_CBS | PHP_UV_CB_BIT(LISTEN) | PHP_UV_CB_BIT(CONNECT));
+	PHP_UV_REGISTER_LAYOUT(uv_udp_ce, udp, uv_udp_t, PHP_UV_CB_BIT(RECV) | PHP_UV_CB_BIT(SEND) | PHP_UV_CB_BIT(CLOSE));
+	PHP_UV_REGISTER_LAYOUT(uv_pipe_ce, pipe, uv_pipe_t, PHP_UV_STREAM_CBS | PHP_UV_CB_BIT(LISTEN) | PHP_UV_CB_BIT(PIPE_CONNECT));
+	PHP_UV_REGISTER_LAYOUT(uv_idle_ce, idle, uv_idle_t, PHP_UV_CB_BIT(IDLE) | PHP_UV_CB_BIT(CLOSE));
+	PHP_UV_REGISTER_LAYOUT(uv_timer_ce, timer, uv_timer_t, PHP_UV_CB_BIT(TIMER) | PHP_UV_CB_BIT(CLOSE));
+	PHP_UV_REGISTER_LAYOUT(uv_async_ce, async, uv_async_t, PHP_UV_CB_BIT(ASYNC) | PHP_UV_CB_BIT(CLOSE));
+	PHP_UV_REGISTER_LAYOUT(uv_stream_ce, stream, uv_stream_t, PHP_UV_STREAM_CBS | PHP_UV_CB_BIT(LISTEN));
+	PHP_UV_REGISTER_LAYOUT(uv_addrinfo_ce, addrinfo, uv_getaddrinfo_t, PHP_UV_CB_BIT(GETADDR));
+	PHP_UV_REGISTER_LAYOUT(uv_process_ce, process, uv_process_t, PHP_UV_CB_BIT(PROC_CLOSE) | PHP_UV_CB_BIT(CLOSE));
+	PHP_UV_REGISTER_LAYOUT(uv_prepare_ce, prepare, uv_prepare_t, PHP_UV_CB_BIT(PREPARE) | PHP_UV_CB_BIT(CLOSE));
+	PHP_UV_REGISTER_LAYOUT(uv_check_ce, check, uv_check_t, PHP_UV_CB_BIT(CHECK) | PHP_UV_CB_BIT(CLOSE));
+	PHP_UV_REGISTER_LAYOUT(uv_work_ce, work, uv_work_t, PHP_UV_CB_BIT(WORK) | PHP_UV_CB_BIT(AFTER_WORK));
+	PHP_UV_REGISTER_LAYOUT(uv_fs_ce, fs, uv_fs_t, PHP_UV_CB_BIT(FS));
+	PHP_UV_REGISTER_LAYOUT(uv_fs_event_ce, fs_event, uv_fs_event_t, PHP_UV_CB_BIT(FS_EVENT) | PHP_UV_CB_BIT(CLOSE));
+	PHP_UV_REGISTER_LAYOUT(uv_tty_ce, tty, uv_tty_t, PHP_UV_STREAM_CBS);
+	PHP_UV_REGISTER_LAYOUT(uv_fs_poll_ce, fs_poll, uv_fs_poll_t, PHP_UV_CB_BIT(FS_POLL) | PHP_UV_CB_BIT(CLOSE));
+	PHP_UV_REGISTER_LAYOUT(uv_poll_ce, poll, uv_poll_t, PHP_UV_CB_BIT(POLL) | PHP_UV_CB_BIT(CLOSE));
+	PHP_UV_REGISTER_LAYOUT(uv_signal_ce, signal, uv_signal_t, PHP_UV_CB_BIT(SIGNAL) | PHP_UV_CB_BIT(CLOSE));
+
+	uv_loop_ce = php_uv_register_internal_class("UVLoop");
+	uv_loop_ce->create_object = php_uv_create_uv_loop;
+	memcpy(&uv_loop_handlers, &uv_default_handlers, sizeof(zend_object_handlers));
+	uv_loop_handlers.get_gc = php_uv_loop_get_gc;
+	uv_loop_handlers.dtor_obj = destruct_uv_loop;
+	uv_loop_handlers.free_obj = free_uv_loop;
+
+	uv_sockaddr_ce = php_uv_register_internal_class("UVSockAddr");
+	uv_sockaddr_ce->ce_flags |= ZEND_ACC_ABSTRACT;
+	uv_sockaddr_ce->ce_flags &= ~ZEND_ACC_FINAL;
+	uv_sockaddr_ce->create_object = php_uv_create_uv_sockaddr;
+
+	uv_sockaddr_ipv4_ce = php_uv_register_internal_class_ex("UVSockAddrIPv4", uv_sockaddr_ce);
+	uv_sockaddr_ipv4_ce->create_object = php_uv_create_uv_sockaddr;
+
+	uv_sockaddr_ipv6_ce = php_uv_register_internal_class_ex("UVSockAddrIPv6", uv_sockaddr_ce);
+	uv_sockaddr_ipv6_ce->create_object = php_uv_create_uv_sockaddr;
+
+	uv_lock_ce = php_uv_register_internal_class("UVLock");
+	uv_lock_ce->create_object = php_uv_create_uv_lock;
+	memcpy(&uv_lock_handlers, &uv_default_handlers, sizeof(zend_object_handlers));
+	uv_lock_handlers.dtor_obj = destruct_uv_lock;
+
+	uv_stdio_ce = php_uv_register_internal_class("UVStdio");
+	uv_stdio_ce->create_object = php_uv_create_uv_stdio;
+	memcpy(&uv_stdio_handlers, &uv_default_handlers, sizeof(zend_object_handlers));
+	uv_stdio_handlers.dtor_obj = destruct_uv_stdio;
+	uv_stdio_handlers.get_gc = php_uv_stdio_get_gc;
+
+	uv_promise_ce = php_uv_register_internal_class("UVPromise");
+	uv_promise_ce->create_object = php_uv_create_uv_promise;
+	memcpy(&uv_promise_handlers, &uv_default_handlers, sizeof(zend_object_handlers));
+	uv_promise_handlers.dtor_obj = destruct_uv_promise;
+	uv_promise_handlers.get_gc = php_uv_promise_get_gc;
+
+	uv_runtime_ce = php_uv_register_internal_class("UVRuntime");
+	uv_runtime_ce->create_object = php_uv_create_uv_runtime;
+	memcpy(&uv_runtime_handlers, &uv_default_handlers, sizeof(zend_object_handlers));
+	uv_runtime_handlers.free_obj = free_uv_runtime;
+
+	uv_timer_wheel_ce = php_uv_register_internal_class("UVTimerWheel");
+	uv_timer_wheel_ce->create_object = php_uv_create_uv_timer_wheel;
+	memcpy(&uv_timer_wheel_handlers, &uv_default_handlers, sizeof(zend_object_handlers));
+	uv_timer_wheel_handlers.free_obj = free_uv_timer_wheel;
+	uv_timer_wheel_handlers.get_gc = php_uv_timer_wheel_get_gc;
+
+	uv_stat_ce = php_uv_register_internal_class("UVStat");
+	uv_stat_ce->create_object = php_uv_create_uv_stat;
+	memcpy(&uv_stat_handlers, &uv_default_handlers, sizeof(zend_object_handlers));
+	uv_stat_handlers.read_property = php_uv_stat_read_property;
+	uv_stat_handlers.write_property = php_uv_stat_write_property;
+	uv_stat_handlers.has_property = php_uv_stat_has_property;
+	uv_stat_handlers.unset_property = php_uv_stat_unset_property;
+	uv_stat_handlers.get_property_ptr_ptr = php_uv_stat_get_property_ptr_ptr;
+	uv_stat_handlers.read_dimension = php_uv_stat_read_dimension;
+	uv_stat_handlers.write_dimension = php_uv_stat_write_dimension;
+	uv_stat_handlers.has_dimension = php_uv_stat_has_dimension;
+	uv_stat_handlers.unset_dimension = php_uv_stat_unset_dimension;
+	uv_stat_handlers.get_properties = php_uv_stat_get_properties;
+	uv_stat_handlers.count_elements = php_uv_stat_count_elements;
+	uv_stat_handlers.get_gc = php_uv_stat_get_gc;
+
+#if PHP_VERSION_ID >= 70100
+	php_uv_prev_interrupt_function = zend_interrupt_function;
+	zend_interrupt_function = php_uv_interrupt_function;
+#endif
+
+#if !defined(PHP_WIN32) && !(defined(HAVE_SOCKETS) && !defined(COMPILE_DL_SOCKETS))
+	{
+		zend_module_entry *sockets;
+		if ((sockets = zend_hash_str_find_ptr(&module_registry, ZEND_STRL("sockets")))) {
+			if (sockets->handle) { // shared
+				php_sockets_le_socket = (int (*)(void)) DL_FETCH_SYMBOL(sockets->handle, "php_sockets_le_socket");
+				if (php_sockets_le_socket == NULL) {
+					php_sockets_le_socket = (int (*)(void)) DL_FETCH_SYMBOL(sockets->handle, "_php_sockets_le_socket");
+				}
+			}
+		}
+	}
+#endif
+
+	return SUCCESS;
+}
+
+PHP_RINIT_FUNCTION(uv)
+{
+	UV_G(pool_enabled) = 1;
+	zend_hash_init(&UV_G(timeouts), 8, NULL, NULL, 0);
+	UV_G(timeout_id) = 0;
+
+	return SUCCESS;
+}
+
+PHP_RSHUTDOWN_FUNCTION(uv)
+{
+	UV_G(watchdog) = NULL;
+
+#ifdef ZTS
+	/* cheap: only runtimes whose workers already exited */
+	php_uv_runtime_reap(0);
+#endif
+
+	if (UV_G(default_loop)) {
+		uv_loop_t *loop = &UV_G(default_loop)->loop;
+
+		/* for proper destruction: close all handles, let libuv call close callback and then close and free the loop */
+		php_uv_loop_clear_events(UV_G(default_loop));
+		php_uv_loop_clear_deferred(UV_G(default_loop));
+		php_uv_loop_clear_microtasks(UV_G(default_loop));
+		uv_stop(loop); /* in case we longjmp()'ed ... */
+		uv_run(loop, UV_RUN_DEFAULT); /* invalidate the stop ;-) */
+
+		uv_walk(loop, destruct_uv_loop_walk_cb, NULL);
+		uv_run(loop, UV_RUN_DEFAULT);
+		uv_loop_close(loop);
+		OBJ_RELEASE(&UV_G(default_loop)->std);
+	}
+
+	php_uv_pool_clear();
+	/* the timers are gone with their loops */
+	zend_hash_destroy(&UV_G(timeouts));
+
+	return SUCCESS;
+}
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_run, 0, 0, 1)
+	ZEND_ARG_INFO(0, loop)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_event_sink, 0, 0, 2)
+	ZEND_ARG_INFO(0, handle)
+	ZEND_ARG_INFO(0, sink)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_run_budget, 0, 0, 0)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, max_ms)
+	ZEND_ARG_INFO(0, max_callbacks)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_loop_metrics, 0, 0, 0)
+	ZEND_ARG_INFO(0, loop)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_loop_watchdog, 0, 0, 2)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, threshold)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_loop_watchdog_report, 0, 0, 1)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, reset)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_loop_gc_idle, 0, 0, 2)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, enable)
+	ZEND_ARG_INFO(0, slice)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_run_collect, 0, 0, 0)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, max)
+	ZEND_ARG_INFO(0, timeout)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_coroutine, 0, 0, 1)
+	ZEND_ARG_INFO(0, coroutine)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_promise_then, 0, 0, 1)
+	ZEND_ARG_INFO(0, promise)
+	ZEND_ARG_INFO(0, on_fulfilled)
+	ZEND_ARG_INFO(0, on_rejected)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_promise_all, 0, 0, 1)
+	ZEND_ARG_INFO(0, promises)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_promise_race, 0, 0, 1)
+	ZEND_ARG_INFO(0, promises)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_promise_timeout, 0, 0, 2)
+	ZEND_ARG_INFO(0, promise)
+	ZEND_ARG_INFO(0, timeout)
+	ZEND_ARG_INFO(0, loop)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_runtime_new, 0, 0, 2)
+	ZEND_ARG_INFO(0, workers)
+	ZEND_ARG_INFO(0, bootstrap)
+	ZEND_ARG_INFO(0, listener)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_runtime_stop, 0, 0, 1)
+	ZEND_ARG_INFO(0, runtime)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_runtime_join, 0, 0, 1)
+	ZEND_ARG_INFO(0, runtime)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_stop, 0, 0, 1)
+	ZEND_ARG_INFO(0, loop)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_loop_delete, 0, 0, 1)
+	ZEND_ARG_INFO(0, loop)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_now, 0, 0, 1)
+	ZEND_ARG_INFO(0, loop)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_backend_fd, 0, 0, 0)
+	ZEND_ARG_INFO(0, loop)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_backend_timeout, 0, 0, 0)
+	ZEND_ARG_INFO(0, loop)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_tcp_connect, 0, 0, 2)
+	ZEND_ARG_INFO(0, resource)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_tcp_connect6, 0, 0, 2)
+	ZEND_ARG_INFO(0, resource)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_tcp_init, 0, 0, 1)
+	ZEND_ARG_INFO(0, loop)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_listen, 0, 0, 3)
+	ZEND_ARG_INFO(0, resource)
+	ZEND_ARG_INFO(0, backlog)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_accept, 0, 0, 2)
+	ZEND_ARG_INFO(0, server)
+	ZEND_ARG_INFO(0, client)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_read_start, 0, 0, 2)
+	ZEND_ARG_INFO(0, server)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_read2_start, 0, 0, 2)
+	ZEND_ARG_INFO(0, server)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_read_stop, 0, 0, 1)
+	ZEND_ARG_INFO(0, server)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_write, 0, 0, 3)
+	ZEND_ARG_INFO(0, client)
+	ZEND_ARG_INFO(0, data)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_write2, 0, 0, 4)
+	ZEND_ARG_INFO(0, client)
+	ZEND_ARG_INFO(0, data)
+	ZEND_ARG_INFO(0, send)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_stream_set_timeouts, 0, 0, 4)
+	ZEND_ARG_INFO(0, handle)
+	ZEND_ARG_INFO(0, idle)
+	ZEND_ARG_INFO(0, read)
+	ZEND_ARG_INFO(0, write)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_strerror, 0, 0, 1)
+	ZEND_ARG_INFO(0, error)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_err_name, 0, 0, 1)
+	ZEND_ARG_INFO(0, error)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_timer_init, 0, 0, 1)
+	ZEND_ARG_INFO(0, loop)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_idle_stop, 0, 0, 1)
+	ZEND_ARG_INFO(0, idle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_timer_start, 0, 0, 4)
+	ZEND_ARG_INFO(0, timer)
+	ZEND_ARG_INFO(0, timeout)
+	ZEND_ARG_INFO(0, repeat)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_timer_stop, 0, 0, 1)
+	ZEND_ARG_INFO(0, timer)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_timer_again, 0, 0, 1)
+	ZEND_ARG_INFO(0, timer)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_timer_set_repeat, 0, 0, 2)
+	ZEND_ARG_INFO(0, timer)
+	ZEND_ARG_INFO(0, timeout)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_timer_get_repeat, 0, 0, 1)
+	ZEND_ARG_INFO(0, timer)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_timer_wheel_new, 0, 0, 2)
+	ZEND_ARG_INFO(0, tick)
+	ZEND_ARG_INFO(0, callback)
+	ZEND_ARG_INFO(0, slots)
+	ZEND_ARG_INFO(0, loop)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_timer_wheel_add, 0, 0, 2)
+	ZEND_ARG_INFO(0, wheel)
+	ZEND_ARG_INFO(0, timeout)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_timer_wheel_reset, 0, 0, 2)
+	ZEND_ARG_INFO(0, wheel)
+	ZEND_ARG_INFO(0, id)
+	ZEND_ARG_INFO(0, timeout)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_timer_wheel_cancel, 0, 0, 2)
+	ZEND_ARG_INFO(0, wheel)
+	ZEND_ARG_INFO(0, id)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_timer_wheel_count, 0, 0, 1)
+	ZEND_ARG_INFO(0, wheel)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_set_timeout, 0, 0, 3)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, timeout)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_clear_timeout, 0, 0, 1)
+	ZEND_ARG_INFO(0, id)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_queue_microtask, 0, 0, 2)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_idle_start, 0, 0, 2)
+	ZEND_ARG_INFO(0, timer)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_tcp_open, 0, 0, 2)
+	ZEND_ARG_INFO(0, resource)
+	ZEND_ARG_INFO(0, tcpfd)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_tcp_bind, 0, 0, 2)
+	ZEND_ARG_INFO(0, resource)
+	ZEND_ARG_INFO(0, address)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_tcp_bind6, 0, 0, 2)
+	ZEND_ARG_INFO(0, resource)
+	ZEND_ARG_INFO(0, address)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_shutdown, 0, 0, 2)
+	ZEND_ARG_INFO(0, stream)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_close, 0, 0, 2)
+	ZEND_ARG_INFO(0, stream)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_idle_init, 0, 0, 1)
+	ZEND_ARG_INFO(0, loop)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_update_time, 0, 0, 1)
+	ZEND_ARG_INFO(0, loop)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_is_active, 0, 0, 1)
+	ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_is_closing, 0, 0, 1)
+	ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_is_readable, 0, 0, 1)
+	ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_is_writable, 0, 0, 1)
+	ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_walk, 0, 0, 3)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, callback)
+	ZEND_ARG_INFO(0, opaque)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_guess_handle, 0, 0, 1)
+	ZEND_ARG_INFO(0, fd)
+ZEND_END_ARG_INFO()
+
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_ref, 0, 0, 1)
+	ZEND_ARG_INFO(0, loop)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_unref, 0, 0, 1)
+	ZEND_ARG_INFO(0, loop)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_tcp_nodelay, 0, 0, 2)
+	ZEND_ARG_INFO(0, tcp)
+	ZEND_ARG_INFO(0, enabled)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_ip4_addr, 0, 0, 2)
+	ZEND_ARG_INFO(0, address)
+	ZEND_ARG_INFO(0, port)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_ip6_addr, 0, 0, 2)
+	ZEND_ARG_INFO(0, address)
+	ZEND_ARG_INFO(0, port)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_init, 0, 0, 1)
+	ZEND_ARG_INFO(0, loop)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_open, 0, 0, 2)
+	ZEND_ARG_INFO(0, resource)
+	ZEND_ARG_INFO(0, udpfd)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_bind, 0, 0, 3)
+	ZEND_ARG_INFO(0, resource)
+	ZEND_ARG_INFO(0, address)
+	ZEND_ARG_INFO(0, flags)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_bind6, 0, 0, 3)
+	ZEND_ARG_INFO(0, resource)
+	ZEND_ARG_INFO(0, address)
+	ZEND_ARG_INFO(0, flags)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_recv_start, 0, 0, 2)
+	ZEND_ARG_INFO(0, server)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_recv_stop, 0, 0, 1)
+	ZEND_ARG_INFO(0, server)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_set_multicast_loop, 0, 0, 2)
+	ZEND_ARG_INFO(0, server)
+	ZEND_ARG_INFO(0, enabled)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_set_multicast_ttl, 0, 0, 2)
+	ZEND_ARG_INFO(0, server)
+	ZEND_ARG_INFO(0, ttl)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_set_broadcast, 0, 0, 2)
+	ZEND_ARG_INFO(0, server)
+	ZEND_ARG_INFO(0, enabled)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_relay_start, 0, 0, 2)
+	ZEND_ARG_INFO(0, listener)
+	ZEND_ARG_INFO(0, upstreams)
+	ZEND_ARG_INFO(0, mode)
+	ZEND_ARG_INFO(0, idle_timeout)
+	ZEND_ARG_INFO(0, callback)
+	ZEND_ARG_INFO(0, max_sessions)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_relay_stop, 0, 0, 1)
+	ZEND_ARG_INFO(0, listener)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_relay_info, 0, 0, 1)
+	ZEND_ARG_INFO(0, listener)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_set_segment_size, 0, 0, 2)
+	ZEND_ARG_INFO(0, handle)
+	ZEND_ARG_INFO(0, size)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_send, 0, 0, 4)
+	ZEND_ARG_INFO(0, server)
+	ZEND_ARG_INFO(0, buffer)
+	ZEND_ARG_INFO(0, address)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_send6, 0, 0, 4)
+	ZEND_ARG_INFO(0, server)
+	ZEND_ARG_INFO(0, buffer)
+	ZEND_ARG_INFO(0, address)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_pipe_open, 0, 0, 2)
+	ZEND_ARG_INFO(0, file)
+	ZEND_ARG_INFO(0, pipe)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_pipe_init, 0, 0, 1)
+	ZEND_ARG_INFO(0, file)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_pipe_bind, 0, 0, 2)
+	ZEND_ARG_INFO(0, handle)
+	ZEND_ARG_INFO(0, name)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_pipe_connect, 0, 0, 2)
+	ZEND_ARG_INFO(0, handle)
+	ZEND_ARG_INFO(0, name)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_pipe_pending_count, 0, 0, 1)
+    ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_pipe_pending_type, 0, 0, 1)
+    ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_pipe_pending_instances, 0, 0, 2)
+	ZEND_ARG_INFO(0, handle)
+	ZEND_ARG_INFO(0, count)
+ZEND_END_ARG_INFO()
+
+/*
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_spawn, 0, 0, 5)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, command)
+	ZEND_ARG_INFO(0, args)
+	ZEND_ARG_INFO(0, options)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+*/
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_kill, 0, 0, 2)
+	ZEND_ARG_INFO(0, pid)
+	ZEND_ARG_INFO(0, signal)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_process_kill, 0, 0, 2)
+	ZEND_ARG_INFO(0, process)
+	ZEND_ARG_INFO(0, signal)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_chdir, 0, 0, 1)
+	ZEND_ARG_INFO(0, dir)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_tty_get_winsize, 0, 0, 3)
 	ZEND_ARG_INFO(0, tty)
 	ZEND_ARG_INFO(1, width)
 	ZEND_ARG_INFO(1, height)
 ZEND_END_ARG_INFO()
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_tty_init, 0, 0, 3)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, fd)
-	ZEND_ARG_INFO(0, readable)
-ZEND_END_ARG_INFO()
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_tty_init, 0, 0, 3)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+	ZEND_ARG_INFO(0, readable)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_event_init, 0, 0, 4)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+	ZEND_ARG_INFO(0, callback)
+	ZEND_ARG_INFO(0, flags)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_sendfile, 0, 0, 6)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, in)
+	ZEND_ARG_INFO(0, out)
+	ZEND_ARG_INFO(0, offset)
+	ZEND_ARG_INFO(0, length)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_open_sync, 0, 0, 4)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+	ZEND_ARG_INFO(0, flag)
+	ZEND_ARG_INFO(0, mode)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_read_sync, 0, 0, 4)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+	ZEND_ARG_INFO(0, offset)
+	ZEND_ARG_INFO(0, size)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_write_sync, 0, 0, 4)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+	ZEND_ARG_INFO(0, buffer)
+	ZEND_ARG_INFO(0, offset)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_close_sync, 0, 0, 2)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_fsync_sync, 0, 0, 2)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_fdatasync_sync, 0, 0, 2)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_ftruncate_sync, 0, 0, 3)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+	ZEND_ARG_INFO(0, offset)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_mkdir_sync, 0, 0, 3)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+	ZEND_ARG_INFO(0, mode)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_rmdir_sync, 0, 0, 2)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_unlink_sync, 0, 0, 2)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_rename_sync, 0, 0, 3)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, from)
+	ZEND_ARG_INFO(0, to)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_utime_sync, 0, 0, 4)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+	ZEND_ARG_INFO(0, utime)
+	ZEND_ARG_INFO(0, atime)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_futime_sync, 0, 0, 4)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+	ZEND_ARG_INFO(0, utime)
+	ZEND_ARG_INFO(0, atime)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_chmod_sync, 0, 0, 3)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+	ZEND_ARG_INFO(0, mode)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_fchmod_sync, 0, 0, 3)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+	ZEND_ARG_INFO(0, mode)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_chown_sync, 0, 0, 4)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+	ZEND_ARG_INFO(0, uid)
+	ZEND_ARG_INFO(0, gid)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_fchown_sync, 0, 0, 4)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+	ZEND_ARG_INFO(0, uid)
+	ZEND_ARG_INFO(0, gid)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_link_sync, 0, 0, 3)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, from)
+	ZEND_ARG_INFO(0, to)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_symlink_sync, 0, 0, 4)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, from)
+	ZEND_ARG_INFO(0, to)
+	ZEND_ARG_INFO(0, flags)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_readlink_sync, 0, 0, 2)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_stat_sync, 0, 0, 2)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_lstat_sync, 0, 0, 2)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_fstat_sync, 0, 0, 2)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_scandir_sync, 0, 0, 3)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+	ZEND_ARG_INFO(0, flags)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_sendfile_sync, 0, 0, 5)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, in)
+	ZEND_ARG_INFO(0, out)
+	ZEND_ARG_INFO(0, offset)
+	ZEND_ARG_INFO(0, length)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_writev, 0, 0, 4)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+	ZEND_ARG_INFO(0, buffers)
+	ZEND_ARG_INFO(0, offset)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_readv, 0, 0, 4)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+	ZEND_ARG_INFO(0, offset)
+	ZEND_ARG_INFO(0, lengths)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_writev_sync, 0, 0, 4)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+	ZEND_ARG_INFO(0, buffers)
+	ZEND_ARG_INFO(0, offset)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_readv_sync, 0, 0, 4)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+	ZEND_ARG_INFO(0, offset)
+	ZEND_ARG_INFO(0, lengths)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_read_file, 0, 0, 2)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_write_file, 0, 0, 3)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+	ZEND_ARG_INFO(0, data)
+	ZEND_ARG_INFO(0, flags)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_stat_cache_enable, 0, 0, 2)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, ttl)
+	ZEND_ARG_INFO(0, max_entries)
+	ZEND_ARG_INFO(0, max_watchers)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_stat_cache_info, 0, 0, 0)
+	ZEND_ARG_INFO(0, loop)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_readdir, 0, 0, 4)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+	ZEND_ARG_INFO(0, flags)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_scandir, 0, 0, 4)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+	ZEND_ARG_INFO(0, flags)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_fstat, 0, 0, 3)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_lstat, 0, 0, 3)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_stat, 0, 0, 3)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_readlink, 0, 0, 3)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_symlink, 0, 0, 5)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, from)
+	ZEND_ARG_INFO(0, to)
+	ZEND_ARG_INFO(0, callback)
+	ZEND_ARG_INFO(0, flags)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_link, 0, 0, 4)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, from)
+	ZEND_ARG_INFO(0, to)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_fchown, 0, 0, 5)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+	ZEND_ARG_INFO(0, uid)
+	ZEND_ARG_INFO(0, gid)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_chown, 0, 0, 5)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+	ZEND_ARG_INFO(0, uid)
+	ZEND_ARG_INFO(0, gid)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_fchmod, 0, 0, 4)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+	ZEND_ARG_INFO(0, mode)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_chmod, 0, 0, 4)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+	ZEND_ARG_INFO(0, mode)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_futime, 0, 0, 5)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+	ZEND_ARG_INFO(0, utime)
+	ZEND_ARG_INFO(0, atime)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_utime, 0, 0, 5)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+	ZEND_ARG_INFO(0, utime)
+	ZEND_ARG_INFO(0, atime)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_open, 0, 0, 5)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+	ZEND_ARG_INFO(0, flag)
+	ZEND_ARG_INFO(0, mode)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_read, 0, 0, 3)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+	ZEND_ARG_INFO(0, offset)
+	ZEND_ARG_INFO(0, size)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_close, 0, 0, 3)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_write, 0, 0, 5)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+	ZEND_ARG_INFO(0, buffer)
+	ZEND_ARG_INFO(0, offset)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_fsync, 0, 0, 3)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_fdatasync, 0, 0, 3)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_ftruncate, 0, 0, 4)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+	ZEND_ARG_INFO(0, offset)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_mkdir, 0, 0, 4)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+	ZEND_ARG_INFO(0, mode)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_rmdir, 0, 0, 3)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_unlink, 0, 0, 3)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, path)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_rename, 0, 0, 4)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, from)
+	ZEND_ARG_INFO(0, to)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_rwlock_rdlock, 0, 0, 1)
+	ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_rwlock_tryrdlock, 0, 0, 1)
+	ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_rwlock_rdunlock, 0, 0, 1)
+	ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_rwlock_wrlock, 0, 0, 1)
+	ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_rwlock_trywrlock, 0, 0, 1)
+	ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_rwlock_wrunlock, 0, 0, 1)
+	ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_mutex_lock, 0, 0, 1)
+	ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_mutex_trylock, 0, 0, 1)
+	ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_mutex_unlock, 0, 0, 1)
+	ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_sem_init, 0, 0, 1)
+	ZEND_ARG_INFO(0, val)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_sem_post, 0, 0, 1)
+	ZEND_ARG_INFO(0, resource)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_sem_wait, 0, 0, 1)
+	ZEND_ARG_INFO(0, resource)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_sem_trywait, 0, 0, 1)
+	ZEND_ARG_INFO(0, resource)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_prepare_init, 0, 0, 0)
+	ZEND_ARG_INFO(0, loop)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_prepare_start, 0, 0, 2)
+	ZEND_ARG_INFO(0, handle)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_prepare_stop, 0, 0, 1)
+	ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_check_init, 0, 0, 1)
+	ZEND_ARG_INFO(0, loop)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_check_start, 0, 0, 2)
+	ZEND_ARG_INFO(0, handle)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_check_stop, 0, 0, 1)
+	ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_async_send, 0, 0, 1)
+	ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_async_init, 0, 0, 2)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_tcp_getsockname, 0, 0, 1)
+	ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_tcp_getpeername, 0, 0, 1)
+	ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_getsockname, 0, 0, 1)
+	ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_set_membership, 0, 0, 4)
+	ZEND_ARG_INFO(0, client)
+	ZEND_ARG_INFO(0, multicast_addr)
+	ZEND_ARG_INFO(0, interface_addr)
+	ZEND_ARG_INFO(0, membership)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_ip6_name, 0, 0, 1)
+	ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_ip4_name, 0, 0, 1)
+	ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_poll_init, 0, 0, 1)
+	ZEND_ARG_INFO(0, loop)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_poll_start, 0, 0, 4)
+	ZEND_ARG_INFO(0, handle)
+	ZEND_ARG_INFO(0, callback)
+	ZEND_ARG_INFO(0, path)
+	ZEND_ARG_INFO(0, interval)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_poll_stop, 0, 0, 1)
+	ZEND_ARG_INFO(0, loop)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_poll_init, 0, 0, 2)
+	ZEND_ARG_INFO(0, loop)
+	ZEND_ARG_INFO(0, fd)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_poll_start, 0, 0, 3)
+	ZEND_ARG_INFO(0, handle)
+	ZEND_ARG_INFO(0, events)
+	ZEND_ARG_INFO(0, callback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_poll_stop, 0, 0, 1)
+	ZEND_ARG_INFO(0, handle)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_signal_init, 0, 0, 1)
+	ZEND_ARG_INFO(0, loop)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_signal_start, 0, 0, 3)
+	ZEND_ARG_INFO(0, sig_handle)
+	ZEND_ARG_INFO(0, sig_callback)
+	ZEND_ARG_INFO(0, sig_num)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_signal_stop, 0, 0, 1)
+	ZEND_ARG_INFO(0, sig_handle)
+ZEND_END_ARG_INFO()
+
+/* PHP Functions */
+
+/* {{{ proto void uv_unref(UV $uv_t)
+*/
+PHP_FUNCTION(uv_unref)
+{
+	php_uv_t *uv;
+//	uv_loop_t *loop;
+
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+/*
+	if ((loop = (uv_loop_t *) zend_fetch_resource_ex(handle, NULL, uv_loop_handle))) {
+		uv_unref((uv_handle_t *) loop);
+	} else
+*/
+	uv_unref(&uv->uv.handle);
+}
+/* }}} */
+
+/* {{{ proto string uv_err_name(long $error_code)
+*/
+PHP_FUNCTION(uv_err_name)
+{
+	zend_long error_code;
+	const char *error_msg;
+
+	if (zend_parse_parameters(ZEND_NUM_ARGS(),
+		"l", &error_code) == FAILURE) {
+		return;
+	}
+
+	if (error_code < UV_ERRNO_MAX || error_code > 0) {
+		php_error_docref(NULL, E_NOTICE, "passes unexpected value.");
+		RETURN_FALSE;
+	}
+
+	error_msg = uv_err_name(error_code);
+
+	RETVAL_STRING(error_msg);
+}
+/* }}} */
+
+
+/* {{{ proto string uv_strerror(long $error_code)
+*/
+PHP_FUNCTION(uv_strerror)
+{
+	zend_long error_code;
+	const char *error_msg;
+
+	if (zend_parse_parameters(ZEND_NUM_ARGS(),
+		"l", &error_code) == FAILURE) {
+		return;
+	}
+
+	error_msg = php_uv_strerror(error_code);
+	RETVAL_STRING(error_msg);
+}
+/* }}} */
+
+/* {{{ proto void uv_update_time([UVLoop $uv_loop])
+*/
+PHP_FUNCTION(uv_update_time)
+{
+	php_uv_loop_t *loop = NULL;
+
+	ZEND_PARSE_PARAMETERS_START(0, 1)
+		Z_PARAM_OPTIONAL
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+	uv_update_time(&loop->loop);
+}
+/* }}} */
+
+/* {{{ proto void uv_ref(UV $uv_handle)
+*/
+PHP_FUNCTION(uv_ref)
+{
+	php_uv_t *uv;
+//	uv_loop_t *loop;
+
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+/*
+	if ((loop = (uv_loop_t *) zend_fetch_resource_ex(handle, NULL, uv_loop_handle))) {
+		uv_ref((uv_handle_t *)loop);
+	} else
+*/
+	uv_ref(&uv->uv.handle);
+}
+/* }}} */
+
+static void php_uv_collect_timer_cb(uv_timer_t *handle)
+{
+	/* only there to wake up uv_run() */
+}
+
+static void php_uv_collect_timer_dispose(php_uv_internal_t *internal)
+{
+	php_uv_loop_t *loop = PHP_UV_CONTAINER_OF(internal, php_uv_loop_t, collect_internal);
+
+	uv_close((uv_handle_t *) &loop->collect_timer, NULL);
+}
+
+/* makes a blocking uv_run() return after timeout ms at the latest, without keeping the loop alive */
+static void php_uv_collect_timer_start(php_uv_loop_t *loop, uint64_t timeout)
+{
+	if (!loop->collect_timer_init) {
+		uv_timer_init(&loop->loop, &loop->collect_timer);
+		PHP_UV_INTERNAL_INIT(&loop->collect_internal, php_uv_collect_timer_dispose);
+		loop->collect_timer.data = &loop->collect_internal;
+		uv_unref((uv_handle_t *) &loop->collect_timer);
+		loop->collect_timer_init = 1;
+	}
+	uv_timer_start(&loop->collect_timer, php_uv_collect_timer_cb, timeout, 0);
+}
+
+/* {{{ proto void uv_run([UVLoop $uv_loop, long $run_mode])
+*/
+PHP_FUNCTION(uv_run)
+{
+	php_uv_loop_t *loop = NULL;
+	zend_long run_mode = UV_RUN_DEFAULT;
+
+	ZEND_PARSE_PARAMETERS_START(0, 2)
+		Z_PARAM_OPTIONAL
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+		Z_PARAM_LONG(run_mode)
+	ZEND_PARSE_PARAMETERS_END();
+
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+	php_uv_deferred_replay(loop, NULL);
+	php_uv_microtask_start(loop);
+	uv_run(&loop->loop, run_mode);
+}
+/* }}} */
+
+/* {{{ proto bool uv_run_budget([UVLoop $uv_loop, long $max_ms = 0, long $max_callbacks = 0])
+*/
+PHP_FUNCTION(uv_run_budget)
+{
+	php_uv_loop_t *loop = NULL;
+	zend_long max_ms = 0, max_callbacks = 0;
+	php_uv_budget_t budget;
+	zend_bool bailout = 0;
+
+	ZEND_PARSE_PARAMETERS_START(0, 3)
+		Z_PARAM_OPTIONAL
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+		Z_PARAM_LONG(max_ms)
+		Z_PARAM_LONG(max_callbacks)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (max_ms < 0 || max_callbacks < 0) {
+		php_error_docref(NULL, E_WARNING, "budget limits must not be negative");
+		RETURN_FALSE;
+	}
+
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+
+	if (loop->budget) {
+		php_error_docref(NULL, E_WARNING, "uv_run_budget() cannot be called from a callback of a bounded run of the same loop");
+		RETURN_FALSE;
+	}
+
+	budget.loop = loop;
+	budget.deadline = max_ms > 0 ? uv_hrtime() + (uint64_t) max_ms * 1000000 : 0;
+	budget.callbacks = max_callbacks > 0 ? max_callbacks : -1;
+	budget.running = 0;
+	budget.spent = 0;
+	loop->budget = &budget;
+
+	zend_try {
+		/* first what the previous run had to hold back, in the order it came in */
+		php_uv_deferred_replay(loop, &budget);
+		php_uv_microtask_start(loop);
+
+		if (!budget.spent && !EG(exception)) {
+			if (max_ms > 0) {
+				php_uv_collect_timer_start(loop, max_ms);
+			}
+
+			/* like uv_run(UV_RUN_DEFAULT); once spent, php_uv_do_callback2() defers the rest of the iteration */
+			budget.running = 1;
+			while (!budget.spent && !EG(exception)) {
+				if (!uv_run(&loop->loop, UV_RUN_ONCE)) {
+					break;
+				}
+				if (budget.deadline && uv_hrtime() >= budget.deadline) {
+					break;
+				}
+			}
+			budget.running = 0;
+
+			if (max_ms > 0) {
+				uv_timer_stop(&loop->collect_timer);
+			}
+		}
+	} zend_catch {
+		bailout = 1;
+	} zend_end_try();
+
+	loop->budget = NULL;
+	if (bailout) {
+		zend_bailout();
+	}
+
+	RETURN_BOOL(loop->deferred != NULL || uv_loop_alive(&loop->loop));
+}
+/* }}} */
+
+/* {{{ proto bool uv_event_sink(UV $handle, long $sink)
+*/
+PHP_FUNCTION(uv_event_sink)
+{
+	php_uv_t *uv;
+	zend_long sink;
+
+	ZEND_PARSE_PARAMETERS_START(2, 2)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_ce)
+		Z_PARAM_LONG(sink)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (!php_uv_closeable_type(uv)) {
+		php_error_docref(NULL, E_WARNING, "passed %s is not a handle", ZSTR_VAL(uv->std.ce->name));
+		RETURN_FALSE;
+	}
+	if (sink != PHP_UV_SINK_CALLBACK && sink != PHP_UV_SINK_QUEUE) {
+		php_error_docref(NULL, E_WARNING, "sink must be UV::SINK_CALLBACK or UV::SINK_QUEUE");
+		RETURN_FALSE;
+	}
+
+	uv->sink = (int) sink;
+
+	RETURN_TRUE;
+}
+/* }}} */
+
+/* {{{ proto array uv_loop_metrics([UVLoop $uv_loop])
+*/
+PHP_FUNCTION(uv_loop_metrics)
+{
+	php_uv_loop_t *loop = NULL;
+	zval callbacks;
+	uint32_t i;
+#if UV_VERSION_HEX >= 0x012D00
+	uv_metrics_t metrics;
+#endif
+
+	ZEND_PARSE_PARAMETERS_START(0, 1)
+		Z_PARAM_OPTIONAL
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+
+	array_init(return_value);
+#if UV_VERSION_HEX >= 0x012700
+	add_assoc_long(return_value, "idle_time", (zend_long) uv_metrics_idle_time(&loop->loop));
+#else
+	add_assoc_null(return_value, "idle_time");
+#endif
+#if UV_VERSION_HEX >= 0x012D00
+	uv_metrics_info(&loop->loop, &metrics);
+	add_assoc_long(return_value, "iterations", (zend_long) metrics.loop_count);
+	add_assoc_long(return_value, "events", (zend_long) metrics.events);
+	add_assoc_long(return_value, "events_waiting", (zend_long) metrics.events_waiting);
+#else
+	add_assoc_long(return_value, "iterations", (zend_long) loop->iterations);
+	add_assoc_null(return_value, "events");
+	add_assoc_null(return_value, "events_waiting");
+#endif
+
+	array_init(&callbacks);
+	for (i = 0; i < php_uv_layout_count; i++) {
+		if (loop->callbacks[i]) {
+			zend_string *name = php_uv_layouts[i]->ce->name;
+			add_assoc_long_ex(&callbacks, ZSTR_VAL(name), ZSTR_LEN(name), (zend_long) loop->callbacks[i]);
+		}
+	}
+	add_assoc_zval(return_value, "callbacks", &callbacks);
+}
+/* }}} */
+
+/* {{{ proto bool uv_loop_watchdog(UVLoop $uv_loop, long $threshold_ms)
+*/
+PHP_FUNCTION(uv_loop_watchdog)
+{
+	php_uv_loop_t *loop = NULL;
+	php_uv_watchdog_t *watchdog;
+	zend_long threshold;
+	int r;
+
+	ZEND_PARSE_PARAMETERS_START(2, 2)
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+		Z_PARAM_LONG(threshold)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (threshold < 0) {
+		php_error_docref(NULL, E_WARNING, "threshold must not be negative");
+		RETURN_FALSE;
+	}
+
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+
+	if (threshold == 0) {
+		php_uv_watchdog_stop(loop);
+		RETURN_TRUE;
+	}
+
+	if (loop->watchdog) {
+		uv_mutex_lock(&loop->watchdog->lock);
+		loop->watchdog->threshold = (uint64_t) threshold * 1000000;
+		uv_mutex_unlock(&loop->watchdog->lock);
+		RETURN_TRUE;
+	}
+
+	watchdog = ecalloc(1, sizeof(php_uv_watchdog_t));
+	watchdog->threshold = (uint64_t) threshold * 1000000;
+#if PHP_VERSION_ID >= 70100
+	watchdog->vm_interrupt = &EG(vm_interrupt);
+#endif
+	array_init(&watchdog->slow);
+	uv_mutex_init(&watchdog->lock);
+	uv_cond_init(&watchdog->cond);
+
+	r = uv_thread_create(&watchdog->thread, php_uv_watchdog_thread, watchdog);
+	if (r) {
+		php_error_docref(NULL, E_WARNING, "uv_thread_create failed: %s", php_uv_strerror(r));
+		uv_cond_destroy(&watchdog->cond);
+		uv_mutex_destroy(&watchdog->lock);
+		zval_ptr_dtor(&watchdog->slow);
+		efree(watchdog);
+		RETURN_FALSE;
+	}
+
+	loop->watchdog = watchdog;
+	RETURN_TRUE;
+}
+/* }}} */
+
+/* {{{ proto array uv_loop_watchdog_report(UVLoop $uv_loop[, bool $reset = false])
+*/
+PHP_FUNCTION(uv_loop_watchdog_report)
+{
+	php_uv_loop_t *loop = NULL;
+	php_uv_watchdog_t *watchdog;
+	zend_bool reset = 0;
+	zval histogram, slow, *entry;
+	int i;
+
+	ZEND_PARSE_PARAMETERS_START(1, 2)
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_BOOL(reset)
+	ZEND_PARSE_PARAMETERS_END();
+
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+
+	watchdog = loop->watchdog;
+	if (!watchdog) {
+		php_error_docref(NULL, E_WARNING, "the loop has no watchdog");
+		RETURN_FALSE;
+	}
+
+	/* keyed by the exclusive upper bound in ms, the last bucket takes everything above */
+	array_init_size(&histogram, PHP_UV_WATCHDOG_BUCKETS);
+	for (i = 0; i < PHP_UV_WATCHDOG_BUCKETS; i++) {
+		add_index_long(&histogram, (zend_ulong) 1 << i, (zend_long) watchdog->histogram[i]);
+	}
+
+	array_init_size(&slow, zend_hash_num_elements(Z_ARRVAL(watchdog->slow)));
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL(watchdog->slow), entry) {
+		Z_TRY_ADDREF_P(entry);
+		add_next_index_zval(&slow, entry);
+	} ZEND_HASH_FOREACH_END();
+
+	array_init(return_value);
+	add_assoc_long(return_value, "threshold", (zend_long) (watchdog->threshold / 1000000));
+	add_assoc_double(return_value, "max", watchdog->max / 1000000.0);
+	add_assoc_zval(return_value, "histogram", &histogram);
+	add_assoc_long(return_value, "slow_count", (zend_long) watchdog->slow_count);
+	add_assoc_zval(return_value, "slow", &slow);
+
+	if (reset) {
+		memset(watchdog->histogram, 0, sizeof(watchdog->histogram));
+		watchdog->max = 0;
+		watchdog->slow_count = 0;
+		zend_hash_clean(Z_ARRVAL(watchdog->slow));
+	}
+}
+/* }}} */
+
+/* the loop is about to poll for i/o: collect cycles unless it has to wake up again soon */
+static void php_uv_gc_idle_cb(uv_prepare_t *handle)
+{
+	php_uv_loop_t *loop = PHP_UV_CONTAINER_OF(handle, php_uv_loop_t, gc_idle_prepare);
+	int timeout = uv_backend_timeout(&loop->loop);
+	uint64_t room = MAX(loop->gc_idle_slice, loop->gc_idle_last / 1000000);
+	uint64_t start;
+
+	if (EG(exception)) {
+		return;
+	}
+
+	/* a collection cannot be interrupted, so the next timer must leave room for a whole one */
+	if (timeout == 0 || (timeout > 0 && (uint64_t) timeout < room)) {
+		return;
+	}
+
+	start = uv_hrtime();
+	if (gc_collect_cycles() > 0) {
+		loop->gc_idle_last = uv_hrtime() - start;
+	}
+}
+
+static void php_uv_gc_idle_dispose(php_uv_internal_t *internal)
+{
+	php_uv_loop_t *loop = PHP_UV_CONTAINER_OF(internal, php_uv_loop_t, gc_idle_internal);
+
+	loop->gc_idle = 0;
+	uv_close((uv_handle_t *) &loop->gc_idle_prepare, NULL);
+}
+
+/* {{{ proto bool uv_loop_gc_idle(UVLoop $uv_loop, bool $enable[, long $slice_ms = 1])
+*/
+PHP_FUNCTION(uv_loop_gc_idle)
+{
+	php_uv_loop_t *loop = NULL;
+	zend_bool enable;
+	zend_long slice = 1;
+
+	ZEND_PARSE_PARAMETERS_START(2, 3)
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+		Z_PARAM_BOOL(enable)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_LONG(slice)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (slice < 0) {
+		php_error_docref(NULL, E_WARNING, "slice must not be negative");
+		RETURN_FALSE;
+	}
+
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+
+	loop->gc_idle_slice = (uint64_t) slice;
+	if (!enable) {
+		if (loop->gc_idle) {
+			uv_prepare_stop(&loop->gc_idle_prepare);
+			loop->gc_idle = 0;
+		}
+		RETURN_TRUE;
+	}
+
+	if (!loop->gc_idle_init) {
+		uv_prepare_init(&loop->loop, &loop->gc_idle_prepare);
+		PHP_UV_INTERNAL_INIT(&loop->gc_idle_internal, php_uv_gc_idle_dispose);
+		loop->gc_idle_prepare.data = &loop->gc_idle_internal;
+		uv_unref((uv_handle_t *) &loop->gc_idle_prepare);
+		loop->gc_idle_init = 1;
+	}
+	if (!loop->gc_idle) {
+		uv_prepare_start(&loop->gc_idle_prepare, php_uv_gc_idle_cb);
+		loop->gc_idle = 1;
+	}
+
+	RETURN_TRUE;
+}
+/* }}} */
+
+/* {{{ proto array uv_run_collect([UVLoop $uv_loop, long $max = 64, long $timeout = -1])
+*/
+PHP_FUNCTION(uv_run_collect)
+{
+	php_uv_loop_t *loop = NULL;
+	zend_long max = 64, timeout = -1;
+
+	ZEND_PARSE_PARAMETERS_START(0, 3)
+		Z_PARAM_OPTIONAL
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+		Z_PARAM_LONG(max)
+		Z_PARAM_LONG(timeout)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (max <= 0) {
+		php_error_docref(NULL, E_WARNING, "max must be greater than 0");
+		RETURN_FALSE;
+	}
+
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+
+	if (loop->events_count == 0) {
+		if (timeout == 0) {
+			uv_run(&loop->loop, UV_RUN_NOWAIT);
+		} else {
+			uint64_t deadline = 0;
+
+			if (timeout > 0) {
+				uv_update_time(&loop->loop);
+				deadline = uv_now(&loop->loop) + timeout;
+				php_uv_collect_timer_start(loop, timeout);
+			}
+
+			/* like uv_run(UV_RUN_DEFAULT), but return as soon as something was queued */
+			while (loop->events_count == 0 && !EG(exception)) {
+				if (!uv_run(&loop->loop, UV_RUN_ONCE)) {
+					break;
+				}
+				if (timeout > 0 && uv_now(&loop->loop) >= deadline) {
+					break;
+				}
+			}
+
+			if (timeout > 0) {
+				uv_timer_stop(&loop->collect_timer);
+			}
+		}
+	}
+
+	array_init_size(return_value, MIN((uint32_t) max, loop->events_count));
+	while (max-- > 0 && loop->events_count > 0) {
+		zval record;
+
+		php_uv_event_shift(loop, &record);
+		add_next_index_zval(return_value, &record);
+	}
+}
+/* }}} */
+
+/* {{{ proto void uv_coroutine(Generator $coroutine)
+*/
+PHP_FUNCTION(uv_coroutine)
+{
+	zval *coroutine;
+
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		Z_PARAM_OBJECT_OF_CLASS(coroutine, zend_ce_generator)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (php_uv_coroutine_finished(coroutine)) {
+		php_error_docref(NULL, E_WARNING, "passed generator has already finished");
+		return;
+	}
+
+	php_uv_coroutine_step(coroutine, NULL);
+}
+/* }}} */
+
+/* {{{ proto UVPromise uv_promise_then(UVPromise $promise[, callable $on_fulfilled = null, callable $on_rejected = null])
+*/
+PHP_FUNCTION(uv_promise_then)
+{
+	php_uv_promise_t *promise;
+	zend_fcall_info fulfilled_fci = empty_fcall_info, rejected_fci = empty_fcall_info;
+	zend_fcall_info_cache fulfilled_fcc = empty_fcall_info_cache, rejected_fcc = empty_fcall_info_cache;
+	php_uv_promise_reaction_t *reaction;
+
+	ZEND_PARSE_PARAMETERS_START(1, 3)
+		UV_PARAM_OBJ(promise, php_uv_promise_t, uv_promise_ce)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_FUNC_EX(fulfilled_fci, fulfilled_fcc, 1, 0)
+		Z_PARAM_FUNC_EX(rejected_fci, rejected_fcc, 1, 0)
+	ZEND_PARSE_PARAMETERS_END();
+
+	object_init_ex(return_value, uv_promise_ce);
+
+	reaction = php_uv_promise_reaction_new(PHP_UV_REACTION_THEN, return_value);
+	if (ZEND_FCI_INITIALIZED(fulfilled_fci)) {
+		reaction->on_fulfilled = php_uv_cb_init_dynamic(NULL, &fulfilled_fci, &fulfilled_fcc);
+	}
+	if (ZEND_FCI_INITIALIZED(rejected_fci)) {
+		reaction->on_rejected = php_uv_cb_init_dynamic(NULL, &rejected_fci, &rejected_fcc);
+	}
+
+	php_uv_promise_add_reaction(promise, reaction);
+}
+/* }}} */
+
+static void php_uv_promise_combine(enum php_uv_promise_reaction_kind kind, INTERNAL_FUNCTION_PARAMETERS)
+{
+	zval *promises, *entry;
+	zend_string *key;
+	zend_ulong index;
+	php_uv_promise_t *combined;
+
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		Z_PARAM_ARRAY(promises)
+	ZEND_PARSE_PARAMETERS_END();
+
+	object_init_ex(return_value, uv_promise_ce);
+	combined = (php_uv_promise_t *) Z_OBJ_P(return_value);
+
+	if (kind == PHP_UV_REACTION_ALL) {
+		/* keep the order and keys of the input, one slot per entry */
+		array_init_size(&combined->result, zend_hash_num_elements(Z_ARRVAL_P(promises)));
+		combined->pending = 1;
+	}
+
+	ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(promises), index, key, entry) {
+		php_uv_promise_t *promise = NULL;
+		php_uv_promise_reaction_t *reaction;
+		zval slot;
+
+		ZVAL_DEREF(entry);
+		if (Z_TYPE_P(entry) == IS_OBJECT && Z_OBJCE_P(entry) == uv_promise_ce) {
+			promise = (php_uv_promise_t *) Z_OBJ_P(entry);
+		}
+
+		if (kind == PHP_UV_REACTION_ALL) {
+			if (combined->state != PHP_UV_PROMISE_PENDING) {
+				break;
+			}
+
+			ZVAL_NULL(&slot);
+			if (promise == NULL || promise->state == PHP_UV_PROMISE_FULFILLED) {
+				ZVAL_COPY(&slot, promise ? &promise->result : entry);
+			} else if (promise->state == PHP_UV_PROMISE_REJECTED) {
+				php_uv_promise_settle(combined, PHP_UV_PROMISE_REJECTED, &promise->result);
+				break;
+			}
+
+			if (key) {
+				zend_hash_update(Z_ARRVAL(combined->result), key, &slot);
+			} else {
+				zend_hash_index_update(Z_ARRVAL(combined->result), index, &slot);
+			}
+
+			if (promise == NULL || promise->state != PHP_UV_PROMISE_PENDING) {
+				continue;
+			}
+
+			reaction = php_uv_promise_reaction_new(PHP_UV_REACTION_ALL, return_value);
+			if (key) {
+				ZVAL_STR_COPY(&reaction->key, key);
+			} else {
+				ZVAL_LONG(&reaction->key, index);
+			}
+			combined->pending++;
+			php_uv_promise_add_reaction(promise, reaction);
+		} else {
+			/* race: the first input to settle wins */
+			if (combined->state != PHP_UV_PROMISE_PENDING) {
+				break;
+			}
+			if (promise == NULL) {
+				php_uv_promise_settle(combined, PHP_UV_PROMISE_FULFILLED, entry);
+				break;
+			}
+			php_uv_promise_add_reaction(promise, php_uv_promise_reaction_new(PHP_UV_REACTION_FORWARD, return_value));
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	if (kind == PHP_UV_REACTION_ALL && combined->state == PHP_UV_PROMISE_PENDING && --combined->pending == 0) {
+		php_uv_promise_settle(combined, PHP_UV_PROMISE_FULFILLED, &combined->result);
+	}
+}
+
+/* {{{ proto UVPromise uv_promise_all(array $promises)
+*/
+PHP_FUNCTION(uv_promise_all)
+{
+	php_uv_promise_combine(PHP_UV_REACTION_ALL, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
+
+/* {{{ proto UVPromise uv_promise_race(array $promises)
+*/
+PHP_FUNCTION(uv_promise_race)
+{
+	php_uv_promise_combine(PHP_UV_REACTION_FORWARD, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
+
+/* {{{ proto UVPromise uv_promise_timeout(UVPromise $promise, long $timeout[, UVLoop $loop])
+*/
+PHP_FUNCTION(uv_promise_timeout)
+{
+	php_uv_promise_t *promise, *limited;
+	php_uv_promise_timeout_t *timeout;
+	php_uv_loop_t *loop = NULL;
+	zend_long ms;
+
+	ZEND_PARSE_PARAMETERS_START(2, 3)
+		UV_PARAM_OBJ(promise, php_uv_promise_t, uv_promise_ce)
+		Z_PARAM_LONG(ms)
+		Z_PARAM_OPTIONAL
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (ms < 0) {
+		php_error_docref(NULL, E_WARNING, "timeout must be 0 or greater");
+		RETURN_FALSE;
+	}
+
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+
+	object_init_ex(return_value, uv_promise_ce);
+	limited = (php_uv_promise_t *) Z_OBJ_P(return_value);
+
+	php_uv_promise_add_reaction(promise, php_uv_promise_reaction_new(PHP_UV_REACTION_FORWARD, return_value));
+	if (limited->state != PHP_UV_PROMISE_PENDING) {
+		return;
+	}
+
+	timeout = emalloc(sizeof(php_uv_promise_timeout_t));
+	PHP_UV_INTERNAL_INIT(&timeout->internal, php_uv_promise_timeout_dispose);
+	TSRMLS_SET_CTX(timeout->thread_ctx);
+	uv_timer_init(&loop->loop, &timeout->timer);
+	timeout->timer.data = &timeout->internal;
+
+	GC_REFCOUNT(&limited->std)++;
+	timeout->promise = limited;
+	limited->timeout = timeout;
+
+	uv_timer_start(&timeout->timer, php_uv_promise_timeout_cb, ms, 0);
+}
+/* }}} */
+
+/* {{{ proto void uv_stop([UVLoop $uv_loop])
+*/
+PHP_FUNCTION(uv_stop)
+{
+	php_uv_loop_t *loop = NULL;
+
+	ZEND_PARSE_PARAMETERS_START(0, 1)
+		Z_PARAM_OPTIONAL
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+	uv_stop(&loop->loop);
+}
+/* }}} */
+
+/* {{{ proto resource uv_signal_init([UVLoop $uv_loop])
+*/
+PHP_FUNCTION(uv_signal_init)
+{
+	php_uv_loop_t *loop = NULL;
+	php_uv_t *uv;
+
+	ZEND_PARSE_PARAMETERS_START(0, 1)
+		Z_PARAM_OPTIONAL
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+	PHP_UV_INIT_UV_EX(uv, uv_signal_ce, uv_signal_init);
+
+	RETURN_OBJ(&uv->std);
+}
+/* }}} */
+
+/* {{{ proto void uv_signal_start(UVSignal $sig_handle, callable $sig_callback, int $sig_num)
+*/
+PHP_FUNCTION(uv_signal_start)
+{
+	zend_long sig_num;
+	php_uv_t *uv;
+	zend_fcall_info fci       = empty_fcall_info;
+	zend_fcall_info_cache fcc = empty_fcall_info_cache;
+	php_uv_cb_t *cb;
+
+	ZEND_PARSE_PARAMETERS_START(3, 3)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_signal_ce)
+		Z_PARAM_FUNC(fci, fcc)
+		Z_PARAM_LONG(sig_num)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (uv_is_active((uv_handle_t *) &uv->uv.signal)) {
+		php_error_docref(NULL, E_NOTICE, "passed uv signal resource has been started. you don't have to call this method");
+		RETURN_FALSE;
+	}
+
+	GC_REFCOUNT(&uv->std)++;
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_signal_start, uv);
+
+	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_SIGNAL_CB);
+
+	uv_signal_start((uv_signal_t *) &uv->uv.signal, php_uv_signal_cb, sig_num);
+}
+/* }}} */
+
+/* {{{ proto int uv_signal_stop(UVSignal $sig_handle)
+*/
+PHP_FUNCTION(uv_signal_stop)
+{
+	php_uv_t *uv;
+	int r = 0;
+
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_signal_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (!uv_is_active((uv_handle_t *) &uv->uv.signal)) {
+		php_error_docref(NULL, E_NOTICE, "passed uv signal resource has been stopped. you don't have to call this method");
+		RETURN_FALSE;
+	}
+
+	r = uv_signal_stop((uv_signal_t *) &uv->uv.signal);
+
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_signal_stop, uv);
+	OBJ_RELEASE(&uv->std);
+
+	RETURN_LONG(r);
+}
+/* }}} */
+
+/* {{{ proto void uv_loop_delete(UVLoop $uv_loop)
+*/
+PHP_FUNCTION(uv_loop_delete)
+{
+	php_uv_loop_t *loop;
+
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		UV_PARAM_OBJ(loop, php_uv_loop_t, uv_loop_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (loop != UV_G(default_loop)) {
+		GC_FLAGS(&loop->std) |= IS_OBJ_DESTRUCTOR_CALLED;
+		destruct_uv_loop(&loop->std);
+	}
+}
+/* }}} */
+
+/* {{{ proto long uv_now([UVLoop $uv_loop])
+*/
+PHP_FUNCTION(uv_now)
+{
+	php_uv_loop_t *loop = NULL;
+	int64_t now;
+
+	ZEND_PARSE_PARAMETERS_START(0, 1)
+		Z_PARAM_OPTIONAL
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+	now = uv_now(&loop->loop);
+	RETURN_LONG((long)now);
+}
+/* }}} */
+
+/* {{{ proto long uv_backend_fd([UVLoop $uv_loop])
+*/
+PHP_FUNCTION(uv_backend_fd)
+{
+	php_uv_loop_t *loop = NULL;
+
+	ZEND_PARSE_PARAMETERS_START(0, 1)
+		Z_PARAM_OPTIONAL
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+	RETURN_LONG(uv_backend_fd(&loop->loop));
+}
+/* }}} */
+
+/* {{{ proto long uv_backend_timeout([UVLoop $uv_loop])
+*/
+PHP_FUNCTION(uv_backend_timeout)
+{
+	php_uv_loop_t *loop = NULL;
+
+	ZEND_PARSE_PARAMETERS_START(0, 1)
+		Z_PARAM_OPTIONAL
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+
+	/* callbacks held back by uv_run_budget() are due right away */
+	if (loop->deferred) {
+		RETURN_LONG(0);
+	}
+	RETURN_LONG(uv_backend_timeout(&loop->loop));
+}
+/* }}} */
+
+
+/* {{{ proto void uv_tcp_bind(resource $uv_tcp, resource $uv_sockaddr)
+*/
+PHP_FUNCTION(uv_tcp_bind)
+{
+	php_uv_socket_bind(PHP_UV_TCP_IPV4, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
+
+/* {{{ proto void uv_tcp_bind6(resource $uv_tcp, resource $uv_sockaddr)
+*/
+PHP_FUNCTION(uv_tcp_bind6)
+{
+	php_uv_socket_bind(PHP_UV_TCP_IPV6, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
+
+
+/* {{{ proto void uv_write(resource $handle, string $data, callable $callback)
+*/
+PHP_FUNCTION(uv_write)
+{
+	zend_string *data;
+	int r;
+	php_uv_t *uv;
+	write_req_t *w;
+	zend_fcall_info fci       = empty_fcall_info;
+	zend_fcall_info_cache fcc = empty_fcall_info_cache;
+	php_uv_cb_t *cb;
+
+	ZEND_PARSE_PARAMETERS_START(2, 3)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_tcp_ce, uv_pipe_ce, uv_tty_ce)
+		Z_PARAM_STR(data)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_FUNC_EX(fci, fcc, 1, 0)
+	ZEND_PARSE_PARAMETERS_END();
+
+	cb = php_uv_cb_init_dynamic(uv, &fci, &fcc);
+	PHP_UV_INIT_WRITE_REQ(w, uv, data->val, data->len, cb)
+
+	r = uv_write(&w->req, &uv->uv.stream, &w->buf, 1, php_uv_write_cb);
+	if (r) {
+		php_uv_free_write_req(w);
+		php_error_docref(NULL, E_WARNING, "write failed");
+	} else {
+		if (uv->timeouts) {
+			php_uv_stream_timeouts_write_start(uv->timeouts);
+		}
+		GC_REFCOUNT(&uv->std)++;
+		PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_write, uv);
+	}
+}
+/* }}} */
+
+/* {{{ proto void uv_write2(resource $handle, string $data, resource $send, callable $callback)
+*/
+PHP_FUNCTION(uv_write2)
+{
+	zend_string *data;
+	int r;
+	php_uv_t *uv, *send;
+	write_req_t *w;
+	zend_fcall_info fci       = empty_fcall_info;
+	zend_fcall_info_cache fcc = empty_fcall_info_cache;
+	php_uv_cb_t *cb;
+
+	ZEND_PARSE_PARAMETERS_START(4, 4)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_tcp_ce, uv_pipe_ce, uv_tty_ce)
+		Z_PARAM_STR(data)
+		UV_PARAM_OBJ(send, php_uv_t, uv_ce)
+		Z_PARAM_FUNC(fci, fcc)
+	ZEND_PARSE_PARAMETERS_END();
+
+	cb = php_uv_cb_init_dynamic(uv, &fci, &fcc);
+	PHP_UV_INIT_WRITE_REQ(w, uv, data->val, data->len, cb);
+
+	r = uv_write2(&w->req, &uv->uv.stream, &w->buf, 1, &send->uv.stream, php_uv_write_cb);
+	if (r) {
+		php_uv_free_write_req(w);
+		php_error_docref(NULL, E_ERROR, "write2 failed");
+	} else {
+		if (uv->timeouts) {
+			php_uv_stream_timeouts_write_start(uv->timeouts);
+		}
+		GC_REFCOUNT(&uv->std)++;
+		PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_write2, uv);
+	}
+}
+/* }}} */
+
+/* {{{ proto bool uv_stream_set_timeouts(UVStream $handle, long $idle_ms, long $read_ms, long $write_ms[, callable $callback])
+*/
+PHP_FUNCTION(uv_stream_set_timeouts)
+{
+	php_uv_t *uv;
+	php_uv_stream_timeouts_t *timeouts;
+	zend_long idle, read, write;
+	zend_fcall_info fci = empty_fcall_info;
+	zend_fcall_info_cache fcc = empty_fcall_info_cache;
+	uint64_t now;
+
+	ZEND_PARSE_PARAMETERS_START(4, 5)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_tcp_ce, uv_pipe_ce, uv_tty_ce)
+		Z_PARAM_LONG(idle)
+		Z_PARAM_LONG(read)
+		Z_PARAM_LONG(write)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_FUNC_EX(fci, fcc, 1, 0)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (idle < 0 || read < 0 || write < 0) {
+		php_error_docref(NULL, E_WARNING, "timeouts must be 0 or greater");
+		RETURN_FALSE;
+	}
+	if (uv_is_closing(&uv->uv.handle)) {
+		php_error_docref(NULL, E_WARNING, "passed uv_resource is closing");
+		RETURN_FALSE;
+	}
+
+	if (idle == 0 && read == 0 && write == 0) {
+		if (uv->timeouts) {
+			php_uv_stream_timeouts_stop(uv);
+		}
+		RETURN_TRUE;
+	}
+
+	timeouts = uv->timeouts;
+	if (timeouts == NULL) {
+		timeouts = emalloc(sizeof(php_uv_stream_timeouts_t));
+		PHP_UV_INTERNAL_INIT(&timeouts->internal, php_uv_stream_timeouts_dispose);
+		TSRMLS_SET_CTX(timeouts->thread_ctx);
+		uv_timer_init(uv->uv.handle.loop, &timeouts->timer);
+		timeouts->timer.data = &timeouts->internal;
+		/* the stream keeps the loop alive, its deadlines do not */
+		uv_unref((uv_handle_t *) &timeouts->timer);
+		timeouts->stream = uv;
+		timeouts->callback = NULL;
+		timeouts->writes = 0;
+		uv->timeouts = timeouts;
+	} else if (timeouts->callback) {
+		php_uv_cb_free(timeouts->callback);
+		timeouts->callback = NULL;
+	}
+	if (ZEND_FCI_INITIALIZED(fci)) {
+		timeouts->callback = php_uv_cb_init_dynamic(uv, &fci, &fcc);
+	}
+
+	now = uv_now(uv->uv.handle.loop);
+	timeouts->idle = (uint64_t) idle;
+	timeouts->write = (uint64_t) write;
+	timeouts->activity = now;
+	timeouts->read_deadline = read ? now + (uint64_t) read : 0;
+	timeouts->write_deadline = timeouts->writes && write ? now + (uint64_t) write : 0;
+	php_uv_stream_timeouts_arm(timeouts);
+
+	RETURN_TRUE;
+}
+/* }}} */
+
+/* {{{ proto void uv_tcp_nodelay(resource $handle, bool $enable)
+*/
+PHP_FUNCTION(uv_tcp_nodelay)
+{
+	php_uv_t *client;
+	zend_bool bval = 1;
+
+	ZEND_PARSE_PARAMETERS_START(2, 2)
+		UV_PARAM_OBJ(client, php_uv_t, uv_tcp_ce)
+		Z_PARAM_BOOL(bval)
+	ZEND_PARSE_PARAMETERS_END();
+
+	uv_tcp_nodelay(&client->uv.tcp, bval);
+}
+/* }}} */
+
+/* {{{ proto void uv_accept(resource $server, resource $client)
+*/
+PHP_FUNCTION(uv_accept)
+{
+	php_uv_t *server, *client;
+	int r;
+
+	ZEND_PARSE_PARAMETERS_START(2, 2)
+		UV_PARAM_OBJ(server, php_uv_t, uv_tcp_ce, uv_pipe_ce)
+		UV_PARAM_OBJ(client, php_uv_t, uv_tcp_ce, uv_pipe_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (server->std.ce != client->std.ce) {
+		php_error_docref(NULL, E_WARNING, ".");
+		zend_internal_type_error(ZEND_ARG_USES_STRICT_TYPES(), "%s expects server and client parameters to be either both of type UVTcp or both of type UVPipe", get_active_function_name());
+		return;
+	}
+
+	r = uv_accept(&server->uv.stream, &client->uv.stream);
+	if (r) {
+		php_error_docref(NULL, E_WARNING, "%s", php_uv_strerror(r));
+		RETURN_FALSE;
+	}
+}
+/* }}} */
+
+
+/* {{{ proto void uv_shutdown(resource $handle, callable $callback)
+*/
+PHP_FUNCTION(uv_shutdown)
+{
+	php_uv_t *uv;
+	uv_shutdown_t *shutdown;
+	zend_fcall_info fci       = empty_fcall_info;
+	zend_fcall_info_cache fcc = empty_fcall_info_cache;
+	php_uv_cb_t *cb;
+	int r = 0;
+
+	ZEND_PARSE_PARAMETERS_START(1, 2)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_ce)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_FUNC_EX(fci, fcc, 1, 0)
+	ZEND_PARSE_PARAMETERS_END();
+
+	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_SHUTDOWN_CB);
+
+	GC_REFCOUNT(&uv->std)++;
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_shutdown, uv);
+	shutdown = emalloc(sizeof(uv_shutdown_t));
+	shutdown->data = uv;
+
+	r = uv_shutdown(shutdown, &uv->uv.stream, (uv_shutdown_cb)php_uv_shutdown_cb);
+	if (r) {
+		php_error_docref(NULL, E_WARNING, "%s", php_uv_strerror(r));
+		efree(&shutdown);
+	}
+
+}
+/* }}} */
+
+/* {{{ proto void uv_close(resource $handle, callable $callback)
+*/
+PHP_FUNCTION(uv_close)
+{
+	php_uv_t *uv;
+	zend_fcall_info fci       = empty_fcall_info;
+	zend_fcall_info_cache fcc = empty_fcall_info_cache;
+	php_uv_cb_t *cb;
+
+	ZEND_PARSE_PARAMETERS_START(1, 2)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_ce)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_FUNC_EX(fci, fcc, 1, 0)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (!php_uv_closeable_type(uv)) {
+		php_error_docref(NULL, E_WARNING, "passed UV handle (%s) is not closeable", ZSTR_VAL(uv->std.ce->name));
+		RETURN_FALSE;
+	}
+
+	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_CLOSE_CB);
+
+	php_uv_close(uv);
+}
+/* }}} */
+
+/* {{{ proto void uv_read_start(resource $handle, callable $callback)
+*/
+PHP_FUNCTION(uv_read_start)
+{
+	php_uv_t *uv;
+	zend_fcall_info fci       = empty_fcall_info;
+	zend_fcall_info_cache fcc = empty_fcall_info_cache;
+	php_uv_cb_t *cb;
+	int r;
+	uv_os_fd_t fd;
+
+	PHP_UV_DEBUG_PRINT("uv_read_start\n");
+
+	ZEND_PARSE_PARAMETERS_START(2, 2)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_tcp_ce, uv_pipe_ce, uv_tty_ce)
+		Z_PARAM_FUNC(fci, fcc)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (uv_fileno(&uv->uv.handle, &fd) != 0) {
+		php_error_docref(NULL, E_WARNING, "passed UV handle is not initialized yet");
+		return;
+	}
+
+	GC_REFCOUNT(&uv->std)++;
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_read_start, uv);
+
+	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_READ_CB);
+
+	r = uv_read_start(&uv->uv.stream, php_uv_read_alloc, php_uv_read_cb);
+	if (r) {
+		php_error_docref(NULL, E_NOTICE, "read failed");
+		OBJ_RELEASE(&uv->std);
+	}
+}
+/* }}} */
+
+/* {{{ proto void uv_read2_start(resource $handle, callable $callback)
+*/
+PHP_FUNCTION(uv_read2_start)
+{
+	/* TODO: determine how to make this backwards compatible? */
+	php_error_docref(NULL, E_ERROR, "uv_read2_start is no longer supported.");
+	/*
+	php_uv_t *uv;
+	int r;
+	zend_fcall_info fci       = empty_fcall_info;
+	zend_fcall_info_cache fcc = empty_fcall_info_cache;
+	php_uv_cb_t *cb;
+
+	PHP_UV_DEBUG_PRINT("uv_read2_start\n");
+
+	ZEND_PARSE_PARAMETERS_START(2, 2)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_tcp_ce, uv_pipe_ce, uv_tty_ce)
+		Z_PARAM_FUNC(fci, fcc)
+	ZEND_PARSE_PARAMETERS_END();
+
+	GC_REFCOUNT(&uv->std)++;
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_read2_start, uv);
+
+	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_READ2_CB);
+	r = uv_read2_start(&uv->uv.stream, php_uv_read_alloc, php_uv_read2_cb);
+	if (r) {
+		php_error_docref(NULL, E_NOTICE, "read2 failed");
+		OBJ_RELEASE(&uv->std);
+	}
+	*/
+}
+/* }}} */
+
+/* {{{ proto void uv_read_stop(resource $handle)
+*/
+PHP_FUNCTION(uv_read_stop)
+{
+	php_uv_t *uv;
+
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_tcp_ce, uv_pipe_ce, uv_tty_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (!uv_is_active(&uv->uv.handle)) {
+		return;
+	}
+
+	uv_read_stop(&uv->uv.stream);
+
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_read_stop, uv);
+	OBJ_RELEASE(&uv->std);
+}
+/* }}} */
+
+/* {{{ proto resource uv_ip4_addr(string $ipv4_addr, long $port)
+*/
+PHP_FUNCTION(uv_ip4_addr)
+{
+	zend_string *address;
+	zend_long port = 0;
+	php_uv_sockaddr_t *sockaddr;
+
+	if (zend_parse_parameters(ZEND_NUM_ARGS(),
+		"Sl", &address, &port) == FAILURE) {
+		return;
+	}
+
+	PHP_UV_SOCKADDR_IPV4_INIT(sockaddr);
+	uv_ip4_addr(address->val, port, &PHP_UV_SOCKADDR_IPV4(sockaddr));
+
+	RETURN_OBJ(&sockaddr->std);
+}
+/* }}} */
+
+/* {{{ proto resource uv_ip6_addr(string $ipv6_addr, long $port)
+*/
+PHP_FUNCTION(uv_ip6_addr)
+{
+	zend_string *address;
+	zend_long port = 0;
+	php_uv_sockaddr_t *sockaddr;
+
+	if (zend_parse_parameters(ZEND_NUM_ARGS(),
+		"Sl", &address, &port) == FAILURE) {
+		return;
+	}
+
+	PHP_UV_SOCKADDR_IPV6_INIT(sockaddr);
+	uv_ip6_addr(address->val, port, &PHP_UV_SOCKADDR_IPV6(sockaddr));
+
+	RETURN_OBJ(&sockaddr->std);
+}
+/* }}} */
+
+
+/* {{{ proto void uv_listen(resource $handle, long $backlog, callable $callback)
+*/
+PHP_FUNCTION(uv_listen)
+{
+	zend_long backlog = SOMAXCONN;
+	php_uv_t *uv;
+	zend_fcall_info fci       = empty_fcall_info;
+	zend_fcall_info_cache fcc = empty_fcall_info_cache;
+	php_uv_cb_t *cb;
+	int r;
+
+	ZEND_PARSE_PARAMETERS_START(3, 3)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_tcp_ce, uv_pipe_ce)
+		Z_PARAM_LONG(backlog)
+		Z_PARAM_FUNC(fci, fcc)
+	ZEND_PARSE_PARAMETERS_END();
+
+	GC_REFCOUNT(&uv->std)++;
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_listen, uv);
+	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_LISTEN_CB);
+
+	r = uv_listen(&uv->uv.stream, backlog, php_uv_listen_cb);
+	if (r) {
+		php_error_docref(NULL, E_WARNING, "%s", php_uv_strerror(r));
+		OBJ_RELEASE(&uv->std);
+	}
+}
+/* }}} */
+
+/* {{{ proto UVPromise uv_tcp_connect(resource $handle, resource $ipv4_addr[, callable $callback])
+*/
+PHP_FUNCTION(uv_tcp_connect)
+{
+	php_uv_tcp_connect(PHP_UV_TCP_IPV4, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
+
+
+/* {{{ proto UVPromise uv_tcp_connect6(resource $handle, resource $ipv6_addr[, callable $callback])
+*/
+PHP_FUNCTION(uv_tcp_connect6)
+{
+	php_uv_tcp_connect(PHP_UV_TCP_IPV6, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
+
+
+/* {{{ proto resource uv_timer_init([resource $loop])
+*/
+PHP_FUNCTION(uv_timer_init)
+{
+	php_uv_loop_t *loop = NULL;
+	php_uv_t *uv;
+
+	ZEND_PARSE_PARAMETERS_START(0, 1)
+		Z_PARAM_OPTIONAL
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+	ZEND_PARSE_PARAMETERS_END();
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_event_init, 0, 0, 4)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, path)
-	ZEND_ARG_INFO(0, callback)
-	ZEND_ARG_INFO(0, flags)
-ZEND_END_ARG_INFO()
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+	PHP_UV_INIT_UV_EX(uv, uv_timer_ce, uv_timer_init);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_sendfile, 0, 0, 6)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, in)
-	ZEND_ARG_INFO(0, out)
-	ZEND_ARG_INFO(0, offset)
-	ZEND_ARG_INFO(0, length)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	PHP_UV_DEBUG_PRINT("uv_timer_init: resource: %p\n", uv);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_readdir, 0, 0, 4)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, path)
-	ZEND_ARG_INFO(0, flags)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	RETURN_OBJ(&uv->std);
+}
+/* }}} */
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_scandir, 0, 0, 4)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, path)
-	ZEND_ARG_INFO(0, flags)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+/* {{{ proto void uv_timer_start(resource $timer, long $timeout, long $repeat, callable $callback)
+*/
+PHP_FUNCTION(uv_timer_start)
+{
+	php_uv_t *uv;
+	zend_long timeout, repeat = 0;
+	zend_fcall_info fci       = empty_fcall_info;
+	zend_fcall_info_cache fcc = empty_fcall_info_cache;
+	php_uv_cb_t *cb;
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_fstat, 0, 0, 3)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, fd)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	ZEND_PARSE_PARAMETERS_START(3, 4)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_timer_ce)
+		Z_PARAM_LONG(timeout)
+		Z_PARAM_LONG(repeat)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_FUNC_EX(fci, fcc, 1, 0)
+	ZEND_PARSE_PARAMETERS_END();
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_lstat, 0, 0, 3)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, path)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	if (timeout < 0) {
+		php_error_docref(NULL, E_WARNING, "timeout value have to be larger than 0. given %ld", timeout);
+		RETURN_FALSE;
+	}
+
+	if (repeat < 0) {
+		php_error_docref(NULL, E_WARNING, "repeat value have to be larger than 0. given %ld", repeat);
+		RETURN_FALSE;
+	}
+
+	if (uv_is_active(&uv->uv.handle)) {
+		php_error_docref(NULL, E_NOTICE, "passed uv timer resource has been started. you don't have to call this method");
+		RETURN_FALSE;
+	}
+
+	GC_REFCOUNT(&uv->std)++;
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_timer_start, uv);
+	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_TIMER_CB);
+	uv->await_type = PHP_UV_TIMER_CB;
+
+	uv_timer_start((uv_timer_t*)&uv->uv.timer, php_uv_timer_cb, timeout, repeat);
+}
+/* }}} */
+
+/* {{{ proto void uv_timer_stop(resource $timer)
+*/
+PHP_FUNCTION(uv_timer_stop)
+{
+	php_uv_t *uv;
+	int r = 0;
+
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_timer_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (!uv_is_active(&uv->uv.handle)) {
+		php_error_docref(NULL, E_NOTICE, "passed uv timer resource has been stopped. you don't have to call this method");
+		RETURN_FALSE;
+	}
+
+	PHP_UV_DEBUG_PRINT("uv_timer_stop: resource: %p\n", uv);
+	r = uv_timer_stop(&uv->uv.timer);
+
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_timer_stop, uv);
+	OBJ_RELEASE(&uv->std);
+
+	RETURN_LONG(r);
+}
+/* }}} */
+
+/* {{{ proto void uv_timer_again(resource $timer)
+*/
+PHP_FUNCTION(uv_timer_again)
+{
+	php_uv_t *uv;
+
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_timer_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (uv_is_active(&uv->uv.handle)) {
+		php_error_docref(NULL, E_NOTICE, "passed uv timer resource has been started. you don't have to call this method");
+		RETURN_FALSE;
+	}
+
+	GC_REFCOUNT(&uv->std)++;
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_timer_again, uv);
+
+	uv_timer_again(&uv->uv.timer);
+}
+/* }}} */
+
+/* {{{ proto void uv_timer_set_repeat(resource $timer, long $repeat)
+*/
+PHP_FUNCTION(uv_timer_set_repeat)
+{
+	php_uv_t *uv;
+	zend_long repeat;
+
+	ZEND_PARSE_PARAMETERS_START(2, 2)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_timer_ce)
+		Z_PARAM_LONG(repeat)
+	ZEND_PARSE_PARAMETERS_END();
+
+	uv_timer_set_repeat(&uv->uv.timer, repeat);
+}
+/* }}} */
+
+/* {{{ proto long uv_timer_get_repeat(resource $timer)
+*/
+PHP_FUNCTION(uv_timer_get_repeat)
+{
+	php_uv_t *uv;
+	int64_t repeat;
+
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_timer_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+	repeat = uv_timer_get_repeat(&uv->uv.timer);
+	RETURN_LONG(repeat);
+}
+/* }}} */
+
+#define PHP_UV_TIMER_WHEEL_MAX_SLOTS (1 << 20)
+
+static zend_always_inline uint64_t php_uv_timer_wheel_now(php_uv_timer_wheel_t *wheel)
+{
+	return (uv_now(wheel->driver->timer.loop) - wheel->epoch) / wheel->tick;
+}
+
+static void php_uv_timer_wheel_link(php_uv_timer_wheel_t *wheel, int32_t index, uint32_t timeout)
+{
+	php_uv_timer_wheel_entry_t *entry = &wheel->entries[index];
+
+	/* the current tick is partly over already: one more, so deadlines never expire early */
+	entry->timeout = timeout;
+	entry->expires = php_uv_timer_wheel_now(wheel) + timeout + 1;
+	entry->slot = (int32_t) (entry->expires & wheel->mask);
+	entry->prev = -1;
+	entry->next = wheel->slots[entry->slot];
+	if (entry->next >= 0) {
+		wheel->entries[entry->next].prev = index;
+	}
+	wheel->slots[entry->slot] = index;
+}
+
+static void php_uv_timer_wheel_unlink(php_uv_timer_wheel_t *wheel, int32_t index)
+{
+	php_uv_timer_wheel_entry_t *entry = &wheel->entries[index];
+
+	if (entry->prev >= 0) {
+		wheel->entries[entry->prev].next = entry->next;
+	} else {
+		wheel->slots[entry->slot] = entry->next;
+	}
+	if (entry->next >= 0) {
+		wheel->entries[entry->next].prev = entry->prev;
+	}
+}
+
+static void php_uv_timer_wheel_release_entry(php_uv_timer_wheel_t *wheel, int32_t index)
+{
+	wheel->entries[index].slot = -1;
+	wheel->entries[index].next = wheel->free;
+	wheel->free = index;
+	wheel->count--;
+}
+
+static void php_uv_timer_wheel_disarm(php_uv_timer_wheel_t *wheel)
+{
+	if (wheel->armed) {
+		wheel->armed = 0;
+		uv_timer_stop(&wheel->driver->timer);
+		OBJ_RELEASE(&wheel->std);
+	}
+}
+
+static void php_uv_timer_wheel_cb(uv_timer_t *handle)
+{
+	php_uv_timer_wheel_driver_t *driver = PHP_UV_CONTAINER_OF(handle, php_uv_timer_wheel_driver_t, timer);
+	php_uv_timer_wheel_t *wheel = driver->wheel;
+	uint64_t now, steps, i;
+	zval params[2], retval;
+	TSRMLS_FETCH_FROM_CTX(driver->thread_ctx);
+	PHP_UV_CTX_ENTER();
+
+	/* the callback may cancel the last deadline and so drop the timer's reference */
+	GC_REFCOUNT(&wheel->std)++;
+
+	now = php_uv_timer_wheel_now(wheel);
+	steps = MIN(now - wheel->current, (uint64_t) wheel->mask + 1);
+
+	array_init(&params[1]);
+	for (i = 1; i <= steps; i++) {
+		int32_t index = wheel->slots[(wheel->current + i) & wheel->mask];
+
+		while (index >= 0) {
+			php_uv_timer_wheel_entry_t *entry = &wheel->entries[index];
+			int32_t next = entry->next;
+
+			/* the others are a round or more away */
+			if (entry->expires <= now) {
+				php_uv_timer_wheel_unlink(wheel, index);
+				php_uv_timer_wheel_release_entry(wheel, index);
+				add_next_index_long(&params[1], index + 1);
+			}
+			index = next;
+		}
+	}
+	wheel->current = now;
+
+	if (zend_hash_num_elements(Z_ARRVAL(params[1])) > 0) {
+		ZVAL_OBJ(&params[0], &wheel->std);
+		if (php_uv_dispatch(PHP_UV_CONTAINER_OF(handle->loop, php_uv_loop_t, loop), &wheel->std, wheel->callback, &retval, params, 2) == SUCCESS) {
+			zval_ptr_dtor(&retval);
+		}
+	}
+	zval_ptr_dtor(&params[1]);
+
+	if (wheel->count == 0) {
+		php_uv_timer_wheel_disarm(wheel);
+	}
+	OBJ_RELEASE(&wheel->std);
+
+	PHP_UV_CTX_LEAVE();
+}
+
+static void php_uv_timer_wheel_dispose(php_uv_internal_t *internal)
+{
+	php_uv_timer_wheel_driver_t *driver = PHP_UV_CONTAINER_OF(internal, php_uv_timer_wheel_driver_t, internal);
+	php_uv_timer_wheel_t *wheel = driver->wheel;
+
+	/* the loop goes away: pending deadlines never expire */
+	uv_close((uv_handle_t *) &driver->timer, php_uv_timer_wheel_driver_close_cb);
+	if (wheel) {
+		driver->wheel = NULL;
+		wheel->driver = NULL;
+		if (wheel->armed) {
+			wheel->armed = 0;
+			OBJ_RELEASE(&wheel->std);
+		}
+	}
+}
+
+static zend_bool php_uv_timer_wheel_ticks(php_uv_timer_wheel_t *wheel, zend_long timeout, uint32_t *ticks)
+{
+	if (timeout < 0) {
+		php_error_docref(NULL, E_WARNING, "timeout must be 0 or greater");
+		return 0;
+	}
+	if (wheel->driver == NULL) {
+		php_error_docref(NULL, E_WARNING, "the loop of the passed UVTimerWheel is gone");
+		return 0;
+	}
+
+	/* rounded up, and due on the next tick at the earliest */
+	*ticks = (uint32_t) MIN(((uint64_t) timeout + wheel->tick - 1) / wheel->tick, UINT32_MAX);
+	if (*ticks == 0) {
+		*ticks = 1;
+	}
+	return 1;
+}
+
+static zend_always_inline php_uv_timer_wheel_entry_t *php_uv_timer_wheel_entry(php_uv_timer_wheel_t *wheel, zend_long id)
+{
+	if (id < 1 || (zend_ulong) id > wheel->entries_size || wheel->entries[id - 1].slot < 0) {
+		return NULL;
+	}
+	return &wheel->entries[id - 1];
+}
+
+/* {{{ proto UVTimerWheel uv_timer_wheel_new(long $tick_ms, callable $callback[, long $slots = 512, UVLoop $loop])
+*/
+PHP_FUNCTION(uv_timer_wheel_new)
+{
+	php_uv_loop_t *loop = NULL;
+	php_uv_timer_wheel_t *wheel;
+	php_uv_timer_wheel_driver_t *driver;
+	zend_fcall_info fci = empty_fcall_info;
+	zend_fcall_info_cache fcc = empty_fcall_info_cache;
+	zend_long tick, slots = 512;
+	uint32_t count = 1;
+
+	ZEND_PARSE_PARAMETERS_START(2, 4)
+		Z_PARAM_LONG(tick)
+		Z_PARAM_FUNC(fci, fcc)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_LONG(slots)
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (tick < 1) {
+		php_error_docref(NULL, E_WARNING, "tick must be 1 or greater");
+		RETURN_FALSE;
+	}
+	if (slots < 1 || slots > PHP_UV_TIMER_WHEEL_MAX_SLOTS) {
+		php_error_docref(NULL, E_WARNING, "slots must be between 1 and %d", PHP_UV_TIMER_WHEEL_MAX_SLOTS);
+		RETURN_FALSE;
+	}
+
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+
+	/* a power of two, so the slot is a mask of the tick */
+	while (count < (uint32_t) slots) {
+		count <<= 1;
+	}
+
+	object_init_ex(return_value, uv_timer_wheel_ce);
+	wheel = (php_uv_timer_wheel_t *) Z_OBJ_P(return_value);
+	wheel->callback = php_uv_cb_init_dynamic(NULL, &fci, &fcc);
+	wheel->tick = (uint64_t) tick;
+	wheel->epoch = uv_now(&loop->loop);
+	wheel->mask = count - 1;
+	wheel->slots = safe_emalloc(count, sizeof(int32_t), 0);
+	memset(wheel->slots, 0xff, count * sizeof(int32_t));
+
+	driver = emalloc(sizeof(php_uv_timer_wheel_driver_t));
+	PHP_UV_INTERNAL_INIT(&driver->internal, php_uv_timer_wheel_dispose);
+	TSRMLS_SET_CTX(driver->thread_ctx);
+	uv_timer_init(&loop->loop, &driver->timer);
+	driver->timer.data = &driver->internal;
+	driver->wheel = wheel;
+	wheel->driver = driver;
+}
+/* }}} */
+
+/* {{{ proto long uv_timer_wheel_add(UVTimerWheel $wheel, long $timeout_ms)
+*/
+PHP_FUNCTION(uv_timer_wheel_add)
+{
+	php_uv_timer_wheel_t *wheel;
+	zend_long timeout;
+	uint32_t ticks;
+	int32_t index;
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_stat, 0, 0, 3)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, path)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	ZEND_PARSE_PARAMETERS_START(2, 2)
+		UV_PARAM_OBJ(wheel, php_uv_timer_wheel_t, uv_timer_wheel_ce)
+		Z_PARAM_LONG(timeout)
+	ZEND_PARSE_PARAMETERS_END();
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_readlink, 0, 0, 3)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, path)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	if (!php_uv_timer_wheel_ticks(wheel, timeout, &ticks)) {
+		RETURN_FALSE;
+	}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_symlink, 0, 0, 5)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, from)
-	ZEND_ARG_INFO(0, to)
-	ZEND_ARG_INFO(0, callback)
-	ZEND_ARG_INFO(0, flags)
-ZEND_END_ARG_INFO()
+	if (wheel->free < 0) {
+		uint32_t i, size = wheel->entries_size ? wheel->entries_size * 2 : 64;
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_link, 0, 0, 4)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, from)
-	ZEND_ARG_INFO(0, to)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+		if (size > INT32_MAX) {
+			php_error_docref(NULL, E_WARNING, "too many deadlines");
+			RETURN_FALSE;
+		}
+		wheel->entries = safe_erealloc(wheel->entries, size, sizeof(php_uv_timer_wheel_entry_t), 0);
+		for (i = size; i > wheel->entries_size; i--) {
+			wheel->entries[i - 1].slot = -1;
+			wheel->entries[i - 1].next = wheel->free;
+			wheel->free = (int32_t) (i - 1);
+		}
+		wheel->entries_size = size;
+	}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_fchown, 0, 0, 5)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, fd)
-	ZEND_ARG_INFO(0, uid)
-	ZEND_ARG_INFO(0, gid)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	if (!wheel->armed) {
+		/* ticks passed while nothing was due are skipped */
+		wheel->current = php_uv_timer_wheel_now(wheel);
+		GC_REFCOUNT(&wheel->std)++;
+		wheel->armed = 1;
+		uv_timer_start(&wheel->driver->timer, php_uv_timer_wheel_cb, wheel->tick, wheel->tick);
+	}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_chown, 0, 0, 5)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, path)
-	ZEND_ARG_INFO(0, uid)
-	ZEND_ARG_INFO(0, gid)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	index = wheel->free;
+	wheel->free = wheel->entries[index].next;
+	wheel->count++;
+	php_uv_timer_wheel_link(wheel, index, ticks);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_fchmod, 0, 0, 4)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, fd)
-	ZEND_ARG_INFO(0, mode)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	RETURN_LONG(index + 1);
+}
+/* }}} */
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_chmod, 0, 0, 4)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, path)
-	ZEND_ARG_INFO(0, mode)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+/* {{{ proto bool uv_timer_wheel_reset(UVTimerWheel $wheel, long $id[, long $timeout_ms])
+*/
+PHP_FUNCTION(uv_timer_wheel_reset)
+{
+	php_uv_timer_wheel_t *wheel;
+	php_uv_timer_wheel_entry_t *entry;
+	zend_long id, timeout = -1;
+	uint32_t ticks;
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_futime, 0, 0, 5)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, fd)
-	ZEND_ARG_INFO(0, utime)
-	ZEND_ARG_INFO(0, atime)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	ZEND_PARSE_PARAMETERS_START(2, 3)
+		UV_PARAM_OBJ(wheel, php_uv_timer_wheel_t, uv_timer_wheel_ce)
+		Z_PARAM_LONG(id)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_LONG(timeout)
+	ZEND_PARSE_PARAMETERS_END();
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_utime, 0, 0, 5)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, path)
-	ZEND_ARG_INFO(0, utime)
-	ZEND_ARG_INFO(0, atime)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	entry = php_uv_timer_wheel_entry(wheel, id);
+	if (entry == NULL) {
+		RETURN_FALSE;
+	}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_open, 0, 0, 5)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, path)
-	ZEND_ARG_INFO(0, flag)
-	ZEND_ARG_INFO(0, mode)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	if (!php_uv_timer_wheel_ticks(wheel, ZEND_NUM_ARGS() < 3 ? 0 : timeout, &ticks)) {
+		RETURN_FALSE;
+	}
+	if (ZEND_NUM_ARGS() < 3) {
+		ticks = entry->timeout;
+	}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_read, 0, 0, 3)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, fd)
-	ZEND_ARG_INFO(0, offset)
-	ZEND_ARG_INFO(0, size)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	php_uv_timer_wheel_unlink(wheel, (int32_t) (id - 1));
+	php_uv_timer_wheel_link(wheel, (int32_t) (id - 1), ticks);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_close, 0, 0, 3)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, fd)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	RETURN_TRUE;
+}
+/* }}} */
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_write, 0, 0, 5)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, fd)
-	ZEND_ARG_INFO(0, buffer)
-	ZEND_ARG_INFO(0, offset)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+/* {{{ proto bool uv_timer_wheel_cancel(UVTimerWheel $wheel, long $id)
+*/
+PHP_FUNCTION(uv_timer_wheel_cancel)
+{
+	php_uv_timer_wheel_t *wheel;
+	zend_long id;
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_fsync, 0, 0, 3)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, fd)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	ZEND_PARSE_PARAMETERS_START(2, 2)
+		UV_PARAM_OBJ(wheel, php_uv_timer_wheel_t, uv_timer_wheel_ce)
+		Z_PARAM_LONG(id)
+	ZEND_PARSE_PARAMETERS_END();
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_fdatasync, 0, 0, 3)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, fd)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	if (php_uv_timer_wheel_entry(wheel, id) == NULL) {
+		RETURN_FALSE;
+	}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_ftruncate, 0, 0, 4)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, fd)
-	ZEND_ARG_INFO(0, offset)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	php_uv_timer_wheel_unlink(wheel, (int32_t) (id - 1));
+	php_uv_timer_wheel_release_entry(wheel, (int32_t) (id - 1));
+	if (wheel->count == 0) {
+		php_uv_timer_wheel_disarm(wheel);
+	}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_mkdir, 0, 0, 4)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, path)
-	ZEND_ARG_INFO(0, mode)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	RETURN_TRUE;
+}
+/* }}} */
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_rmdir, 0, 0, 3)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, path)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+static void php_uv_timeout_close_cb(uv_handle_t *handle)
+{
+	efree(PHP_UV_CONTAINER_OF(handle, php_uv_timeout_t, timer));
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_unlink, 0, 0, 3)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, path)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+/* the timer is stopped: keep it for the next uv_set_timeout() on its loop */
+static void php_uv_timeout_release(php_uv_timeout_t *timeout)
+{
+	php_uv_loop_t *loop = PHP_UV_CONTAINER_OF(timeout->timer.loop, php_uv_loop_t, loop);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_rename, 0, 0, 4)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, from)
-	ZEND_ARG_INFO(0, to)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	if (loop->timeouts_pool_count < PHP_UV_TIMEOUT_POOL_MAX && !PHP_UV_IS_DTORED(loop)) {
+		timeout->next = loop->timeouts_pool;
+		loop->timeouts_pool = timeout;
+		loop->timeouts_pool_count++;
+	} else {
+		uv_close((uv_handle_t *) &timeout->timer, php_uv_timeout_close_cb);
+	}
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_rwlock_rdlock, 0, 0, 1)
-	ZEND_ARG_INFO(0, handle)
-ZEND_END_ARG_INFO()
+static void php_uv_timeout_cb(uv_timer_t *handle)
+{
+	php_uv_timeout_t *timeout = PHP_UV_CONTAINER_OF(handle, php_uv_timeout_t, timer);
+	php_uv_loop_t *loop = PHP_UV_CONTAINER_OF(handle->loop, php_uv_loop_t, loop);
+	php_uv_cb_t *cb = timeout->callback;
+	zval retval;
+	TSRMLS_FETCH_FROM_CTX(timeout->thread_ctx);
+	PHP_UV_CTX_ENTER();
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_rwlock_tryrdlock, 0, 0, 1)
-	ZEND_ARG_INFO(0, handle)
-ZEND_END_ARG_INFO()
+	/* released first, the callback may schedule the next one on the same timer */
+	zend_hash_index_del(&UV_G(timeouts), timeout->id);
+	timeout->callback = NULL;
+	php_uv_timeout_release(timeout);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_rwlock_rdunlock, 0, 0, 1)
-	ZEND_ARG_INFO(0, handle)
-ZEND_END_ARG_INFO()
+	if (php_uv_dispatch(loop, NULL, cb, &retval, NULL, 0) == SUCCESS) {
+		zval_ptr_dtor(&retval);
+	}
+	php_uv_cb_free(cb);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_rwlock_wrlock, 0, 0, 1)
-	ZEND_ARG_INFO(0, handle)
-ZEND_END_ARG_INFO()
+	PHP_UV_CTX_LEAVE();
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_rwlock_trywrlock, 0, 0, 1)
-	ZEND_ARG_INFO(0, handle)
-ZEND_END_ARG_INFO()
+static void php_uv_timeout_dispose(php_uv_internal_t *internal)
+{
+	php_uv_timeout_t *timeout = PHP_UV_CONTAINER_OF(internal, php_uv_timeout_t, internal);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_rwlock_wrunlock, 0, 0, 1)
-	ZEND_ARG_INFO(0, handle)
-ZEND_END_ARG_INFO()
+	if (timeout->callback) {
+		zend_hash_index_del(&UV_G(timeouts), timeout->id);
+		php_uv_cb_free(timeout->callback);
+	} else {
+		/* the pool goes away with the loop, all its timers are disposed of */
+		PHP_UV_CONTAINER_OF(timeout->timer.loop, php_uv_loop_t, loop)->timeouts_pool = NULL;
+	}
+	uv_close((uv_handle_t *) &timeout->timer, php_uv_timeout_close_cb);
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_mutex_lock, 0, 0, 1)
-	ZEND_ARG_INFO(0, handle)
-ZEND_END_ARG_INFO()
+/* {{{ proto long uv_set_timeout(UVLoop $uv_loop, long $timeout_ms, callable $callback)
+*/
+PHP_FUNCTION(uv_set_timeout)
+{
+	php_uv_loop_t *loop = NULL;
+	php_uv_timeout_t *timeout;
+	zend_fcall_info fci = empty_fcall_info;
+	zend_fcall_info_cache fcc = empty_fcall_info_cache;
+	zend_long ms;
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_mutex_trylock, 0, 0, 1)
-	ZEND_ARG_INFO(0, handle)
-ZEND_END_ARG_INFO()
+	ZEND_PARSE_PARAMETERS_START(3, 3)
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+		Z_PARAM_LONG(ms)
+		Z_PARAM_FUNC(fci, fcc)
+	ZEND_PARSE_PARAMETERS_END();
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_mutex_unlock, 0, 0, 1)
-	ZEND_ARG_INFO(0, handle)
-ZEND_END_ARG_INFO()
+	if (ms < 0) {
+		php_error_docref(NULL, E_WARNING, "timeout must be 0 or greater");
+		RETURN_FALSE;
+	}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_sem_init, 0, 0, 1)
-	ZEND_ARG_INFO(0, val)
-ZEND_END_ARG_INFO()
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_sem_post, 0, 0, 1)
-	ZEND_ARG_INFO(0, resource)
-ZEND_END_ARG_INFO()
+	if (loop->timeouts_pool) {
+		timeout = loop->timeouts_pool;
+		loop->timeouts_pool = timeout->next;
+		loop->timeouts_pool_count--;
+	} else {
+		timeout = emalloc(sizeof(php_uv_timeout_t));
+		PHP_UV_INTERNAL_INIT(&timeout->internal, php_uv_timeout_dispose);
+		TSRMLS_SET_CTX(timeout->thread_ctx);
+		uv_timer_init(&loop->loop, &timeout->timer);
+		timeout->timer.data = &timeout->internal;
+	}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_sem_wait, 0, 0, 1)
-	ZEND_ARG_INFO(0, resource)
-ZEND_END_ARG_INFO()
+	timeout->callback = php_uv_cb_init_dynamic(NULL, &fci, &fcc);
+	timeout->id = ++UV_G(timeout_id);
+	zend_hash_index_add_new_ptr(&UV_G(timeouts), timeout->id, timeout);
+	uv_timer_start(&timeout->timer, php_uv_timeout_cb, ms, 0);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_sem_trywait, 0, 0, 1)
-	ZEND_ARG_INFO(0, resource)
-ZEND_END_ARG_INFO()
+	RETURN_LONG(timeout->id);
+}
+/* }}} */
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_prepare_init, 0, 0, 0)
-	ZEND_ARG_INFO(0, loop)
-ZEND_END_ARG_INFO()
+/* {{{ proto bool uv_clear_timeout(long $id)
+*/
+PHP_FUNCTION(uv_clear_timeout)
+{
+	php_uv_timeout_t *timeout;
+	zend_long id;
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_prepare_start, 0, 0, 2)
-	ZEND_ARG_INFO(0, handle)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		Z_PARAM_LONG(id)
+	ZEND_PARSE_PARAMETERS_END();
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_prepare_stop, 0, 0, 1)
-	ZEND_ARG_INFO(0, handle)
-ZEND_END_ARG_INFO()
+	timeout = zend_hash_index_find_ptr(&UV_G(timeouts), id);
+	if (timeout == NULL) {
+		RETURN_FALSE;
+	}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_check_init, 0, 0, 1)
-	ZEND_ARG_INFO(0, loop)
-ZEND_END_ARG_INFO()
+	zend_hash_index_del(&UV_G(timeouts), id);
+	uv_timer_stop(&timeout->timer);
+	php_uv_cb_free(timeout->callback);
+	timeout->callback = NULL;
+	php_uv_timeout_release(timeout);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_check_start, 0, 0, 2)
-	ZEND_ARG_INFO(0, handle)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	RETURN_TRUE;
+}
+/* }}} */
+
+/* microtasks are kept by value in the ring, this drops what php_uv_microtask_push() took */
+static void php_uv_microtask_release(php_uv_cb_t *task)
+{
+	zval_ptr_dtor(&task->fci.function_name);
+	if (task->fci.object != NULL) {
+		OBJ_RELEASE(task->fci.object);
+	}
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_check_stop, 0, 0, 1)
-	ZEND_ARG_INFO(0, handle)
-ZEND_END_ARG_INFO()
+static void php_uv_microtask_push(php_uv_loop_t *loop, zend_fcall_info *fci, zend_fcall_info_cache *fcc)
+{
+	php_uv_cb_t *task;
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_async_send, 0, 0, 1)
-	ZEND_ARG_INFO(0, handle)
-ZEND_END_ARG_INFO()
+	if (loop->microtasks_count == loop->microtasks_size) {
+		uint32_t size = loop->microtasks_size ? loop->microtasks_size * 2 : 16;
+		php_uv_cb_t *microtasks = safe_emalloc(size, sizeof(php_uv_cb_t), 0);
+		uint32_t i;
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_async_init, 0, 0, 2)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+		for (i = 0; i < loop->microtasks_count; i++) {
+			microtasks[i] = loop->microtasks[(loop->microtasks_head + i) % loop->microtasks_size];
+		}
+		if (loop->microtasks) {
+			efree(loop->microtasks);
+		}
+		loop->microtasks = microtasks;
+		loop->microtasks_head = 0;
+		loop->microtasks_size = size;
+	}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_tcp_getsockname, 0, 0, 1)
-	ZEND_ARG_INFO(0, handle)
-ZEND_END_ARG_INFO()
+	task = &loop->microtasks[(loop->microtasks_head + loop->microtasks_count++) % loop->microtasks_size];
+	memcpy(&task->fci, fci, sizeof(zend_fcall_info));
+	memcpy(&task->fcc, fcc, sizeof(zend_fcall_info_cache));
+	task->fast = php_uv_cb_fast_function(fci, fcc);
+	Z_TRY_ADDREF(task->fci.function_name);
+	if (fci->object) {
+		GC_REFCOUNT(task->fci.object)++;
+	}
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_tcp_getpeername, 0, 0, 1)
-	ZEND_ARG_INFO(0, handle)
-ZEND_END_ARG_INFO()
+static void php_uv_microtask_idle_cb(uv_idle_t *handle)
+{
+	/* only there to make the loop poll without blocking */
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_getsockname, 0, 0, 1)
-	ZEND_ARG_INFO(0, handle)
-ZEND_END_ARG_INFO()
+static void php_uv_microtask_cb(uv_check_t *handle)
+{
+	php_uv_loop_t *loop = PHP_UV_CONTAINER_OF(handle, php_uv_loop_t, microtask_check);
+	php_uv_budget_t *budget = loop->budget;
+	/* microtasks queued from here on wait for the next iteration */
+	uint32_t n = MIN(loop->microtasks_count, PHP_UV_MICROTASK_TICK_MAX);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_udp_set_membership, 0, 0, 4)
-	ZEND_ARG_INFO(0, client)
-	ZEND_ARG_INFO(0, multicast_addr)
-	ZEND_ARG_INFO(0, interface_addr)
-	ZEND_ARG_INFO(0, membership)
-ZEND_END_ARG_INFO()
+	/* a spent budget leaves the rest queued rather than deferred, they keep their order */
+	while (n-- > 0 && loop->microtasks_count > 0 && !EG(exception) && !(budget && budget->spent)) {
+		php_uv_cb_t task = loop->microtasks[loop->microtasks_head];
+		zval retval;
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_ip6_name, 0, 0, 1)
-	ZEND_ARG_INFO(0, handle)
-ZEND_END_ARG_INFO()
+		loop->microtasks_head = (loop->microtasks_head + 1) % loop->microtasks_size;
+		loop->microtasks_count--;
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_ip4_name, 0, 0, 1)
-	ZEND_ARG_INFO(0, handle)
-ZEND_END_ARG_INFO()
+		if (php_uv_dispatch(loop, NULL, &task, &retval, NULL, 0) == SUCCESS) {
+			zval_ptr_dtor(&retval);
+		}
+		php_uv_microtask_release(&task);
+	}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_poll_init, 0, 0, 1)
-	ZEND_ARG_INFO(0, loop)
-ZEND_END_ARG_INFO()
+	if (loop->microtasks_count == 0 || EG(exception)) {
+		/* an exception leaves the rest queued, php_uv_microtask_start() picks them up in the next uv_run() */
+		uv_check_stop(&loop->microtask_check);
+		uv_idle_stop(&loop->microtask_idle);
+	}
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_poll_start, 0, 0, 4)
-	ZEND_ARG_INFO(0, handle)
-	ZEND_ARG_INFO(0, callback)
-	ZEND_ARG_INFO(0, path)
-	ZEND_ARG_INFO(0, interval)
-ZEND_END_ARG_INFO()
+static void php_uv_microtask_start(php_uv_loop_t *loop)
+{
+	if (loop->microtasks_count > 0 && !uv_is_active((uv_handle_t *) &loop->microtask_check)) {
+		uv_check_start(&loop->microtask_check, php_uv_microtask_cb);
+		uv_idle_start(&loop->microtask_idle, php_uv_microtask_idle_cb);
+	}
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_fs_poll_stop, 0, 0, 1)
-	ZEND_ARG_INFO(0, loop)
-ZEND_END_ARG_INFO()
+static void php_uv_loop_clear_microtasks(php_uv_loop_t *loop)
+{
+	while (loop->microtasks_count > 0) {
+		php_uv_microtask_release(&loop->microtasks[loop->microtasks_head]);
+		loop->microtasks_head = (loop->microtasks_head + 1) % loop->microtasks_size;
+		loop->microtasks_count--;
+	}
+	if (loop->microtask_init) {
+		uv_check_stop(&loop->microtask_check);
+		uv_idle_stop(&loop->microtask_idle);
+	}
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_poll_init, 0, 0, 2)
-	ZEND_ARG_INFO(0, loop)
-	ZEND_ARG_INFO(0, fd)
-ZEND_END_ARG_INFO()
+static void php_uv_microtask_dispose(php_uv_internal_t *internal)
+{
+	php_uv_loop_t *loop = PHP_UV_CONTAINER_OF(internal, php_uv_loop_t, microtask_internal);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_poll_start, 0, 0, 3)
-	ZEND_ARG_INFO(0, handle)
-	ZEND_ARG_INFO(0, events)
-	ZEND_ARG_INFO(0, callback)
-ZEND_END_ARG_INFO()
+	if (!uv_is_closing((uv_handle_t *) &loop->microtask_check)) {
+		uv_close((uv_handle_t *) &loop->microtask_check, NULL);
+	}
+	if (!uv_is_closing((uv_handle_t *) &loop->microtask_idle)) {
+		uv_close((uv_handle_t *) &loop->microtask_idle, NULL);
+	}
+}
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_poll_stop, 0, 0, 1)
-	ZEND_ARG_INFO(0, handle)
-ZEND_END_ARG_INFO()
+/* {{{ proto void uv_queue_microtask(UVLoop $uv_loop, callable $callback)
+*/
+PHP_FUNCTION(uv_queue_microtask)
+{
+	php_uv_loop_t *loop = NULL;
+	zend_fcall_info fci = empty_fcall_info;
+	zend_fcall_info_cache fcc = empty_fcall_info_cache;
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_signal_init, 0, 0, 1)
-	ZEND_ARG_INFO(0, loop)
-ZEND_END_ARG_INFO()
+	ZEND_PARSE_PARAMETERS_START(2, 2)
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+		Z_PARAM_FUNC(fci, fcc)
+	ZEND_PARSE_PARAMETERS_END();
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_signal_start, 0, 0, 3)
-	ZEND_ARG_INFO(0, sig_handle)
-	ZEND_ARG_INFO(0, sig_callback)
-	ZEND_ARG_INFO(0, sig_num)
-ZEND_END_ARG_INFO()
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
 
-ZEND_BEGIN_ARG_INFO_EX(arginfo_uv_signal_stop, 0, 0, 1)
-	ZEND_ARG_INFO(0, sig_handle)
-ZEND_END_ARG_INFO()
+	if (!loop->microtask_init) {
+		PHP_UV_INTERNAL_INIT(&loop->microtask_internal, php_uv_microtask_dispose);
+		uv_check_init(&loop->loop, &loop->microtask_check);
+		loop->microtask_check.data = &loop->microtask_internal;
+		uv_unref((uv_handle_t *) &loop->microtask_check);
+		uv_idle_init(&loop->loop, &loop->microtask_idle);
+		loop->microtask_idle.data = &loop->microtask_internal;
+		loop->microtask_init = 1;
+	}
 
-/* PHP Functions */
+	php_uv_microtask_push(loop, &fci, &fcc);
+	php_uv_microtask_start(loop);
+}
+/* }}} */
 
-/* {{{ proto void uv_unref(UV $uv_t)
+/* {{{ proto long uv_timer_wheel_count(UVTimerWheel $wheel)
 */
-PHP_FUNCTION(uv_unref)
+PHP_FUNCTION(uv_timer_wheel_count)
 {
-	php_uv_t *uv;
-//	uv_loop_t *loop;
+	php_uv_timer_wheel_t *wheel;
 
 	ZEND_PARSE_PARAMETERS_START(1, 1)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_ce)
+		UV_PARAM_OBJ(wheel, php_uv_timer_wheel_t, uv_timer_wheel_ce)
 	ZEND_PARSE_PARAMETERS_END();
 
-/*
-	if ((loop = (uv_loop_t *) zend_fetch_resource_ex(handle, NULL, uv_loop_handle))) {
-		uv_unref((uv_handle_t *) loop);
-	} else
+	RETURN_LONG(wheel->count);
+}
+/* }}} */
+
+
+/* {{{ proto resource uv_idle_init([resource $loop])
 */
-	uv_unref(&uv->uv.handle);
+PHP_FUNCTION(uv_idle_init)
+{
+	php_uv_loop_t *loop = NULL;
+	php_uv_t *uv;
+
+	ZEND_PARSE_PARAMETERS_START(0, 1)
+		Z_PARAM_OPTIONAL
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+	PHP_UV_INIT_UV_EX(uv, uv_idle_ce, uv_idle_init);
+
+	RETURN_OBJ(&uv->std);
 }
 /* }}} */
 
-/* {{{ proto string uv_err_name(long $error_code)
+/* {{{ proto void uv_idle_start(resource $idle, callable $callback)
 */
-PHP_FUNCTION(uv_err_name)
+PHP_FUNCTION(uv_idle_start)
 {
-	zend_long error_code;
-	const char *error_msg;
+	php_uv_t *uv;
+	zend_fcall_info fci       = empty_fcall_info;
+	zend_fcall_info_cache fcc = empty_fcall_info_cache;
+	php_uv_cb_t *cb;
+	int r = 0;
 
-	if (zend_parse_parameters(ZEND_NUM_ARGS(),
-		"l", &error_code) == FAILURE) {
-		return;
-	}
+	ZEND_PARSE_PARAMETERS_START(2, 2)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_idle_ce)
+		Z_PARAM_FUNC(fci, fcc)
+	ZEND_PARSE_PARAMETERS_END();
 
-	if (error_code < UV_ERRNO_MAX || error_code > 0) {
-		php_error_docref(NULL, E_NOTICE, "passes unexpected value.");
+	if (uv_is_active(&uv->uv.handle)) {
+		php_error_docref(NULL, E_WARNING, "passed uv_idle resource has already started.");
 		RETURN_FALSE;
 	}
 
-	error_msg = uv_err_name(error_code);
+	GC_REFCOUNT(&uv->std)++;
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_idle_start, uv);
 
-	RETVAL_STRING(error_msg);
+	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_IDLE_CB);
+
+	r = uv_idle_start(&uv->uv.idle, (uv_idle_cb) php_uv_idle_cb);
+
+	RETURN_LONG(r);
 }
 /* }}} */
 
 
-/* {{{ proto string uv_strerror(long $error_code)
+/* {{{ proto void uv_idle_stop(resource $idle)
 */
-PHP_FUNCTION(uv_strerror)
+PHP_FUNCTION(uv_idle_stop)
 {
-	zend_long error_code;
-	const char *error_msg;
+	php_uv_t *uv;
+	int r = 0;
 
-	if (zend_parse_parameters(ZEND_NUM_ARGS(),
-		"l", &error_code) == FAILURE) {
-		return;
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_idle_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (!uv_is_active(&uv->uv.handle)) {
+		php_error_docref(NULL, E_NOTICE, "passed uv_idle resource does not start yet.");
+		RETURN_FALSE;
 	}
 
-	error_msg = php_uv_strerror(error_code);
-	RETVAL_STRING(error_msg);
+	r = uv_idle_stop(&uv->uv.idle);
+
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_idle_stop, uv);
+	OBJ_RELEASE(&uv->std);
+
+	RETURN_LONG(r);
 }
 /* }}} */
 
-/* {{{ proto void uv_update_time([UVLoop $uv_loop])
+
+/* {{{ proto UVAddrinfo uv_getaddrinfo(resource $loop, callable $callback, string $node, string $service, array $hints)
 */
-PHP_FUNCTION(uv_update_time)
+PHP_FUNCTION(uv_getaddrinfo)
 {
-	php_uv_loop_t *loop = NULL;
+	zval *hints = NULL;
+	php_uv_loop_t *loop;
+	php_uv_t *uv = NULL;
+	struct addrinfo hint = {0};
+	zend_string *node, *service;
+	int error;
+	zend_fcall_info fci       = empty_fcall_info;
+	zend_fcall_info_cache fcc = empty_fcall_info_cache;
+	php_uv_cb_t *cb;
 
-	ZEND_PARSE_PARAMETERS_START(0, 1)
+	ZEND_PARSE_PARAMETERS_START(4, 5)
+		UV_PARAM_OBJ(loop, php_uv_loop_t, uv_loop_ce)
+		Z_PARAM_FUNC_EX(fci, fcc, 1, 0)
+		Z_PARAM_STR(node)
+		Z_PARAM_STR(service)
 		Z_PARAM_OPTIONAL
-		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+		Z_PARAM_ARRAY(hints)
 	ZEND_PARSE_PARAMETERS_END();
 
-	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
-	uv_update_time(&loop->loop);
-}
-/* }}} */
+	if (Z_TYPE_P(hints) == IS_ARRAY) {
+		HashTable *h;
+		zval *data;
 
-/* {{{ proto void uv_ref(UV $uv_handle)
-*/
-PHP_FUNCTION(uv_ref)
-{
-	php_uv_t *uv;
-//	uv_loop_t *loop;
+		h = Z_ARRVAL_P(hints);
+		if ((data = zend_hash_str_find(h, ZEND_STRL("ai_family")))) {
+			hint.ai_family = Z_LVAL_P(data);
+		}
+		if ((data = zend_hash_str_find(h, ZEND_STRL("ai_socktype")))) {
+			hint.ai_socktype = Z_LVAL_P(data);
+		}
+		if ((data = zend_hash_str_find(h, ZEND_STRL("ai_protocol")))) {
+			hint.ai_socktype = Z_LVAL_P(data);
+		}
+		if ((data = zend_hash_str_find(h, ZEND_STRL("ai_flags")))) {
+			hint.ai_flags = Z_LVAL_P(data);
+		}
+	}
 
-	ZEND_PARSE_PARAMETERS_START(1, 1)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_ce)
-	ZEND_PARSE_PARAMETERS_END();
+	PHP_UV_INIT_UV(uv, uv_addrinfo_ce);
+
+	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_GETADDR_CB);
+	uv->await_type = PHP_UV_GETADDR_CB;
+
+	error = uv_getaddrinfo(&loop->loop, &uv->uv.addrinfo, php_uv_getaddrinfo_cb, node->val, service->val, &hint);
+	if (error) {
+		PHP_UV_DEINIT_UV(uv);
+		php_error_docref(NULL, E_WARNING, "uv_getaddrinfo failed: %s", php_uv_strerror(error));
+		RETURN_FALSE;
+	}
+
+	if (!ZEND_FCI_INITIALIZED(fci)) {
+		php_uv_promise_attach(uv, return_value);
+		return;
+	}
 
-/*
-	if ((loop = (uv_loop_t *) zend_fetch_resource_ex(handle, NULL, uv_loop_handle))) {
-		uv_ref((uv_handle_t *)loop);
-	} else
-*/
-	uv_ref(&uv->uv.handle);
+	GC_REFCOUNT(&uv->std)++;
+	RETURN_OBJ(&uv->std);
 }
 /* }}} */
 
-/* {{{ proto void uv_run([UVLoop $uv_loop, long $run_mode])
+/* {{{ proto resource uv_tcp_init([resource $loop])
 */
-PHP_FUNCTION(uv_run)
+PHP_FUNCTION(uv_tcp_init)
 {
 	php_uv_loop_t *loop = NULL;
-	zend_long run_mode = UV_RUN_DEFAULT;
+	php_uv_t *uv;
 
-	ZEND_PARSE_PARAMETERS_START(0, 2)
+	ZEND_PARSE_PARAMETERS_START(0, 1)
 		Z_PARAM_OPTIONAL
 		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
-		Z_PARAM_LONG(run_mode)
 	ZEND_PARSE_PARAMETERS_END();
 
 	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
-	uv_run(&loop->loop, run_mode);
+	PHP_UV_INIT_UV_EX(uv, uv_tcp_ce, uv_tcp_init);
+
+	RETURN_OBJ(&uv->std);
 }
 /* }}} */
 
-/* {{{ proto void uv_stop([UVLoop $uv_loop])
+/* {{{ proto int|false uv_tcp_open(resource $handle, long $tcpfd)
 */
-PHP_FUNCTION(uv_stop)
+PHP_FUNCTION(uv_tcp_open)
 {
-	php_uv_loop_t *loop = NULL;
+	php_uv_handle_open((int (*)(uv_handle_t *, long)) uv_tcp_open, uv_tcp_ce, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
 
-	ZEND_PARSE_PARAMETERS_START(0, 1)
-		Z_PARAM_OPTIONAL
-		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
-	ZEND_PARSE_PARAMETERS_END();
+/* {{{ proto resource uv_default_loop()
+*/
+PHP_FUNCTION(uv_default_loop)
+{
+	php_uv_loop_t *loop = php_uv_default_loop();
+	++GC_REFCOUNT(&loop->std);
+	RETURN_OBJ(&loop->std);
+}
+/* }}} */
 
-	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
-	uv_stop(&loop->loop);
+/* {{{ proto resource uv_loop_new()
+*/
+PHP_FUNCTION(uv_loop_new)
+{
+	object_init_ex(return_value, uv_loop_ce);
 }
 /* }}} */
 
-/* {{{ proto resource uv_signal_init([UVLoop $uv_loop])
+
+/* {{{ proto resource uv_udp_init([resource $loop])
 */
-PHP_FUNCTION(uv_signal_init)
+PHP_FUNCTION(uv_udp_init)
 {
 	php_uv_loop_t *loop = NULL;
 	php_uv_t *uv;
@@ -3472,2277 +8678,2578 @@ PHP_FUNCTION(uv_signal_init)
 	ZEND_PARSE_PARAMETERS_END();
 
 	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
-	PHP_UV_INIT_UV_EX(uv, uv_signal_ce, uv_signal_init);
+	PHP_UV_INIT_UV_EX(uv, uv_udp_ce, uv_udp_init);
 
 	RETURN_OBJ(&uv->std);
 }
 /* }}} */
 
-/* {{{ proto void uv_signal_start(UVSignal $sig_handle, callable $sig_callback, int $sig_num)
+/* {{{ proto int|false uv_udp_open(resource $handle, long $udpfd)
 */
-PHP_FUNCTION(uv_signal_start)
+PHP_FUNCTION(uv_udp_open)
+{
+	php_uv_handle_open((int (*)(uv_handle_t *, long)) uv_udp_open, uv_udp_ce, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
+
+/* {{{ proto void uv_udp_bind(resource $resource, resource $address, long $flags)
+*/
+PHP_FUNCTION(uv_udp_bind)
+{
+	php_uv_socket_bind(PHP_UV_UDP_IPV4, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
+
+/* {{{ proto void uv_udp_bind6(resource $resource, resource $address, long $flags)
+*/
+PHP_FUNCTION(uv_udp_bind6)
+{
+	php_uv_socket_bind(PHP_UV_UDP_IPV6, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
+
+/* {{{ proto void uv_udp_recv_start(resource $handle, callable $callback)
+*/
+PHP_FUNCTION(uv_udp_recv_start)
 {
-	zend_long sig_num;
 	php_uv_t *uv;
 	zend_fcall_info fci       = empty_fcall_info;
 	zend_fcall_info_cache fcc = empty_fcall_info_cache;
 	php_uv_cb_t *cb;
+	int r;
 
-	ZEND_PARSE_PARAMETERS_START(3, 3)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_signal_ce)
+	ZEND_PARSE_PARAMETERS_START(2, 2)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_udp_ce)
 		Z_PARAM_FUNC(fci, fcc)
-		Z_PARAM_LONG(sig_num)
 	ZEND_PARSE_PARAMETERS_END();
 
-	if (uv_is_active((uv_handle_t *) &uv->uv.signal)) {
-		php_error_docref(NULL, E_NOTICE, "passed uv signal resource has been started. you don't have to call this method");
+	if (uv_is_active(&uv->uv.handle)) {
+		php_error_docref(NULL, E_WARNING, "passed uv_resource has already activated.");
 		RETURN_FALSE;
 	}
 
 	GC_REFCOUNT(&uv->std)++;
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_signal_start, uv);
-
-	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_SIGNAL_CB);
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_udp_recv_start, uv);
 
-	uv_signal_start((uv_signal_t *) &uv->uv.signal, php_uv_signal_cb, sig_num);
+	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_RECV_CB);
+	r = uv_udp_recv_start(&uv->uv.udp, php_uv_read_alloc, php_uv_udp_recv_cb);
+	if (r) {
+		php_error_docref(NULL, E_NOTICE, "read failed");
+		OBJ_RELEASE(&uv->std);
+	}
 }
 /* }}} */
 
-/* {{{ proto int uv_signal_stop(UVSignal $sig_handle)
+/* {{{ proto void uv_udp_recv_stop(resource $handle)
 */
-PHP_FUNCTION(uv_signal_stop)
+PHP_FUNCTION(uv_udp_recv_stop)
 {
 	php_uv_t *uv;
-	int r = 0;
 
 	ZEND_PARSE_PARAMETERS_START(1, 1)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_signal_ce)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_udp_ce)
 	ZEND_PARSE_PARAMETERS_END();
 
-	if (!uv_is_active((uv_handle_t *) &uv->uv.signal)) {
-		php_error_docref(NULL, E_NOTICE, "passed uv signal resource has been stopped. you don't have to call this method");
+	if (!uv_is_active(&uv->uv.handle)) {
+		php_error_docref(NULL, E_NOTICE, "passed uv_resource has already stopped.");
+		RETURN_FALSE;
+	}
+	if (uv->ext) {
+		php_error_docref(NULL, E_NOTICE, "passed uv_resource is relaying, use uv_udp_relay_stop().");
 		RETURN_FALSE;
 	}
 
-	r = uv_signal_stop((uv_signal_t *) &uv->uv.signal);
+	uv_udp_recv_stop(&uv->uv.udp);
 
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_signal_stop, uv);
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_udp_recv_stop, uv);
 	OBJ_RELEASE(&uv->std);
-
-	RETURN_LONG(r);
-}
-/* }}} */
-
-/* {{{ proto void uv_loop_delete(UVLoop $uv_loop)
-*/
-PHP_FUNCTION(uv_loop_delete)
-{
-	php_uv_loop_t *loop;
-
-	ZEND_PARSE_PARAMETERS_START(1, 1)
-		UV_PARAM_OBJ(loop, php_uv_loop_t, uv_loop_ce)
-	ZEND_PARSE_PARAMETERS_END();
-
-	if (loop != UV_G(default_loop)) {
-		GC_FLAGS(&loop->std) |= IS_OBJ_DESTRUCTOR_CALLED;
-		destruct_uv_loop(&loop->std);
-	}
 }
 /* }}} */
 
-/* {{{ proto long uv_now([UVLoop $uv_loop])
+/* {{{ proto long uv_udp_set_membership(resource $handle, string $multicast_addr, string $interface_addr, long $membership)
 */
-PHP_FUNCTION(uv_now)
+PHP_FUNCTION(uv_udp_set_membership)
 {
-	php_uv_loop_t *loop = NULL;
-	int64_t now;
+	php_uv_t *uv;
+	zend_string *multicast_addr, *interface_addr;
+	int error;
+	zend_long membership;
 
-	ZEND_PARSE_PARAMETERS_START(0, 1)
-		Z_PARAM_OPTIONAL
-		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+	ZEND_PARSE_PARAMETERS_START(4, 4)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_udp_ce)
+		Z_PARAM_STR(multicast_addr)
+		Z_PARAM_STR(interface_addr)
+		Z_PARAM_LONG(membership)
 	ZEND_PARSE_PARAMETERS_END();
 
-	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
-	now = uv_now(&loop->loop);
-	RETURN_LONG((long)now);
-}
-/* }}} */
-
-
-/* {{{ proto void uv_tcp_bind(resource $uv_tcp, resource $uv_sockaddr)
-*/
-PHP_FUNCTION(uv_tcp_bind)
-{
-	php_uv_socket_bind(PHP_UV_TCP_IPV4, INTERNAL_FUNCTION_PARAM_PASSTHRU);
-}
-/* }}} */
+	error = uv_udp_set_membership(&uv->uv.udp, (const char *) multicast_addr->val, (const char *) interface_addr->val, membership);
 
-/* {{{ proto void uv_tcp_bind6(resource $uv_tcp, resource $uv_sockaddr)
-*/
-PHP_FUNCTION(uv_tcp_bind6)
-{
-	php_uv_socket_bind(PHP_UV_TCP_IPV6, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	RETURN_LONG(error);
 }
 /* }}} */
 
 
-/* {{{ proto void uv_write(resource $handle, string $data, callable $callback)
+/* {{{ proto void uv_udp_set_multicast_loop(resource $handle, long $enabled)
 */
-PHP_FUNCTION(uv_write)
+PHP_FUNCTION(uv_udp_set_multicast_loop)
 {
-	zend_string *data;
-	int r;
 	php_uv_t *uv;
-	write_req_t *w;
-	zend_fcall_info fci       = empty_fcall_info;
-	zend_fcall_info_cache fcc = empty_fcall_info_cache;
-	php_uv_cb_t *cb;
+	zend_long enabled = 0;
+	int r;
 
-	ZEND_PARSE_PARAMETERS_START(2, 3)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_tcp_ce, uv_pipe_ce, uv_tty_ce)
-		Z_PARAM_STR(data)
-		Z_PARAM_OPTIONAL
-		Z_PARAM_FUNC_EX(fci, fcc, 1, 0)
+	ZEND_PARSE_PARAMETERS_START(2, 2)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_udp_ce)
+		Z_PARAM_LONG(enabled)
 	ZEND_PARSE_PARAMETERS_END();
 
-	cb = php_uv_cb_init_dynamic(uv, &fci, &fcc);
-	PHP_UV_INIT_WRITE_REQ(w, uv, data->val, data->len, cb)
-
-	r = uv_write(&w->req, &uv->uv.stream, &w->buf, 1, php_uv_write_cb);
+	r = uv_udp_set_multicast_loop((uv_udp_t*)&uv->uv.udp, enabled);
 	if (r) {
-		php_uv_free_write_req(w);
-		php_error_docref(NULL, E_WARNING, "write failed");
-	} else {
-		GC_REFCOUNT(&uv->std)++;
-		PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_write, uv);
+		php_error_docref(NULL, E_NOTICE, "uv_udp_set_muticast_loop failed");
 	}
 }
 /* }}} */
 
-/* {{{ proto void uv_write2(resource $handle, string $data, resource $send, callable $callback)
+/* {{{ proto void uv_udp_set_multicast_ttl(resource $handle, long $ttl)
 */
-PHP_FUNCTION(uv_write2)
+PHP_FUNCTION(uv_udp_set_multicast_ttl)
 {
-	zend_string *data;
+	php_uv_t *uv;
+	zend_long ttl = 0; /* 1 through 255 */
 	int r;
-	php_uv_t *uv, *send;
-	write_req_t *w;
-	zend_fcall_info fci       = empty_fcall_info;
-	zend_fcall_info_cache fcc = empty_fcall_info_cache;
-	php_uv_cb_t *cb;
 
-	ZEND_PARSE_PARAMETERS_START(4, 4)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_tcp_ce, uv_pipe_ce, uv_tty_ce)
-		Z_PARAM_STR(data)
-		UV_PARAM_OBJ(send, php_uv_t, uv_ce)
-		Z_PARAM_FUNC(fci, fcc)
+	ZEND_PARSE_PARAMETERS_START(2, 2)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_udp_ce)
+		Z_PARAM_LONG(ttl)
 	ZEND_PARSE_PARAMETERS_END();
 
-	cb = php_uv_cb_init_dynamic(uv, &fci, &fcc);
-	PHP_UV_INIT_WRITE_REQ(w, uv, data->val, data->len, cb);
+	if (ttl > 255) {
+		php_error_docref(NULL, E_NOTICE, "uv_udp_set_muticast_ttl: ttl parameter expected smaller than 255.");
+		ttl = 255;
+	} else if (ttl < 1) {
+		php_error_docref(NULL, E_NOTICE, "uv_udp_set_muticast_ttl: ttl parameter expected larger than 0.");
+		ttl = 1;
+	}
 
-	r = uv_write2(&w->req, &uv->uv.stream, &w->buf, 1, &send->uv.stream, php_uv_write_cb);
+	r = uv_udp_set_multicast_ttl(&uv->uv.udp, ttl);
 	if (r) {
-		php_uv_free_write_req(w);
-		php_error_docref(NULL, E_ERROR, "write2 failed");
-	} else {
-		GC_REFCOUNT(&uv->std)++;
-		PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_write2, uv);
+		php_error_docref(NULL, E_NOTICE, "uv_udp_set_muticast_ttl failed");
 	}
 }
 /* }}} */
 
-/* {{{ proto void uv_tcp_nodelay(resource $handle, bool $enable)
+/* {{{ proto void uv_udp_set_broadcast(resource $handle, bool $enabled)
 */
-PHP_FUNCTION(uv_tcp_nodelay)
-{
-	php_uv_t *client;
-	zend_bool bval = 1;
+PHP_FUNCTION(uv_udp_set_broadcast)
+{
+	php_uv_t *uv;
+	zend_long enabled = 0;
+	int r;
 
 	ZEND_PARSE_PARAMETERS_START(2, 2)
-		UV_PARAM_OBJ(client, php_uv_t, uv_tcp_ce)
-		Z_PARAM_BOOL(bval)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_udp_ce)
+		Z_PARAM_LONG(enabled)
 	ZEND_PARSE_PARAMETERS_END();
 
-	uv_tcp_nodelay(&client->uv.tcp, bval);
+	r = uv_udp_set_broadcast(&uv->uv.udp, enabled);
+	if (r) {
+		php_error_docref(NULL, E_NOTICE, "uv_udp_set_muticast_loop failed");
+	}
 }
 /* }}} */
 
-/* {{{ proto void uv_accept(resource $server, resource $client)
+/* {{{ proto bool uv_udp_set_segment_size(UVUdp $handle, long $size)
 */
-PHP_FUNCTION(uv_accept)
+PHP_FUNCTION(uv_udp_set_segment_size)
 {
-	php_uv_t *server, *client;
-	int r;
+	php_uv_t *uv;
+	zend_long size = 0;
 
 	ZEND_PARSE_PARAMETERS_START(2, 2)
-		UV_PARAM_OBJ(server, php_uv_t, uv_tcp_ce, uv_pipe_ce)
-		UV_PARAM_OBJ(client, php_uv_t, uv_tcp_ce, uv_pipe_ce)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_udp_ce)
+		Z_PARAM_LONG(size)
 	ZEND_PARSE_PARAMETERS_END();
 
-	if (server->std.ce != client->std.ce) {
-		php_error_docref(NULL, E_WARNING, ".");
-		zend_internal_type_error(ZEND_ARG_USES_STRICT_TYPES(), "%s expects server and client parameters to be either both of type UVTcp or both of type UVPipe", get_active_function_name());
-		return;
+	if (size < 0 || size > PHP_UV_UDP_MAX_PAYLOAD) {
+		php_error_docref(NULL, E_WARNING, "segment size must be between 0 and %d", PHP_UV_UDP_MAX_PAYLOAD);
+		RETURN_FALSE;
 	}
 
-	r = uv_accept(&server->uv.stream, &client->uv.stream);
-	if (r) {
-		php_error_docref(NULL, E_WARNING, "%s", php_uv_strerror(r));
-		RETURN_FALSE;
+#if defined(__linux__)
+	{
+		uv_os_fd_t fd;
+		int gso = (int) size;
+
+		/* the socket only exists once the handle is bound; until then php-uv splits the data itself */
+		if (uv_fileno(&uv->uv.handle, &fd) == 0 && setsockopt(fd, SOL_UDP, UDP_SEGMENT, &gso, sizeof(gso)) == 0) {
+			uv->gso_size = gso;
+			RETURN_BOOL(gso > 0);
+		}
 	}
+#endif
+
+	uv->gso_size = (int) -size;
+	RETURN_FALSE;
 }
 /* }}} */
 
+/* {{{ proto void uv_udp_send(resource $handle, string $data, resource $uv_addr, callable $callback)
+*/
+PHP_FUNCTION(uv_udp_send)
+{
+	php_uv_udp_send(1, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
 
-/* {{{ proto void uv_shutdown(resource $handle, callable $callback)
+/* {{{ proto void uv_udp_send6(resource $handle, string $data, resource $uv_addr6, callable $callback)
 */
-PHP_FUNCTION(uv_shutdown)
+PHP_FUNCTION(uv_udp_send6)
+{
+	php_uv_udp_send(2, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
+
+/* {{{ proto bool uv_udp_relay_start(UVUdp $listener, array $upstreams[, long $mode = UV::RELAY_ROUND_ROBIN[, long $idle_timeout = 30000[, callable $callback]]])
+*/
+PHP_FUNCTION(uv_udp_relay_start)
 {
 	php_uv_t *uv;
-	uv_shutdown_t *shutdown;
+	zval *upstreams, *entry;
+	zend_long mode = PHP_UV_RELAY_ROUND_ROBIN, idle_timeout = 30000, max_sessions = 512;
 	zend_fcall_info fci       = empty_fcall_info;
 	zend_fcall_info_cache fcc = empty_fcall_info_cache;
 	php_uv_cb_t *cb;
-	int r = 0;
+	php_uv_udp_relay_t *relay;
+	int i = 0, r;
 
-	ZEND_PARSE_PARAMETERS_START(1, 2)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_ce)
+	ZEND_PARSE_PARAMETERS_START(2, 6)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_udp_ce)
+		Z_PARAM_ARRAY(upstreams)
 		Z_PARAM_OPTIONAL
+		Z_PARAM_LONG(mode)
+		Z_PARAM_LONG(idle_timeout)
 		Z_PARAM_FUNC_EX(fci, fcc, 1, 0)
+		Z_PARAM_LONG(max_sessions)
 	ZEND_PARSE_PARAMETERS_END();
 
-	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_SHUTDOWN_CB);
+	if (uv->ext || uv_is_active(&uv->uv.handle)) {
+		php_error_docref(NULL, E_WARNING, "passed uv_resource has already activated.");
+		RETURN_FALSE;
+	}
+	if (zend_hash_num_elements(Z_ARRVAL_P(upstreams)) == 0) {
+		php_error_docref(NULL, E_WARNING, "at least one upstream address is required");
+		RETURN_FALSE;
+	}
+	if (mode != PHP_UV_RELAY_ROUND_ROBIN && mode != PHP_UV_RELAY_SOURCE_HASH) {
+		php_error_docref(NULL, E_WARNING, "mode must be UV::RELAY_ROUND_ROBIN or UV::RELAY_SOURCE_HASH");
+		RETURN_FALSE;
+	}
+	if (idle_timeout < 0) {
+		php_error_docref(NULL, E_WARNING, "idle timeout must not be negative");
+		RETURN_FALSE;
+	}
+	if (max_sessions < 0 || max_sessions > UINT32_MAX) {
+		php_error_docref(NULL, E_WARNING, "max_sessions must be between 0 and %u", UINT32_MAX);
+		RETURN_FALSE;
+	}
 
-	GC_REFCOUNT(&uv->std)++;
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_shutdown, uv);
-	shutdown = emalloc(sizeof(uv_shutdown_t));
-	shutdown->data = uv;
+	relay = emalloc(sizeof(php_uv_udp_relay_t));
+	relay->upstreams = safe_emalloc(zend_hash_num_elements(Z_ARRVAL_P(upstreams)), sizeof(struct sockaddr_storage), 0);
 
-	r = uv_shutdown(shutdown, &uv->uv.stream, (uv_shutdown_cb)php_uv_shutdown_cb);
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(upstreams), entry) {
+		php_uv_sockaddr_t *addr;
+
+		ZVAL_DEREF(entry);
+		if (Z_TYPE_P(entry) != IS_OBJECT || !instanceof_function(Z_OBJCE_P(entry), uv_sockaddr_ce)) {
+			php_error_docref(NULL, E_WARNING, "upstreams must be UVSockAddr objects");
+			efree(relay->upstreams);
+			efree(relay);
+			RETURN_FALSE;
+		}
+
+		addr = (php_uv_sockaddr_t *) Z_OBJ_P(entry);
+		if (PHP_UV_SOCKADDR_IS_IPV4(addr)) {
+			memcpy(&relay->upstreams[i++], PHP_UV_SOCKADDR_IPV4_P(addr), sizeof(struct sockaddr_in));
+		} else {
+			memcpy(&relay->upstreams[i++], PHP_UV_SOCKADDR_IPV6_P(addr), sizeof(struct sockaddr_in6));
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	PHP_UV_INTERNAL_INIT(&relay->internal, php_uv_udp_relay_dispose);
+	relay->listener = uv;
+	relay->upstream_count = i;
+	relay->mode = (int) mode;
+	relay->next = 0;
+	relay->idle_timeout = (uint64_t) idle_timeout;
+	relay->max_sessions = (uint32_t) max_sessions;
+	relay->handles = 1;
+	relay->stopped = 0;
+	relay->forwarded = 0;
+	relay->replied = 0;
+	relay->dropped = 0;
+	zend_hash_init(&relay->sessions, 16, NULL, NULL, 0);
+
+	uv_timer_init(uv->uv.udp.loop, &relay->timer);
+	relay->timer.data = &relay->internal;
+	uv_unref((uv_handle_t *) &relay->timer);
+
+	uv->ext = relay;
+	r = uv_udp_recv_start(&uv->uv.udp, php_uv_udp_relay_alloc, php_uv_udp_relay_recv_cb);
 	if (r) {
-		php_error_docref(NULL, E_WARNING, "%s", php_uv_strerror(r));
-		efree(&shutdown);
+		php_error_docref(NULL, E_WARNING, "uv_udp_relay_start failed: %s", php_uv_strerror(r));
+		php_uv_udp_relay_stop(relay, 1);
+		RETURN_FALSE;
+	}
+
+	GC_REFCOUNT(&uv->std)++;
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_udp_relay_start, uv);
+
+	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_RECV_CB);
+
+	if (idle_timeout > 0) {
+		uint64_t sweep = MAX(idle_timeout / 2, 10);
+		uv_timer_start(&relay->timer, php_uv_udp_relay_timer_cb, sweep, sweep);
 	}
 
+	RETURN_TRUE;
 }
 /* }}} */
 
-/* {{{ proto void uv_close(resource $handle, callable $callback)
+/* {{{ proto bool uv_udp_relay_stop(UVUdp $listener)
 */
-PHP_FUNCTION(uv_close)
+PHP_FUNCTION(uv_udp_relay_stop)
 {
 	php_uv_t *uv;
-	zend_fcall_info fci       = empty_fcall_info;
-	zend_fcall_info_cache fcc = empty_fcall_info_cache;
-	php_uv_cb_t *cb;
 
-	ZEND_PARSE_PARAMETERS_START(1, 2)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_ce)
-		Z_PARAM_OPTIONAL
-		Z_PARAM_FUNC_EX(fci, fcc, 1, 0)
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_udp_ce)
 	ZEND_PARSE_PARAMETERS_END();
 
-	if (!php_uv_closeable_type(uv)) {
-		php_error_docref(NULL, E_WARNING, "passed UV handle (%s) is not closeable", ZSTR_VAL(uv->std.ce->name));
+	if (uv->ext == NULL) {
+		php_error_docref(NULL, E_NOTICE, "passed uv_resource has no relay running.");
 		RETURN_FALSE;
 	}
 
-	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_CLOSE_CB);
+	php_uv_udp_relay_stop(uv->ext, 0);
 
-	php_uv_close(uv);
+	RETURN_TRUE;
 }
 /* }}} */
 
-/* {{{ proto void uv_read_start(resource $handle, callable $callback)
+/* {{{ proto array uv_udp_relay_info(UVUdp $listener)
 */
-PHP_FUNCTION(uv_read_start)
+PHP_FUNCTION(uv_udp_relay_info)
 {
 	php_uv_t *uv;
-	zend_fcall_info fci       = empty_fcall_info;
-	zend_fcall_info_cache fcc = empty_fcall_info_cache;
-	php_uv_cb_t *cb;
-	int r;
-	uv_os_fd_t fd;
+	php_uv_udp_relay_t *relay;
 
-	PHP_UV_DEBUG_PRINT("uv_read_start\n");
-
-	ZEND_PARSE_PARAMETERS_START(2, 2)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_tcp_ce, uv_pipe_ce, uv_tty_ce)
-		Z_PARAM_FUNC(fci, fcc)
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_udp_ce)
 	ZEND_PARSE_PARAMETERS_END();
 
-	if (uv_fileno(&uv->uv.handle, &fd) != 0) {
-		php_error_docref(NULL, E_WARNING, "passed UV handle is not initialized yet");
-		return;
+	if (uv->ext == NULL) {
+		RETURN_FALSE;
 	}
+	relay = uv->ext;
 
-	GC_REFCOUNT(&uv->std)++;
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_read_start, uv);
-
-	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_READ_CB);
-
-	r = uv_read_start(&uv->uv.stream, php_uv_read_alloc, php_uv_read_cb);
-	if (r) {
-		php_error_docref(NULL, E_NOTICE, "read failed");
-		OBJ_RELEASE(&uv->std);
-	}
+	array_init(return_value);
+	add_assoc_long_ex(return_value, ZEND_STRL("sessions"), zend_hash_num_elements(&relay->sessions));
+	add_assoc_long_ex(return_value, ZEND_STRL("forwarded"), relay->forwarded);
+	add_assoc_long_ex(return_value, ZEND_STRL("replied"), relay->replied);
+	add_assoc_long_ex(return_value, ZEND_STRL("dropped"), relay->dropped);
 }
 /* }}} */
 
-/* {{{ proto void uv_read2_start(resource $handle, callable $callback)
+/* {{{ proto bool uv_is_active(UV $handle)
 */
-PHP_FUNCTION(uv_read2_start)
+PHP_FUNCTION(uv_is_active)
 {
-	/* TODO: determine how to make this backwards compatible? */
-	php_error_docref(NULL, E_ERROR, "uv_read2_start is no longer supported.");
-	/*
+	zval *zv;
 	php_uv_t *uv;
-	int r;
-	zend_fcall_info fci       = empty_fcall_info;
-	zend_fcall_info_cache fcc = empty_fcall_info_cache;
-	php_uv_cb_t *cb;
-
-	PHP_UV_DEBUG_PRINT("uv_read2_start\n");
 
-	ZEND_PARSE_PARAMETERS_START(2, 2)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_tcp_ce, uv_pipe_ce, uv_tty_ce)
-		Z_PARAM_FUNC(fci, fcc)
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		Z_PARAM_OBJECT_OF_CLASS(zv, uv_ce)
 	ZEND_PARSE_PARAMETERS_END();
 
-	GC_REFCOUNT(&uv->std)++;
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_read2_start, uv);
+	uv = (php_uv_t *) Z_OBJ_P(zv);
 
-	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_READ2_CB);
-	r = uv_read2_start(&uv->uv.stream, php_uv_read_alloc, php_uv_read2_cb);
-	if (r) {
-		php_error_docref(NULL, E_NOTICE, "read2 failed");
-		OBJ_RELEASE(&uv->std);
-	}
-	*/
+	RETURN_BOOL(!PHP_UV_IS_DTORED(uv) && uv_is_active(&uv->uv.handle));
 }
 /* }}} */
 
-/* {{{ proto void uv_read_stop(resource $handle)
+/* {{{ proto bool uv_is_closing(UV $handle)
 */
-PHP_FUNCTION(uv_read_stop)
+PHP_FUNCTION(uv_is_closing)
 {
+	zval *zv;
 	php_uv_t *uv;
 
 	ZEND_PARSE_PARAMETERS_START(1, 1)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_tcp_ce, uv_pipe_ce, uv_tty_ce)
+		Z_PARAM_OBJECT_OF_CLASS(zv, uv_ce)
 	ZEND_PARSE_PARAMETERS_END();
 
-	if (!uv_is_active(&uv->uv.handle)) {
-		return;
-	}
-
-	uv_read_stop(&uv->uv.stream);
+	uv = (php_uv_t *) Z_OBJ_P(zv);
 
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_read_stop, uv);
-	OBJ_RELEASE(&uv->std);
+	RETURN_BOOL(PHP_UV_IS_DTORED(uv));
 }
 /* }}} */
 
-/* {{{ proto resource uv_ip4_addr(string $ipv4_addr, long $port)
+/* {{{ proto bool uv_is_readable(resource $handle)
 */
-PHP_FUNCTION(uv_ip4_addr)
+PHP_FUNCTION(uv_is_readable)
 {
-	zend_string *address;
-	zend_long port = 0;
-	php_uv_sockaddr_t *sockaddr;
-
-	if (zend_parse_parameters(ZEND_NUM_ARGS(),
-		"Sl", &address, &port) == FAILURE) {
-		return;
-	}
+	php_uv_t *uv;
 
-	PHP_UV_SOCKADDR_IPV4_INIT(sockaddr);
-	uv_ip4_addr(address->val, port, &PHP_UV_SOCKADDR_IPV4(sockaddr));
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_ce)
+	ZEND_PARSE_PARAMETERS_END();
 
-	RETURN_OBJ(&sockaddr->std);
+	RETURN_BOOL(uv_is_readable(&uv->uv.stream));
 }
 /* }}} */
 
-/* {{{ proto resource uv_ip6_addr(string $ipv6_addr, long $port)
+/* {{{ proto bool uv_is_writable(resource $handle)
 */
-PHP_FUNCTION(uv_ip6_addr)
+PHP_FUNCTION(uv_is_writable)
 {
-	zend_string *address;
-	zend_long port = 0;
-	php_uv_sockaddr_t *sockaddr;
-
-	if (zend_parse_parameters(ZEND_NUM_ARGS(),
-		"Sl", &address, &port) == FAILURE) {
-		return;
-	}
+	php_uv_t *uv;
 
-	PHP_UV_SOCKADDR_IPV6_INIT(sockaddr);
-	uv_ip6_addr(address->val, port, &PHP_UV_SOCKADDR_IPV6(sockaddr));
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_ce)
+	ZEND_PARSE_PARAMETERS_END();
 
-	RETURN_OBJ(&sockaddr->std);
+	RETURN_BOOL(uv_is_writable(&uv->uv.stream));
 }
 /* }}} */
 
 
-/* {{{ proto void uv_listen(resource $handle, long $backlog, callable $callback)
+/* {{{ proto bool uv_walk(resource $loop, callable $closure[, array $opaque])
 */
-PHP_FUNCTION(uv_listen)
+PHP_FUNCTION(uv_walk)
 {
-	zend_long backlog = SOMAXCONN;
-	php_uv_t *uv;
+	zval *opaque = NULL;
+	php_uv_loop_t *loop;
 	zend_fcall_info fci       = empty_fcall_info;
 	zend_fcall_info_cache fcc = empty_fcall_info_cache;
-	php_uv_cb_t *cb;
-	int r;
+	//php_uv_cb_t *cb;
 
-	ZEND_PARSE_PARAMETERS_START(3, 3)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_tcp_ce, uv_pipe_ce)
-		Z_PARAM_LONG(backlog)
+	ZEND_PARSE_PARAMETERS_START(2, 3)
+		UV_PARAM_OBJ(loop, php_uv_loop_t, uv_loop_ce)
 		Z_PARAM_FUNC(fci, fcc)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_ARRAY(opaque)
 	ZEND_PARSE_PARAMETERS_END();
 
-	GC_REFCOUNT(&uv->std)++;
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_listen, uv);
-	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_LISTEN_CB);
-
-	r = uv_listen(&uv->uv.stream, backlog, php_uv_listen_cb);
-	if (r) {
-		php_error_docref(NULL, E_WARNING, "%s", php_uv_strerror(r));
-		OBJ_RELEASE(&uv->std);
-	}
-}
-/* }}} */
+	php_error_docref(NULL, E_ERROR, "uv_walk not yet supported");
 
-/* {{{ proto void uv_tcp_connect(resource $handle, resource $ipv4_addr, callable $callback)
-*/
-PHP_FUNCTION(uv_tcp_connect)
-{
-	php_uv_tcp_connect(PHP_UV_TCP_IPV4, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+	uv_walk(&loop->loop, php_uv_walk_cb, NULL);
 }
 /* }}} */
 
-
-/* {{{ proto void uv_tcp_connect6(resource $handle, resource $ipv6_addr, callable $callback)
+/* {{{ proto long uv_guess_handle(resource $uv)
 */
-PHP_FUNCTION(uv_tcp_connect6)
+PHP_FUNCTION(uv_guess_handle)
 {
-	php_uv_tcp_connect(PHP_UV_TCP_IPV6, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	zval *handle;
+	long fd = -1;
+	uv_handle_type type;
+
+	if (zend_parse_parameters(ZEND_NUM_ARGS(),
+		"r", &handle) == FAILURE) {
+		return;
+	}
+
+	fd = php_uv_zval_to_fd(handle);
+	if (fd < 0) {
+		php_error_docref(NULL, E_WARNING, "invalid variable passed. can't convert to fd.");
+		return;
+	}
+	type = uv_guess_handle(fd);
+
+	RETURN_LONG(type);
 }
 /* }}} */
 
 
-/* {{{ proto resource uv_timer_init([resource $loop])
+/* {{{ proto resource uv_pipe_init([resource $loop, long $ipc])
 */
-PHP_FUNCTION(uv_timer_init)
+PHP_FUNCTION(uv_pipe_init)
 {
-	php_uv_loop_t *loop = NULL;
 	php_uv_t *uv;
+	php_uv_loop_t *loop = NULL;
+	zend_bool ipc = 0;
 
-	ZEND_PARSE_PARAMETERS_START(0, 1)
+	ZEND_PARSE_PARAMETERS_START(0, 2)
 		Z_PARAM_OPTIONAL
 		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+		Z_PARAM_BOOL(ipc)
 	ZEND_PARSE_PARAMETERS_END();
 
 	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
-	PHP_UV_INIT_UV_EX(uv, uv_timer_ce, uv_timer_init);
 
-	PHP_UV_DEBUG_PRINT("uv_timer_init: resource: %p\n", uv);
+	PHP_UV_INIT_UV_EX(uv, uv_pipe_ce, uv_pipe_init, (int) ipc);
 
 	RETURN_OBJ(&uv->std);
 }
 /* }}} */
 
-/* {{{ proto void uv_timer_start(resource $timer, long $timeout, long $repeat, callable $callback)
+/* {{{ proto int|false uv_pipe_open(resource $handle, long $pipe)
 */
-PHP_FUNCTION(uv_timer_start)
+PHP_FUNCTION(uv_pipe_open)
 {
-	php_uv_t *uv;
-	zend_long timeout, repeat = 0;
-	zend_fcall_info fci       = empty_fcall_info;
-	zend_fcall_info_cache fcc = empty_fcall_info_cache;
-	php_uv_cb_t *cb;
-
-	ZEND_PARSE_PARAMETERS_START(3, 4)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_timer_ce)
-		Z_PARAM_LONG(timeout)
-		Z_PARAM_LONG(repeat)
-		Z_PARAM_OPTIONAL
-		Z_PARAM_FUNC_EX(fci, fcc, 1, 0)
-	ZEND_PARSE_PARAMETERS_END();
-
-	if (timeout < 0) {
-		php_error_docref(NULL, E_WARNING, "timeout value have to be larger than 0. given %ld", timeout);
-		RETURN_FALSE;
-	}
-
-	if (repeat < 0) {
-		php_error_docref(NULL, E_WARNING, "repeat value have to be larger than 0. given %ld", repeat);
-		RETURN_FALSE;
-	}
-
-	if (uv_is_active(&uv->uv.handle)) {
-		php_error_docref(NULL, E_NOTICE, "passed uv timer resource has been started. you don't have to call this method");
-		RETURN_FALSE;
-	}
-
-	GC_REFCOUNT(&uv->std)++;
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_timer_start, uv);
-	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_TIMER_CB);
-
-	uv_timer_start((uv_timer_t*)&uv->uv.timer, php_uv_timer_cb, timeout, repeat);
+	php_uv_handle_open((int (*)(uv_handle_t *, long)) uv_pipe_open, uv_pipe_ce, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_timer_stop(resource $timer)
+/* {{{ proto long uv_pipe_bind(resource $handle, string $name)
 */
-PHP_FUNCTION(uv_timer_stop)
+PHP_FUNCTION(uv_pipe_bind)
 {
 	php_uv_t *uv;
-	int r = 0;
+	zend_string *name;
+	int error;
 
-	ZEND_PARSE_PARAMETERS_START(1, 1)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_timer_ce)
+	ZEND_PARSE_PARAMETERS_START(2, 2)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_pipe_ce)
+		Z_PARAM_STR(name)
 	ZEND_PARSE_PARAMETERS_END();
 
-	if (!uv_is_active(&uv->uv.handle)) {
-		php_error_docref(NULL, E_NOTICE, "passed uv timer resource has been stopped. you don't have to call this method");
-		RETURN_FALSE;
+	error = uv_pipe_bind(&uv->uv.pipe, name->val);
+	if (error) {
+		php_error_docref(NULL, E_WARNING, "%s", php_uv_strerror(error));
 	}
 
-	PHP_UV_DEBUG_PRINT("uv_timer_stop: resource: %p\n", uv);
-	r = uv_timer_stop(&uv->uv.timer);
-
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_timer_stop, uv);
-	OBJ_RELEASE(&uv->std);
-
-	RETURN_LONG(r);
+	RETURN_LONG(error);
 }
 /* }}} */
 
-/* {{{ proto void uv_timer_again(resource $timer)
+/* {{{ proto UVPromise uv_pipe_connect(resource $handle, string $path[, callable $callback])
 */
-PHP_FUNCTION(uv_timer_again)
+PHP_FUNCTION(uv_pipe_connect)
 {
 	php_uv_t *uv;
+	zend_string *name;
+	uv_connect_t *req;
+	zend_fcall_info fci       = empty_fcall_info;
+	zend_fcall_info_cache fcc = empty_fcall_info_cache;
+	php_uv_cb_t *cb;
 
-	ZEND_PARSE_PARAMETERS_START(1, 1)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_timer_ce)
+	ZEND_PARSE_PARAMETERS_START(2, 3)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_pipe_ce)
+		Z_PARAM_STR(name)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_FUNC_EX(fci, fcc, 1, 0)
 	ZEND_PARSE_PARAMETERS_END();
 
-	if (uv_is_active(&uv->uv.handle)) {
-		php_error_docref(NULL, E_NOTICE, "passed uv timer resource has been started. you don't have to call this method");
-		RETURN_FALSE;
-	}
-
 	GC_REFCOUNT(&uv->std)++;
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_timer_again, uv);
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_pipe_connect, uv);
 
-	uv_timer_again(&uv->uv.timer);
+	req = (uv_connect_t *) emalloc(sizeof(uv_connect_t));
+	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_PIPE_CONNECT_CB);
+	uv->await_type = PHP_UV_PIPE_CONNECT_CB;
+	if (!ZEND_FCI_INITIALIZED(fci)) {
+		php_uv_promise_attach(uv, return_value);
+	}
+
+	req->data = uv;
+	uv_pipe_connect(req, &uv->uv.pipe, name->val, php_uv_pipe_connect_cb);
 }
 /* }}} */
 
-/* {{{ proto void uv_timer_set_repeat(resource $timer, long $repeat)
+/* {{{ proto void uv_pipe_pending_instances(resource $handle, long $count)
 */
-PHP_FUNCTION(uv_timer_set_repeat)
+PHP_FUNCTION(uv_pipe_pending_instances)
 {
 	php_uv_t *uv;
-	zend_long repeat;
+	zend_long count;
 
 	ZEND_PARSE_PARAMETERS_START(2, 2)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_timer_ce)
-		Z_PARAM_LONG(repeat)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_pipe_ce)
+		Z_PARAM_LONG(count)
 	ZEND_PARSE_PARAMETERS_END();
 
-	uv_timer_set_repeat(&uv->uv.timer, repeat);
+	uv_pipe_pending_instances(&uv->uv.pipe, count);
 }
 /* }}} */
 
-/* {{{ proto long uv_timer_get_repeat(resource $timer)
+/* {{{ proto void uv_pipe_pending_count(resource $handle)
 */
-PHP_FUNCTION(uv_timer_get_repeat)
+PHP_FUNCTION(uv_pipe_pending_count)
 {
 	php_uv_t *uv;
-	int64_t repeat;
 
 	ZEND_PARSE_PARAMETERS_START(1, 1)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_timer_ce)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_pipe_ce)
 	ZEND_PARSE_PARAMETERS_END();
 
-	repeat = uv_timer_get_repeat(&uv->uv.timer);
-	RETURN_LONG(repeat);
+	RETURN_LONG(uv_pipe_pending_count(&uv->uv.pipe));
 }
 /* }}} */
 
-
-/* {{{ proto resource uv_idle_init([resource $loop])
+/* {{{ proto void uv_pipe_pending_type(resource $handle)
 */
-PHP_FUNCTION(uv_idle_init)
+PHP_FUNCTION(uv_pipe_pending_type)
 {
-	php_uv_loop_t *loop = NULL;
 	php_uv_t *uv;
+	uv_handle_type ret;
 
-	ZEND_PARSE_PARAMETERS_START(0, 1)
-		Z_PARAM_OPTIONAL
-		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_pipe_ce)
 	ZEND_PARSE_PARAMETERS_END();
 
-	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
-	PHP_UV_INIT_UV_EX(uv, uv_idle_ce, uv_idle_init);
-
-	RETURN_OBJ(&uv->std);
+	ret = uv_pipe_pending_type(&uv->uv.pipe);
+	RETURN_LONG(ret);
 }
 /* }}} */
 
-/* {{{ proto void uv_idle_start(resource $idle, callable $callback)
+/* {{{ proto void uv_stdio_new(zval $fd, long $flags)
 */
-PHP_FUNCTION(uv_idle_start)
+PHP_FUNCTION(uv_stdio_new)
 {
-	php_uv_t *uv;
-	zend_fcall_info fci       = empty_fcall_info;
-	zend_fcall_info_cache fcc = empty_fcall_info_cache;
-	php_uv_cb_t *cb;
-	int r = 0;
-
-	ZEND_PARSE_PARAMETERS_START(2, 2)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_idle_ce)
-		Z_PARAM_FUNC(fci, fcc)
-	ZEND_PARSE_PARAMETERS_END();
+	php_uv_stdio_t *stdio;
+	zval *handle;
+	zend_long flags = 0;
+#if !defined(PHP_WIN32) || defined(HAVE_SOCKET)
+	php_socket *socket;
+#endif
+	php_socket_t fd = -1;
+	php_stream *stream;
 
-	if (uv_is_active(&uv->uv.handle)) {
-		php_error_docref(NULL, E_WARNING, "passed uv_idle resource has already started.");
-		RETURN_FALSE;
+	if (zend_parse_parameters(ZEND_NUM_ARGS(),
+		"z|l", &handle, &flags) == FAILURE) {
+		return;
 	}
 
-	GC_REFCOUNT(&uv->std)++;
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_idle_start, uv);
-
-	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_IDLE_CB);
-
-	r = uv_idle_start(&uv->uv.idle, (uv_idle_cb) php_uv_idle_cb);
-
-	RETURN_LONG(r);
-}
-/* }}} */
-
-
-/* {{{ proto void uv_idle_stop(resource $idle)
-*/
-PHP_FUNCTION(uv_idle_stop)
-{
-	php_uv_t *uv;
-	int r = 0;
-
-	ZEND_PARSE_PARAMETERS_START(1, 1)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_idle_ce)
-	ZEND_PARSE_PARAMETERS_END();
-
-	if (!uv_is_active(&uv->uv.handle)) {
-		php_error_docref(NULL, E_NOTICE, "passed uv_idle resource does not start yet.");
+	if (Z_TYPE_P(handle) == IS_LONG) {
+		fd = Z_LVAL_P(handle);
+		if (flags & (UV_CREATE_PIPE | UV_INHERIT_STREAM)) {
+			php_error_docref(NULL, E_WARNING, "flags must not be UV::CREATE_PIPE or UV::INHERIT_STREAM for resources");
+			RETURN_FALSE;
+		}
+		flags |= UV_INHERIT_FD;
+	} else if (Z_TYPE_P(handle) == IS_RESOURCE) {
+		if ((stream = (php_stream *) zend_fetch_resource_ex(handle, NULL, php_file_le_stream()))) {
+			if (php_stream_cast(stream, PHP_STREAM_AS_FD | PHP_STREAM_CAST_INTERNAL, (void *) &fd, 1) != SUCCESS || fd < 0) {
+				php_error_docref(NULL, E_WARNING, "passed resource without file descriptor");
+				RETURN_FALSE;
+			}
+#if !defined(PHP_WIN32) || defined(HAVE_SOCKET)
+		} else if ((socket = (php_socket *) zend_fetch_resource_ex(handle, NULL, php_sockets_le_socket()))) {
+			fd = socket->bsd_socket;
+#endif
+		} else {
+			php_error_docref(NULL, E_WARNING, "passed unexpected resource, expected file or socket");
+			RETURN_FALSE;
+		}
+		if (flags & (UV_CREATE_PIPE | UV_INHERIT_STREAM)) {
+			php_error_docref(NULL, E_WARNING, "flags must not be UV::CREATE_PIPE or UV::INHERIT_STREAM for resources");
+			RETURN_FALSE;
+		}
+		flags |= UV_INHERIT_FD;
+	} else if (Z_TYPE_P(handle) == IS_OBJECT && instanceof_function(Z_OBJCE_P(handle), uv_ce)) {
+		if (flags & UV_INHERIT_FD) {
+			php_error_docref(NULL, E_WARNING, "flags must not be UV::INHERIT_FD for UV handles");
+			RETURN_FALSE;
+		}
+		if ((flags & (UV_CREATE_PIPE | UV_INHERIT_STREAM)) == (UV_CREATE_PIPE | UV_INHERIT_STREAM) || !(flags & (UV_CREATE_PIPE | UV_INHERIT_STREAM))) {
+			php_error_docref(NULL, E_WARNING, "flags must be exactly one of UV::INHERIT_STREAM or UV::CREATE_PIPE for UV handles");
+			RETURN_FALSE;
+		}
+	} else {
+		php_error_docref(NULL, E_WARNING, "passed unexpected value, expected instance of UV, file resource or socket resource");
 		RETURN_FALSE;
 	}
 
-	r = uv_idle_stop(&uv->uv.idle);
+	PHP_UV_INIT_GENERIC(stdio, php_uv_stdio_t, uv_stdio_ce);
+	stdio->flags = flags;
+	stdio->fd = fd;
 
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_idle_stop, uv);
-	OBJ_RELEASE(&uv->std);
+	if (Z_TYPE_P(handle) == IS_RESOURCE || Z_TYPE_P(handle) == IS_OBJECT) {
+		ZVAL_COPY(&stdio->stream, handle);
+	}
 
-	RETURN_LONG(r);
+	RETURN_OBJ(&stdio->std);
 }
 /* }}} */
 
 
-/* {{{ proto void uv_getaddrinfo(resource $loop, callable $callback, string $node, string $service, array $hints)
+/* {{{ proto array uv_loadavg(void)
 */
-PHP_FUNCTION(uv_getaddrinfo)
+PHP_FUNCTION(uv_loadavg)
 {
-	zval *hints = NULL;
-	php_uv_loop_t *loop;
-	php_uv_t *uv = NULL;
-	struct addrinfo hint = {0};
-	zend_string *node, *service;
-	zend_fcall_info fci       = empty_fcall_info;
-	zend_fcall_info_cache fcc = empty_fcall_info_cache;
-	php_uv_cb_t *cb;
-
-	ZEND_PARSE_PARAMETERS_START(4, 5)
-		UV_PARAM_OBJ(loop, php_uv_loop_t, uv_loop_ce)
-		Z_PARAM_FUNC(fci, fcc)
-		Z_PARAM_STR(node)
-		Z_PARAM_STR(service)
-		Z_PARAM_OPTIONAL
-		Z_PARAM_ARRAY(hints)
-	ZEND_PARSE_PARAMETERS_END();
-
-	if (Z_TYPE_P(hints) == IS_ARRAY) {
-		HashTable *h;
-		zval *data;
+	double average[3];
 
-		h = Z_ARRVAL_P(hints);
-		if ((data = zend_hash_str_find(h, ZEND_STRL("ai_family")))) {
-			hint.ai_family = Z_LVAL_P(data);
-		}
-		if ((data = zend_hash_str_find(h, ZEND_STRL("ai_socktype")))) {
-			hint.ai_socktype = Z_LVAL_P(data);
-		}
-		if ((data = zend_hash_str_find(h, ZEND_STRL("ai_protocol")))) {
-			hint.ai_socktype = Z_LVAL_P(data);
-		}
-		if ((data = zend_hash_str_find(h, ZEND_STRL("ai_flags")))) {
-			hint.ai_flags = Z_LVAL_P(data);
-		}
+	if (zend_parse_parameters_none() == FAILURE) {
+		return;
 	}
 
-	PHP_UV_INIT_UV(uv, uv_addrinfo_ce);
+	uv_loadavg(average);
 
-	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_GETADDR_CB);
-	uv_getaddrinfo(&loop->loop, &uv->uv.addrinfo, php_uv_getaddrinfo_cb, node->val, service->val, &hint);
+	array_init(return_value);
+	add_next_index_double(return_value, average[0]);
+	add_next_index_double(return_value, average[1]);
+	add_next_index_double(return_value, average[2]);
 }
 /* }}} */
 
-/* {{{ proto resource uv_tcp_init([resource $loop])
+/* {{{ proto double uv_uptime(void)
 */
-PHP_FUNCTION(uv_tcp_init)
+PHP_FUNCTION(uv_uptime)
 {
-	php_uv_loop_t *loop = NULL;
-	php_uv_t *uv;
+	double uptime;
 
-	ZEND_PARSE_PARAMETERS_START(0, 1)
-		Z_PARAM_OPTIONAL
-		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
-	ZEND_PARSE_PARAMETERS_END();
+	if (zend_parse_parameters_none() == FAILURE) {
+		return;
+	}
 
-	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
-	PHP_UV_INIT_UV_EX(uv, uv_tcp_ce, uv_tcp_init);
+	uv_uptime(&uptime);
 
-	RETURN_OBJ(&uv->std);
+	RETURN_DOUBLE(uptime);
 }
 /* }}} */
 
-/* {{{ proto int|false uv_tcp_open(resource $handle, long $tcpfd)
+/* {{{ proto long uv_get_free_memory(void)
 */
-PHP_FUNCTION(uv_tcp_open)
+PHP_FUNCTION(uv_get_free_memory)
 {
-	php_uv_handle_open((int (*)(uv_handle_t *, long)) uv_tcp_open, uv_tcp_ce, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	if (zend_parse_parameters_none() == FAILURE) {
+		return;
+	}
+
+	RETURN_LONG(uv_get_free_memory());
 }
 /* }}} */
 
-/* {{{ proto resource uv_default_loop()
+/* {{{ proto long uv_get_total_memory(void)
 */
-PHP_FUNCTION(uv_default_loop)
+PHP_FUNCTION(uv_get_total_memory)
 {
-	php_uv_loop_t *loop = php_uv_default_loop();
-	++GC_REFCOUNT(&loop->std);
-	RETURN_OBJ(&loop->std);
+	if (zend_parse_parameters_none() == FAILURE) {
+		return;
+	}
+
+	RETURN_LONG(uv_get_total_memory());
 }
 /* }}} */
 
-/* {{{ proto resource uv_loop_new()
+/* {{{ proto long uv_hrtime(void)
 */
-PHP_FUNCTION(uv_loop_new)
+PHP_FUNCTION(uv_hrtime)
 {
-	object_init_ex(return_value, uv_loop_ce);
+	if (zend_parse_parameters_none() == FAILURE) {
+		return;
+	}
+
+	/* TODO: is this correct? */
+	RETURN_LONG(uv_hrtime());
 }
 /* }}} */
 
-
-/* {{{ proto resource uv_udp_init([resource $loop])
+/* {{{ proto string uv_exepath(void)
 */
-PHP_FUNCTION(uv_udp_init)
+PHP_FUNCTION(uv_exepath)
 {
-	php_uv_loop_t *loop = NULL;
-	php_uv_t *uv;
+	char buffer[MAXPATHLEN];
+	size_t buffer_sz = sizeof(buffer) / sizeof(buffer[0]);
 
-	ZEND_PARSE_PARAMETERS_START(0, 1)
-		Z_PARAM_OPTIONAL
-		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
-	ZEND_PARSE_PARAMETERS_END();
+	if (zend_parse_parameters_none() == FAILURE) {
+		return;
+	}
 
-	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
-	PHP_UV_INIT_UV_EX(uv, uv_udp_ce, uv_udp_init);
+	if (uv_exepath(buffer, &buffer_sz) == UV_EINVAL) {
+		RETURN_FALSE;
+	}
 
-	RETURN_OBJ(&uv->std);
+	RETURN_STRINGL(buffer, buffer_sz);
 }
 /* }}} */
 
-/* {{{ proto int|false uv_udp_open(resource $handle, long $udpfd)
+/* {{{ proto string uv_cwd(void)
 */
-PHP_FUNCTION(uv_udp_open)
+PHP_FUNCTION(uv_cwd)
 {
-	php_uv_handle_open((int (*)(uv_handle_t *, long)) uv_udp_open, uv_udp_ce, INTERNAL_FUNCTION_PARAM_PASSTHRU);
-}
-/* }}} */
+	char buffer[MAXPATHLEN];
+	size_t buffer_sz = sizeof(buffer) / sizeof(buffer[0]);
 
-/* {{{ proto void uv_udp_bind(resource $resource, resource $address, long $flags)
-*/
-PHP_FUNCTION(uv_udp_bind)
-{
-	php_uv_socket_bind(PHP_UV_UDP_IPV4, INTERNAL_FUNCTION_PARAM_PASSTHRU);
-}
-/* }}} */
+	if (zend_parse_parameters_none() == FAILURE) {
+		return;
+	}
 
-/* {{{ proto void uv_udp_bind6(resource $resource, resource $address, long $flags)
-*/
-PHP_FUNCTION(uv_udp_bind6)
-{
-	php_uv_socket_bind(PHP_UV_UDP_IPV6, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	uv_cwd(buffer, &buffer_sz);
+
+	RETURN_STRING(buffer);
 }
 /* }}} */
 
-/* {{{ proto void uv_udp_recv_start(resource $handle, callable $callback)
+/* {{{ proto array uv_cpu_info(void)
 */
-PHP_FUNCTION(uv_udp_recv_start)
+PHP_FUNCTION(uv_cpu_info)
 {
-	php_uv_t *uv;
-	zend_fcall_info fci       = empty_fcall_info;
-	zend_fcall_info_cache fcc = empty_fcall_info_cache;
-	php_uv_cb_t *cb;
-	int r;
-
-	ZEND_PARSE_PARAMETERS_START(2, 2)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_udp_ce)
-		Z_PARAM_FUNC(fci, fcc)
-	ZEND_PARSE_PARAMETERS_END();
+	uv_cpu_info_t *cpus;
+	int error;
+	int i, count;
 
-	if (uv_is_active(&uv->uv.handle)) {
-		php_error_docref(NULL, E_WARNING, "passed uv_resource has already activated.");
-		RETURN_FALSE;
+	if (zend_parse_parameters_none() == FAILURE) {
+		return;
 	}
 
-	GC_REFCOUNT(&uv->std)++;
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_udp_recv_start, uv);
+	error = uv_cpu_info(&cpus, &count);
+	if (0 == error) {
+		array_init(return_value);
 
-	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_RECV_CB);
-	r = uv_udp_recv_start(&uv->uv.udp, php_uv_read_alloc, php_uv_udp_recv_cb);
-	if (r) {
-		php_error_docref(NULL, E_NOTICE, "read failed");
-		OBJ_RELEASE(&uv->std);
+		for (i = 0; i < count; i++) {
+			zval tmp, times;
+
+			array_init(&tmp);
+			array_init(&times);
+
+			add_assoc_string_ex(&tmp, ZEND_STRL("model"), cpus[i].model);
+			add_assoc_long_ex(&tmp,   ZEND_STRL("speed"), cpus[i].speed);
+
+			add_assoc_long_ex(&times, ZEND_STRL("sys"),  (size_t)cpus[i].cpu_times.sys);
+			add_assoc_long_ex(&times, ZEND_STRL("user"), (size_t)cpus[i].cpu_times.user);
+			add_assoc_long_ex(&times, ZEND_STRL("idle"), (size_t)cpus[i].cpu_times.idle);
+			add_assoc_long_ex(&times, ZEND_STRL("irq"),  (size_t)cpus[i].cpu_times.irq);
+			add_assoc_long_ex(&times, ZEND_STRL("nice"), (size_t)cpus[i].cpu_times.nice);
+			add_assoc_zval_ex(&tmp,   ZEND_STRL("times"), &times);
+
+			add_next_index_zval(return_value, &tmp);
+		}
+
+		uv_free_cpu_info(cpus, count);
 	}
 }
 /* }}} */
 
-/* {{{ proto void uv_udp_recv_stop(resource $handle)
+
+/* {{{ proto array uv_interface_addresses(void)
 */
-PHP_FUNCTION(uv_udp_recv_stop)
+PHP_FUNCTION(uv_interface_addresses)
 {
-	php_uv_t *uv;
-
-	ZEND_PARSE_PARAMETERS_START(1, 1)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_udp_ce)
-	ZEND_PARSE_PARAMETERS_END();
+	uv_interface_address_t *interfaces;
+	int error;
+	char buffer[512];
+	int i, count;
 
-	if (!uv_is_active(&uv->uv.handle)) {
-		php_error_docref(NULL, E_NOTICE, "passed uv_resource has already stopped.");
-		RETURN_FALSE;
+	if (zend_parse_parameters_none() == FAILURE) {
+		return;
 	}
 
-	uv_udp_recv_stop(&uv->uv.udp);
+	error = uv_interface_addresses(&interfaces, &count);
+	if (0 == error) {
+		array_init(return_value);
 
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_udp_recv_stop, uv);
-	OBJ_RELEASE(&uv->std);
+		for (i = 0; i < count; i++) {
+			zval tmp;
+
+			array_init(&tmp);
+
+			add_assoc_string_ex(&tmp, ZEND_STRL("name"), interfaces[i].name);
+			add_assoc_bool_ex(&tmp, ZEND_STRL("is_internal"), interfaces[i].is_internal);
+
+			if (interfaces[i].address.address4.sin_family == AF_INET) {
+				uv_ip4_name(&interfaces[i].address.address4, buffer, sizeof(buffer));
+			} else if (interfaces[i].address.address4.sin_family == AF_INET6) {
+				uv_ip6_name(&interfaces[i].address.address6, buffer, sizeof(buffer));
+			}
+			add_assoc_string_ex(&tmp, ZEND_STRL("address"), buffer);
+
+			add_next_index_zval(return_value, &tmp);
+		}
+		uv_free_interface_addresses(interfaces, count);
+	}
 }
 /* }}} */
 
-/* {{{ proto long uv_udp_set_membership(resource $handle, string $multicast_addr, string $interface_addr, long $membership)
+/* {{{ proto resource uv_spawn(resource $loop, string $command, array $args, array $stdio, string $cwd, array $env = array(), callable $callback [,long $flags, array $options])
 */
-PHP_FUNCTION(uv_udp_set_membership)
+PHP_FUNCTION(uv_spawn)
 {
-	php_uv_t *uv;
-	zend_string *multicast_addr, *interface_addr;
-	int error;
-	zend_long membership;
+	php_uv_loop_t *loop;
+	uv_process_options_t options = {0};
+	uv_stdio_container_t *stdio = NULL;
+	php_uv_t *proc;
+	zval *args, *env, *zoptions = NULL, *zstdio = NULL, *value;
+	char **command_args, **zenv;
+	zend_string *command, *cwd;
+	int uid = 0, gid = 0, stdio_count = 0, ret;
+	zend_long flags = 0;
+	zend_fcall_info fci       = empty_fcall_info;
+	zend_fcall_info_cache fcc = empty_fcall_info_cache;
+	php_uv_cb_t *cb;
 
-	ZEND_PARSE_PARAMETERS_START(4, 4)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_udp_ce)
-		Z_PARAM_STR(multicast_addr)
-		Z_PARAM_STR(interface_addr)
-		Z_PARAM_LONG(membership)
+	ZEND_PARSE_PARAMETERS_START(7, 9)
+		UV_PARAM_OBJ(loop, php_uv_loop_t, uv_loop_ce)
+		Z_PARAM_STR(command)
+		Z_PARAM_ARRAY(args)
+		Z_PARAM_ARRAY(zstdio)
+		Z_PARAM_STR(cwd)
+		Z_PARAM_ARRAY(env)
+		Z_PARAM_FUNC(fci, fcc)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_LONG(flags)
+		Z_PARAM_ARRAY(zoptions)
 	ZEND_PARSE_PARAMETERS_END();
 
-	error = uv_udp_set_membership(&uv->uv.udp, (const char *) multicast_addr->val, (const char *) interface_addr->val, membership);
+	memset(&options, 0, sizeof(uv_process_options_t));
 
-	RETURN_LONG(error);
-}
-/* }}} */
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
 
+	{/* process stdio */
+		HashTable *stdio_container;
+		int x = 0;
 
-/* {{{ proto void uv_udp_set_multicast_loop(resource $handle, long $enabled)
-*/
-PHP_FUNCTION(uv_udp_set_multicast_loop)
-{
-	php_uv_t *uv;
-	zend_long enabled = 0;
-	int r;
+		stdio_container = Z_ARRVAL_P(zstdio);
+		stdio_count = zend_hash_num_elements(stdio_container);
 
-	ZEND_PARSE_PARAMETERS_START(2, 2)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_udp_ce)
-		Z_PARAM_LONG(enabled)
-	ZEND_PARSE_PARAMETERS_END();
+		stdio = emalloc(sizeof(uv_stdio_container_t) * stdio_count);
 
-	r = uv_udp_set_multicast_loop((uv_udp_t*)&uv->uv.udp, enabled);
-	if (r) {
-		php_error_docref(NULL, E_NOTICE, "uv_udp_set_muticast_loop failed");
-	}
-}
-/* }}} */
+		ZEND_HASH_FOREACH_VAL(stdio_container, value) {
+			php_uv_stdio_t *stdio_tmp;
 
-/* {{{ proto void uv_udp_set_multicast_ttl(resource $handle, long $ttl)
-*/
-PHP_FUNCTION(uv_udp_set_multicast_ttl)
-{
-	php_uv_t *uv;
-	zend_long ttl = 0; /* 1 through 255 */
-	int r;
+			if (Z_TYPE_P(value) != IS_OBJECT || Z_OBJCE_P(value) != uv_stdio_ce) {
+				php_error_docref(NULL, E_ERROR, "must be instance of UVStdio");
+			}
 
-	ZEND_PARSE_PARAMETERS_START(2, 2)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_udp_ce)
-		Z_PARAM_LONG(ttl)
-	ZEND_PARSE_PARAMETERS_END();
+			stdio_tmp = (php_uv_stdio_t *) Z_OBJ_P(value);
 
-	if (ttl > 255) {
-		php_error_docref(NULL, E_NOTICE, "uv_udp_set_muticast_ttl: ttl parameter expected smaller than 255.");
-		ttl = 255;
-	} else if (ttl < 1) {
-		php_error_docref(NULL, E_NOTICE, "uv_udp_set_muticast_ttl: ttl parameter expected larger than 0.");
-		ttl = 1;
-	}
+			stdio[x].flags = stdio_tmp->flags;
 
-	r = uv_udp_set_multicast_ttl(&uv->uv.udp, ttl);
-	if (r) {
-		php_error_docref(NULL, E_NOTICE, "uv_udp_set_muticast_ttl failed");
+			if (stdio_tmp->flags & UV_INHERIT_FD) {
+				stdio[x].data.fd = stdio_tmp->fd;
+			} else if (stdio_tmp->flags & (UV_CREATE_PIPE | UV_INHERIT_STREAM)) {
+				php_uv_t *uv_pipe = (php_uv_t *) Z_OBJ(stdio_tmp->stream);
+				stdio[x].data.stream = &uv_pipe->uv.stream;
+			} else {
+				php_error_docref(NULL, E_WARNING, "passes unexpected stdio flags");
+				RETURN_FALSE;
+			}
+
+			x++;
+		} ZEND_HASH_FOREACH_END();
 	}
-}
-/* }}} */
 
-/* {{{ proto void uv_udp_set_broadcast(resource $handle, bool $enabled)
-*/
-PHP_FUNCTION(uv_udp_set_broadcast)
-{
-	php_uv_t *uv;
-	zend_long enabled = 0;
-	int r;
+	{
+		HashTable *h;
+		zval *value;
+		int n = 0;
+		int hash_len = 0;
 
-	ZEND_PARSE_PARAMETERS_START(2, 2)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_udp_ce)
-		Z_PARAM_LONG(enabled)
-	ZEND_PARSE_PARAMETERS_END();
+		h = Z_ARRVAL_P(args);
 
-	r = uv_udp_set_broadcast(&uv->uv.udp, enabled);
-	if (r) {
-		php_error_docref(NULL, E_NOTICE, "uv_udp_set_muticast_loop failed");
+		hash_len = zend_hash_num_elements(h);
+
+		command_args = ecalloc(hash_len+2, sizeof(char**));
+		command_args[n] = command->val;
+
+		n++;
+		ZEND_HASH_FOREACH_VAL(h, value) {
+			command_args[n] = Z_STRVAL_P(value);
+			n++;
+		} ZEND_HASH_FOREACH_END();
+
+		command_args[n] = NULL;
 	}
-}
-/* }}} */
 
-/* {{{ proto void uv_udp_send(resource $handle, string $data, resource $uv_addr, callable $callback)
-*/
-PHP_FUNCTION(uv_udp_send)
-{
-	php_uv_udp_send(1, INTERNAL_FUNCTION_PARAM_PASSTHRU);
-}
-/* }}} */
+	{ /* env */
+		HashTable *tmp_env;
+		zend_string *key;
+		int i = 0;
+		zval *value;
 
-/* {{{ proto void uv_udp_send6(resource $handle, string $data, resource $uv_addr6, callable $callback)
-*/
-PHP_FUNCTION(uv_udp_send6)
-{
-	php_uv_udp_send(2, INTERNAL_FUNCTION_PARAM_PASSTHRU);
-}
-/* }}} */
+		tmp_env = Z_ARRVAL_P(env);
 
-/* {{{ proto bool uv_is_active(UV $handle)
-*/
-PHP_FUNCTION(uv_is_active)
-{
-	zval *zv;
-	php_uv_t *uv;
+		zenv = ecalloc(zend_hash_num_elements(tmp_env)+1, sizeof(char*));
+		ZEND_HASH_FOREACH_STR_KEY_VAL(tmp_env, key, value) {
+			char *tmp_env_entry;
 
-	ZEND_PARSE_PARAMETERS_START(1, 1)
-		Z_PARAM_OBJECT_OF_CLASS(zv, uv_ce)
-	ZEND_PARSE_PARAMETERS_END();
+			tmp_env_entry = emalloc(sizeof(char) * (key->len + 2 + Z_STRLEN_P(value)));
+			slprintf(tmp_env_entry, key->len + 1 + Z_STRLEN_P(value), "%s=%s", key->val, Z_STRVAL_P(value));
 
-	uv = (php_uv_t *) Z_OBJ_P(zv);
+			zenv[i++] = tmp_env_entry;
+		} ZEND_HASH_FOREACH_END();
+		zenv[i] = NULL;
+	}
 
-	RETURN_BOOL(!PHP_UV_IS_DTORED(uv) && uv_is_active(&uv->uv.handle));
-}
-/* }}} */
+	if (zoptions != NULL && Z_TYPE_P(zoptions) != IS_NULL){
+		HashTable *opts;
+		zval *data;
 
-/* {{{ proto bool uv_is_closing(UV $handle)
-*/
-PHP_FUNCTION(uv_is_closing)
-{
-	zval *zv;
-	php_uv_t *uv;
+		opts = Z_ARRVAL_P(zoptions);
 
-	ZEND_PARSE_PARAMETERS_START(1, 1)
-		Z_PARAM_OBJECT_OF_CLASS(zv, uv_ce)
-	ZEND_PARSE_PARAMETERS_END();
+		if ((data = zend_hash_str_find(opts, ZEND_STRL("uid")))) {
+			uid = Z_LVAL_P(data);
+		}
 
-	uv = (php_uv_t *) Z_OBJ_P(zv);
+		if ((data = zend_hash_str_find(opts, ZEND_STRL("gid")))) {
+			gid = Z_LVAL_P(data);
+		}
+	}
 
-	RETURN_BOOL(PHP_UV_IS_DTORED(uv));
-}
-/* }}} */
+	options.file    = command->val;
+	options.stdio   = stdio;
+	options.exit_cb = php_uv_process_close_cb;
+	options.env     = zenv;
+	options.args    = command_args;
+	options.cwd     = cwd->val;
+	options.stdio   = stdio;
+	options.stdio_count = stdio_count;
+	options.flags = flags;
+	options.uid = uid;
+	options.gid = gid;
 
-/* {{{ proto bool uv_is_readable(resource $handle)
-*/
-PHP_FUNCTION(uv_is_readable)
-{
-	php_uv_t *uv;
+	PHP_UV_INIT_UV(proc, uv_process_ce);
 
-	ZEND_PARSE_PARAMETERS_START(1, 1)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_ce)
-	ZEND_PARSE_PARAMETERS_END();
+	ret = uv_spawn(&loop->loop, &proc->uv.process, &options);
 
-	RETURN_BOOL(uv_is_readable(&uv->uv.stream));
+	if (ret) {
+		PHP_UV_DEINIT_UV(proc);
+		RETVAL_LONG(ret);
+	} else {
+		php_uv_cb_init(&cb, proc, &fci, &fcc, PHP_UV_PROC_CLOSE_CB);
+		++GC_REFCOUNT(&proc->std);
+		PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_spawn, proc);
+		RETVAL_OBJ(&proc->std);
+	}
+
+	if (zenv != NULL) {
+		char **p = zenv;
+		while(*p != NULL) {
+			efree(*p);
+			p++;
+		}
+		efree(zenv);
+	}
+	if (command_args != NULL) {
+		efree(command_args);
+	}
+
+	if (stdio != NULL) {
+		efree(stdio);
+	}
 }
 /* }}} */
 
-/* {{{ proto bool uv_is_writable(resource $handle)
+
+/* {{{ proto void uv_process_kill(resource $handle, long $signal)
 */
-PHP_FUNCTION(uv_is_writable)
+PHP_FUNCTION(uv_process_kill)
 {
 	php_uv_t *uv;
+	zend_long signal;
 
-	ZEND_PARSE_PARAMETERS_START(1, 1)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_ce)
+	ZEND_PARSE_PARAMETERS_START(2, 2)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_process_ce)
+		Z_PARAM_LONG(signal)
 	ZEND_PARSE_PARAMETERS_END();
 
-	RETURN_BOOL(uv_is_writable(&uv->uv.stream));
+	uv_process_kill(&uv->uv.process, signal);
 }
 /* }}} */
 
-
-/* {{{ proto bool uv_walk(resource $loop, callable $closure[, array $opaque])
+/* {{{ proto void uv_kill(long $pid, long $signal)
 */
-PHP_FUNCTION(uv_walk)
+PHP_FUNCTION(uv_kill)
 {
-	zval *opaque = NULL;
-	php_uv_loop_t *loop;
-	zend_fcall_info fci       = empty_fcall_info;
-	zend_fcall_info_cache fcc = empty_fcall_info_cache;
-	//php_uv_cb_t *cb;
-
-	ZEND_PARSE_PARAMETERS_START(2, 3)
-		UV_PARAM_OBJ(loop, php_uv_loop_t, uv_loop_ce)
-		Z_PARAM_FUNC(fci, fcc)
-		Z_PARAM_OPTIONAL
-		Z_PARAM_ARRAY(opaque)
-	ZEND_PARSE_PARAMETERS_END();
-
-	php_error_docref(NULL, E_ERROR, "uv_walk not yet supported");
+	zend_long pid, signal;
 
-	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
-	uv_walk(&loop->loop, php_uv_walk_cb, NULL);
+	if (zend_parse_parameters(ZEND_NUM_ARGS(),
+		"ll", &pid, &signal) == FAILURE) {
+		return;
+	}
+	uv_kill(pid, signal);
 }
 /* }}} */
 
-/* {{{ proto long uv_guess_handle(resource $uv)
+/* {{{ proto bool uv_chdir(string $directory)
 */
-PHP_FUNCTION(uv_guess_handle)
+PHP_FUNCTION(uv_chdir)
 {
-	zval *handle;
-	long fd = -1;
-	uv_handle_type type;
+	int error;
+	zend_string *directory;
 
 	if (zend_parse_parameters(ZEND_NUM_ARGS(),
-		"r", &handle) == FAILURE) {
+		"S", &directory) == FAILURE) {
 		return;
 	}
-
-	fd = php_uv_zval_to_fd(handle);
-	if (fd < 0) {
-		php_error_docref(NULL, E_WARNING, "invalid variable passed. can't convert to fd.");
-		return;
+	error = uv_chdir(directory->val);
+	if (error == 0) {
+		RETURN_TRUE;
+	} else {
+		RETURN_FALSE;
 	}
-	type = uv_guess_handle(fd);
-
-	RETURN_LONG(type);
 }
 /* }}} */
 
 
-/* {{{ proto resource uv_pipe_init([resource $loop, long $ipc])
+/* {{{ proto resource uv_rwlock_init(void)
 */
-PHP_FUNCTION(uv_pipe_init)
+PHP_FUNCTION(uv_rwlock_init)
 {
-	php_uv_t *uv;
-	php_uv_loop_t *loop = NULL;
-	zend_bool ipc = 0;
-
-	ZEND_PARSE_PARAMETERS_START(0, 2)
-		Z_PARAM_OPTIONAL
-		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
-		Z_PARAM_BOOL(ipc)
-	ZEND_PARSE_PARAMETERS_END();
-
-	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
-
-	PHP_UV_INIT_UV_EX(uv, uv_pipe_ce, uv_pipe_init, (int) ipc);
-
-	RETURN_OBJ(&uv->std);
+	php_uv_lock_init(IS_UV_RWLOCK, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto int|false uv_pipe_open(resource $handle, long $pipe)
+/* {{{ proto uv_rwlock_rdlock(resource $handle)
 */
-PHP_FUNCTION(uv_pipe_open)
+PHP_FUNCTION(uv_rwlock_rdlock)
 {
-	php_uv_handle_open((int (*)(uv_handle_t *, long)) uv_pipe_open, uv_pipe_ce, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_lock_lock(IS_UV_RWLOCK_RD, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto long uv_pipe_bind(resource $handle, string $name)
+/* {{{ proto bool uv_rwlock_tryrdlock(resource $handle)
 */
-PHP_FUNCTION(uv_pipe_bind)
+PHP_FUNCTION(uv_rwlock_tryrdlock)
 {
-	php_uv_t *uv;
-	zend_string *name;
-	int error;
-
-	ZEND_PARSE_PARAMETERS_START(2, 2)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_pipe_ce)
-		Z_PARAM_STR(name)
-	ZEND_PARSE_PARAMETERS_END();
-
-	error = uv_pipe_bind(&uv->uv.pipe, name->val);
-	if (error) {
-		php_error_docref(NULL, E_WARNING, "%s", php_uv_strerror(error));
-	}
-
-	RETURN_LONG(error);
+	php_uv_lock_trylock(IS_UV_RWLOCK_RD, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_pipe_connect(resource $handle, string $path, callable $callback)
+/* {{{ proto void uv_rwlock_rdunlock(resource $handle)
 */
-PHP_FUNCTION(uv_pipe_connect)
+PHP_FUNCTION(uv_rwlock_rdunlock)
 {
-	php_uv_t *uv;
-	zend_string *name;
-	uv_connect_t *req;
-	zend_fcall_info fci       = empty_fcall_info;
-	zend_fcall_info_cache fcc = empty_fcall_info_cache;
-	php_uv_cb_t *cb;
-
-	ZEND_PARSE_PARAMETERS_START(3, 3)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_pipe_ce)
-		Z_PARAM_STR(name)
-		Z_PARAM_FUNC(fci, fcc)
-	ZEND_PARSE_PARAMETERS_END();
-
-	GC_REFCOUNT(&uv->std)++;
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_pipe_connect, uv);
-
-	req = (uv_connect_t *) emalloc(sizeof(uv_connect_t));
-	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_PIPE_CONNECT_CB);
-
-	req->data = uv;
-	uv_pipe_connect(req, &uv->uv.pipe, name->val, php_uv_pipe_connect_cb);
+	php_uv_lock_unlock(IS_UV_RWLOCK_RD, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_pipe_pending_instances(resource $handle, long $count)
+/* {{{ proto uv_rwlock_wrlock(resource $handle)
 */
-PHP_FUNCTION(uv_pipe_pending_instances)
+PHP_FUNCTION(uv_rwlock_wrlock)
 {
-	php_uv_t *uv;
-	zend_long count;
-
-	ZEND_PARSE_PARAMETERS_START(2, 2)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_pipe_ce)
-		Z_PARAM_LONG(count)
-	ZEND_PARSE_PARAMETERS_END();
-
-	uv_pipe_pending_instances(&uv->uv.pipe, count);
+	php_uv_lock_lock(IS_UV_RWLOCK_WR, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_pipe_pending_count(resource $handle)
+/* {{{ proto uv_rwlock_trywrlock(resource $handle)
 */
-PHP_FUNCTION(uv_pipe_pending_count)
+PHP_FUNCTION(uv_rwlock_trywrlock)
 {
-	php_uv_t *uv;
-
-	ZEND_PARSE_PARAMETERS_START(1, 1)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_pipe_ce)
-	ZEND_PARSE_PARAMETERS_END();
-
-	RETURN_LONG(uv_pipe_pending_count(&uv->uv.pipe));
+	php_uv_lock_trylock(IS_UV_RWLOCK_WR, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_pipe_pending_type(resource $handle)
+/* {{{ proto uv_rwlock_wrunlock(resource $handle)
 */
-PHP_FUNCTION(uv_pipe_pending_type)
+PHP_FUNCTION(uv_rwlock_wrunlock)
 {
-	php_uv_t *uv;
-	uv_handle_type ret;
+	php_uv_lock_unlock(IS_UV_RWLOCK_WR, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
 
-	ZEND_PARSE_PARAMETERS_START(1, 1)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_pipe_ce)
-	ZEND_PARSE_PARAMETERS_END();
+/* {{{ proto uv_lock uv_mutex_init(void)
+*/
+PHP_FUNCTION(uv_mutex_init)
+{
+	php_uv_lock_init(IS_UV_MUTEX, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
 
-	ret = uv_pipe_pending_type(&uv->uv.pipe);
-	RETURN_LONG(ret);
+/* {{{ proto void uv_mutex_lock(uv_lock $lock)
+*/
+PHP_FUNCTION(uv_mutex_lock)
+{
+	php_uv_lock_lock(IS_UV_MUTEX, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_stdio_new(zval $fd, long $flags)
+/* {{{ proto bool uv_mutex_trylock(uv_lock $lock)
 */
-PHP_FUNCTION(uv_stdio_new)
+PHP_FUNCTION(uv_mutex_trylock)
 {
-	php_uv_stdio_t *stdio;
-	zval *handle;
-	zend_long flags = 0;
-#if !defined(PHP_WIN32) || defined(HAVE_SOCKET)
-	php_socket *socket;
-#endif
-	php_socket_t fd = -1;
-	php_stream *stream;
+	php_uv_lock_trylock(IS_UV_MUTEX, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
 
-	if (zend_parse_parameters(ZEND_NUM_ARGS(),
-		"z|l", &handle, &flags) == FAILURE) {
-		return;
-	}
+/* {{{ void uv_mutex_unlock(uv_lock $lock)
 
-	if (Z_TYPE_P(handle) == IS_LONG) {
-		fd = Z_LVAL_P(handle);
-		if (flags & (UV_CREATE_PIPE | UV_INHERIT_STREAM)) {
-			php_error_docref(NULL, E_WARNING, "flags must not be UV::CREATE_PIPE or UV::INHERIT_STREAM for resources");
-			RETURN_FALSE;
-		}
-		flags |= UV_INHERIT_FD;
-	} else if (Z_TYPE_P(handle) == IS_RESOURCE) {
-		if ((stream = (php_stream *) zend_fetch_resource_ex(handle, NULL, php_file_le_stream()))) {
-			if (php_stream_cast(stream, PHP_STREAM_AS_FD | PHP_STREAM_CAST_INTERNAL, (void *) &fd, 1) != SUCCESS || fd < 0) {
-				php_error_docref(NULL, E_WARNING, "passed resource without file descriptor");
-				RETURN_FALSE;
-			}
-#if !defined(PHP_WIN32) || defined(HAVE_SOCKET)
-		} else if ((socket = (php_socket *) zend_fetch_resource_ex(handle, NULL, php_sockets_le_socket()))) {
-			fd = socket->bsd_socket;
-#endif
-		} else {
-			php_error_docref(NULL, E_WARNING, "passed unexpected resource, expected file or socket");
-			RETURN_FALSE;
-		}
-		if (flags & (UV_CREATE_PIPE | UV_INHERIT_STREAM)) {
-			php_error_docref(NULL, E_WARNING, "flags must not be UV::CREATE_PIPE or UV::INHERIT_STREAM for resources");
-			RETURN_FALSE;
-		}
-		flags |= UV_INHERIT_FD;
-	} else if (Z_TYPE_P(handle) == IS_OBJECT && instanceof_function(Z_OBJCE_P(handle), uv_ce)) {
-		if (flags & UV_INHERIT_FD) {
-			php_error_docref(NULL, E_WARNING, "flags must not be UV::INHERIT_FD for UV handles");
-			RETURN_FALSE;
-		}
-		if ((flags & (UV_CREATE_PIPE | UV_INHERIT_STREAM)) == (UV_CREATE_PIPE | UV_INHERIT_STREAM) || !(flags & (UV_CREATE_PIPE | UV_INHERIT_STREAM))) {
-			php_error_docref(NULL, E_WARNING, "flags must be exactly one of UV::INHERIT_STREAM or UV::CREATE_PIPE for UV handles");
-			RETURN_FALSE;
-		}
-	} else {
-		php_error_docref(NULL, E_WARNING, "passed unexpected value, expected instance of UV, file resource or socket resource");
-		RETURN_FALSE;
-	}
+##### *Description*
+
+unlock mutex
+
+##### *Parameters*
+
+*resource $handle*: uv resource handle (uv mutex)
+
+##### *Return Value*
 
-	PHP_UV_INIT_GENERIC(stdio, php_uv_stdio_t, uv_stdio_ce);
-	stdio->flags = flags;
-	stdio->fd = fd;
+*void *:
 
-	if (Z_TYPE_P(handle) == IS_RESOURCE || Z_TYPE_P(handle) == IS_OBJECT) {
-		ZVAL_COPY(&stdio->stream, handle);
-	}
+##### *Example*
 
-	RETURN_OBJ(&stdio->std);
+*/
+PHP_FUNCTION(uv_mutex_unlock)
+{
+	php_uv_lock_unlock(IS_UV_MUTEX, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-
-/* {{{ proto array uv_loadavg(void)
+/* {{{ proto uv_lock uv_sem_init(long $value)
 */
-PHP_FUNCTION(uv_loadavg)
+PHP_FUNCTION(uv_sem_init)
 {
-	double average[3];
-
-	if (zend_parse_parameters_none() == FAILURE) {
-		return;
-	}
-
-	uv_loadavg(average);
-
-	array_init(return_value);
-	add_next_index_double(return_value, average[0]);
-	add_next_index_double(return_value, average[1]);
-	add_next_index_double(return_value, average[2]);
+	php_uv_lock_init(IS_UV_SEMAPHORE, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto double uv_uptime(void)
+/* {{{ proto void uv_sem_post(uv_lock $sem)
 */
-PHP_FUNCTION(uv_uptime)
+PHP_FUNCTION(uv_sem_post)
 {
-	double uptime;
-
-	if (zend_parse_parameters_none() == FAILURE) {
-		return;
-	}
-
-	uv_uptime(&uptime);
-
-	RETURN_DOUBLE(uptime);
+	php_uv_lock_lock(IS_UV_SEMAPHORE, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto long uv_get_free_memory(void)
+/* {{{ proto void uv_sem_wait(uv_lock $sem)
 */
-PHP_FUNCTION(uv_get_free_memory)
+PHP_FUNCTION(uv_sem_wait)
 {
-	if (zend_parse_parameters_none() == FAILURE) {
-		return;
-	}
+	php_uv_lock_unlock(IS_UV_SEMAPHORE, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
 
-	RETURN_LONG(uv_get_free_memory());
+/* {{{ proto void uv_sem_trywait(uv_lock $sem)
+*/
+PHP_FUNCTION(uv_sem_trywait)
+{
+	php_uv_lock_trylock(IS_UV_SEMAPHORE, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto long uv_get_total_memory(void)
+/* {{{ proto resource uv_prepare_init(resource $loop)
 */
-PHP_FUNCTION(uv_get_total_memory)
+PHP_FUNCTION(uv_prepare_init)
 {
-	if (zend_parse_parameters_none() == FAILURE) {
-		return;
-	}
+	php_uv_loop_t *loop = NULL;
+	php_uv_t *uv;
 
-	RETURN_LONG(uv_get_total_memory());
+	ZEND_PARSE_PARAMETERS_START(0, 1)
+		Z_PARAM_OPTIONAL
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+	PHP_UV_INIT_UV_EX(uv, uv_prepare_ce, uv_prepare_init);
+
+	RETURN_OBJ(&uv->std);
 }
 /* }}} */
 
-/* {{{ proto long uv_hrtime(void)
+/* {{{ proto void uv_prepare_start(resource $handle, callable $callback)
 */
-PHP_FUNCTION(uv_hrtime)
+PHP_FUNCTION(uv_prepare_start)
 {
-	if (zend_parse_parameters_none() == FAILURE) {
-		return;
+	php_uv_t *uv;
+	int r;
+	zend_fcall_info fci       = empty_fcall_info;
+	zend_fcall_info_cache fcc = empty_fcall_info_cache;
+	php_uv_cb_t *cb;
+
+	PHP_UV_DEBUG_PRINT("uv_prepare_start\n");
+
+	ZEND_PARSE_PARAMETERS_START(2, 2)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_prepare_ce)
+		Z_PARAM_FUNC(fci, fcc)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (uv_is_active(&uv->uv.handle)) {
+		php_error_docref(NULL, E_WARNING, "passed uv_prepare resource has been started.");
+		RETURN_FALSE;
 	}
 
-	/* TODO: is this correct? */
-	RETURN_LONG(uv_hrtime());
+	GC_REFCOUNT(&uv->std)++;
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_prepare_start, uv);
+
+	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_PREPARE_CB);
+	r = uv_prepare_start(&uv->uv.prepare, php_uv_prepare_cb);
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_prepare_start, uv);
+
+	RETURN_LONG(r);
 }
 /* }}} */
 
-/* {{{ proto string uv_exepath(void)
+/* {{{ proto void uv_prepare_stop(resource $handle)
 */
-PHP_FUNCTION(uv_exepath)
+PHP_FUNCTION(uv_prepare_stop)
 {
-	char buffer[MAXPATHLEN];
-	size_t buffer_sz = sizeof(buffer) / sizeof(buffer[0]);
+	php_uv_t *uv;
+	int r = 0;
 
-	if (zend_parse_parameters_none() == FAILURE) {
-		return;
-	}
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_prepare_ce)
+	ZEND_PARSE_PARAMETERS_END();
 
-	if (uv_exepath(buffer, &buffer_sz) == UV_EINVAL) {
+	if (!uv_is_active(&uv->uv.handle)) {
+		php_error_docref(NULL, E_NOTICE, "passed uv_prepare resource has been stopped.");
 		RETURN_FALSE;
 	}
 
-	RETURN_STRINGL(buffer, buffer_sz);
+	r = uv_prepare_stop(&uv->uv.prepare);
+
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_prepare_stop, uv);
+	OBJ_RELEASE(&uv->std);
+
+	RETURN_LONG(r);
 }
 /* }}} */
 
-/* {{{ proto string uv_cwd(void)
+/* {{{ proto resoruce uv_check_init([resource $loop])
 */
-PHP_FUNCTION(uv_cwd)
+PHP_FUNCTION(uv_check_init)
 {
-	char buffer[MAXPATHLEN];
-	size_t buffer_sz = sizeof(buffer) / sizeof(buffer[0]);
+	php_uv_loop_t *loop = NULL;
+	php_uv_t *uv;
 
-	if (zend_parse_parameters_none() == FAILURE) {
-		return;
-	}
+	ZEND_PARSE_PARAMETERS_START(0, 1)
+		Z_PARAM_OPTIONAL
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+	ZEND_PARSE_PARAMETERS_END();
 
-	uv_cwd(buffer, &buffer_sz);
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+	PHP_UV_INIT_UV_EX(uv, uv_check_ce, uv_check_init);
 
-	RETURN_STRING(buffer);
+	RETURN_OBJ(&uv->std);
 }
 /* }}} */
 
-/* {{{ proto array uv_cpu_info(void)
+/* {{{ proto void uv_check_start(resource $handle, callable $callback)
 */
-PHP_FUNCTION(uv_cpu_info)
+PHP_FUNCTION(uv_check_start)
 {
-	uv_cpu_info_t *cpus;
-	int error;
-	int i, count;
+	php_uv_t *uv;
+	int r;
+	zend_fcall_info fci       = empty_fcall_info;
+	zend_fcall_info_cache fcc = empty_fcall_info_cache;
+	php_uv_cb_t *cb;
 
-	if (zend_parse_parameters_none() == FAILURE) {
-		return;
+	PHP_UV_DEBUG_PRINT("uv_check_start");
+
+	ZEND_PARSE_PARAMETERS_START(2, 2)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_check_ce)
+		Z_PARAM_FUNC(fci, fcc)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (uv_is_active(&uv->uv.handle)) {
+		php_error_docref(NULL, E_WARNING, "passed uv check resource has already started");
+		RETURN_FALSE;
 	}
 
-	error = uv_cpu_info(&cpus, &count);
-	if (0 == error) {
-		array_init(return_value);
+	GC_REFCOUNT(&uv->std)++;
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_check_start, uv);
 
-		for (i = 0; i < count; i++) {
-			zval tmp, times;
+	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_CHECK_CB);
 
-			array_init(&tmp);
-			array_init(&times);
+	r = uv_check_start(&uv->uv.check, php_uv_check_cb);
 
-			add_assoc_string_ex(&tmp, ZEND_STRL("model"), cpus[i].model);
-			add_assoc_long_ex(&tmp,   ZEND_STRL("speed"), cpus[i].speed);
+	RETURN_LONG(r);
+}
+/* }}} */
 
-			add_assoc_long_ex(&times, ZEND_STRL("sys"),  (size_t)cpus[i].cpu_times.sys);
-			add_assoc_long_ex(&times, ZEND_STRL("user"), (size_t)cpus[i].cpu_times.user);
-			add_assoc_long_ex(&times, ZEND_STRL("idle"), (size_t)cpus[i].cpu_times.idle);
-			add_assoc_long_ex(&times, ZEND_STRL("irq"),  (size_t)cpus[i].cpu_times.irq);
-			add_assoc_long_ex(&times, ZEND_STRL("nice"), (size_t)cpus[i].cpu_times.nice);
-			add_assoc_zval_ex(&tmp,   ZEND_STRL("times"), &times);
+/* {{{ proto void uv_check_stop(resource $handle)
+*/
+PHP_FUNCTION(uv_check_stop)
+{
+	php_uv_t *uv;
 
-			add_next_index_zval(return_value, &tmp);
-		}
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_check_ce)
+	ZEND_PARSE_PARAMETERS_END();
 
-		uv_free_cpu_info(cpus, count);
+	if (!uv_is_active(&uv->uv.handle)) {
+		php_error_docref(NULL, E_NOTICE, "passed uv_check resource hasn't start yet.");
+		RETURN_FALSE;
 	}
+
+	uv_check_stop(&uv->uv.check);
+
+	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_check_stop, uv);
+	OBJ_RELEASE(&uv->std);
 }
 /* }}} */
 
 
-/* {{{ proto array uv_interface_addresses(void)
+/* {{{ proto resource uv_async_init(resource $loop, callable $callback)
 */
-PHP_FUNCTION(uv_interface_addresses)
+PHP_FUNCTION(uv_async_init)
 {
-	uv_interface_address_t *interfaces;
-	int error;
-	char buffer[512];
-	int i, count;
-
-	if (zend_parse_parameters_none() == FAILURE) {
-		return;
-	}
+	php_uv_loop_t *loop;
+	php_uv_t *uv;
+	zend_fcall_info fci       = empty_fcall_info;
+	zend_fcall_info_cache fcc = empty_fcall_info_cache;
+	php_uv_cb_t *cb;
 
-	error = uv_interface_addresses(&interfaces, &count);
-	if (0 == error) {
-		array_init(return_value);
+	ZEND_PARSE_PARAMETERS_START(2, 2)
+		UV_PARAM_OBJ(loop, php_uv_loop_t, uv_loop_ce)
+		Z_PARAM_FUNC(fci, fcc)
+	ZEND_PARSE_PARAMETERS_END();
 
-		for (i = 0; i < count; i++) {
-			zval tmp;
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+	PHP_UV_INIT_UV_EX(uv, uv_async_ce, uv_async_init, php_uv_async_cb);
 
-			array_init(&tmp);
+	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_ASYNC_CB);
 
-			add_assoc_string_ex(&tmp, ZEND_STRL("name"), interfaces[i].name);
-			add_assoc_bool_ex(&tmp, ZEND_STRL("is_internal"), interfaces[i].is_internal);
+	RETURN_OBJ(&uv->std);
+}
+/* }}} */
 
-			if (interfaces[i].address.address4.sin_family == AF_INET) {
-				uv_ip4_name(&interfaces[i].address.address4, buffer, sizeof(buffer));
-			} else if (interfaces[i].address.address4.sin_family == AF_INET6) {
-				uv_ip6_name(&interfaces[i].address.address6, buffer, sizeof(buffer));
-			}
-			add_assoc_string_ex(&tmp, ZEND_STRL("address"), buffer);
+/* {{{ proto void uv_async_send(resource $handle)
+*/
+PHP_FUNCTION(uv_async_send)
+{
+	php_uv_t *uv;
 
-			add_next_index_zval(return_value, &tmp);
-		}
-		uv_free_interface_addresses(interfaces, count);
-	}
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		UV_PARAM_OBJ(uv, php_uv_t, uv_async_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+	uv_async_send(&uv->uv.async);
+	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_async_send, uv);
 }
 /* }}} */
 
-/* {{{ proto resource uv_spawn(resource $loop, string $command, array $args, array $stdio, string $cwd, array $env = array(), callable $callback [,long $flags, array $options])
+/* {{{ proto UVPromise uv_queue_work(resource $loop, callable $callback[, callable $after_callback])
 */
-PHP_FUNCTION(uv_spawn)
+PHP_FUNCTION(uv_queue_work)
 {
+#ifdef ZTS
+	int r;
 	php_uv_loop_t *loop;
-	uv_process_options_t options = {0};
-	uv_stdio_container_t *stdio = NULL;
-	php_uv_t *proc;
-	zval *args, *env, *zoptions = NULL, *zstdio = NULL, *value;
-	char **command_args, **zenv;
-	zend_string *command, *cwd;
-	int uid = 0, gid = 0, stdio_count = 0, ret;
-	zend_long flags = 0;
-	zend_fcall_info fci       = empty_fcall_info;
-	zend_fcall_info_cache fcc = empty_fcall_info_cache;
-	php_uv_cb_t *cb;
+	php_uv_t *uv;
+	zend_fcall_info work_fci, after_fci       = empty_fcall_info;
+	zend_fcall_info_cache work_fcc, after_fcc = empty_fcall_info_cache;
+	php_uv_cb_t *work_cb, *after_cb;
 
-	ZEND_PARSE_PARAMETERS_START(7, 9)
+	ZEND_PARSE_PARAMETERS_START(2, 3)
 		UV_PARAM_OBJ(loop, php_uv_loop_t, uv_loop_ce)
-		Z_PARAM_STR(command)
-		Z_PARAM_ARRAY(args)
-		Z_PARAM_ARRAY(zstdio)
-		Z_PARAM_STR(cwd)
-		Z_PARAM_ARRAY(env)
-		Z_PARAM_FUNC(fci, fcc)
+		Z_PARAM_FUNC(work_fci, work_fcc)
 		Z_PARAM_OPTIONAL
-		Z_PARAM_LONG(flags)
-		Z_PARAM_ARRAY(zoptions)
+		Z_PARAM_FUNC_EX(after_fci, after_fcc, 1, 0)
 	ZEND_PARSE_PARAMETERS_END();
 
-	memset(&options, 0, sizeof(uv_process_options_t));
+	PHP_UV_INIT_UV(uv, uv_work_ce);
 
-	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+	php_uv_cb_init(&work_cb, uv, &work_fci, &work_fcc, PHP_UV_WORK_CB);
+	php_uv_cb_init(&after_cb, uv, &after_fci, &after_fcc, PHP_UV_AFTER_WORK_CB);
+	uv->await_type = PHP_UV_AFTER_WORK_CB;
 
-	{/* process stdio */
-		HashTable *stdio_container;
-		int x = 0;
+	r = uv_queue_work(&loop->loop, &uv->uv.work, php_uv_work_cb, php_uv_after_work_cb);
 
-		stdio_container = Z_ARRVAL_P(zstdio);
-		stdio_count = zend_hash_num_elements(stdio_container);
+	if (r) {
+		php_error_docref(NULL, E_ERROR, "uv_queue_work failed");
+		PHP_UV_DEINIT_UV(uv);
+		return;
+	}
 
-		stdio = emalloc(sizeof(uv_stdio_container_t) * stdio_count);
+	if (!ZEND_FCI_INITIALIZED(after_fci)) {
+		php_uv_promise_attach(uv, return_value);
+	}
+#else
+	php_error_docref(NULL, E_ERROR, "this PHP doesn't support this uv_queue_work. please rebuild with --enable-maintainer-zts");
+#endif
+}
+/* }}} */
 
-		ZEND_HASH_FOREACH_VAL(stdio_container, value) {
-			php_uv_stdio_t *stdio_tmp;
+#ifdef ZTS
+static void php_uv_runtime_stop_cb(uv_async_t *handle)
+{
+	php_uv_worker_t *worker = PHP_UV_CONTAINER_OF(handle, php_uv_worker_t, stop);
 
-			if (Z_TYPE_P(value) != IS_OBJECT || Z_OBJCE_P(value) != uv_stdio_ce) {
-				php_error_docref(NULL, E_ERROR, "must be instance of UVStdio");
-			}
+	worker->stopping = 1;
+	uv_stop(handle->loop);
+}
 
-			stdio_tmp = (php_uv_stdio_t *) Z_OBJ_P(value);
+static void php_uv_runtime_stop_dispose(php_uv_internal_t *internal)
+{
+	php_uv_worker_t *worker = PHP_UV_CONTAINER_OF(internal, php_uv_worker_t, internal);
 
-			stdio[x].flags = stdio_tmp->flags;
+	uv_mutex_lock(&worker->shared->lock);
+	worker->alive = 0;
+	uv_mutex_unlock(&worker->shared->lock);
 
-			if (stdio_tmp->flags & UV_INHERIT_FD) {
-				stdio[x].data.fd = stdio_tmp->fd;
-			} else if (stdio_tmp->flags & (UV_CREATE_PIPE | UV_INHERIT_STREAM)) {
-				php_uv_t *uv_pipe = (php_uv_t *) Z_OBJ(stdio_tmp->stream);
-				stdio[x].data.stream = &uv_pipe->uv.stream;
-			} else {
-				php_error_docref(NULL, E_WARNING, "passes unexpected stdio flags");
-				RETURN_FALSE;
-			}
+	uv_close((uv_handle_t *) &worker->stop, NULL);
+}
 
-			x++;
-		} ZEND_HASH_FOREACH_END();
+static void php_uv_runtime_exited(php_uv_worker_t *worker)
+{
+	uv_mutex_lock(&worker->shared->lock);
+	worker->exited = 1;
+	uv_mutex_unlock(&worker->shared->lock);
+}
+
+/* thread body: a request of its own, the bootstrap script, then the default loop until it runs out of work or is stopped */
+static void php_uv_runtime_worker(void *arg)
+{
+	php_uv_worker_t *worker = (php_uv_worker_t *) arg;
+	php_uv_runtime_shared_t *shared = worker->shared;
+	php_uv_loop_t *loop;
+	zend_file_handle file_handle;
+	void *tsrm_ls, *old;
+	int executed;
+
+	tsrm_ls = tsrm_new_interpreter_context();
+	old = tsrm_set_interpreter_context(tsrm_ls);
+
+	PG(expose_php) = 0;
+	PG(auto_globals_jit) = 0;
+
+	if (php_request_startup() == FAILURE) {
+		tsrm_set_interpreter_context(old);
+		tsrm_free_interpreter_context(tsrm_ls);
+		php_uv_runtime_exited(worker);
+		uv_sem_post(&shared->ready);
+		return;
 	}
+	EG(current_execute_data) = NULL;
+	EG(current_module) = phpext_uv_ptr;
+	UV_G(worker) = worker;
 
-	{
-		HashTable *h;
-		zval *value;
-		int n = 0;
-		int hash_len = 0;
+	loop = php_uv_default_loop();
+	uv_async_init(&loop->loop, &worker->stop, php_uv_runtime_stop_cb);
+	uv_unref((uv_handle_t *) &worker->stop);
+	PHP_UV_INTERNAL_INIT(&worker->internal, php_uv_runtime_stop_dispose);
+	worker->stop.data = &worker->internal;
 
-		h = Z_ARRVAL_P(args);
+	uv_mutex_lock(&shared->lock);
+	worker->alive = 1;
+	uv_mutex_unlock(&shared->lock);
+	uv_sem_post(&shared->ready);
 
-		hash_len = zend_hash_num_elements(h);
+	memset(&file_handle, 0, sizeof(file_handle));
+	file_handle.type = ZEND_HANDLE_FILENAME;
+	file_handle.filename = shared->bootstrap;
 
-		command_args = ecalloc(hash_len+2, sizeof(char**));
-		command_args[n] = command->val;
+	executed = php_execute_script(&file_handle);
+	if (executed && !worker->stopping) {
+		uv_run(&loop->loop, UV_RUN_DEFAULT);
+	}
 
-		n++;
-		ZEND_HASH_FOREACH_VAL(h, value) {
-			command_args[n] = Z_STRVAL_P(value);
-			n++;
-		} ZEND_HASH_FOREACH_END();
+	/* RSHUTDOWN closes the stop handle with the rest of the loop */
+	php_request_shutdown(NULL);
+	tsrm_set_interpreter_context(old);
+	tsrm_free_interpreter_context(tsrm_ls);
+	php_uv_runtime_exited(worker);
+}
 
-		command_args[n] = NULL;
+static void php_uv_runtime_stop(php_uv_runtime_shared_t *shared)
+{
+	uint32_t i;
+
+	uv_mutex_lock(&shared->lock);
+	for (i = 0; i < shared->started; i++) {
+		if (shared->workers[i].alive) {
+			uv_async_send(&shared->workers[i].stop);
+		}
 	}
+	uv_mutex_unlock(&shared->lock);
+}
 
-	{ /* env */
-		HashTable *tmp_env;
-		zend_string *key;
-		int i = 0;
-		zval *value;
+static void php_uv_runtime_join(php_uv_runtime_shared_t *shared)
+{
+	uint32_t i;
 
-		tmp_env = Z_ARRVAL_P(env);
+	if (shared->joined) {
+		return;
+	}
 
-		zenv = ecalloc(zend_hash_num_elements(tmp_env)+1, sizeof(char*));
-		ZEND_HASH_FOREACH_STR_KEY_VAL(tmp_env, key, value) {
-			char *tmp_env_entry;
+	for (i = 0; i < shared->started; i++) {
+		uv_thread_join(&shared->workers[i].thread);
+	}
+	shared->joined = 1;
+}
 
-			tmp_env_entry = emalloc(sizeof(char) * (key->len + 2 + Z_STRLEN_P(value)));
-			slprintf(tmp_env_entry, key->len + 1 + Z_STRLEN_P(value), "%s=%s", key->val, Z_STRVAL_P(value));
+/* whether all workers are past their last access to the runtime, so joining them does not block */
+static zend_bool php_uv_runtime_exited_all(php_uv_runtime_shared_t *shared)
+{
+	zend_bool exited = 1;
+	uint32_t i;
 
-			zenv[i++] = tmp_env_entry;
-		} ZEND_HASH_FOREACH_END();
-		zenv[i] = NULL;
+	uv_mutex_lock(&shared->lock);
+	for (i = 0; i < shared->started && exited; i++) {
+		exited = shared->workers[i].exited;
 	}
+	uv_mutex_unlock(&shared->lock);
 
-	if (zoptions != NULL && Z_TYPE_P(zoptions) != IS_NULL){
-		HashTable *opts;
-		zval *data;
+	return exited;
+}
 
-		opts = Z_ARRVAL_P(zoptions);
+static void php_uv_runtime_shared_free(php_uv_runtime_shared_t *shared)
+{
+	free(shared->workers);
+	free(shared->bootstrap);
+#ifndef PHP_WIN32
+	if (shared->listener_fd >= 0) {
+		close(shared->listener_fd);
+	}
+#endif
+	uv_sem_destroy(&shared->ready);
+	uv_mutex_destroy(&shared->lock);
+	free(shared);
+}
 
-		if ((data = zend_hash_str_find(opts, ZEND_STRL("uid")))) {
-			uid = Z_LVAL_P(data);
+/* the UVRuntime is gone but its workers still run: they are joined once they exited, at the latest on module shutdown */
+static void php_uv_runtime_orphan(php_uv_runtime_shared_t *shared)
+{
+	uv_mutex_lock(&php_uv_runtime_orphans_lock);
+	shared->next = php_uv_runtime_orphans;
+	php_uv_runtime_orphans = shared;
+	uv_mutex_unlock(&php_uv_runtime_orphans_lock);
+}
+
+/* joins the orphaned runtimes whose workers exited, or all of them when wait is set */
+static void php_uv_runtime_reap(zend_bool wait)
+{
+	php_uv_runtime_shared_t **link, *shared;
+
+	uv_mutex_lock(&php_uv_runtime_orphans_lock);
+	link = &php_uv_runtime_orphans;
+	while ((shared = *link) != NULL) {
+		if (wait || php_uv_runtime_exited_all(shared)) {
+			*link = shared->next;
+			php_uv_runtime_join(shared);
+			php_uv_runtime_shared_free(shared);
+		} else {
+			link = &shared->next;
 		}
+	}
+	uv_mutex_unlock(&php_uv_runtime_orphans_lock);
+}
+#endif
 
-		if ((data = zend_hash_str_find(opts, ZEND_STRL("gid")))) {
-			gid = Z_LVAL_P(data);
+/* never blocks: workers which were not joined yet are asked to stop and joined later, see php_uv_runtime_reap() */
+void static free_uv_runtime(zend_object *obj)
+{
+	php_uv_runtime_t *runtime = (php_uv_runtime_t *) obj;
+
+#ifdef ZTS
+	if (runtime->shared) {
+		if (runtime->shared->joined) {
+			php_uv_runtime_shared_free(runtime->shared);
+		} else {
+			php_uv_runtime_stop(runtime->shared);
+			php_uv_runtime_orphan(runtime->shared);
 		}
+		runtime->shared = NULL;
 	}
+#endif
 
-	options.file    = command->val;
-	options.stdio   = stdio;
-	options.exit_cb = php_uv_process_close_cb;
-	options.env     = zenv;
-	options.args    = command_args;
-	options.cwd     = cwd->val;
-	options.stdio   = stdio;
-	options.stdio_count = stdio_count;
-	options.flags = flags;
-	options.uid = uid;
-	options.gid = gid;
+	zend_object_std_dtor(obj);
+}
 
-	PHP_UV_INIT_UV(proc, uv_process_ce);
+/* {{{ proto UVRuntime uv_runtime_new(long $workers, string $bootstrap[, UVTcp $listener])
+*/
+PHP_FUNCTION(uv_runtime_new)
+{
+#ifdef ZTS
+	zend_long workers;
+	zend_string *bootstrap;
+	php_uv_t *listener = NULL;
+	php_uv_runtime_t *runtime;
+	php_uv_runtime_shared_t *shared;
+	uv_os_fd_t fd;
+	int listener_fd = -1;
+	uint32_t i;
+	int r;
 
-	ret = uv_spawn(&loop->loop, &proc->uv.process, &options);
+	ZEND_PARSE_PARAMETERS_START(2, 3)
+		Z_PARAM_LONG(workers)
+		Z_PARAM_PATH_STR(bootstrap)
+		Z_PARAM_OPTIONAL
+		UV_PARAM_OBJ_NULL(listener, php_uv_t, uv_tcp_ce)
+	ZEND_PARSE_PARAMETERS_END();
 
-	if (ret) {
-		PHP_UV_DEINIT_UV(proc);
-		RETVAL_LONG(ret);
-	} else {
-		php_uv_cb_init(&cb, proc, &fci, &fcc, PHP_UV_PROC_CLOSE_CB);
-		++GC_REFCOUNT(&proc->std);
-		PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_spawn, proc);
-		RETVAL_OBJ(&proc->std);
+	if (workers < 1 || workers > PHP_UV_RUNTIME_MAX_WORKERS) {
+		php_error_docref(NULL, E_WARNING, "workers must be between 1 and %d", PHP_UV_RUNTIME_MAX_WORKERS);
+		RETURN_FALSE;
 	}
 
-	if (zenv != NULL) {
-		char **p = zenv;
-		while(*p != NULL) {
-			efree(*p);
-			p++;
+	if (listener) {
+#ifdef PHP_WIN32
+		php_error_docref(NULL, E_WARNING, "sharing a listener between workers is not supported on this platform");
+		RETURN_FALSE;
+#else
+		if (uv_fileno(&listener->uv.handle, &fd) != 0) {
+			php_error_docref(NULL, E_WARNING, "the listener has to be bound first");
+			RETURN_FALSE;
 		}
-		efree(zenv);
+		/* connections queue up from now on, until a worker calls uv_listen() */
+		if (listen(fd, SOMAXCONN) != 0) {
+			php_error_docref(NULL, E_WARNING, "listen failed: %s", php_uv_strerror(-errno));
+			RETURN_FALSE;
+		}
+		/* the workers' own reference on the socket, the UVTcp may be closed before they are done */
+		listener_fd = dup(fd);
+		if (listener_fd < 0) {
+			php_error_docref(NULL, E_WARNING, "dup failed: %s", php_uv_strerror(-errno));
+			RETURN_FALSE;
+		}
+#endif
 	}
-	if (command_args != NULL) {
-		efree(command_args);
+
+	shared = calloc(1, sizeof(php_uv_runtime_shared_t));
+	shared->workers = calloc(workers, sizeof(php_uv_worker_t));
+	shared->bootstrap = malloc(ZSTR_LEN(bootstrap) + 1);
+	memcpy(shared->bootstrap, ZSTR_VAL(bootstrap), ZSTR_LEN(bootstrap) + 1);
+	shared->listener_fd = listener_fd;
+	uv_mutex_init(&shared->lock);
+	uv_sem_init(&shared->ready, 0);
+
+	object_init_ex(return_value, uv_runtime_ce);
+	runtime = (php_uv_runtime_t *) Z_OBJ_P(return_value);
+	runtime->shared = shared;
+
+	for (i = 0; i < workers; i++) {
+		shared->workers[i].shared = shared;
+		shared->workers[i].id = i;
+		r = uv_thread_create(&shared->workers[i].thread, php_uv_runtime_worker, &shared->workers[i]);
+		if (r) {
+			php_error_docref(NULL, E_WARNING, "uv_thread_create failed: %s", php_uv_strerror(r));
+			break;
+		}
+		shared->started++;
 	}
 
-	if (stdio != NULL) {
-		efree(stdio);
+	/* every started worker has its stop handle set up (or gave up) before we return */
+	for (i = 0; i < shared->started; i++) {
+		uv_sem_wait(&shared->ready);
+	}
+
+	if (shared->started < workers) {
+		php_uv_runtime_stop(shared);
+		php_uv_runtime_join(shared);
+		zval_ptr_dtor(return_value);
+		RETURN_FALSE;
 	}
+#else
+	php_error_docref(NULL, E_WARNING, "this PHP doesn't support uv_runtime_new. please rebuild with --enable-maintainer-zts");
+	RETURN_FALSE;
+#endif
 }
 /* }}} */
 
-
-/* {{{ proto void uv_process_kill(resource $handle, long $signal)
+/* {{{ proto void uv_runtime_stop(UVRuntime $runtime)
 */
-PHP_FUNCTION(uv_process_kill)
+PHP_FUNCTION(uv_runtime_stop)
 {
-	php_uv_t *uv;
-	zend_long signal;
+	php_uv_runtime_t *runtime;
 
-	ZEND_PARSE_PARAMETERS_START(2, 2)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_process_ce)
-		Z_PARAM_LONG(signal)
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		UV_PARAM_OBJ(runtime, php_uv_runtime_t, uv_runtime_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+#ifdef ZTS
+	php_uv_runtime_stop(runtime->shared);
+#endif
+}
+/* }}} */
+
+/* {{{ proto void uv_runtime_join(UVRuntime $runtime)
+*/
+PHP_FUNCTION(uv_runtime_join)
+{
+	php_uv_runtime_t *runtime;
+
+	ZEND_PARSE_PARAMETERS_START(1, 1)
+		UV_PARAM_OBJ(runtime, php_uv_runtime_t, uv_runtime_ce)
 	ZEND_PARSE_PARAMETERS_END();
 
-	uv_process_kill(&uv->uv.process, signal);
+#ifdef ZTS
+	php_uv_runtime_join(runtime->shared);
+#endif
 }
 /* }}} */
 
-/* {{{ proto void uv_kill(long $pid, long $signal)
+/* {{{ proto long|null uv_runtime_worker_id(void)
 */
-PHP_FUNCTION(uv_kill)
+PHP_FUNCTION(uv_runtime_worker_id)
 {
-	zend_long pid, signal;
-
-	if (zend_parse_parameters(ZEND_NUM_ARGS(),
-		"ll", &pid, &signal) == FAILURE) {
+	if (zend_parse_parameters_none() == FAILURE) {
 		return;
 	}
-	uv_kill(pid, signal);
+
+	if (UV_G(worker)) {
+		RETURN_LONG(UV_G(worker)->id);
+	}
+	RETURN_NULL();
 }
 /* }}} */
 
-/* {{{ proto bool uv_chdir(string $directory)
+/* {{{ proto UVTcp|null uv_runtime_listener(void)
 */
-PHP_FUNCTION(uv_chdir)
+PHP_FUNCTION(uv_runtime_listener)
 {
-	int error;
-	zend_string *directory;
+#ifndef PHP_WIN32
+	php_uv_loop_t *loop = NULL;
+	php_uv_worker_t *worker = UV_G(worker);
+	php_uv_t *uv;
+	int fd, r;
 
-	if (zend_parse_parameters(ZEND_NUM_ARGS(),
-		"S", &directory) == FAILURE) {
+	if (zend_parse_parameters_none() == FAILURE) {
 		return;
 	}
-	error = uv_chdir(directory->val);
-	if (error == 0) {
-		RETURN_TRUE;
-	} else {
+
+	if (!worker || worker->shared->listener_fd < 0) {
+		RETURN_NULL();
+	}
+
+	fd = dup(worker->shared->listener_fd);
+	if (fd < 0) {
+		php_error_docref(NULL, E_WARNING, "dup failed: %s", php_uv_strerror(-errno));
 		RETURN_FALSE;
 	}
-}
-/* }}} */
 
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+	PHP_UV_INIT_UV_EX(uv, uv_tcp_ce, uv_tcp_init);
 
-/* {{{ proto resource uv_rwlock_init(void)
-*/
-PHP_FUNCTION(uv_rwlock_init)
-{
-	php_uv_lock_init(IS_UV_RWLOCK, INTERNAL_FUNCTION_PARAM_PASSTHRU);
-}
-/* }}} */
+	r = uv_tcp_open(&uv->uv.tcp, fd);
+	if (r) {
+		php_error_docref(NULL, E_WARNING, "uv_tcp_open failed: %s", php_uv_strerror(r));
+		close(fd);
+		php_uv_close(uv);
+		OBJ_RELEASE(&uv->std);
+		RETURN_FALSE;
+	}
 
-/* {{{ proto uv_rwlock_rdlock(resource $handle)
-*/
-PHP_FUNCTION(uv_rwlock_rdlock)
-{
-	php_uv_lock_lock(IS_UV_RWLOCK_RD, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	RETURN_OBJ(&uv->std);
+#else
+	RETURN_NULL();
+#endif
 }
 /* }}} */
 
-/* {{{ proto bool uv_rwlock_tryrdlock(resource $handle)
+/* {{{ proto UVFs uv_fs_open(resource $loop, string $path, long $flag, long $mode, callable $callback)
 */
-PHP_FUNCTION(uv_rwlock_tryrdlock)
+PHP_FUNCTION(uv_fs_open)
 {
-	php_uv_lock_trylock(IS_UV_RWLOCK_RD, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_OPEN, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_rwlock_rdunlock(resource $handle)
+
+/* {{{ proto UVFs uv_fs_read(resource $loop, zval $fd, long $offset, long $length, callable $callback)
 */
-PHP_FUNCTION(uv_rwlock_rdunlock)
+PHP_FUNCTION(uv_fs_read)
 {
-	php_uv_lock_unlock(IS_UV_RWLOCK_RD, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_READ, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto uv_rwlock_wrlock(resource $handle)
+
+/* {{{ proto UVFs uv_fs_close(resource $loop, zval $fd, callable $callback)
 */
-PHP_FUNCTION(uv_rwlock_wrlock)
+PHP_FUNCTION(uv_fs_close)
 {
-	php_uv_lock_lock(IS_UV_RWLOCK_WR, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_CLOSE, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto uv_rwlock_trywrlock(resource $handle)
+
+/* {{{ proto UVFs uv_fs_write(resource $loop, zval $fd, string $buffer, long $offset, callable $callback)
 */
-PHP_FUNCTION(uv_rwlock_trywrlock)
+PHP_FUNCTION(uv_fs_write)
 {
-	php_uv_lock_trylock(IS_UV_RWLOCK_WR, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_WRITE, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto uv_rwlock_wrunlock(resource $handle)
+/* {{{ proto UVFs uv_fs_writev(resource $loop, zval $fd, array $buffers, long $offset, callable $callback)
 */
-PHP_FUNCTION(uv_rwlock_wrunlock)
+PHP_FUNCTION(uv_fs_writev)
 {
-	php_uv_lock_unlock(IS_UV_RWLOCK_WR, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_WRITE, PHP_UV_FS_VECTORED, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto uv_lock uv_mutex_init(void)
+/* {{{ proto UVFs uv_fs_readv(resource $loop, zval $fd, long $offset, array $lengths, callable $callback)
 */
-PHP_FUNCTION(uv_mutex_init)
+PHP_FUNCTION(uv_fs_readv)
 {
-	php_uv_lock_init(IS_UV_MUTEX, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_READ, PHP_UV_FS_VECTORED, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_mutex_lock(uv_lock $lock)
+/* {{{ proto UVFs uv_fs_fsync(resource $loop, zval $fd, callable $callback)
 */
-PHP_FUNCTION(uv_mutex_lock)
+PHP_FUNCTION(uv_fs_fsync)
 {
-	php_uv_lock_lock(IS_UV_MUTEX, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_FSYNC, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto bool uv_mutex_trylock(uv_lock $lock)
+/* {{{ proto UVFs uv_fs_fdatasync(resource $loop, zval $fd, callable $callback)
 */
-PHP_FUNCTION(uv_mutex_trylock)
+PHP_FUNCTION(uv_fs_fdatasync)
 {
-	php_uv_lock_trylock(IS_UV_MUTEX, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_FDATASYNC, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ void uv_mutex_unlock(uv_lock $lock)
-
-##### *Description*
-
-unlock mutex
-
-##### *Parameters*
-
-*resource $handle*: uv resource handle (uv mutex)
-
-##### *Return Value*
-
-*void *:
-
-##### *Example*
-
+/* {{{ proto UVFs uv_fs_ftruncate(resource $loop, zval $fd, long $offset, callable $callback)
 */
-PHP_FUNCTION(uv_mutex_unlock)
+PHP_FUNCTION(uv_fs_ftruncate)
 {
-	php_uv_lock_unlock(IS_UV_MUTEX, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_FTRUNCATE, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto uv_lock uv_sem_init(long $value)
+/* {{{ proto UVFs uv_fs_mkdir(resource $loop, string $path, long $mode, callable $callback)
 */
-PHP_FUNCTION(uv_sem_init)
+PHP_FUNCTION(uv_fs_mkdir)
 {
-	php_uv_lock_init(IS_UV_SEMAPHORE, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_MKDIR, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_sem_post(uv_lock $sem)
+
+/* {{{ proto UVFs uv_fs_rmdir(resource $loop, string $path, callable $callback)
 */
-PHP_FUNCTION(uv_sem_post)
+PHP_FUNCTION(uv_fs_rmdir)
 {
-	php_uv_lock_lock(IS_UV_SEMAPHORE, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_RMDIR, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_sem_wait(uv_lock $sem)
+/* {{{ proto UVFs uv_fs_unlink(resource $loop, string $path, callable $callback)
 */
-PHP_FUNCTION(uv_sem_wait)
+PHP_FUNCTION(uv_fs_unlink)
 {
-	php_uv_lock_unlock(IS_UV_SEMAPHORE, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_UNLINK, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_sem_trywait(uv_lock $sem)
+/* {{{ proto UVFs uv_fs_rename(resource $loop, string $from, string $to, callable $callback)
 */
-PHP_FUNCTION(uv_sem_trywait)
+PHP_FUNCTION(uv_fs_rename)
 {
-	php_uv_lock_trylock(IS_UV_SEMAPHORE, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_RENAME, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto resource uv_prepare_init(resource $loop)
+/* {{{ proto UVFs uv_fs_utime(resource $loop, string $path, long $utime, long $atime, callable $callback)
 */
-PHP_FUNCTION(uv_prepare_init)
+PHP_FUNCTION(uv_fs_utime)
 {
-	php_uv_loop_t *loop = NULL;
-	php_uv_t *uv;
-
-	ZEND_PARSE_PARAMETERS_START(0, 1)
-		Z_PARAM_OPTIONAL
-		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
-	ZEND_PARSE_PARAMETERS_END();
-
-	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
-	PHP_UV_INIT_UV_EX(uv, uv_prepare_ce, uv_prepare_init);
-
-	RETURN_OBJ(&uv->std);
+	php_uv_fs_common(UV_FS_UTIME, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_prepare_start(resource $handle, callable $callback)
+/* {{{ proto UVFs uv_fs_futime(resource $loop, zval $fd, long $utime, long $atime callable $callback)
 */
-PHP_FUNCTION(uv_prepare_start)
+PHP_FUNCTION(uv_fs_futime)
 {
-	php_uv_t *uv;
-	int r;
-	zend_fcall_info fci       = empty_fcall_info;
-	zend_fcall_info_cache fcc = empty_fcall_info_cache;
-	php_uv_cb_t *cb;
-
-	PHP_UV_DEBUG_PRINT("uv_prepare_start\n");
-
-	ZEND_PARSE_PARAMETERS_START(2, 2)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_prepare_ce)
-		Z_PARAM_FUNC(fci, fcc)
-	ZEND_PARSE_PARAMETERS_END();
-
-	if (uv_is_active(&uv->uv.handle)) {
-		php_error_docref(NULL, E_WARNING, "passed uv_prepare resource has been started.");
-		RETURN_FALSE;
-	}
-
-	GC_REFCOUNT(&uv->std)++;
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_prepare_start, uv);
-
-	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_PREPARE_CB);
-	r = uv_prepare_start(&uv->uv.prepare, php_uv_prepare_cb);
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_prepare_start, uv);
-
-	RETURN_LONG(r);
+	php_uv_fs_common(UV_FS_FUTIME, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_prepare_stop(resource $handle)
+/* {{{ proto UVFs uv_fs_chmod(resource $loop, string $path, long $mode, callable $callback)
 */
-PHP_FUNCTION(uv_prepare_stop)
+PHP_FUNCTION(uv_fs_chmod)
 {
-	php_uv_t *uv;
-	int r = 0;
-
-	ZEND_PARSE_PARAMETERS_START(1, 1)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_prepare_ce)
-	ZEND_PARSE_PARAMETERS_END();
-
-	if (!uv_is_active(&uv->uv.handle)) {
-		php_error_docref(NULL, E_NOTICE, "passed uv_prepare resource has been stopped.");
-		RETURN_FALSE;
-	}
-
-	r = uv_prepare_stop(&uv->uv.prepare);
-
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_prepare_stop, uv);
-	OBJ_RELEASE(&uv->std);
-
-	RETURN_LONG(r);
+	php_uv_fs_common(UV_FS_CHMOD, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto resoruce uv_check_init([resource $loop])
+
+/* {{{ proto UVFs uv_fs_fchmod(resource $loop, zval $fd, long $mode, callable $callback)
 */
-PHP_FUNCTION(uv_check_init)
+PHP_FUNCTION(uv_fs_fchmod)
 {
-	php_uv_loop_t *loop = NULL;
-	php_uv_t *uv;
-
-	ZEND_PARSE_PARAMETERS_START(0, 1)
-		Z_PARAM_OPTIONAL
-		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
-	ZEND_PARSE_PARAMETERS_END();
-
-	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
-	PHP_UV_INIT_UV_EX(uv, uv_check_ce, uv_check_init);
-
-	RETURN_OBJ(&uv->std);
+	php_uv_fs_common(UV_FS_FCHMOD, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_check_start(resource $handle, callable $callback)
+
+/* {{{ proto UVFs uv_fs_chown(resource $loop, string $path, long $uid, long $gid, callable $callback)
 */
-PHP_FUNCTION(uv_check_start)
+PHP_FUNCTION(uv_fs_chown)
 {
-	php_uv_t *uv;
-	int r;
-	zend_fcall_info fci       = empty_fcall_info;
-	zend_fcall_info_cache fcc = empty_fcall_info_cache;
-	php_uv_cb_t *cb;
-
-	PHP_UV_DEBUG_PRINT("uv_check_start");
-
-	ZEND_PARSE_PARAMETERS_START(2, 2)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_check_ce)
-		Z_PARAM_FUNC(fci, fcc)
-	ZEND_PARSE_PARAMETERS_END();
-
-	if (uv_is_active(&uv->uv.handle)) {
-		php_error_docref(NULL, E_WARNING, "passed uv check resource has already started");
-		RETURN_FALSE;
-	}
-
-	GC_REFCOUNT(&uv->std)++;
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_check_start, uv);
-
-	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_CHECK_CB);
-
-	r = uv_check_start(&uv->uv.check, php_uv_check_cb);
-
-	RETURN_LONG(r);
+	php_uv_fs_common(UV_FS_CHOWN, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_check_stop(resource $handle)
+/* {{{ proto UVFs uv_fs_fchown(resource $loop, zval $fd, long $uid, $long $gid, callable $callback)
 */
-PHP_FUNCTION(uv_check_stop)
+PHP_FUNCTION(uv_fs_fchown)
 {
-	php_uv_t *uv;
-
-	ZEND_PARSE_PARAMETERS_START(1, 1)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_check_ce)
-	ZEND_PARSE_PARAMETERS_END();
-
-	if (!uv_is_active(&uv->uv.handle)) {
-		php_error_docref(NULL, E_NOTICE, "passed uv_check resource hasn't start yet.");
-		RETURN_FALSE;
-	}
-
-	uv_check_stop(&uv->uv.check);
-
-	PHP_UV_DEBUG_OBJ_DEL_REFCOUNT(uv_check_stop, uv);
-	OBJ_RELEASE(&uv->std);
+	php_uv_fs_common(UV_FS_FCHOWN, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
+	
+/* {{{ proto UVFs uv_fs_link(resource $loop, string $from, string $to, callable $callback)
+*/
+PHP_FUNCTION(uv_fs_link)
+{
+	php_uv_fs_common(UV_FS_LINK, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
 
-/* {{{ proto resource uv_async_init(resource $loop, callable $callback)
+/* {{{ proto UVFs uv_fs_symlink(resource $loop, string $from, string $to, long $flags, callable $callback)
 */
-PHP_FUNCTION(uv_async_init)
+PHP_FUNCTION(uv_fs_symlink)
 {
-	php_uv_loop_t *loop;
-	php_uv_t *uv;
-	zend_fcall_info fci       = empty_fcall_info;
-	zend_fcall_info_cache fcc = empty_fcall_info_cache;
-	php_uv_cb_t *cb;
-
-	ZEND_PARSE_PARAMETERS_START(2, 2)
-		UV_PARAM_OBJ(loop, php_uv_loop_t, uv_loop_ce)
-		Z_PARAM_FUNC(fci, fcc)
-	ZEND_PARSE_PARAMETERS_END();
-
-	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
-	PHP_UV_INIT_UV_EX(uv, uv_async_ce, uv_async_init, php_uv_async_cb);
-
-	php_uv_cb_init(&cb, uv, &fci, &fcc, PHP_UV_ASYNC_CB);
-
-	RETURN_OBJ(&uv->std);
+	php_uv_fs_common(UV_FS_SYMLINK, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_async_send(resource $handle)
+/* {{{ proto UVFs uv_fs_readlink(resource $loop, string $path, callable $callback)
 */
-PHP_FUNCTION(uv_async_send)
+PHP_FUNCTION(uv_fs_readlink)
 {
-	php_uv_t *uv;
-
-	ZEND_PARSE_PARAMETERS_START(1, 1)
-		UV_PARAM_OBJ(uv, php_uv_t, uv_async_ce)
-	ZEND_PARSE_PARAMETERS_END();
-
-	uv_async_send(&uv->uv.async);
-	PHP_UV_DEBUG_OBJ_ADD_REFCOUNT(uv_async_send, uv);
+	php_uv_fs_common(UV_FS_READLINK, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_queue_work(resource $loop, callable $callback, callable $after_callback)
+/* {{{ proto UVFs uv_fs_stat(resource $loop, string $path, callable $callback)
 */
-PHP_FUNCTION(uv_queue_work)
+PHP_FUNCTION(uv_fs_stat)
 {
-#ifdef ZTS
-	int r;
-	php_uv_loop_t *loop;
-	php_uv_t *uv;
-	zend_fcall_info work_fci, after_fci       = empty_fcall_info;
-	zend_fcall_info_cache work_fcc, after_fcc = empty_fcall_info_cache;
-	php_uv_cb_t *work_cb, *after_cb;
+	php_uv_fs_common(UV_FS_STAT, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
 
-	ZEND_PARSE_PARAMETERS_START(3, 3)
-		UV_PARAM_OBJ(loop, php_uv_loop_t, uv_loop_ce)
-		Z_PARAM_FUNC(work_fci, work_fcc)
-		Z_PARAM_FUNC(after_fci, after_fcc)
-	ZEND_PARSE_PARAMETERS_END();
+/* {{{ proto UVFs uv_fs_lstat(resource $loop, string $path, callable $callback)
+*/
+PHP_FUNCTION(uv_fs_lstat)
+{
+	php_uv_fs_common(UV_FS_LSTAT, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
 
-	PHP_UV_INIT_UV(uv, uv_work_ce);
+/* {{{ proto UVFs uv_fs_fstat(resource $loop, zval $fd, callable $callback)
+*/
+PHP_FUNCTION(uv_fs_fstat)
+{
+	php_uv_fs_common(UV_FS_FSTAT, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
 
-	php_uv_cb_init(&work_cb, uv, &work_fci, &work_fcc, PHP_UV_WORK_CB);
-	php_uv_cb_init(&after_cb, uv, &after_fci, &after_fcc, PHP_UV_AFTER_WORK_CB);
 
-	r = uv_queue_work(&loop->loop, &uv->uv.work, php_uv_work_cb, php_uv_after_work_cb);
+/* {{{ proto UVFs uv_fs_readdir(resource $loop, string $path, long $flags, callable $callback)
+*/
+PHP_FUNCTION(uv_fs_readdir)
+{
+	php_uv_fs_common(UV_FS_SCANDIR, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
 
-	if (r) {
-		php_error_docref(NULL, E_ERROR, "uv_queue_work failed");
-		PHP_UV_DEINIT_UV(uv);
-		return;
-	}
-#else
-	php_error_docref(NULL, E_ERROR, "this PHP doesn't support this uv_queue_work. please rebuild with --enable-maintainer-zts");
-#endif
+/* {{{ proto UVFs uv_fs_scandir(resource $loop, string $path, long $flags, callable $callback)
+ *  */
+PHP_FUNCTION(uv_fs_scandir)
+{
+    php_uv_fs_common(UV_FS_SCANDIR, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto resource uv_fs_open(resource $loop, string $path, long $flag, long $mode, callable $callback)
+/* {{{ proto UVFs uv_fs_sendfile(resource $loop, zval $in_fd, zval $out_fd, long $offset, long $length, callable $callback)
 */
-PHP_FUNCTION(uv_fs_open)
+PHP_FUNCTION(uv_fs_sendfile)
 {
-	php_uv_fs_common(UV_FS_OPEN, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_SENDFILE, 0, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-
-/* {{{ proto void uv_fs_read(resource $loop, zval $fd, long $offset, long $length, callable $callback)
+/* {{{ proto mixed uv_fs_open_sync(resource $loop, string $path, long $flag, long $mode)
 */
-PHP_FUNCTION(uv_fs_read)
+PHP_FUNCTION(uv_fs_open_sync)
 {
-	php_uv_fs_common(UV_FS_READ, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_OPEN, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-
-/* {{{ proto void uv_fs_close(resource $loop, zval $fd, callable $callback)
+/* {{{ proto mixed uv_fs_read_sync(resource $loop, zval $fd, long $offset, long $length)
 */
-PHP_FUNCTION(uv_fs_close)
+PHP_FUNCTION(uv_fs_read_sync)
 {
-	php_uv_fs_common(UV_FS_CLOSE, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_READ, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
+/* {{{ proto mixed uv_fs_write_sync(resource $loop, zval $fd, string $buffer, long $offset)
+*/
+PHP_FUNCTION(uv_fs_write_sync)
+{
+	php_uv_fs_common(UV_FS_WRITE, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
 
-/* {{{ proto void uv_fs_write(resource $loop, zval $fd, string $buffer, long $offset, callable $callback)
+/* {{{ proto mixed uv_fs_close_sync(resource $loop, zval $fd)
 */
-PHP_FUNCTION(uv_fs_write)
+PHP_FUNCTION(uv_fs_close_sync)
 {
-	php_uv_fs_common(UV_FS_WRITE, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_CLOSE, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_fs_fsync(resource $loop, zval $fd, callable $callback)
+/* {{{ proto mixed uv_fs_fsync_sync(resource $loop, zval $fd)
 */
-PHP_FUNCTION(uv_fs_fsync)
+PHP_FUNCTION(uv_fs_fsync_sync)
 {
-	php_uv_fs_common(UV_FS_FSYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_FSYNC, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_fs_fdatasync(resource $loop, zval $fd, callable $callback)
+/* {{{ proto mixed uv_fs_fdatasync_sync(resource $loop, zval $fd)
 */
-PHP_FUNCTION(uv_fs_fdatasync)
+PHP_FUNCTION(uv_fs_fdatasync_sync)
 {
-	php_uv_fs_common(UV_FS_FDATASYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_FDATASYNC, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_fs_ftruncate(resource $loop, zval $fd, long $offset, callable $callback)
+/* {{{ proto mixed uv_fs_ftruncate_sync(resource $loop, zval $fd, long $offset)
 */
-PHP_FUNCTION(uv_fs_ftruncate)
+PHP_FUNCTION(uv_fs_ftruncate_sync)
 {
-	php_uv_fs_common(UV_FS_FTRUNCATE, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_FTRUNCATE, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_fs_mkdir(resource $loop, string $path, long $mode, callable $callback)
+/* {{{ proto mixed uv_fs_mkdir_sync(resource $loop, string $path, long $mode)
 */
-PHP_FUNCTION(uv_fs_mkdir)
+PHP_FUNCTION(uv_fs_mkdir_sync)
 {
-	php_uv_fs_common(UV_FS_MKDIR, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_MKDIR, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
+/* {{{ proto mixed uv_fs_rmdir_sync(resource $loop, string $path)
+*/
+PHP_FUNCTION(uv_fs_rmdir_sync)
+{
+	php_uv_fs_common(UV_FS_RMDIR, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
 
-/* {{{ proto void uv_fs_rmdir(resource $loop, string $path, callable $callback)
+/* {{{ proto mixed uv_fs_unlink_sync(resource $loop, string $path)
 */
-PHP_FUNCTION(uv_fs_rmdir)
+PHP_FUNCTION(uv_fs_unlink_sync)
 {
-	php_uv_fs_common(UV_FS_RMDIR, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_UNLINK, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_fs_unlink(resource $loop, string $path, callable $callback)
+/* {{{ proto mixed uv_fs_rename_sync(resource $loop, string $from, string $to)
 */
-PHP_FUNCTION(uv_fs_unlink)
+PHP_FUNCTION(uv_fs_rename_sync)
 {
-	php_uv_fs_common(UV_FS_UNLINK, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_RENAME, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_fs_rename(resource $loop, string $from, string $to, callable $callback)
+/* {{{ proto mixed uv_fs_utime_sync(resource $loop, string $path, long $utime, long $atime)
 */
-PHP_FUNCTION(uv_fs_rename)
+PHP_FUNCTION(uv_fs_utime_sync)
 {
-	php_uv_fs_common(UV_FS_RENAME, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_UTIME, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_fs_utime(resource $loop, string $path, long $utime, long $atime, callable $callback)
+/* {{{ proto mixed uv_fs_futime_sync(resource $loop, zval $fd, long $utime, long $atime callable $callback)
 */
-PHP_FUNCTION(uv_fs_utime)
+PHP_FUNCTION(uv_fs_futime_sync)
 {
-	php_uv_fs_common(UV_FS_UTIME, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_FUTIME, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_fs_futime(resource $loop, zval $fd, long $utime, long $atime callable $callback)
+/* {{{ proto mixed uv_fs_chmod_sync(resource $loop, string $path, long $mode)
 */
-PHP_FUNCTION(uv_fs_futime)
+PHP_FUNCTION(uv_fs_chmod_sync)
 {
-	php_uv_fs_common(UV_FS_FUTIME, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_CHMOD, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_fs_chmod(resource $loop, string $path, long $mode, callable $callback)
+/* {{{ proto mixed uv_fs_fchmod_sync(resource $loop, zval $fd, long $mode)
 */
-PHP_FUNCTION(uv_fs_chmod)
+PHP_FUNCTION(uv_fs_fchmod_sync)
 {
-	php_uv_fs_common(UV_FS_CHMOD, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_FCHMOD, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
+/* {{{ proto mixed uv_fs_chown_sync(resource $loop, string $path, long $uid, long $gid)
+*/
+PHP_FUNCTION(uv_fs_chown_sync)
+{
+	php_uv_fs_common(UV_FS_CHOWN, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
 
-/* {{{ proto void uv_fs_fchmod(resource $loop, zval $fd, long $mode, callable $callback)
+/* {{{ proto mixed uv_fs_fchown_sync(resource $loop, zval $fd, long $uid, $long $gid)
 */
-PHP_FUNCTION(uv_fs_fchmod)
+PHP_FUNCTION(uv_fs_fchown_sync)
 {
-	php_uv_fs_common(UV_FS_FCHMOD, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_FCHOWN, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
+/* {{{ proto mixed uv_fs_link_sync(resource $loop, string $from, string $to)
+*/
+PHP_FUNCTION(uv_fs_link_sync)
+{
+	php_uv_fs_common(UV_FS_LINK, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
 
-/* {{{ proto void uv_fs_chown(resource $loop, string $path, long $uid, long $gid, callable $callback)
+/* {{{ proto mixed uv_fs_symlink_sync(resource $loop, string $from, string $to, long $flags)
 */
-PHP_FUNCTION(uv_fs_chown)
+PHP_FUNCTION(uv_fs_symlink_sync)
 {
-	php_uv_fs_common(UV_FS_CHOWN, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_SYMLINK, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_fs_fchown(resource $loop, zval $fd, long $uid, $long $gid, callable $callback)
+/* {{{ proto mixed uv_fs_readlink_sync(resource $loop, string $path)
 */
-PHP_FUNCTION(uv_fs_fchown)
+PHP_FUNCTION(uv_fs_readlink_sync)
 {
-	php_uv_fs_common(UV_FS_FCHOWN, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_READLINK, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
-	
-/* {{{ proto void uv_fs_link(resource $loop, string $from, string $to, callable $callback)
+
+/* {{{ proto mixed uv_fs_stat_sync(resource $loop, string $path)
 */
-PHP_FUNCTION(uv_fs_link)
+PHP_FUNCTION(uv_fs_stat_sync)
 {
-	php_uv_fs_common(UV_FS_LINK, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_STAT, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
+/* {{{ proto mixed uv_fs_lstat_sync(resource $loop, string $path)
+*/
+PHP_FUNCTION(uv_fs_lstat_sync)
+{
+	php_uv_fs_common(UV_FS_LSTAT, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+}
+/* }}} */
 
-/* {{{ proto void uv_fs_symlink(resource $loop, string $from, string $to, long $flags, callable $callback)
+/* {{{ proto mixed uv_fs_fstat_sync(resource $loop, zval $fd)
 */
-PHP_FUNCTION(uv_fs_symlink)
+PHP_FUNCTION(uv_fs_fstat_sync)
 {
-	php_uv_fs_common(UV_FS_SYMLINK, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_FSTAT, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_fs_readlink(resource $loop, string $path, callable $callback)
+/* {{{ proto mixed uv_fs_scandir_sync(resource $loop, string $path, long $flags)
 */
-PHP_FUNCTION(uv_fs_readlink)
+PHP_FUNCTION(uv_fs_scandir_sync)
 {
-	php_uv_fs_common(UV_FS_READLINK, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_SCANDIR, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_fs_stat(resource $loop, string $path, callable $callback)
+/* {{{ proto mixed uv_fs_sendfile_sync(resource $loop, zval $in_fd, zval $out_fd, long $offset, long $length)
 */
-PHP_FUNCTION(uv_fs_stat)
+PHP_FUNCTION(uv_fs_sendfile_sync)
 {
-	php_uv_fs_common(UV_FS_STAT, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_SENDFILE, PHP_UV_FS_SYNC, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_fs_lstat(resource $loop, string $path, callable $callback)
+/* {{{ proto mixed uv_fs_writev_sync(resource $loop, zval $fd, array $buffers, long $offset)
 */
-PHP_FUNCTION(uv_fs_lstat)
+PHP_FUNCTION(uv_fs_writev_sync)
 {
-	php_uv_fs_common(UV_FS_LSTAT, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_WRITE, PHP_UV_FS_SYNC | PHP_UV_FS_VECTORED, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
-/* {{{ proto void uv_fs_fstat(resource $loop, zval $fd, callable $callback)
+/* {{{ proto mixed uv_fs_readv_sync(resource $loop, zval $fd, long $offset, array $lengths)
 */
-PHP_FUNCTION(uv_fs_fstat)
+PHP_FUNCTION(uv_fs_readv_sync)
 {
-	php_uv_fs_common(UV_FS_FSTAT, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_fs_common(UV_FS_READ, PHP_UV_FS_SYNC | PHP_UV_FS_VECTORED, INTERNAL_FUNCTION_PARAM_PASSTHRU);
 }
 /* }}} */
 
+/* runs in the threadpool: no PHP memory or values may be touched here */
+static void php_uv_fs_file_work_cb(uv_work_t *req)
+{
+	php_uv_fs_file_t *file = PHP_UV_CONTAINER_OF(req, php_uv_fs_file_t, work);
+	uv_loop_t *loop = req->loop;
+	uv_fs_t fs;
+	uv_buf_t buf;
+	uv_file fd;
+	ssize_t r = 0;
+	size_t done = 0;
+
+	/* without a callback libuv runs each step in this thread */
+	fd = uv_fs_open(loop, &fs, ZSTR_VAL(file->path), file->flags, 0666, NULL);
+	uv_fs_req_cleanup(&fs);
+	if (fd < 0) {
+		file->result = fd;
+		return;
+	}
+
+	if (file->read) {
+		size_t size = 0;
+
+		if (uv_fs_fstat(loop, &fs, fd, NULL) == 0) {
+			size = (size_t) fs.statbuf.st_size;
+		}
+		uv_fs_req_cleanup(&fs);
+
+		/* one byte more to see the end of the file in the first read, files in /proc report no size at all */
+		file->len = size > 0 ? size + 1 : 4096;
+		file->buf = malloc(file->len);
+		while (file->buf != NULL) {
+			if (done == file->len) {
+				char *grown = realloc(file->buf, file->len * 2);
+
+				if (grown == NULL) {
+					break;
+				}
+				file->buf = grown;
+				file->len *= 2;
+			}
+			buf = uv_buf_init(file->buf + done, (unsigned int) MIN(file->len - done, UINT_MAX));
+			r = uv_fs_read(loop, &fs, fd, &buf, 1, -1, NULL);
+			uv_fs_req_cleanup(&fs);
+			if (r <= 0) {
+				break;
+			}
+			done += (size_t) r;
+		}
+		if (file->buf == NULL || (r > 0 && done == file->len)) {
+			r = UV_ENOMEM;
+		}
+	} else {
+		while (done < ZSTR_LEN(file->data)) {
+			buf = uv_buf_init(ZSTR_VAL(file->data) + done, (unsigned int) MIN(ZSTR_LEN(file->data) - done, UINT_MAX));
+			r = uv_fs_write(loop, &fs, fd, &buf, 1, -1, NULL);
+			uv_fs_req_cleanup(&fs);
+			if (r < 0) {
+				break;
+			}
+			done += (size_t) r;
+		}
+	}
+
+	file->result = r < 0 ? r : (ssize_t) done;
+
+	/* a write is only complete once the close succeeded */
+	r = uv_fs_close(loop, &fs, fd, NULL);
+	uv_fs_req_cleanup(&fs);
+	if (r < 0 && file->result >= 0) {
+		file->result = r;
+	}
+}
+
+static void php_uv_fs_file_after_work_cb(uv_work_t *req, int status)
+{
+	php_uv_fs_file_t *file = PHP_UV_CONTAINER_OF(req, php_uv_fs_file_t, work);
+	zval result, retval;
+	TSRMLS_FETCH_FROM_CTX(file->thread_ctx);
+	PHP_UV_CTX_ENTER();
+
+	if (status < 0) {
+		file->result = status;
+	}
+	if (file->result < 0) {
+		ZVAL_LONG(&result, file->result);
+	} else if (file->read) {
+		ZVAL_STRINGL(&result, file->buf, file->result);
+	} else {
+		ZVAL_LONG(&result, file->result);
+	}
+	free(file->buf);
+
+	if (file->callback) {
+		if (php_uv_dispatch(PHP_UV_CONTAINER_OF(req->loop, php_uv_loop_t, loop), NULL, file->callback, &retval, &result, 1) == SUCCESS) {
+			zval_ptr_dtor(&retval);
+		}
+		php_uv_cb_free(file->callback);
+	} else {
+		php_uv_promise_settle((php_uv_promise_t *) Z_OBJ(file->promise), file->result < 0 ? PHP_UV_PROMISE_REJECTED : PHP_UV_PROMISE_FULFILLED, &result);
+		zval_ptr_dtor(&file->promise);
+	}
+
+	zval_ptr_dtor(&result);
+	zend_string_release(file->path);
+	if (file->data) {
+		zend_string_release(file->data);
+	}
+	efree(file);
+
+	PHP_UV_CTX_LEAVE();
+}
+
+static void php_uv_fs_file(php_uv_loop_t *loop, zend_string *path, zend_string *data, zend_long flags, zend_fcall_info *fci, zend_fcall_info_cache *fcc, zval *return_value)
+{
+	php_uv_fs_file_t *file = emalloc(sizeof(php_uv_fs_file_t));
+	int r;
+
+	file->read = data == NULL;
+	file->path = zend_string_copy(path);
+	file->data = data ? zend_string_copy(data) : NULL;
+	file->flags = (int) flags;
+	file->buf = NULL;
+	file->len = 0;
+	file->result = 0;
+	file->callback = ZEND_FCI_INITIALIZED(*fci) ? php_uv_cb_init_dynamic(NULL, fci, fcc) : NULL;
+	ZVAL_UNDEF(&file->promise);
+	TSRMLS_SET_CTX(file->thread_ctx);
+
+	r = uv_queue_work(&loop->loop, &file->work, php_uv_fs_file_work_cb, php_uv_fs_file_after_work_cb);
+	if (r) {
+		php_error_docref(NULL, E_WARNING, "uv_queue_work failed: %s", uv_strerror(r));
+		if (file->callback) {
+			php_uv_cb_free(file->callback);
+		}
+		zend_string_release(file->path);
+		if (file->data) {
+			zend_string_release(file->data);
+		}
+		efree(file);
+		RETURN_FALSE;
+	}
 
-/* {{{ proto uv_fs_readdir(resource $loop, string $path, long $flags, callable $callback)
+	if (file->callback == NULL) {
+		object_init_ex(return_value, uv_promise_ce);
+		ZVAL_COPY(&file->promise, return_value);
+	} else {
+		RETURN_TRUE;
+	}
+}
+
+/* {{{ proto mixed uv_fs_read_file(UVLoop $loop, string $path[, callable $callback])
 */
-PHP_FUNCTION(uv_fs_readdir)
+PHP_FUNCTION(uv_fs_read_file)
+{
+	php_uv_loop_t *loop = NULL;
+	zend_string *path;
+	zend_fcall_info fci = empty_fcall_info;
+	zend_fcall_info_cache fcc = empty_fcall_info_cache;
+
+	ZEND_PARSE_PARAMETERS_START(2, 3)
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+		Z_PARAM_PATH_STR(path)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_FUNC_EX(fci, fcc, 1, 0)
+	ZEND_PARSE_PARAMETERS_END();
+
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+
+	php_uv_fs_file(loop, path, NULL, O_RDONLY, &fci, &fcc, return_value);
+}
+/* }}} */
+
+/* {{{ proto mixed uv_fs_write_file(UVLoop $loop, string $path, string $data[, long $flags = UV::O_WRONLY | UV::O_CREAT | UV::O_TRUNC, callable $callback])
+*/
+PHP_FUNCTION(uv_fs_write_file)
 {
-	php_uv_fs_common(UV_FS_SCANDIR, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_loop_t *loop = NULL;
+	zend_string *path, *data;
+	zend_long flags = O_WRONLY | O_CREAT | O_TRUNC;
+	zend_fcall_info fci = empty_fcall_info;
+	zend_fcall_info_cache fcc = empty_fcall_info_cache;
+
+	ZEND_PARSE_PARAMETERS_START(3, 5)
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+		Z_PARAM_PATH_STR(path)
+		Z_PARAM_STR(data)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_LONG(flags)
+		Z_PARAM_FUNC_EX(fci, fcc, 1, 0)
+	ZEND_PARSE_PARAMETERS_END();
+
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+
+	php_uv_fs_file(loop, path, data, flags, &fci, &fcc, return_value);
 }
 /* }}} */
 
-/* {{{ proto uv_fs_scandir(resource $loop, string $path, long $flags, callable $callback)
- *  */
-PHP_FUNCTION(uv_fs_scandir)
+/* {{{ proto bool uv_fs_stat_cache_enable(UVLoop $loop, long $ttl[, long $max_entries = 65536, long $max_watchers = 128])
+*/
+PHP_FUNCTION(uv_fs_stat_cache_enable)
 {
-    php_uv_fs_common(UV_FS_SCANDIR, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_loop_t *loop = NULL;
+	php_uv_stat_cache_t *cache;
+	zend_long ttl, max_entries = 65536, max_watchers = 128;
+
+	ZEND_PARSE_PARAMETERS_START(2, 4)
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+		Z_PARAM_LONG(ttl)
+		Z_PARAM_OPTIONAL
+		Z_PARAM_LONG(max_entries)
+		Z_PARAM_LONG(max_watchers)
+	ZEND_PARSE_PARAMETERS_END();
+
+	if (ttl < 0) {
+		php_error_docref(NULL, E_WARNING, "ttl must not be negative");
+		RETURN_FALSE;
+	}
+	if (max_entries < 1 || max_entries > UINT32_MAX) {
+		php_error_docref(NULL, E_WARNING, "max_entries must be between 1 and %u", UINT32_MAX);
+		RETURN_FALSE;
+	}
+	if (max_watchers < 0 || max_watchers > UINT32_MAX) {
+		php_error_docref(NULL, E_WARNING, "max_watchers must be between 0 and %u", UINT32_MAX);
+		RETURN_FALSE;
+	}
+
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+
+	cache = loop->stat_cache;
+	if (cache == NULL) {
+		if (ttl == 0) {
+			RETURN_TRUE;
+		}
+		cache = emalloc(sizeof(php_uv_stat_cache_t));
+		zend_hash_init(&cache->entries, 64, NULL, php_uv_stat_cache_entry_dtor, 0);
+		zend_hash_init(&cache->watches, 8, NULL, NULL, 0);
+		cache->epoch = 1;
+		cache->hits = 0;
+		cache->misses = 0;
+		cache->invalidations = 0;
+		loop->stat_cache = cache;
+	} else {
+		php_uv_stat_cache_clear(cache);
+	}
+
+	cache->ttl = (uint64_t) ttl * 1000000;
+	cache->max_entries = (uint32_t) max_entries;
+	cache->max_watches = (uint32_t) max_watchers;
+
+	RETURN_TRUE;
 }
 /* }}} */
 
-/* {{{ proto void uv_fs_sendfile(resource $loop, zval $in_fd, zval $out_fd, long $offset, long $length, callable $callback)
+/* {{{ proto array uv_fs_stat_cache_info([UVLoop $loop])
 */
-PHP_FUNCTION(uv_fs_sendfile)
+PHP_FUNCTION(uv_fs_stat_cache_info)
 {
-	php_uv_fs_common(UV_FS_SENDFILE, INTERNAL_FUNCTION_PARAM_PASSTHRU);
+	php_uv_loop_t *loop = NULL;
+	php_uv_stat_cache_t *cache;
+	php_uv_stat_watch_t *watch;
+	zend_long watchers = 0;
+
+	ZEND_PARSE_PARAMETERS_START(0, 1)
+		Z_PARAM_OPTIONAL
+		UV_PARAM_OBJ_NULL(loop, php_uv_loop_t, uv_loop_ce)
+	ZEND_PARSE_PARAMETERS_END();
+
+	PHP_UV_FETCH_UV_DEFAULT_LOOP(loop);
+
+	cache = loop->stat_cache;
+	array_init(return_value);
+	add_assoc_bool_ex(return_value, ZEND_STRL("enabled"), cache && cache->ttl > 0);
+	add_assoc_long_ex(return_value, ZEND_STRL("ttl"), cache ? (zend_long) (cache->ttl / 1000000) : 0);
+	add_assoc_long_ex(return_value, ZEND_STRL("entries"), cache ? zend_hash_num_elements(&cache->entries) : 0);
+	if (cache) {
+		ZEND_HASH_FOREACH_PTR(&cache->watches, watch) {
+			if (watch) {
+				watchers++;
+			}
+		} ZEND_HASH_FOREACH_END();
+	}
+	add_assoc_long_ex(return_value, ZEND_STRL("watchers"), watchers);
+	add_assoc_long_ex(return_value, ZEND_STRL("hits"), cache ? (zend_long) cache->hits : 0);
+	add_assoc_long_ex(return_value, ZEND_STRL("misses"), cache ? (zend_long) cache->misses : 0);
+	add_assoc_long_ex(return_value, ZEND_STRL("invalidations"), cache ? (zend_long) cache->invalidations : 0);
 }
 /* }}} */
 
@@ -6108,15 +11615,30 @@ static zend_function_entry uv_functions[] = {
 	PHP_FE(uv_default_loop,             NULL)
 	PHP_FE(uv_stop,                     arginfo_uv_stop)
 	PHP_FE(uv_run,                      arginfo_uv_run)
+	PHP_FE(uv_run_budget,               arginfo_uv_run_budget)
+	PHP_FE(uv_loop_metrics,             arginfo_uv_loop_metrics)
+	PHP_FE(uv_loop_watchdog,            arginfo_uv_loop_watchdog)
+	PHP_FE(uv_loop_watchdog_report,     arginfo_uv_loop_watchdog_report)
+	PHP_FE(uv_loop_gc_idle,             arginfo_uv_loop_gc_idle)
+	PHP_FE(uv_run_collect,              arginfo_uv_run_collect)
+	PHP_FE(uv_event_sink,               arginfo_uv_event_sink)
+	PHP_FE(uv_coroutine,                arginfo_uv_coroutine)
+	PHP_FE(uv_promise_then,             arginfo_uv_promise_then)
+	PHP_FE(uv_promise_all,              arginfo_uv_promise_all)
+	PHP_FE(uv_promise_race,             arginfo_uv_promise_race)
+	PHP_FE(uv_promise_timeout,          arginfo_uv_promise_timeout)
 	PHP_FE(uv_ip4_addr,                 arginfo_uv_ip4_addr)
 	PHP_FE(uv_ip6_addr,                 arginfo_uv_ip6_addr)
 	PHP_FE(uv_ip4_name,                 arginfo_uv_ip4_name)
 	PHP_FE(uv_ip6_name,                 arginfo_uv_ip6_name)
 	PHP_FE(uv_write,                    arginfo_uv_write)
 	PHP_FE(uv_write2,                   arginfo_uv_write2)
+	PHP_FE(uv_stream_set_timeouts,      arginfo_uv_stream_set_timeouts)
 	PHP_FE(uv_shutdown,                 arginfo_uv_shutdown)
 	PHP_FE(uv_close,                    arginfo_uv_close)
 	PHP_FE(uv_now,                      arginfo_uv_now)
+	PHP_FE(uv_backend_fd,               arginfo_uv_backend_fd)
+	PHP_FE(uv_backend_timeout,          arginfo_uv_backend_timeout)
 	PHP_FE(uv_loop_delete,              arginfo_uv_loop_delete)
 	PHP_FE(uv_read_start,               arginfo_uv_read_start)
 	PHP_FE(uv_read2_start,              arginfo_uv_read2_start)
@@ -6140,6 +11662,14 @@ static zend_function_entry uv_functions[] = {
 	PHP_FE(uv_timer_again,              arginfo_uv_timer_again)
 	PHP_FE(uv_timer_set_repeat,         arginfo_uv_timer_set_repeat)
 	PHP_FE(uv_timer_get_repeat,         arginfo_uv_timer_get_repeat)
+	PHP_FE(uv_timer_wheel_new,          arginfo_uv_timer_wheel_new)
+	PHP_FE(uv_timer_wheel_add,          arginfo_uv_timer_wheel_add)
+	PHP_FE(uv_timer_wheel_reset,        arginfo_uv_timer_wheel_reset)
+	PHP_FE(uv_timer_wheel_cancel,       arginfo_uv_timer_wheel_cancel)
+	PHP_FE(uv_timer_wheel_count,        arginfo_uv_timer_wheel_count)
+	PHP_FE(uv_set_timeout,              arginfo_uv_set_timeout)
+	PHP_FE(uv_clear_timeout,            arginfo_uv_clear_timeout)
+	PHP_FE(uv_queue_microtask,          arginfo_uv_queue_microtask)
 	/* tcp */
 	PHP_FE(uv_tcp_init,                 arginfo_uv_tcp_init)
 	PHP_FE(uv_tcp_open,                 arginfo_uv_tcp_open)
@@ -6157,8 +11687,12 @@ static zend_function_entry uv_functions[] = {
 	PHP_FE(uv_udp_bind6,                arginfo_uv_udp_bind6)
 	PHP_FE(uv_udp_set_multicast_loop,   arginfo_uv_udp_set_multicast_loop)
 	PHP_FE(uv_udp_set_multicast_ttl,    arginfo_uv_udp_set_multicast_ttl)
+	PHP_FE(uv_udp_set_segment_size,     arginfo_uv_udp_set_segment_size)
 	PHP_FE(uv_udp_send,                 arginfo_uv_udp_send)
 	PHP_FE(uv_udp_send6,                arginfo_uv_udp_send6)
+	PHP_FE(uv_udp_relay_start,          arginfo_uv_udp_relay_start)
+	PHP_FE(uv_udp_relay_stop,           arginfo_uv_udp_relay_stop)
+	PHP_FE(uv_udp_relay_info,           arginfo_uv_udp_relay_info)
 	PHP_FE(uv_udp_recv_start,           arginfo_uv_udp_recv_start)
 	PHP_FE(uv_udp_recv_stop,            arginfo_uv_udp_recv_stop)
 	PHP_FE(uv_udp_set_membership,       arginfo_uv_udp_set_membership)
@@ -6224,10 +11758,17 @@ static zend_function_entry uv_functions[] = {
 	PHP_FE(uv_async_send,               arginfo_uv_async_send)
 	/* queue (does not work yet) */
 	PHP_FE(uv_queue_work,               NULL)
+	PHP_FE(uv_runtime_new,              arginfo_uv_runtime_new)
+	PHP_FE(uv_runtime_stop,             arginfo_uv_runtime_stop)
+	PHP_FE(uv_runtime_join,             arginfo_uv_runtime_join)
+	PHP_FE(uv_runtime_worker_id,        NULL)
+	PHP_FE(uv_runtime_listener,         NULL)
 	/* fs */
 	PHP_FE(uv_fs_open,                  arginfo_uv_fs_open)
 	PHP_FE(uv_fs_read,                  arginfo_uv_fs_read)
 	PHP_FE(uv_fs_write,                 arginfo_uv_fs_write)
+	PHP_FE(uv_fs_writev,                arginfo_uv_fs_writev)
+	PHP_FE(uv_fs_readv,                 arginfo_uv_fs_readv)
 	PHP_FE(uv_fs_close,                 arginfo_uv_fs_close)
 	PHP_FE(uv_fs_fsync,                 arginfo_uv_fs_fsync)
 	PHP_FE(uv_fs_fdatasync,             arginfo_uv_fs_fdatasync)
@@ -6251,6 +11792,37 @@ static zend_function_entry uv_functions[] = {
 	PHP_FE(uv_fs_readdir,               arginfo_uv_fs_readdir)
 	PHP_FE(uv_fs_scandir,               arginfo_uv_fs_scandir)
 	PHP_FE(uv_fs_sendfile,              arginfo_uv_fs_sendfile)
+	PHP_FE(uv_fs_open_sync,             arginfo_uv_fs_open_sync)
+	PHP_FE(uv_fs_read_sync,             arginfo_uv_fs_read_sync)
+	PHP_FE(uv_fs_write_sync,            arginfo_uv_fs_write_sync)
+	PHP_FE(uv_fs_close_sync,            arginfo_uv_fs_close_sync)
+	PHP_FE(uv_fs_fsync_sync,            arginfo_uv_fs_fsync_sync)
+	PHP_FE(uv_fs_fdatasync_sync,        arginfo_uv_fs_fdatasync_sync)
+	PHP_FE(uv_fs_ftruncate_sync,        arginfo_uv_fs_ftruncate_sync)
+	PHP_FE(uv_fs_mkdir_sync,            arginfo_uv_fs_mkdir_sync)
+	PHP_FE(uv_fs_rmdir_sync,            arginfo_uv_fs_rmdir_sync)
+	PHP_FE(uv_fs_unlink_sync,           arginfo_uv_fs_unlink_sync)
+	PHP_FE(uv_fs_rename_sync,           arginfo_uv_fs_rename_sync)
+	PHP_FE(uv_fs_utime_sync,            arginfo_uv_fs_utime_sync)
+	PHP_FE(uv_fs_futime_sync,           arginfo_uv_fs_futime_sync)
+	PHP_FE(uv_fs_chmod_sync,            arginfo_uv_fs_chmod_sync)
+	PHP_FE(uv_fs_fchmod_sync,           arginfo_uv_fs_fchmod_sync)
+	PHP_FE(uv_fs_chown_sync,            arginfo_uv_fs_chown_sync)
+	PHP_FE(uv_fs_fchown_sync,           arginfo_uv_fs_fchown_sync)
+	PHP_FE(uv_fs_link_sync,             arginfo_uv_fs_link_sync)
+	PHP_FE(uv_fs_symlink_sync,          arginfo_uv_fs_symlink_sync)
+	PHP_FE(uv_fs_readlink_sync,         arginfo_uv_fs_readlink_sync)
+	PHP_FE(uv_fs_stat_sync,             arginfo_uv_fs_stat_sync)
+	PHP_FE(uv_fs_lstat_sync,            arginfo_uv_fs_lstat_sync)
+	PHP_FE(uv_fs_fstat_sync,            arginfo_uv_fs_fstat_sync)
+	PHP_FE(uv_fs_scandir_sync,          arginfo_uv_fs_scandir_sync)
+	PHP_FE(uv_fs_sendfile_sync,         arginfo_uv_fs_sendfile_sync)
+	PHP_FE(uv_fs_writev_sync,           arginfo_uv_fs_writev_sync)
+	PHP_FE(uv_fs_readv_sync,            arginfo_uv_fs_readv_sync)
+	PHP_FE(uv_fs_read_file,             arginfo_uv_fs_read_file)
+	PHP_FE(uv_fs_write_file,            arginfo_uv_fs_write_file)
+	PHP_FE(uv_fs_stat_cache_enable,     arginfo_uv_fs_stat_cache_enable)
+	PHP_FE(uv_fs_stat_cache_info,       arginfo_uv_fs_stat_cache_info)
 	PHP_FE(uv_fs_event_init,            arginfo_uv_fs_event_init)
 	/* tty */
 	PHP_FE(uv_tty_init,                 arginfo_uv_tty_init)
@@ -6290,12 +11862,28 @@ PHP_MINFO_FUNCTION(uv)
 	php_info_print_table_end();
 }
 
+PHP_MSHUTDOWN_FUNCTION(uv)
+{
+#ifdef ZTS
+	/* worker threads must be gone before the interpreter is */
+	php_uv_runtime_reap(1);
+	uv_mutex_destroy(&php_uv_runtime_orphans_lock);
+#endif
+
+	return SUCCESS;
+}
+
 static PHP_GINIT_FUNCTION(uv)
 {
 #if defined(COMPILE_DL_UV) && defined(ZTS)
 	ZEND_TSRMLS_CACHE_UPDATE();
 #endif
 	uv_globals->default_loop = NULL;
+	uv_globals->worker = NULL;
+	uv_globals->watchdog = NULL;
+	memset(uv_globals->pool, 0, sizeof(uv_globals->pool));
+	memset(uv_globals->pool_count, 0, sizeof(uv_globals->pool_count));
+	uv_globals->pool_enabled = 0;
 }
 
 zend_module_entry uv_module_entry = {
@@ -6303,8 +11891,8 @@ zend_module_entry uv_module_entry = {
 	"uv",
 	uv_functions,					/* Functions */
 	PHP_MINIT(uv),	/* MINIT */
-	NULL,					/* MSHUTDOWN */
-	NULL,					/* RINIT */
+	PHP_MSHUTDOWN(uv),	/* MSHUTDOWN */
+	PHP_RINIT(uv),		/* RINIT */
 	PHP_RSHUTDOWN(uv),		/* RSHUTDOWN */
 	PHP_MINFO(uv),	/* MINFO */
 	PHP_UV_VERSION,
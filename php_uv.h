@@ -16,6 +16,14 @@
 #include <Iphlpapi.h>
 #endif
 
+#ifdef __linux__
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103 /* linux >= 4.18, older libc headers do not know it */
+#endif
+#endif
+
 #ifndef PHP_UV_DTRACE
 #define PHP_UV_DTRACE 0
 #endif
@@ -49,6 +57,7 @@ typedef struct {
 #include <Zend/zend_exceptions.h>
 #include <Zend/zend_extensions.h>
 #include <Zend/zend_globals.h>
+#include <Zend/zend_generators.h>
 #include <Zend/zend_hash.h>
 #include <Zend/zend_ts_hash.h>
 #include <Zend/zend_interfaces.h>
@@ -125,19 +134,108 @@ enum php_uv_callback_type{
 	PHP_UV_CB_MAX          = 24
 };
 
+/* uv_udp_bind() flag handled by php-uv itself (SO_REUSEPORT), kept clear of the libuv uv_udp_flags */
+#define PHP_UV_UDP_REUSEPORT (1 << 16)
+
+/* uv_udp_relay_start() modes and the events passed to its callback */
+enum php_uv_udp_relay_mode {
+	PHP_UV_RELAY_ROUND_ROBIN = 0,
+	PHP_UV_RELAY_SOURCE_HASH = 1
+};
+
+enum php_uv_udp_relay_event {
+	PHP_UV_RELAY_SESSION_OPEN  = 1,
+	PHP_UV_RELAY_SESSION_CLOSE = 2
+};
+
 typedef struct {
     zend_fcall_info fci;
     zend_fcall_info_cache fcc;
+    zend_function *fast; /* user function resolved at init, called without zend_call_function() */
 } php_uv_cb_t;
 
+/* where a handle's events go: its PHP callbacks, or the loop's event queue drained by uv_run_collect() */
+enum php_uv_sink {
+	PHP_UV_SINK_CALLBACK = 0,
+	PHP_UV_SINK_QUEUE    = 1
+};
+
+/* how php_uv_fs_common() runs a request */
+enum php_uv_fs_mode {
+	PHP_UV_FS_SYNC     = 1, /* inline, the _sync variants */
+	PHP_UV_FS_VECTORED = 2  /* uv_fs_readv() and uv_fs_writev() */
+};
+
+/* the deadline of uv_stream_set_timeouts() which expired */
+enum php_uv_stream_timeout {
+	PHP_UV_TIMEOUT_IDLE  = 1,
+	PHP_UV_TIMEOUT_READ  = 2,
+	PHP_UV_TIMEOUT_WRITE = 3
+};
+
+/* queued event: the callback type and the arguments the callback would have received */
 typedef struct {
+	int type;
+	int argc;
+	zval args[4];
+} php_uv_event_t;
+
+/* callback held back by uv_run_budget() once the budget was spent, replayed by the next run */
+typedef struct php_uv_deferred_s {
+	php_uv_cb_t *cb;
+	int argc;
+	zval args[4];
+	struct php_uv_deferred_s *next;
+} php_uv_deferred_t;
+
+/* libuv handles owned by php-uv itself (no PHP object behind them) point their data at this header.
+ * It starts with a zend_refcounted_h like every zend_object, so GC_TYPE() tells it from a php_uv_t. */
+typedef struct php_uv_internal_s {
+	zend_refcounted_h gc;
+	void (*dispose)(struct php_uv_internal_s *internal); /* the loop is going away: close the owner's handles */
+} php_uv_internal_t;
+
+#define PHP_UV_LAYOUT_MAX 24
+
+/* released objects kept per class for reuse, see php_uv_release() */
+#define PHP_UV_POOL_MAX 64
+
+/* per class: how much memory its objects need and which callbacks they can hold */
+typedef struct {
+	zend_class_entry *ce;
+	size_t size;
+	uint32_t index; /* of the class, into UV_G(pool) and the loop metrics */
+	uint32_t cb_count;
+	int8_t cb_slot[PHP_UV_CB_MAX]; /* index into php_uv_t.callback, -1 if the class has no such callback */
+	zend_bool loop_ref; /* the loop holds a reference on active handles of the class */
+} php_uv_layout_t;
+
+typedef struct php_uv_s {
 	zend_object std;
 
 #ifdef ZTS
 	void ***thread_ctx;
 #endif
-	int type;
+	const php_uv_layout_t *layout;
 	uv_os_sock_t sock;
+	int gso_size; /* uv_udp_set_segment_size(): > 0 segmented by the kernel, < 0 split by php-uv */
+	void *ext; /* uv_udp_relay(): the relay of a udp listener */
+	struct php_uv_stream_timeouts_s *timeouts; /* uv_stream_set_timeouts() of a tcp, pipe or tty stream */
+	struct php_uv_fs_bufs_s *fs_bufs; /* uv_fs_readv() and uv_fs_writev() until the request completes */
+	struct php_uv_s *pool_next; /* next free object of the class while pooled, see php_uv_release() */
+	int sink;
+	int await_type; /* callback type of the last started operation a coroutine can wait for, -1 if none */
+	char *buffer;
+	php_uv_cb_t **callback; /* layout->cb_count slots, allocated behind the libuv handle */
+	zval *gc_data; /* built by php_uv_get_gc on first use */
+	uint32_t gc_slot; /* position + 1 in the loop's gc registry, 0 if not registered */
+	uint32_t gc_dirty; /* position + 1 in the loop's gc dirty list, 0 if not listed */
+	zval fs_fd;
+	zval fs_fd_alt;
+	uint64_t stat_epoch; /* stat and lstat: the stat cache epoch the request started in, 0 if its result is not cached */
+	zval awaiter; /* the Generator or UVPromise waiting for this handle or request */
+
+	/* must stay last: objects only allocate the member of their class */
 	union {
 		uv_tcp_t tcp;
 		uv_udp_t udp;
@@ -145,7 +243,6 @@ typedef struct {
 		uv_idle_t idle;
 		uv_timer_t timer;
 		uv_async_t async;
-		uv_loop_t loop;
 		uv_handle_t handle;
 		uv_req_t req;
 		uv_stream_t stream;
@@ -161,11 +258,6 @@ typedef struct {
 		uv_poll_t poll;
 		uv_signal_t signal;
 	} uv;
-	char *buffer;
-	php_uv_cb_t *callback[PHP_UV_CB_MAX];
-	zval gc_data[PHP_UV_CB_MAX * 2];
-	zval fs_fd;
-	zval fs_fd_alt;
 } php_uv_t;
 
 typedef struct {
@@ -177,6 +269,13 @@ typedef struct {
 	} addr;
 } php_uv_sockaddr_t;
 
+/* UVStat: a copy of the stat result, fields are converted when they are read */
+typedef struct {
+	zend_object std;
+
+	uv_stat_t stat;
+} php_uv_stat_t;
+
 typedef struct {
 	zend_object std;
 
@@ -197,6 +296,121 @@ typedef struct {
 	int flags;
 } php_uv_stdio_t;
 
+/* uv_stream_set_timeouts(): deadlines of a stream, all checked by one timer. I/O only records the time,
+ * the timer finds out when it fires whether a deadline really passed and otherwise waits for the next one. */
+typedef struct php_uv_stream_timeouts_s {
+	php_uv_internal_t internal;
+	uv_timer_t timer;
+	php_uv_t *stream; /* NULL once the stream is closed */
+	php_uv_cb_t *callback; /* NULL to close the stream on expiry */
+	uint64_t idle; /* ms, 0 if not enforced */
+	uint64_t write;
+	uint64_t activity; /* uv_now() of the last read or write */
+	uint64_t read_deadline; /* uv_now() based, 0 if none */
+	uint64_t write_deadline;
+	uint64_t due; /* of the timer, 0 while stopped */
+	uint32_t writes; /* pending */
+#ifdef ZTS
+	void ***thread_ctx;
+#endif
+} php_uv_stream_timeouts_t;
+
+/* the buffers of uv_fs_readv() and uv_fs_writev(), in php_uv_t.fs_bufs until the request completes */
+typedef struct php_uv_fs_bufs_s {
+	unsigned int nbufs;
+	char *data; /* readv: one allocation for all segments */
+	zend_string **strings; /* writev: the strings the buffers point into */
+	uv_buf_t bufs[1];
+} php_uv_fs_bufs_t;
+
+/* uv_fs_read_file() and uv_fs_write_file(): open, read or write, close as one threadpool job */
+typedef struct {
+	uv_work_t work;
+	zend_bool read;
+	zend_string *path;
+	zend_string *data; /* write: the string to write */
+	int flags;
+	char *buf; /* read: malloc()ed by the worker, the file's content */
+	size_t len;
+	ssize_t result; /* bytes read or written, or the negative error code */
+	php_uv_cb_t *callback;
+	zval promise; /* settled instead when there is no callback */
+#ifdef ZTS
+	void ***thread_ctx;
+#endif
+} php_uv_fs_file_t;
+
+/* uv_fs_stat_cache_enable(): a cached uv_fs_stat() or uv_fs_lstat() result */
+typedef struct {
+	uv_stat_t stat;
+	uint64_t expires; /* uv_hrtime() */
+} php_uv_stat_entry_t;
+
+/* uv_fs_stat_cache_enable(): the cached results of a loop, keyed by 's' or 'l' followed by the path as given.
+ * A uv_fs_event watcher on the directory of each entry drops what changes, the ttl bounds everything else. */
+typedef struct {
+	HashTable entries; /* php_uv_stat_entry_t */
+	HashTable watches; /* directory => php_uv_stat_watch_t, NULL if the watcher could not be started */
+	uint64_t ttl; /* ns, 0 while disabled */
+	uint32_t max_entries;
+	uint32_t max_watches;
+	uint64_t epoch; /* starts at 1, bumped by every invalidation, results of requests started before are not stored */
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t invalidations;
+} php_uv_stat_cache_t;
+
+typedef struct {
+	php_uv_internal_t internal;
+	uv_fs_event_t handle;
+	php_uv_stat_cache_t *cache;
+	zend_string *dir;
+} php_uv_stat_watch_t;
+
+/* uv_set_timeout(): a libuv timer kept by the loop for reuse once it fired or was cleared */
+typedef struct php_uv_timeout_s {
+	php_uv_internal_t internal;
+	uv_timer_t timer;
+	php_uv_cb_t *callback; /* NULL while pooled */
+	zend_long id;
+	struct php_uv_timeout_s *next; /* in the pool of the loop */
+#ifdef ZTS
+	void ***thread_ctx;
+#endif
+} php_uv_timeout_t;
+
+/* stopped timers a loop keeps for uv_set_timeout() */
+#define PHP_UV_TIMEOUT_POOL_MAX 1024
+
+/* uv_queue_microtask(): callbacks run by one check handle per loop iteration, at most this many
+ * each time so that microtasks queueing microtasks cannot starve i/o */
+#define PHP_UV_MICROTASK_TICK_MAX 1024
+
+#define PHP_UV_WATCHDOG_BUCKETS 16
+#define PHP_UV_WATCHDOG_SLOW_MAX 16
+
+/* uv_loop_watchdog(): a thread watching the callbacks of one loop */
+typedef struct {
+	uv_thread_t thread;
+	uv_mutex_t lock;
+	uv_cond_t cond;
+	zend_bool *vm_interrupt; /* of the loop's thread */
+
+	/* shared with the watchdog thread, under lock */
+	uint64_t threshold; /* ns */
+	uint64_t entered; /* uv_hrtime() when the running callback started, 0 between callbacks */
+	zend_bool capture; /* the running callback is over the threshold, take a backtrace */
+	zend_bool stop;
+
+	/* loop thread only */
+	zend_object *current; /* what the running callback belongs to, NULL if nothing */
+	zend_bool captured;
+	uint64_t histogram[PHP_UV_WATCHDOG_BUCKETS]; /* callback durations, log2 ms buckets */
+	uint64_t max; /* ns */
+	uint64_t slow_count;
+	zval slow; /* the latest PHP_UV_WATCHDOG_SLOW_MAX callbacks over the threshold */
+} php_uv_watchdog_t;
+
 typedef struct {
 	zend_object std;
 
@@ -204,8 +418,137 @@ typedef struct {
 
 	size_t gc_buffer_size;
 	zval *gc_buffer;
+
+	/* handles the loop holds a reference on, reported by get_gc. Handles which may have been started,
+	 * stopped or fired since the last collection wait in the dirty list and are only checked then. */
+	zval *gc_registry;
+	uint32_t gc_registry_count;
+	uint32_t gc_registry_size;
+	php_uv_t **gc_dirty;
+	uint32_t gc_dirty_count;
+	uint32_t gc_dirty_size;
+
+	php_uv_event_t *events; /* ring buffer */
+	uint32_t events_head;
+	uint32_t events_count;
+	uint32_t events_size;
+
+	php_uv_internal_t collect_internal;
+	uv_timer_t collect_timer; /* bounds the uv_run_collect() and uv_run_budget() time, initialized on first use */
+	zend_bool collect_timer_init;
+
+	struct php_uv_budget_s *budget; /* of the uv_run_budget() running this loop, if any */
+	php_uv_deferred_t *deferred;
+	php_uv_deferred_t **deferred_tail;
+
+	uint64_t callbacks[PHP_UV_LAYOUT_MAX]; /* events delivered, by layout index of the handle or request */
+	php_uv_watchdog_t *watchdog;
+
+	zend_bool gc_idle; /* uv_loop_gc_idle(): no automatic collection in callbacks, collected while idle */
+	zend_bool gc_idle_init;
+	php_uv_internal_t gc_idle_internal;
+	uv_prepare_t gc_idle_prepare; /* initialized on first use */
+	uint64_t gc_idle_slice; /* ms the loop must be expected to stay idle for a collection to start */
+	uint64_t gc_idle_last; /* ns the last collection which found garbage took */
+
+	php_uv_timeout_t *timeouts_pool;
+	uint32_t timeouts_pool_count;
+
+	php_uv_cb_t *microtasks; /* ring buffer */
+	uint32_t microtasks_head;
+	uint32_t microtasks_count;
+	uint32_t microtasks_size;
+	zend_bool microtask_init;
+	php_uv_internal_t microtask_internal;
+	uv_check_t microtask_check; /* runs the queue, initialized on first use */
+	uv_idle_t microtask_idle; /* keeps the loop from blocking in poll while the queue is not empty */
+
+	php_uv_stat_cache_t *stat_cache; /* allocated by the first uv_fs_stat_cache_enable() */
+	php_uv_t **stat_hits; /* stat requests answered by the cache, completed by stat_hits_idle */
+	uint32_t stat_hits_count;
+	uint32_t stat_hits_size;
+	zend_bool stat_hits_init;
+	php_uv_internal_t stat_hits_internal;
+	uv_idle_t stat_hits_idle; /* initialized on first use */
+#if UV_VERSION_HEX < 0x012D00
+	php_uv_internal_t metrics_internal;
+	uv_prepare_t metrics_prepare; /* counts iterations, libuv only does so since 1.45 */
+	uint64_t iterations;
+#endif
 } php_uv_loop_t;
 
+/* limits of the running uv_run_budget() */
+typedef struct php_uv_budget_s {
+	php_uv_loop_t *loop;
+	uint64_t deadline; /* uv_hrtime(), 0 without a time limit */
+	zend_long callbacks; /* left to run, < 0 without a limit */
+	zend_bool running; /* inside uv_run(), so uv_stop() applies to this run */
+	zend_bool spent;
+} php_uv_budget_t;
+
+enum php_uv_promise_state {
+	PHP_UV_PROMISE_PENDING   = 0,
+	PHP_UV_PROMISE_FULFILLED = 1,
+	PHP_UV_PROMISE_REJECTED  = 2
+};
+
+typedef struct php_uv_promise_reaction_s php_uv_promise_reaction_t;
+typedef struct php_uv_promise_timeout_s php_uv_promise_timeout_t;
+
+typedef struct {
+	zend_object std;
+
+	int state;
+	zval result; /* the value or negative error code once settled; uv_promise_all() collects into it while pending */
+	php_uv_promise_reaction_t *reactions; /* run in order once settled */
+	php_uv_promise_reaction_t **reactions_tail;
+	uint32_t pending; /* uv_promise_all(): inputs not fulfilled yet */
+	php_uv_promise_timeout_t *timeout; /* uv_promise_timeout(): armed timer */
+
+	size_t gc_buffer_size;
+	zval *gc_buffer;
+} php_uv_promise_t;
+
+/* deadline of a UVTimerWheel, its id is the index + 1 */
+typedef struct {
+	uint64_t expires; /* tick */
+	uint32_t timeout; /* ticks, for uv_timer_wheel_reset() without a new timeout */
+	int32_t slot; /* -1 while free */
+	int32_t prev;
+	int32_t next; /* in the slot, or the next free entry */
+} php_uv_timer_wheel_entry_t;
+
+typedef struct php_uv_timer_wheel_s php_uv_timer_wheel_t;
+
+/* the libuv timer of a wheel, allocated apart as it is closed after the wheel may be gone */
+typedef struct {
+	php_uv_internal_t internal;
+	uv_timer_t timer;
+	php_uv_timer_wheel_t *wheel; /* NULL once the wheel is freed */
+#ifdef ZTS
+	void ***thread_ctx;
+#endif
+} php_uv_timer_wheel_driver_t;
+
+/* deadlines hashed by expiry tick into slots, a slot holds every deadline due a multiple of the slot count later */
+struct php_uv_timer_wheel_s {
+	zend_object std;
+
+	php_uv_timer_wheel_driver_t *driver; /* NULL once the loop is gone */
+	zend_bool armed; /* the timer runs and holds a reference on the wheel */
+	php_uv_cb_t *callback;
+	uint64_t tick; /* ms */
+	uint64_t epoch; /* uv_now() of tick 0 */
+	uint64_t current; /* the last tick expired */
+	uint32_t mask; /* slot count - 1 */
+	int32_t *slots; /* first entry of each slot, -1 if empty */
+	php_uv_timer_wheel_entry_t *entries;
+	uint32_t entries_size;
+	int32_t free; /* first free entry, -1 if none */
+	uint32_t count; /* armed deadlines */
+	zval gc_table[2];
+};
+
 /* File/directory stat mode constants*/
 #ifdef PHP_WIN32
 #define S_IFDIR _S_IFDIR
@@ -219,8 +562,48 @@ typedef struct {
 #endif
 #endif
 
+typedef struct php_uv_runtime_shared_s php_uv_runtime_shared_t;
+
+typedef struct {
+	php_uv_internal_t internal;
+	uv_async_t stop; /* on the worker's default loop */
+	uv_thread_t thread;
+	php_uv_runtime_shared_t *shared;
+	uint32_t id;
+	zend_bool alive; /* stop handle usable from other threads, guarded by shared->lock */
+	zend_bool stopping;
+	zend_bool exited; /* the thread is about to return, joining it does not block. guarded by shared->lock */
+} php_uv_worker_t;
+
+#define PHP_UV_RUNTIME_MAX_WORKERS 1024
+
+/* what the worker threads use, malloc()ed: it outlives the UVRuntime until the workers are joined */
+struct php_uv_runtime_shared_s {
+	char *bootstrap; /* script every worker executes */
+	int listener_fd; /* a duplicate of the shared listener, -1 if none */
+	uv_mutex_t lock;
+	uv_sem_t ready;
+	uint32_t started; /* worker threads created */
+	zend_bool joined;
+	php_uv_worker_t *workers;
+	php_uv_runtime_shared_t *next; /* while orphaned, see php_uv_runtime_orphan() */
+};
+
+typedef struct {
+	zend_object std;
+
+	php_uv_runtime_shared_t *shared;
+} php_uv_runtime_t;
+
 ZEND_BEGIN_MODULE_GLOBALS(uv)
 	php_uv_loop_t *default_loop;
+	php_uv_worker_t *worker; /* the UVRuntime worker this thread runs, if any */
+	php_uv_watchdog_t *watchdog; /* of the loop whose callback is running */
+	php_uv_t *pool[PHP_UV_LAYOUT_MAX]; /* free lists, linked through pool_next */
+	uint32_t pool_count[PHP_UV_LAYOUT_MAX];
+	zend_bool pool_enabled;
+	HashTable timeouts; /* pending uv_set_timeout() timers by id */
+	zend_long timeout_id; /* the last id handed out */
 ZEND_END_MODULE_GLOBALS(uv)
 
 #ifdef ZTS
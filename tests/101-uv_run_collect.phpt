@@ -0,0 +1,38 @@
+--TEST--
+Check for uv_run_collect with a queue sink
+--FILE--
+<?php
+$loop = uv_loop_new();
+$timer = uv_timer_init($loop);
+var_dump(uv_event_sink($timer, UV::SINK_QUEUE));
+
+uv_timer_start($timer, 10, 10, function($timer) {
+    echo "not called" . PHP_EOL;
+});
+
+$count = 0;
+while ($count < 3) {
+    foreach (uv_run_collect($loop, 16, 1000) as $event) {
+        list($type, $handle) = $event;
+        echo "timer: ", var_export($type == UV::EVENT_TIMER && $handle === $timer, true), PHP_EOL;
+        $count++;
+    }
+}
+
+uv_timer_stop($timer);
+var_dump(uv_run_collect($loop, 16, 0));
+
+uv_close($timer, function() {
+    echo "not called either" . PHP_EOL;
+});
+$events = uv_run_collect($loop);
+var_dump(count($events), $events[0][0] == UV::EVENT_CLOSE);
+--EXPECT--
+bool(true)
+timer: true
+timer: true
+timer: true
+array(0) {
+}
+int(1)
+bool(true)
@@ -0,0 +1,53 @@
+--TEST--
+Check for uv_coroutine
+--FILE--
+<?php
+define("FIXTURE_PATH", dirname(__FILE__) . "/fixtures/hello.data");
+
+$tcp = uv_tcp_init();
+uv_tcp_bind($tcp, uv_ip4_addr('127.0.0.1', 0));
+uv_listen($tcp, 100, function($server) {
+    $client = uv_tcp_init();
+    uv_accept($server, $client);
+    uv_close($client);
+    uv_close($server);
+});
+$addrinfo = uv_tcp_getsockname($tcp);
+
+uv_coroutine((function() use ($addrinfo) {
+    $loop = uv_default_loop();
+
+    $fd = yield uv_fs_open($loop, FIXTURE_PATH, UV::O_RDONLY, 0);
+    $data = yield uv_fs_read($loop, $fd, 0, 32);
+    echo trim($data) . PHP_EOL;
+    var_dump(yield uv_fs_close($loop, $fd));
+
+    $error = yield uv_fs_open($loop, FIXTURE_PATH . ".missing", UV::O_RDONLY, 0);
+    var_dump(is_int($error) && $error < 0);
+
+    $timer = uv_timer_init();
+    uv_timer_start($timer, 10, 0);
+    var_dump((yield $timer) === $timer);
+
+    $c = uv_tcp_init();
+    uv_tcp_connect($c, uv_ip4_addr($addrinfo['address'], $addrinfo['port']));
+    var_dump((yield $c) === $c);
+    uv_close($c);
+
+    var_dump(yield 1);
+})());
+
+echo "started" . PHP_EOL;
+uv_run();
+echo "finished" . PHP_EOL;
+--EXPECTF--
+started
+Hello
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+
+Warning: uv_run(): coroutine yielded a value which can not be awaited, resuming with null in %s on line %d
+NULL
+finished
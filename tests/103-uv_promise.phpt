@@ -0,0 +1,76 @@
+--TEST--
+Check for uv_promise_then, uv_promise_all, uv_promise_race and uv_promise_timeout
+--FILE--
+<?php
+define("FIXTURE_PATH", dirname(__FILE__) . "/fixtures/hello.data");
+$loop = uv_default_loop();
+$log = [];
+
+$stat = uv_fs_stat($loop, FIXTURE_PATH);
+var_dump($stat instanceof UVPromise);
+
+uv_promise_then(uv_promise_then($stat, function ($stat) {
+    return $stat["size"] > 0;
+}), function ($nonempty) {
+    $GLOBALS["log"]["then"] = $nonempty;
+});
+
+uv_promise_then(uv_fs_stat($loop, FIXTURE_PATH . ".missing"), function () {
+    echo "FAIL\n";
+}, function ($error) {
+    $GLOBALS["log"]["rejected"] = $error === UV::ENOENT;
+});
+
+uv_promise_then(uv_promise_all(["a" => uv_fs_stat($loop, FIXTURE_PATH), "b" => 42]), function ($values) {
+    $GLOBALS["log"]["all"] = array_keys($values) === ["a", "b"] && $values["a"] instanceof UVStat && $values["b"] === 42;
+});
+
+uv_promise_then(uv_promise_all([uv_fs_stat($loop, FIXTURE_PATH), uv_fs_stat($loop, FIXTURE_PATH . ".missing")]), null, function ($error) {
+    $GLOBALS["log"]["all rejected"] = $error === UV::ENOENT;
+});
+
+$never = uv_promise_then(uv_promise_all([]), function () {
+    return uv_promise_race([]);
+});
+uv_promise_then(uv_promise_race([$never, uv_fs_stat($loop, FIXTURE_PATH)]), function ($stat) {
+    $GLOBALS["log"]["race"] = $stat instanceof UVStat;
+});
+
+uv_promise_then(uv_promise_then($stat, function () {
+    throw new RuntimeException("thrown");
+}), null, function ($error) {
+    $GLOBALS["log"]["thrown"] = $error instanceof RuntimeException && $error->getMessage() === "thrown";
+});
+
+uv_promise_then(uv_promise_timeout($never, 10), null, function ($error) {
+    $GLOBALS["log"]["timeout"] = $error === UV::ETIMEDOUT;
+});
+
+uv_coroutine((function () use ($loop) {
+    $r = yield uv_promise_timeout(uv_fs_stat($loop, FIXTURE_PATH), 1000);
+    $GLOBALS["log"]["coroutine"] = $r instanceof UVStat;
+})());
+
+uv_run();
+ksort($log);
+var_dump($log);
+--EXPECT--
+bool(true)
+array(8) {
+  ["all"]=>
+  bool(true)
+  ["all rejected"]=>
+  bool(true)
+  ["coroutine"]=>
+  bool(true)
+  ["race"]=>
+  bool(true)
+  ["rejected"]=>
+  bool(true)
+  ["then"]=>
+  bool(true)
+  ["thrown"]=>
+  bool(true)
+  ["timeout"]=>
+  bool(true)
+}
@@ -0,0 +1,54 @@
+--TEST--
+Check that recycled handle and request objects start out clean
+--FILE--
+<?php
+function tick($n) {
+    $timer = uv_timer_init();
+    uv_timer_start($timer, 1, 0, function ($timer) use ($n) {
+        echo "timer $n", PHP_EOL;
+        uv_close($timer, function () use ($n) {
+            echo "closed $n", PHP_EOL;
+        });
+    });
+}
+
+for ($i = 1; $i <= 3; $i++) {
+    tick($i);
+    uv_run();
+}
+
+$stats = [];
+$stat = function ($n) use (&$stat, &$stats) {
+    $file = $n % 2 ? __FILE__ : __FILE__ . '.missing';
+    uv_fs_stat(uv_default_loop(), $file, function ($result, $info) use ($n, $stat, &$stats) {
+        $stats[] = $n . ':' . ($result ? 'found' : 'missing');
+        if ($n < 4) {
+            $stat($n + 1);
+        }
+    });
+};
+$stat(1);
+uv_run();
+echo implode(' ', $stats), PHP_EOL;
+
+$timer = uv_timer_init();
+$timer->tag = 'first';
+uv_close($timer);
+unset($timer);
+uv_run();
+
+$timer = uv_timer_init();
+var_dump(isset($timer->tag));
+var_dump(uv_is_active($timer));
+uv_close($timer);
+uv_run();
+--EXPECT--
+timer 1
+closed 1
+timer 2
+closed 2
+timer 3
+closed 3
+1:found 2:missing 3:found 4:missing
+bool(false)
+bool(false)
@@ -0,0 +1,73 @@
+--TEST--
+Check for uv_run_budget
+--FILE--
+<?php
+function start_timers($loop) {
+    $timers = [];
+    for ($i = 1; $i <= 6; $i++) {
+        $timer = uv_timer_init($loop);
+        uv_timer_start($timer, 0, 0, function () use ($i) {
+            echo $i, " ";
+        });
+        $timers[] = $timer;
+    }
+    return $timers;
+}
+
+$loop = uv_loop_new();
+$timers = start_timers($loop);
+$rounds = 0;
+do {
+    $more = uv_run_budget($loop, 0, 2);
+    echo "| ";
+} while ($more && ++$rounds < 10);
+echo PHP_EOL;
+
+/* a plain uv_run() picks up what a bounded run held back */
+$timers = start_timers($loop);
+var_dump(uv_run_budget($loop, 0, 4));
+uv_run($loop);
+echo PHP_EOL;
+
+$timer = uv_timer_init($loop);
+uv_timer_start($timer, 1000, 0, function () {
+    echo "not reached", PHP_EOL;
+});
+$start = microtime(true);
+var_dump(uv_run_budget($loop, 20, 0));
+var_dump(microtime(true) - $start < 0.5);
+uv_close($timer);
+uv_run($loop);
+
+/* uv_set_timeout() callbacks count against the budget */
+for ($i = 1; $i <= 3; $i++) {
+    uv_set_timeout($loop, 0, function () use ($i) {
+        echo "t$i ";
+    });
+}
+uv_run_budget($loop, 0, 2);
+echo "| ";
+uv_run($loop);
+echo PHP_EOL;
+
+/* those of another loop run from a callback do not */
+$other = uv_loop_new();
+uv_set_timeout($loop, 0, function () use ($other) {
+    for ($i = 1; $i <= 3; $i++) {
+        uv_set_timeout($other, 0, function () use ($i) {
+            echo "inner$i ";
+        });
+    }
+    uv_run($other);
+    echo "outer ";
+});
+uv_run_budget($loop, 0, 1);
+echo PHP_EOL;
+--EXPECT--
+1 2 | 3 4 | 5 6 | 
+1 2 3 4 bool(true)
+5 6 
+bool(true)
+bool(true)
+t1 t2 | t3 
+inner1 inner2 inner3 outer 
@@ -0,0 +1,43 @@
+--TEST--
+Check for uv_loop_metrics
+--FILE--
+<?php
+$loop = uv_loop_new();
+$timer = uv_timer_init($loop);
+$ticks = 0;
+uv_timer_start($timer, 1, 1, function ($timer) use (&$ticks) {
+    if (++$ticks == 3) {
+        uv_close($timer);
+    }
+});
+uv_run($loop);
+
+$metrics = uv_loop_metrics($loop);
+var_dump(array_keys($metrics));
+var_dump($metrics['iterations'] >= 3);
+var_dump($metrics['idle_time'] === null || $metrics['idle_time'] >= 0);
+var_dump($metrics['callbacks']);
+
+$metrics = uv_loop_metrics(uv_loop_new());
+var_dump($metrics['callbacks']);
+--EXPECT--
+array(5) {
+  [0]=>
+  string(9) "idle_time"
+  [1]=>
+  string(10) "iterations"
+  [2]=>
+  string(6) "events"
+  [3]=>
+  string(14) "events_waiting"
+  [4]=>
+  string(9) "callbacks"
+}
+bool(true)
+bool(true)
+array(1) {
+  ["UVTimer"]=>
+  int(3)
+}
+array(0) {
+}
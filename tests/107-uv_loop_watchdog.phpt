@@ -0,0 +1,52 @@
+--TEST--
+Check for uv_loop_watchdog
+--FILE--
+<?php
+function busy($ms) {
+    $until = microtime(true) + $ms / 1000;
+    while (microtime(true) < $until);
+}
+
+$loop = uv_loop_new();
+var_dump(uv_loop_watchdog($loop, 20));
+
+$timer = uv_timer_init($loop);
+$ticks = 0;
+uv_timer_start($timer, 1, 1, function ($timer) use (&$ticks) {
+    if (++$ticks == 2) {
+        busy(150);
+        uv_close($timer);
+    }
+});
+uv_run($loop);
+
+$report = uv_loop_watchdog_report($loop, true);
+var_dump($report['threshold']);
+var_dump(array_sum($report['histogram']));
+var_dump($report['max'] >= 150);
+var_dump($report['slow_count']);
+var_dump($report['slow'][0]['handle']);
+var_dump($report['slow'][0]['duration'] >= 150);
+if (PHP_VERSION_ID >= 70100) {
+    var_dump(in_array('busy', array_column($report['slow'][0]['trace'], 'function')));
+} else {
+    var_dump(true);
+}
+
+$report = uv_loop_watchdog_report($loop);
+var_dump($report['slow_count'], array_sum($report['histogram']));
+var_dump(uv_loop_watchdog($loop, 0));
+var_dump(@uv_loop_watchdog_report($loop));
+--EXPECT--
+bool(true)
+int(20)
+int(2)
+bool(true)
+int(1)
+string(7) "UVTimer"
+bool(true)
+bool(true)
+int(0)
+int(0)
+bool(true)
+bool(false)
@@ -0,0 +1,48 @@
+--TEST--
+Check for uv_loop_gc_idle
+--FILE--
+<?php
+class Cycle {
+    public $self;
+    public $log;
+
+    public function __construct(&$log) {
+        $this->self = $this;
+        $this->log = &$log;
+    }
+
+    public function __destruct() {
+        $this->log[] = "collected";
+    }
+}
+
+$loop = uv_loop_new();
+var_dump(uv_loop_gc_idle($loop, true, 5));
+
+$log = [];
+$first = uv_timer_init($loop);
+uv_timer_start($first, 1, 0, function () use (&$log) {
+    /* only held back where the collector keeps the roots it finds meanwhile */
+    $log[] = gc_enabled() === (PHP_VERSION_ID < 70300) ? "gc as expected" : "gc unexpected";
+    new Cycle($log);
+});
+$second = uv_timer_init($loop);
+uv_timer_start($second, 100, 0, function ($timer) use (&$log, $first) {
+    $log[] = "second timer";
+    uv_close($timer);
+    uv_close($first);
+});
+uv_run($loop);
+
+var_dump(gc_enabled());
+echo implode("\n", $log), "\n";
+var_dump(uv_loop_gc_idle($loop, false));
+var_dump(@uv_loop_gc_idle($loop, true, -1));
+--EXPECT--
+bool(true)
+bool(true)
+gc as expected
+collected
+second timer
+bool(true)
+bool(false)
@@ -0,0 +1,42 @@
+--TEST--
+Check for uv_backend_fd and uv_backend_timeout
+--SKIPIF--
+<?php
+if (substr(PHP_OS, 0, 3) == 'WIN') {
+    die('skip libuv has no backend fd on Windows');
+}
+?>
+--FILE--
+<?php
+$loop = uv_loop_new();
+var_dump(uv_backend_fd($loop) >= 0);
+var_dump(uv_backend_fd($loop) === uv_backend_fd($loop));
+var_dump(uv_backend_fd($loop) !== uv_backend_fd());
+
+// nothing keeps the loop alive
+var_dump(uv_backend_timeout($loop));
+
+$timer = uv_timer_init($loop);
+uv_timer_start($timer, 500, 0, function ($timer) {
+    echo "timer\n";
+});
+$timeout = uv_backend_timeout($loop);
+var_dump($timeout > 0 && $timeout <= 500);
+
+uv_timer_stop($timer);
+$idle = uv_idle_init($loop);
+uv_idle_start($idle, function ($idle) {
+    uv_idle_stop($idle);
+});
+var_dump(uv_backend_timeout($loop));
+uv_run($loop, UV::RUN_NOWAIT);
+uv_close($idle);
+uv_close($timer);
+uv_run($loop);
+--EXPECT--
+bool(true)
+bool(true)
+bool(true)
+int(0)
+bool(true)
+int(0)
@@ -0,0 +1,58 @@
+--TEST--
+Check for uv_timer_wheel
+--FILE--
+<?php
+$loop = uv_loop_new();
+$start = uv_now($loop);
+$timeouts = [];
+
+$wheel = uv_timer_wheel_new(10, function ($wheel, $ids) use ($loop, $start, &$timeouts) {
+    sort($ids);
+    foreach ($ids as $id) {
+        echo "expired $id: ", uv_now($loop) - $start >= $timeouts[$id] ? "in time" : "too early", "\n";
+    }
+    static $readded = false;
+    if ($ids == [1] && !$readded) {
+        $readded = true;
+        $timeouts[uv_timer_wheel_add($wheel, 20)] = uv_now($loop) - $start + 20;
+    }
+}, 8, $loop);
+
+// 200ms go round the 8 slots of 10ms more than twice
+foreach ([30, 30, 200, 50] as $timeout) {
+    $timeouts[uv_timer_wheel_add($wheel, $timeout)] = $timeout;
+}
+var_dump(array_keys($timeouts));
+
+var_dump(uv_timer_wheel_cancel($wheel, 4));
+var_dump(uv_timer_wheel_cancel($wheel, 4));
+var_dump(uv_timer_wheel_reset($wheel, 2, 120));
+$timeouts[2] = 120;
+var_dump(uv_timer_wheel_reset($wheel, 99));
+var_dump(uv_timer_wheel_count($wheel));
+
+uv_run($loop);
+var_dump(uv_timer_wheel_count($wheel));
+var_dump(uv_timer_wheel_reset($wheel, 3));
+--EXPECT--
+array(4) {
+  [0]=>
+  int(1)
+  [1]=>
+  int(2)
+  [2]=>
+  int(3)
+  [3]=>
+  int(4)
+}
+bool(true)
+bool(false)
+bool(true)
+bool(false)
+int(3)
+expired 1: in time
+expired 1: in time
+expired 2: in time
+expired 3: in time
+int(0)
+bool(false)
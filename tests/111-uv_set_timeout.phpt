@@ -0,0 +1,42 @@
+--TEST--
+Check for uv_set_timeout and uv_clear_timeout
+--FILE--
+<?php
+$loop = uv_loop_new();
+$log = [];
+
+$a = uv_set_timeout($loop, 30, function () use (&$log) {
+    $log[] = "a";
+});
+$b = uv_set_timeout($loop, 10, function () use (&$log, $loop) {
+    $log[] = "b";
+    uv_set_timeout($loop, 0, function () use (&$log) {
+        $log[] = "b2";
+    });
+});
+$c = uv_set_timeout($loop, 20, function () use (&$log) {
+    $log[] = "c";
+});
+var_dump(is_int($a), $b > $a, $c > $b);
+var_dump(uv_clear_timeout($c), uv_clear_timeout($c), uv_clear_timeout(-1));
+
+uv_run($loop);
+echo implode(",", $log), "\n";
+var_dump(uv_clear_timeout($a));
+
+$d = uv_set_timeout(null, 1, function () {
+    echo "default loop\n";
+});
+var_dump($d > $c);
+uv_run();
+--EXPECT--
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(false)
+bool(false)
+b,b2,a
+bool(false)
+bool(true)
+default loop
@@ -0,0 +1,68 @@
+--TEST--
+Check for uv_stream_set_timeouts
+--FILE--
+<?php
+$loop = uv_loop_new();
+
+$server = uv_tcp_init($loop);
+uv_tcp_bind($server, uv_ip4_addr('127.0.0.1', 9881));
+$accepted = 0;
+uv_listen($server, 10, function ($server) use ($loop, &$accepted) {
+    $client = uv_tcp_init($loop);
+    uv_accept($server, $client);
+    uv_read_start($client, function ($socket, $nread, $buffer) {
+    });
+
+    if (++$accepted === 1) {
+        var_dump(uv_stream_set_timeouts($client, 50, 0, 0, function ($stream, $kind) {
+            echo "idle: ", $kind === UV::TIMEOUT_IDLE ? "ok" : $kind, PHP_EOL;
+            uv_close($stream);
+        }));
+    } else {
+        /* no callback: the stream is closed when the deadline passes */
+        var_dump(uv_stream_set_timeouts($client, 0, 50, 0));
+    }
+});
+
+$peer = uv_tcp_init($loop);
+uv_tcp_connect($peer, uv_ip4_addr('127.0.0.1', 9881), function ($peer, $status) use ($loop, $server) {
+    uv_read_start($peer, function ($peer, $nread, $buffer) use ($loop, $server) {
+        if ($nread === UV::EOF) {
+            echo "first peer: eof", PHP_EOL;
+            uv_close($peer);
+
+            $peer = uv_tcp_init($loop);
+            uv_tcp_connect($peer, uv_ip4_addr('127.0.0.1', 9881), function ($peer, $status) use ($loop, $server) {
+                /* activity does not extend a read deadline */
+                $ticker = uv_timer_init($loop);
+                uv_timer_start($ticker, 10, 10, function ($ticker) use ($peer) {
+                    uv_write($peer, "x");
+                });
+                uv_read_start($peer, function ($peer, $nread, $buffer) use ($server, $ticker) {
+                    /* EOF, or a reset if a write raced the close */
+                    if ($nread < 0) {
+                        echo "second peer: closed", PHP_EOL;
+                        uv_close($ticker);
+                        uv_close($peer);
+                        uv_close($server);
+                    }
+                });
+            });
+        }
+    });
+});
+
+$tcp = uv_tcp_init($loop);
+var_dump(uv_stream_set_timeouts($tcp, 0, 0, 0));
+var_dump(@uv_stream_set_timeouts($tcp, -1, 0, 0));
+uv_close($tcp);
+
+uv_run($loop);
+--EXPECT--
+bool(true)
+bool(false)
+bool(true)
+idle: ok
+first peer: eof
+bool(true)
+second peer: closed
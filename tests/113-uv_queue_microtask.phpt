@@ -0,0 +1,52 @@
+--TEST--
+Check for uv_queue_microtask
+--FILE--
+<?php
+$loop = uv_loop_new();
+
+uv_queue_microtask($loop, function () use ($loop) {
+    echo "A", PHP_EOL;
+    /* runs in the next loop iteration, after due timers */
+    uv_queue_microtask($loop, function () {
+        echo "C", PHP_EOL;
+    });
+    $timer = uv_timer_init($loop);
+    uv_timer_start($timer, 0, 0, function ($timer) {
+        echo "timer", PHP_EOL;
+        uv_close($timer);
+    });
+});
+uv_queue_microtask($loop, function () {
+    echo "B", PHP_EOL;
+});
+uv_run($loop);
+
+$count = 0;
+for ($i = 0; $i < 3000; $i++) {
+    uv_queue_microtask($loop, function () use (&$count) {
+        $count++;
+    });
+}
+uv_run($loop);
+var_dump($count);
+
+uv_queue_microtask($loop, function () {
+    throw new Exception("boom");
+});
+uv_queue_microtask($loop, function () {
+    echo "after", PHP_EOL;
+});
+try {
+    uv_run($loop);
+} catch (Exception $e) {
+    echo $e->getMessage(), PHP_EOL;
+}
+uv_run($loop);
+--EXPECT--
+A
+B
+timer
+C
+int(3000)
+boom
+after
@@ -0,0 +1,40 @@
+--TEST--
+Check for uv_fs_*_sync
+--FILE--
+<?php
+define("FIXTURE_PATH", dirname(__FILE__) . "/fixtures/hello.data");
+$loop = uv_default_loop();
+
+$fd = uv_fs_open_sync($loop, FIXTURE_PATH, UV::O_RDONLY, 0);
+var_dump(is_resource($fd));
+var_dump(trim(uv_fs_read_sync($loop, $fd, 0, 32)));
+$stat = uv_fs_fstat_sync($loop, $fd);
+var_dump($stat['size'] > 0);
+var_dump(uv_fs_close_sync($loop, $fd));
+
+var_dump(uv_fs_stat_sync($loop, FIXTURE_PATH)['size'] === $stat['size']);
+var_dump(uv_fs_stat_sync($loop, dirname(__FILE__) . "/fixtures/does-not-exist") === UV::ENOENT);
+
+$path = sys_get_temp_dir() . "/php-uv-sync-" . getmypid();
+$fd = uv_fs_open_sync($loop, $path, UV::O_WRONLY | UV::O_CREAT, 0644);
+var_dump(uv_fs_write_sync($loop, $fd, "abc", -1));
+var_dump(uv_fs_fsync_sync($loop, $fd));
+uv_fs_close_sync($loop, $fd);
+var_dump(uv_fs_stat_sync($loop, $path)['size']);
+var_dump(uv_fs_unlink_sync($loop, $path));
+
+/* nothing was left for the loop */
+uv_run($loop);
+echo "done", PHP_EOL;
+--EXPECT--
+bool(true)
+string(5) "Hello"
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+int(3)
+bool(true)
+int(3)
+bool(true)
+done
@@ -0,0 +1,48 @@
+--TEST--
+Check for uv_fs_writev and uv_fs_readv
+--FILE--
+<?php
+$loop = uv_default_loop();
+$path = sys_get_temp_dir() . "/php-uv-vectored-" . getmypid();
+
+uv_fs_open($loop, $path, UV::O_RDWR | UV::O_CREAT | UV::O_TRUNC, 0644, function ($fd) use ($loop, $path) {
+    uv_fs_writev($loop, $fd, ["head", "er", 42, ""], 0, function ($fd, $result) use ($loop, $path) {
+        var_dump($result);
+
+        uv_fs_readv($loop, $fd, 0, [4, 2, 8], function ($fd, $result, $segments) use ($loop, $path) {
+            var_dump($result, $segments);
+
+            var_dump(uv_fs_writev_sync($loop, $fd, ["tail"], 8));
+            var_dump(uv_fs_readv_sync($loop, $fd, 6, [2, 4]));
+
+            uv_fs_close($loop, $fd, function () use ($path) {
+                unlink($path);
+            });
+        });
+    });
+});
+
+var_dump(@uv_fs_readv($loop, STDIN, 0, []));
+var_dump(@uv_fs_readv($loop, STDIN, 0, [-1]));
+
+uv_run();
+--EXPECT--
+bool(false)
+bool(false)
+int(8)
+int(8)
+array(3) {
+  [0]=>
+  string(4) "head"
+  [1]=>
+  string(2) "er"
+  [2]=>
+  string(2) "42"
+}
+int(4)
+array(2) {
+  [0]=>
+  string(2) "42"
+  [1]=>
+  string(4) "tail"
+}
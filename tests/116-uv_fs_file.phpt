@@ -0,0 +1,39 @@
+--TEST--
+Check for uv_fs_read_file and uv_fs_write_file
+--FILE--
+<?php
+$loop = uv_loop_new();
+$path = sys_get_temp_dir() . "/php-uv-file-" . getmypid();
+
+var_dump(uv_fs_write_file($loop, $path, str_repeat("x", 10000), UV::O_WRONLY | UV::O_CREAT | UV::O_TRUNC, function ($result) use ($loop, $path) {
+    var_dump($result);
+
+    uv_fs_read_file($loop, $path, function ($data) use ($loop, $path) {
+        var_dump(strlen($data));
+
+        $written = uv_fs_write_file($loop, $path, "!", UV::O_WRONLY | UV::O_APPEND);
+        var_dump($written instanceof UVPromise);
+        uv_promise_then($written, function ($result) use ($loop, $path) {
+            var_dump($result);
+
+            uv_promise_then(uv_fs_read_file($loop, $path), function ($data) use ($loop, $path) {
+                var_dump(substr($data, -2));
+                unlink($path);
+
+                uv_promise_then(uv_fs_read_file($loop, $path), null, function ($error) {
+                    var_dump($error === UV::ENOENT);
+                });
+            });
+        });
+    });
+}));
+
+uv_run($loop);
+--EXPECT--
+bool(true)
+int(10000)
+int(10000)
+bool(true)
+int(1)
+string(2) "x!"
+bool(true)
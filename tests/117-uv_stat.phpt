@@ -0,0 +1,74 @@
+--TEST--
+Check for UVStat
+--FILE--
+<?php
+define("FIXTURE_PATH", dirname(__FILE__) . "/fixtures/hello.data");
+
+$stat = uv_fs_stat_sync(uv_default_loop(), FIXTURE_PATH);
+var_dump($stat instanceof UVStat);
+var_dump($stat->size === filesize(FIXTURE_PATH));
+var_dump($stat['size'] === $stat->size);
+var_dump($stat['link'] === $stat->nlink);
+var_dump($stat->mtime === filemtime(FIXTURE_PATH));
+var_dump(intdiv($stat->mtime_ns, 1000000000) === $stat->mtime);
+var_dump(isset($stat->ino), isset($stat['nope']), empty($stat->size));
+var_dump(count($stat) === count((array) $stat));
+
+/* array functions take the (array) cast, it still has link */
+$array = (array) $stat;
+var_dump(is_array($stat), is_array($array));
+var_dump(array_key_exists("link", $array), $array["link"] === $stat->nlink);
+var_dump(array_slice($array, 0, 5));
+foreach ($stat as $key => $value) {
+    var_dump($key);
+    break;
+}
+
+try {
+    $stat->size = 0;
+} catch (Error $e) {
+    echo $e->getMessage(), PHP_EOL;
+}
+try {
+    unset($stat['size']);
+} catch (Error $e) {
+    echo $e->getMessage(), PHP_EOL;
+}
+var_dump(@$stat->nope);
+
+uv_fs_stat(uv_default_loop(), FIXTURE_PATH, function ($result, $stat) {
+    var_dump($stat->ino === uv_fs_stat_sync(uv_default_loop(), FIXTURE_PATH)->ino);
+});
+uv_run();
+--EXPECTF--
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(true)
+bool(false)
+bool(false)
+bool(true)
+bool(false)
+bool(true)
+bool(true)
+bool(true)
+array(5) {
+  ["dev"]=>
+  int(%d)
+  ["ino"]=>
+  int(%d)
+  ["mode"]=>
+  int(%d)
+  ["nlink"]=>
+  int(%d)
+  ["link"]=>
+  int(%d)
+}
+string(3) "dev"
+UVStat is read-only
+UVStat is read-only
+NULL
+bool(true)
@@ -0,0 +1,96 @@
+--TEST--
+Check for uv_fs_stat_cache_enable and uv_fs_stat_cache_info
+--FILE--
+<?php
+$loop = uv_loop_new();
+$path = sys_get_temp_dir() . "/php-uv-stat-cache-" . getmypid();
+file_put_contents($path, "abc");
+
+var_dump(uv_fs_stat_cache_info($loop)["enabled"]);
+var_dump(@uv_fs_stat_cache_enable($loop, -1));
+var_dump(uv_fs_stat_cache_enable($loop, 60000));
+
+uv_fs_stat($loop, $path, function ($result, $stat) use ($loop, $path) {
+    echo "miss: ", $stat->size, PHP_EOL;
+
+    /* a hit is a request like a miss, completed in the next iteration */
+    $req = uv_fs_stat($loop, $path, function ($result, $stat) {
+        echo "hit: ", $stat->size, PHP_EOL;
+    });
+    echo "after hit", PHP_EOL;
+    var_dump($req instanceof UVFs, uv_fs_stat($loop, $path) instanceof UVPromise);
+    var_dump(uv_fs_stat_sync($loop, $path)->size);
+
+    $info = uv_fs_stat_cache_info($loop);
+    var_dump($info["entries"], $info["hits"], $info["misses"], $info["watchers"]);
+
+    /* the watcher on the directory drops the entry */
+    file_put_contents($path, "abcdef");
+    $timer = uv_timer_init($loop);
+    uv_timer_start($timer, 100, 0, function ($timer) use ($loop, $path) {
+        uv_close($timer);
+        var_dump(uv_fs_stat_cache_info($loop)["invalidations"] > 0);
+        uv_fs_stat($loop, $path, function ($result, $stat) {
+            echo "changed: ", $stat->size, PHP_EOL;
+        });
+    });
+});
+uv_run($loop);
+
+/* relative paths are cached by the absolute path they named */
+$cwd = getcwd();
+$dirs = [$path . ".d1", $path . ".d2"];
+foreach ($dirs as $i => $dir) {
+    mkdir($dir);
+    file_put_contents("$dir/a.txt", str_repeat("x", $i + 1));
+}
+foreach ($dirs as $dir) {
+    chdir($dir);
+    var_dump(uv_fs_stat_sync($loop, "a.txt")->size);
+}
+var_dump(uv_fs_stat_sync($loop, "a.txt")->size);
+chdir($cwd);
+foreach ($dirs as $dir) {
+    unlink("$dir/a.txt");
+    rmdir($dir);
+}
+
+/* a full cache drops its oldest entry */
+$small = uv_loop_new();
+uv_fs_stat_cache_enable($small, 60000, 2);
+foreach ([__FILE__, $path, __DIR__, __FILE__] as $file) {
+    uv_fs_stat_sync($small, $file);
+}
+$info = uv_fs_stat_cache_info($small);
+var_dump($info["entries"], $info["hits"], $info["misses"]);
+
+var_dump(uv_fs_stat_cache_enable($loop, 0));
+$info = uv_fs_stat_cache_info($loop);
+var_dump($info["enabled"], $info["entries"], $info["watchers"]);
+unlink($path);
+--EXPECT--
+bool(false)
+bool(false)
+bool(true)
+miss: 3
+after hit
+bool(true)
+bool(true)
+int(3)
+int(1)
+int(3)
+int(1)
+int(1)
+hit: 3
+bool(true)
+changed: 6
+int(1)
+int(2)
+int(2)
+int(2)
+int(0)
+int(4)
+bool(true)
+bool(false)
+int(0)
+int(0)
@@ -0,0 +1,29 @@
+--TEST--
+Check that a promise settling does not swallow an exception thrown by an earlier callback
+--FILE--
+<?php
+$loop = uv_loop_new();
+
+$promise = uv_fs_stat($loop, __FILE__);
+$derived = uv_promise_then($promise, function ($stat) {
+    echo "handler ran", PHP_EOL;
+}, function ($error) {
+    echo "rejected", PHP_EOL;
+});
+
+/* runs before the stat completes, its exception is still pending when the promise settles */
+$timer = uv_timer_init($loop);
+uv_timer_start($timer, 0, 0, function ($timer) {
+    uv_close($timer);
+    throw new Exception("thrown by the timer");
+});
+
+try {
+    uv_run($loop);
+} catch (Exception $e) {
+    echo $e->getMessage(), PHP_EOL;
+}
+echo "done", PHP_EOL;
+--EXPECT--
+thrown by the timer
+done
@@ -0,0 +1,25 @@
+--TEST--
+Check for udp bind with UV::UDP_REUSEPORT
+--SKIPIF--
+<?php
+if (strtoupper(substr(PHP_OS, 0, 3)) == 'WIN') {
+  echo "skip SO_REUSEPORT is not available on windows";
+}
+--FILE--
+<?php
+$loop = uv_loop_new();
+
+$a = uv_udp_init();
+var_dump(uv_udp_bind($a, uv_ip4_addr('127.0.0.1', 10001), UV::UDP_REUSEPORT));
+
+$b = uv_udp_init($loop);
+var_dump(uv_udp_bind($b, uv_ip4_addr('127.0.0.1', 10001), UV::UDP_REUSEPORT));
+
+uv_close($a);
+uv_close($b);
+
+uv_run();
+uv_run($loop);
+--EXPECT--
+bool(true)
+bool(true)
@@ -0,0 +1,30 @@
+--TEST--
+Check for udp send with a segment size
+--FILE--
+<?php
+$udp = uv_udp_init();
+uv_udp_bind($udp, uv_ip4_addr('127.0.0.1', 10002));
+
+$count = 0;
+uv_udp_recv_start($udp, function($stream, $nread, $buffer) use (&$count) {
+    echo "recv: " . $nread . " " . $buffer[0] . PHP_EOL;
+
+    if (++$count == 3) {
+        uv_close($stream);
+    }
+});
+
+$uv = uv_udp_init();
+var_dump(uv_udp_set_segment_size($uv, 1000));
+uv_udp_send($uv, str_repeat("a", 1000) . str_repeat("b", 1000) . str_repeat("c", 500), uv_ip4_addr("127.0.0.1", 10002), function($uv, $s) {
+    echo "sent: " . $s . PHP_EOL;
+    uv_close($uv);
+});
+
+uv_run();
+--EXPECT--
+bool(false)
+sent: 0
+recv: 1000 a
+recv: 1000 b
+recv: 500 c
@@ -0,0 +1,47 @@
+--TEST--
+Check for udp relay
+--FILE--
+<?php
+$upstream = stream_socket_server("udp://127.0.0.1:10004", $errno, $errstr, STREAM_SERVER_BIND);
+$poll = uv_poll_init(uv_default_loop(), $upstream);
+uv_poll_start($poll, UV::READABLE, function($poll, $stat, $ev, $socket) {
+    $data = stream_socket_recvfrom($socket, 1024, 0, $peer);
+    stream_socket_sendto($socket, strtoupper($data), 0, $peer);
+});
+
+$listener = uv_udp_init();
+uv_udp_bind($listener, uv_ip4_addr('127.0.0.1', 10003));
+var_dump(uv_udp_relay_start($listener, [uv_ip4_addr('127.0.0.1', 10004)], UV::RELAY_ROUND_ROBIN, 1000, function($listener, $event, $client, $upstream) {
+    echo "event: " . $event . " " . uv_ip4_name($client) . " " . $upstream . PHP_EOL;
+}));
+
+$client = uv_udp_init();
+uv_udp_bind($client, uv_ip4_addr('127.0.0.1', 10005));
+uv_udp_recv_start($client, function($client, $nread, $buffer) use ($listener, $poll) {
+    echo "reply: " . $buffer . PHP_EOL;
+
+    var_dump(uv_udp_relay_info($listener));
+    var_dump(uv_udp_relay_stop($listener));
+
+    uv_close($client);
+    uv_close($listener);
+    uv_poll_stop($poll);
+});
+uv_udp_send($client, "hello", uv_ip4_addr('127.0.0.1', 10003));
+
+uv_run();
+--EXPECT--
+bool(true)
+event: 1 127.0.0.1 0
+reply: HELLO
+array(4) {
+  ["sessions"]=>
+  int(1)
+  ["forwarded"]=>
+  int(1)
+  ["replied"]=>
+  int(1)
+  ["dropped"]=>
+  int(0)
+}
+bool(true)
@@ -0,0 +1,54 @@
+--TEST--
+Check for udp relay session limit
+--FILE--
+<?php
+$upstream = stream_socket_server("udp://127.0.0.1:10007", $errno, $errstr, STREAM_SERVER_BIND);
+$poll = uv_poll_init(uv_default_loop(), $upstream);
+uv_poll_start($poll, UV::READABLE, function($poll, $stat, $ev, $socket) {
+    $data = stream_socket_recvfrom($socket, 1024, 0, $peer);
+    stream_socket_sendto($socket, strtoupper($data), 0, $peer);
+});
+
+$listener = uv_udp_init();
+uv_udp_bind($listener, uv_ip4_addr('127.0.0.1', 10006));
+var_dump(@uv_udp_relay_start($listener, [uv_ip4_addr('127.0.0.1', 10007)], UV::RELAY_ROUND_ROBIN, 1000, null, -1));
+var_dump(uv_udp_relay_start($listener, [uv_ip4_addr('127.0.0.1', 10007)], UV::RELAY_ROUND_ROBIN, 1000, null, 1));
+
+$clients = [];
+foreach ([10008, 10009] as $port) {
+    $client = uv_udp_init();
+    uv_udp_bind($client, uv_ip4_addr('127.0.0.1', $port));
+    uv_udp_recv_start($client, function($client, $nread, $buffer) use ($port) {
+        echo "reply to " . $port . ": " . $buffer . PHP_EOL;
+    });
+    $clients[] = $client;
+}
+
+/* the second client would need a second session */
+uv_udp_send($clients[0], "first", uv_ip4_addr('127.0.0.1', 10006));
+$timer = uv_timer_init();
+uv_timer_start($timer, 100, 0, function($timer) use ($clients) {
+    uv_udp_send($clients[1], "second", uv_ip4_addr('127.0.0.1', 10006));
+});
+$done = uv_timer_init();
+uv_timer_start($done, 300, 0, function($timer) use ($listener, $clients, $poll) {
+    $info = uv_udp_relay_info($listener);
+    var_dump($info["sessions"], $info["forwarded"], $info["dropped"]);
+
+    uv_udp_relay_stop($listener);
+    uv_close($listener);
+    foreach ($clients as $client) {
+        uv_close($client);
+    }
+    uv_poll_stop($poll);
+    uv_close($timer);
+});
+
+uv_run();
+--EXPECT--
+bool(false)
+bool(true)
+reply to 10008: FIRST
+int(1)
+int(1)
+int(1)
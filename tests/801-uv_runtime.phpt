@@ -0,0 +1,43 @@
+--TEST--
+Check for uv_runtime_new with a shared listener
+--SKIPIF--
+<?php
+ob_start();
+phpinfo();
+$data = ob_get_clean();
+if (!preg_match("/Thread Safety.+?enabled/", $data)) {
+  echo "skip";
+}
+--FILE--
+<?php
+$listener = uv_tcp_init();
+uv_tcp_bind($listener, uv_ip4_addr('127.0.0.1', 0));
+$addr = uv_tcp_getsockname($listener);
+
+var_dump(uv_runtime_worker_id());
+$runtime = uv_runtime_new(2, __DIR__ . "/fixtures/runtime_worker.php", $listener);
+var_dump($runtime instanceof UVRuntime);
+
+$replies = [];
+for ($i = 0; $i < 4; $i++) {
+    $client = uv_tcp_init();
+    uv_tcp_connect($client, uv_ip4_addr($addr['address'], $addr['port']), function ($client, $status) use (&$replies) {
+        uv_read_start($client, function ($client, $data) use (&$replies) {
+            if (is_string($data)) {
+                $replies[] = preg_match('/^worker [01]$/', $data) ? 'ok' : $data;
+            }
+            uv_close($client);
+        });
+    });
+}
+uv_run();
+echo implode(' ', $replies), PHP_EOL;
+
+uv_runtime_stop($runtime);
+uv_runtime_join($runtime);
+echo "joined", PHP_EOL;
+--EXPECT--
+NULL
+bool(true)
+ok ok ok ok
+joined
@@ -0,0 +1,10 @@
+<?php
+$server = uv_runtime_listener();
+uv_listen($server, 16, function ($server) {
+    $client = uv_tcp_init();
+    uv_accept($server, $client);
+    uv_write($client, "worker " . uv_runtime_worker_id(), function ($client) {
+        uv_close($client);
+    });
+});
+uv_run();
@@ -139,6 +139,47 @@ void php_uv_init(zend_class_entry *uv_class_entry)
 	zend_declare_class_constant_long(uv_class_entry, "LEAVE_GROUP",  sizeof("LEAVE_GROUP")-1, UV_LEAVE_GROUP TSRMLS_CC);
 	zend_declare_class_constant_long(uv_class_entry, "JOIN_GROUP",  sizeof("JOIN_GROUP")-1, UV_JOIN_GROUP TSRMLS_CC);
 
+	/* udp bind flags */
+	zend_declare_class_constant_long(uv_class_entry, "UDP_IPV6ONLY",  sizeof("UDP_IPV6ONLY")-1, UV_UDP_IPV6ONLY TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "UDP_REUSEADDR",  sizeof("UDP_REUSEADDR")-1, UV_UDP_REUSEADDR TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "UDP_REUSEPORT",  sizeof("UDP_REUSEPORT")-1, PHP_UV_UDP_REUSEPORT TSRMLS_CC);
+
+	/* udp relay */
+	zend_declare_class_constant_long(uv_class_entry, "RELAY_ROUND_ROBIN",  sizeof("RELAY_ROUND_ROBIN")-1, PHP_UV_RELAY_ROUND_ROBIN TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "RELAY_SOURCE_HASH",  sizeof("RELAY_SOURCE_HASH")-1, PHP_UV_RELAY_SOURCE_HASH TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "RELAY_SESSION_OPEN",  sizeof("RELAY_SESSION_OPEN")-1, PHP_UV_RELAY_SESSION_OPEN TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "RELAY_SESSION_CLOSE",  sizeof("RELAY_SESSION_CLOSE")-1, PHP_UV_RELAY_SESSION_CLOSE TSRMLS_CC);
+
+	/* uv_event_sink() and the event types returned by uv_run_collect() */
+	zend_declare_class_constant_long(uv_class_entry, "SINK_CALLBACK",  sizeof("SINK_CALLBACK")-1, PHP_UV_SINK_CALLBACK TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "SINK_QUEUE",  sizeof("SINK_QUEUE")-1, PHP_UV_SINK_QUEUE TSRMLS_CC);
+
+	zend_declare_class_constant_long(uv_class_entry, "EVENT_LISTEN",  sizeof("EVENT_LISTEN")-1, PHP_UV_LISTEN_CB TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "EVENT_READ",  sizeof("EVENT_READ")-1, PHP_UV_READ_CB TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "EVENT_READ2",  sizeof("EVENT_READ2")-1, PHP_UV_READ2_CB TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "EVENT_WRITE",  sizeof("EVENT_WRITE")-1, PHP_UV_WRITE_CB TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "EVENT_SHUTDOWN",  sizeof("EVENT_SHUTDOWN")-1, PHP_UV_SHUTDOWN_CB TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "EVENT_CLOSE",  sizeof("EVENT_CLOSE")-1, PHP_UV_CLOSE_CB TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "EVENT_TIMER",  sizeof("EVENT_TIMER")-1, PHP_UV_TIMER_CB TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "EVENT_IDLE",  sizeof("EVENT_IDLE")-1, PHP_UV_IDLE_CB TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "EVENT_CONNECT",  sizeof("EVENT_CONNECT")-1, PHP_UV_CONNECT_CB TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "EVENT_RECV",  sizeof("EVENT_RECV")-1, PHP_UV_RECV_CB TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "EVENT_SEND",  sizeof("EVENT_SEND")-1, PHP_UV_SEND_CB TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "EVENT_PIPE_CONNECT",  sizeof("EVENT_PIPE_CONNECT")-1, PHP_UV_PIPE_CONNECT_CB TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "EVENT_PROCESS_CLOSE",  sizeof("EVENT_PROCESS_CLOSE")-1, PHP_UV_PROC_CLOSE_CB TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "EVENT_PREPARE",  sizeof("EVENT_PREPARE")-1, PHP_UV_PREPARE_CB TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "EVENT_CHECK",  sizeof("EVENT_CHECK")-1, PHP_UV_CHECK_CB TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "EVENT_ASYNC",  sizeof("EVENT_ASYNC")-1, PHP_UV_ASYNC_CB TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "EVENT_FS_EVENT",  sizeof("EVENT_FS_EVENT")-1, PHP_UV_FS_EVENT_CB TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "EVENT_FS_POLL",  sizeof("EVENT_FS_POLL")-1, PHP_UV_FS_POLL_CB TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "EVENT_POLL",  sizeof("EVENT_POLL")-1, PHP_UV_POLL_CB TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "EVENT_SIGNAL",  sizeof("EVENT_SIGNAL")-1, PHP_UV_SIGNAL_CB TSRMLS_CC);
+
+	/* expired deadline passed to the callback of uv_stream_set_timeouts() */
+	zend_declare_class_constant_long(uv_class_entry, "TIMEOUT_IDLE",  sizeof("TIMEOUT_IDLE")-1, PHP_UV_TIMEOUT_IDLE TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "TIMEOUT_READ",  sizeof("TIMEOUT_READ")-1, PHP_UV_TIMEOUT_READ TSRMLS_CC);
+	zend_declare_class_constant_long(uv_class_entry, "TIMEOUT_WRITE",  sizeof("TIMEOUT_WRITE")-1, PHP_UV_TIMEOUT_WRITE TSRMLS_CC);
+
 	/* for uv_handle_type */
 	zend_declare_class_constant_long(uv_class_entry,  "IS_UV_TCP", sizeof("IS_UV_TCP")-1, IS_UV_TCP TSRMLS_CC);
 	zend_declare_class_constant_long(uv_class_entry,  "IS_UV_UDP", sizeof("IS_UV_UDP")-1, IS_UV_UDP TSRMLS_CC);